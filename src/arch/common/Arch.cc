@@ -17,6 +17,9 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
+#include <limits>
+
 #include <lib/cpp/Misc.h>
 #include <lib/cpp/Terminal.h>
 
@@ -182,6 +185,57 @@ void ArchPool::Run(int &num_active_emulators, int &num_active_timing_simulators)
 }
 
 
+long long ArchPool::getWakeupTime()
+{
+	// Traverse architectures in active detailed simulation
+	esim::Engine *esim_engine = esim::Engine::getInstance();
+	long long time = std::numeric_limits<long long>::max();
+	bool found = false;
+	for (Arch *arch : timing_arch_list)
+	{
+		if (arch->getSimKind() != Arch::SimDetailed || !arch->isActive())
+			continue;
+
+		// Convert the wakeup cycle into the time when it starts
+		Timing *timing = arch->getTiming();
+		esim::FrequencyDomain *frequency_domain =
+				timing->getFrequencyDomain();
+		long long cycle = timing->getWakeupCycle();
+		if (cycle < std::numeric_limits<long long>::max())
+			time = std::min(time, (cycle - 1) *
+					frequency_domain->getCycleTime());
+		found = true;
+	}
+
+	// No architecture in active timing simulation
+	return found ? time : esim_engine->getTime();
+}
+
+
+void ArchPool::SkipCycles(long long old_time)
+{
+	for (Arch *arch : timing_arch_list)
+	{
+		if (arch->getSimKind() != Arch::SimDetailed || !arch->isActive())
+			continue;
+
+		// The first cycle not run yet is the one at the old time,
+		// unless the architecture already ran it at a slower frequency.
+		Timing *timing = arch->getTiming();
+		esim::FrequencyDomain *frequency_domain =
+				timing->getFrequencyDomain();
+		long long first_cycle = std::max(old_time /
+				frequency_domain->getCycleTime() + 1,
+				timing->getLastSimulationCycle() + 1);
+
+		// Skipped cycles, up to the current one
+		long long num_cycles = timing->getCycle() - first_cycle;
+		if (num_cycles > 0)
+			timing->SkipCycles(num_cycles);
+	}
+}
+
+
 void ArchPool::DumpSummary(std::ostream &os) const
 {
 	// Print in blue
@@ -222,6 +222,17 @@ public:
 	///	decide whether the main simulation loop should stop.
 	void Run(int &num_emu_active, int &num_timing_active);
 
+	/// Return the earliest simulation time, in picoseconds, in which an
+	/// architecture running an active timing simulation needs to run
+	/// again, based on its Timing::getWakeupCycle(). If there is no
+	/// such architecture, the current simulation time is returned.
+	long long getWakeupTime();
+
+	/// Notify all architectures running a detailed simulation of the
+	/// cycles skipped by the main simulation loop, after the simulation
+	/// time jumped from the given time to the current one.
+	void SkipCycles(long long old_time);
+
 	/// Dump a summary for all architectures in the pool.
 	void DumpSummary(std::ostream &os = std::cerr) const;
 
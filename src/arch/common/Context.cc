@@ -17,6 +17,8 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
+
 #include <lib/cpp/String.h>
 
 #include "Context.h"
@@ -42,6 +44,19 @@ Context::Context(Emulator *emulator) :
 }
 
 
+void Context::setId(int id)
+{
+	// Set ID
+	this->id = id;
+	id_counter = std::max(id_counter, id + 1);
+
+	// Compute name
+	name = misc::fmt("%s context %d",
+			emulator->getName().c_str(),
+			id);
+}
+
+
 void Context::Suspend()
 {
 	throw misc::Panic("Not implemented");
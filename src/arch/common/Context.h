@@ -47,6 +47,14 @@ class Context
 	// Associated emulator, initialized in constructor
 	Emulator *emulator;
 
+protected:
+
+	/// Change the context identifier. This is used when a context is
+	/// restored from a checkpoint, to keep the identifier it had when the
+	/// checkpoint was saved. Contexts created later are assigned higher
+	/// identifiers.
+	void setId(int id);
+
 public:
 
 	/// Constructor
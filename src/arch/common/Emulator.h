@@ -73,6 +73,9 @@ public:
 	/// Increment the number of emulated instructions
 	void incNumInstructions() { ++num_instructions; }
 
+	/// Add \a count to the number of emulated instructions
+	void addNumInstructions(long long count) { num_instructions += count; }
+
 	/// Return the number of emulated instructions
 	long long getNumInstructions() const { return num_instructions; }
 
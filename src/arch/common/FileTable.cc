@@ -17,8 +17,17 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */ 
  
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
 #include <unistd.h>
 
+#include <lib/cpp/Checkpoint.h>
+#include <lib/cpp/Error.h>
+
 #include "FileTable.h"
 
 namespace comm
@@ -174,5 +183,158 @@ void FileTable::freeFileDescriptor(int index)
 }
 
 
-}  // namespace comm
+void FileTable::SaveCheckpoint(misc::Checkpoint &checkpoint) const
+{
+	checkpoint.WriteTag("file-table");
+	checkpoint.WriteValue<unsigned>(descriptors.size());
+	for (int i = 0; i < (int) descriptors.size(); i++)
+	{
+		// Free entry
+		FileDescriptor *desc = descriptors[i].get();
+		checkpoint.WriteValue<bool>(desc);
+		if (!desc)
+			continue;
+
+		// Only files can be restored
+		FileDescriptor::Type type = desc->getType();
+		if (type != FileDescriptor::TypeRegular &&
+				type != FileDescriptor::TypeStandard &&
+				type != FileDescriptor::TypeVirtual)
+			throw misc::Error(misc::fmt("File descriptor %d of "
+					"type %s cannot be saved in a "
+					"checkpoint", i,
+					FileDescriptor::TypeTypeMap[type]));
+
+		// Look for a previous descriptor using the same host file
+		// descriptor, as stdout and stderr redirected to the same
+		// file. Descriptors without a path, created by 'dup', are
+		// restored by duplicating a previous descriptor pointing to
+		// the same host file.
+		int host_index = desc->getHostIndex();
+		int alias = -1;
+		int dup_of = -1;
+		struct stat desc_stat;
+		bool has_stat = !fstat(host_index, &desc_stat);
+		for (int j = 0; j < i && alias < 0; j++)
+		{
+			FileDescriptor *other = descriptors[j].get();
+			struct stat other_stat;
+			if (!other)
+				continue;
+			if (other->getHostIndex() == host_index)
+				alias = j;
+			else if (desc->getPath().empty() && dup_of < 0 &&
+					has_stat &&
+					!fstat(other->getHostIndex(),
+							&other_stat) &&
+					other_stat.st_dev == desc_stat.st_dev &&
+					other_stat.st_ino == desc_stat.st_ino)
+				dup_of = j;
+		}
+
+		// A descriptor that is not a standard stream must be
+		// reachable again through its path or another descriptor.
+		if (desc->getPath().empty() && alias < 0 && dup_of < 0 &&
+				host_index > 2)
+			throw misc::Error(misc::fmt("File descriptor %d "
+					"cannot be saved in a checkpoint",
+					i));
+
+		// Descriptor
+		checkpoint.WriteValue<int>(type);
+		checkpoint.WriteValue(host_index);
+		checkpoint.WriteValue(desc->getFlags());
+		checkpoint.WriteString(desc->getPath());
+		checkpoint.WriteValue(alias);
+		checkpoint.WriteValue(dup_of);
+		checkpoint.WriteValue<long long>(lseek(host_index, 0,
+				SEEK_CUR));
+
+		// Content of virtual files
+		if (type == FileDescriptor::TypeVirtual)
+		{
+			std::ifstream f(desc->getPath());
+			std::ostringstream content;
+			content << f.rdbuf();
+			checkpoint.WriteString(content.str());
+		}
+	}
+}
+
+
+void FileTable::LoadCheckpoint(misc::Checkpoint &checkpoint)
+{
+	// Discard current descriptors
+	descriptors.clear();
 
+	// Read descriptors
+	checkpoint.ReadTag("file-table");
+	descriptors.resize(checkpoint.ReadValue<unsigned>());
+	for (int i = 0; i < (int) descriptors.size(); i++)
+	{
+		// Free entry
+		if (!checkpoint.ReadValue<bool>())
+			continue;
+
+		// Descriptor
+		auto type = (FileDescriptor::Type) checkpoint.ReadValue<int>();
+		int host_index = checkpoint.ReadValue<int>();
+		int flags = checkpoint.ReadValue<int>();
+		std::string path = checkpoint.ReadString();
+		int alias = checkpoint.ReadValue<int>();
+		int dup_of = checkpoint.ReadValue<int>();
+		long long offset = checkpoint.ReadValue<long long>();
+		if ((alias >= 0 && !getFileDescriptor(alias)) ||
+				(dup_of >= 0 && !getFileDescriptor(dup_of)))
+			throw misc::Error(misc::fmt("%s: invalid file "
+					"descriptor %d in checkpoint file",
+					checkpoint.getPath().c_str(), i));
+
+		// Create virtual file again
+		if (type == FileDescriptor::TypeVirtual)
+		{
+			std::string content = checkpoint.ReadString();
+			char temp_path[] = "/tmp/m2s.XXXXXX";
+			int fd = mkstemp(temp_path);
+			if (fd < 0 || write(fd, content.data(), content.size())
+					!= (int) content.size())
+				throw misc::Error("Cannot create temporary "
+						"file");
+			close(fd);
+			path = temp_path;
+		}
+
+		// Obtain host file descriptor. Files are not truncated, so
+		// that output files keep the content written before the
+		// checkpoint was taken.
+		if (alias >= 0)
+		{
+			host_index = descriptors[alias]->getHostIndex();
+		}
+		else if (dup_of >= 0)
+		{
+			host_index = dup(descriptors[dup_of]->getHostIndex());
+		}
+		else if (!path.empty())
+		{
+			host_index = open(path.c_str(), flags &
+					~(O_CREAT | O_EXCL | O_TRUNC));
+			if (host_index < 0)
+				throw misc::Error(misc::fmt("%s: cannot open "
+						"file saved in checkpoint: "
+						"%s", path.c_str(),
+						strerror(errno)));
+		}
+
+		// Restore offset
+		if (alias < 0 && offset >= 0 && host_index > 2)
+			lseek(host_index, offset, SEEK_SET);
+
+		// Create descriptor
+		descriptors[i].reset(new FileDescriptor(type, i, host_index,
+				flags, path));
+	}
+}
+
+
+}  // namespace comm
@@ -28,6 +28,11 @@
 #include <lib/cpp/String.h>
 
 
+namespace misc
+{
+class Checkpoint;
+}
+
 namespace comm
 {
 
@@ -200,6 +205,21 @@ public:
 	/// Return the guest file descriptor associated with a host file
 	/// descriptor given in \a host_index, or -1 if invalid.
 	int getGuestIndex(int host_index) const;
+
+	/// Write the file descriptors into a checkpoint file, together with
+	/// the current offset of their host files. The content of virtual
+	/// files is saved as well.
+	///
+	/// \throw
+	///	A misc::Error is thrown if any file descriptor is a pipe, a
+	///	socket, or a device, whose state cannot be saved.
+	void SaveCheckpoint(misc::Checkpoint &checkpoint) const;
+
+	/// Replace the file descriptors with those saved in a checkpoint
+	/// file. Host files are opened again and positioned at their saved
+	/// offset, without truncating them. Virtual files are created again
+	/// in new temporary host files.
+	void LoadCheckpoint(misc::Checkpoint &checkpoint);
 };
 
 
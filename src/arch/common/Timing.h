@@ -60,6 +60,20 @@ public:
 	/// function must be implemented by every derived class.
 	virtual bool Run() = 0;
 
+	/// Return the earliest cycle, in the frequency domain of this timing
+	/// simulator, in which it needs to run again, assuming that the
+	/// simulation engine processes no event in the meantime. The main
+	/// simulation loop calls this function after each cycle, and skips
+	/// the cycles in which all timing simulators are stalled. The default
+	/// implementation returns the current cycle, so that no cycle is
+	/// skipped.
+	virtual long long getWakeupCycle() { return getCycle(); }
+
+	/// Update the statistics collected in every cycle for the given number
+	/// of cycles skipped by the main simulation loop, after a call to
+	/// getWakeupCycle() reported them as idle.
+	virtual void SkipCycles(long long num_cycles) { }
+
 	/// Configure the frequency domain with the given frequency. After this
 	/// call, the frequency domain can be retrieved with a call to
 	/// getFrequencyDomain().
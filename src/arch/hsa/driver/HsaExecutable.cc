@@ -202,6 +202,10 @@ void HsaExecutable::parseFunction(BrigFile *file,
 	function->setFirstEntry(std::move(first_entry));
 	function->setFunctionDirective(std::move(entry));
 
+	// Decode the code entries of the function once, so that the emulator
+	// does not parse them on every execution
+	function->DecodeEntries();
+
 	if (Emulator::loader_debug)
 		function->Dump(Emulator::loader_debug);
 
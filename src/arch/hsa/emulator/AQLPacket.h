@@ -231,6 +231,9 @@ public:
 	/// Return the completion signal
 	uint64_t getCompletionSignal() const { return getByOffset<uint64_t>(56); }
 
+	/// Set the completion signal
+	void setCompletionSignal(uint64_t signal){ setByOffset<uint64_t>(56, signal); }
+
 	/// Dump the AQL dispatch packet
 	void Dump(std::ostream &os) const;
 
@@ -40,6 +40,14 @@ BrInstructionWorker::~BrInstructionWorker()
 
 void BrInstructionWorker::Execute(BrigCodeEntry *instruction)
 {
+	// Jump to the target decoded when the function was loaded
+	const Function::DecodedEntry *pc = stack_frame->getDecodedPc();
+	if (pc && pc->entry.get() == instruction && pc->operands[0].target)
+	{
+		stack_frame->setPc(pc->operands[0].target);
+		return;
+	}
+
 	// Retrieve 1st operand
 	auto operand0 = instruction->getOperand(0);
 	if (operand0->getKind() == BRIG_KIND_OPERAND_CODE_REF)
@@ -52,6 +52,15 @@ void CbrInstructionWorker::Execute(BrigCodeEntry *instruction)
 
 	// Jump if condition is true
 	if (condition){
+		// Jump to the target decoded when the function was loaded
+		const Function::DecodedEntry *pc = stack_frame->getDecodedPc();
+		if (pc && pc->entry.get() == instruction &&
+				pc->operands[1].target)
+		{
+			stack_frame->setPc(pc->operands[1].target);
+			return;
+		}
+
 		// Retrieve 1st operand
 		auto operand1 = instruction->getOperand(1);
 		if (operand1->getKind() == BRIG_KIND_OPERAND_CODE_REF)
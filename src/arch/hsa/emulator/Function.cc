@@ -17,11 +17,13 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
 #include <cstring>
 
 #include <lib/cpp/String.h>
 #include <arch/hsa/disassembler/BrigCodeEntry.h>
 #include <arch/hsa/disassembler/BrigFile.h>
+#include <arch/hsa/disassembler/BrigImmed.h>
 #include <arch/hsa/disassembler/BrigOperandEntry.h>
 #include <arch/hsa/disassembler/AsmService.h>
 
@@ -131,6 +133,127 @@ void Function::AllocateRegister(unsigned int *max_register)
 	}
 }
 
+
+void Function::DecodeOperand(BrigCodeEntry *instruction, unsigned index,
+		DecodedOperand *operand) const
+{
+	// Get the operand entry
+	auto entry = instruction->getOperand(index);
+	if (!entry.get())
+		return;
+	operand->kind = entry->getKind();
+
+	// Operands whose register is resolved
+	std::unique_ptr<BrigOperandEntry> reg;
+	switch (operand->kind)
+	{
+	case BRIG_KIND_OPERAND_CONSTANT_BYTES:
+
+	{
+		BrigImmed immed(entry->getBytes(),
+				instruction->getOperandType(index));
+		operand->bytes = entry->getBytes();
+		operand->bytes_size = immed.getSize();
+		return;
+	}
+
+	case BRIG_KIND_OPERAND_REGISTER:
+
+		reg = std::move(entry);
+		break;
+
+	case BRIG_KIND_OPERAND_ADDRESS:
+
+		if (entry->getSymbol().get())
+			operand->symbol = entry->getSymbol()->getName();
+		operand->offset = entry->getOffset();
+		reg = entry->getReg();
+		break;
+
+	default:
+
+		// Other kinds of operands are accessed through the BRIG entry
+		return;
+	}
+
+	// No register
+	if (!reg.get())
+		return;
+
+	// Control registers are identified by their number
+	operand->has_register = true;
+	if (reg->getRegKind() == BRIG_REGISTER_KIND_CONTROL)
+	{
+		operand->register_offset = reg->getRegNumber();
+		operand->register_size = 0;
+		return;
+	}
+
+	// Other registers by their offset in the register storage
+	std::string name = reg->getRegisterName();
+	operand->register_offset = getRegisterOffset(name);
+	operand->register_size = AsmService::getSizeInByteByRegisterName(name);
+}
+
+
+void Function::DecodeEntries()
+{
+	// Nothing to decode
+	decoded_entries.clear();
+	decoded_entry_map.clear();
+	if (!first_entry.get() || !last_entry.get())
+		return;
+
+	// Decode entries from the first to the last one
+	unsigned last_offset = last_entry->getOffset();
+	auto entry = getFirstEntry();
+	while (entry.get() && entry->getOffset() <= last_offset)
+	{
+		auto next_entry = entry->Next();
+		decoded_entries.emplace_back();
+		DecodedEntry &decoded_entry = decoded_entries.back();
+		decoded_entry.is_instruction = entry->isInstruction();
+		if (decoded_entry.is_instruction)
+		{
+			decoded_entry.opcode = entry->getOpcode();
+			decoded_entry.num_operands = std::min(
+					entry->getOperandCount(),
+					MaxDecodedOperands);
+			for (unsigned i = 0; i < decoded_entry.num_operands; i++)
+				DecodeOperand(entry.get(), i,
+						&decoded_entry.operands[i]);
+		}
+		decoded_entry.entry = std::move(entry);
+		entry = std::move(next_entry);
+	}
+
+	// Link entries, now that the vector does not grow anymore
+	for (unsigned i = 0; i < decoded_entries.size(); i++)
+	{
+		DecodedEntry &decoded_entry = decoded_entries[i];
+		if (i + 1 < decoded_entries.size())
+			decoded_entry.next = &decoded_entries[i + 1];
+		decoded_entry_map[decoded_entry.entry->getOffset()] =
+				&decoded_entry;
+	}
+
+	// Resolve branch targets
+	for (DecodedEntry &decoded_entry : decoded_entries)
+	{
+		for (unsigned i = 0; i < decoded_entry.num_operands; i++)
+		{
+			DecodedOperand &operand = decoded_entry.operands[i];
+			if (operand.kind != BRIG_KIND_OPERAND_CODE_REF)
+				continue;
+			auto operand_entry = decoded_entry.entry->getOperand(i);
+			auto target = operand_entry->getRef();
+			if (target.get())
+				operand.target = getDecodedEntry(
+						target->getOffset());
+		}
+	}
+}
+
 /*
 void Function::PassByValue(StackFrame *caller_frame,
 		StackFrame *callee_frame, BrigCodeEntry *call_inst)
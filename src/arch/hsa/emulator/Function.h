@@ -23,6 +23,8 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <arch/hsa/disassembler/BrigCodeEntry.h>
 
@@ -38,6 +40,66 @@ class HsaExecutable;
 /// A function encapsulates information about a HSAIL function
 class Function
 {
+public:
+
+	/// Maximum number of operands decoded for an instruction. Operands
+	/// beyond this are always accessed through the BRIG entry.
+	static const unsigned MaxDecodedOperands = 6;
+
+	struct DecodedEntry;
+
+	/// Operand of an instruction, decoded when the function is loaded
+	struct DecodedOperand
+	{
+		// Kind of the operand
+		BrigKind kind = BRIG_KIND_NONE;
+
+		// For register operands and the register of address operands,
+		// offset of the register in the register storage, or index of
+		// the control register
+		unsigned register_offset = 0;
+
+		// Size of the register in bytes, 0 for control registers
+		unsigned register_size = 0;
+
+		// True if an address operand has a register
+		bool has_register = false;
+
+		// For constant operands, pointer to the value and its size
+		const unsigned char *bytes = nullptr;
+		unsigned bytes_size = 0;
+
+		// For address operands, name of the symbol (empty if none) and
+		// offset
+		std::string symbol;
+		unsigned long long offset = 0;
+
+		// For code reference operands, target entry in the function
+		const DecodedEntry *target = nullptr;
+	};
+
+	/// Code entry of the function, decoded when the function is loaded
+	struct DecodedEntry
+	{
+		// BRIG code entry
+		std::unique_ptr<BrigCodeEntry> entry;
+
+		// True if the entry is an instruction
+		bool is_instruction = false;
+
+		// Opcode, for instructions
+		BrigOpcode opcode = BRIG_OPCODE_NOP;
+
+		// Decoded operands, for instructions
+		unsigned num_operands = 0;
+		DecodedOperand operands[MaxDecodedOperands];
+
+		// Next entry in the function, or nullptr for the last one
+		const DecodedEntry *next = nullptr;
+	};
+
+private:
+
 	// name of the function
 	std::string name;
 
@@ -93,6 +155,23 @@ class Function
 	// Add register information into table
 	void addRegister(BrigRegisterKind kind, unsigned short number);
 
+
+
+
+	//
+	// Fields related with pre-decoded code entries
+	//
+
+	// Code entries from the first to the last entry of the function
+	std::vector<DecodedEntry> decoded_entries;
+
+	// Map from the offset of a code entry to its decoded entry
+	std::unordered_map<unsigned, const DecodedEntry *> decoded_entry_map;
+
+	// Decode an operand of an instruction
+	void DecodeOperand(BrigCodeEntry *instruction, unsigned index,
+			DecodedOperand *operand) const;
+
 public:
 
 	/// Constructor
@@ -154,6 +233,29 @@ public:
 	/// Return the size of register required
 	unsigned int getRegisterSize() const { return register_size; }
 
+	/// Decode all code entries of the function, from the first to the
+	/// last entry, resolving register operands to offsets in the
+	/// register storage. Registers must be allocated before.
+	void DecodeEntries();
+
+	/// Return the first decoded entry, or nullptr if the function has no
+	/// code entries
+	const DecodedEntry *getFirstDecodedEntry() const
+	{
+		return decoded_entries.empty() ? nullptr :
+				&decoded_entries.front();
+	}
+
+	/// Return the decoded entry at the given offset of the code section,
+	/// or nullptr if the offset is not an entry of the function
+	const DecodedEntry *getDecodedEntry(unsigned offset) const
+	{
+		auto it = decoded_entry_map.find(offset);
+		if (it == decoded_entry_map.end())
+			return nullptr;
+		return it->second;
+	}
+
 	/// Return the begin iterator of the register
 	std::map<std::string, unsigned>::iterator getRegisterBegin() 
 	{
@@ -60,6 +60,16 @@ public:
 	/// Execute the instruction
 	virtual void Execute(BrigCodeEntry *instruction) = 0;
 
+	/// Make the worker work on another work item and stack frame. Workers
+	/// are created once per opcode and bound before each execution.
+	void Bind(WorkItem *work_item, StackFrame *stack_frame)
+	{
+		this->work_item = work_item;
+		this->stack_frame = stack_frame;
+		operand_value_retriever->Bind(work_item, stack_frame);
+		operand_value_writer->Bind(work_item, stack_frame);
+	}
+
 	/// Set the operand value retriever
 	void setOperandValueRetriever(OperandValueRetriever *retriever)
 	{
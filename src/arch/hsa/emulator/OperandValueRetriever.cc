@@ -17,6 +17,8 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <cstring>
+
 #include <arch/hsa/disassembler/BrigCodeEntry.h>
 #include <arch/hsa/disassembler/BrigOperandEntry.h>
 #include <arch/hsa/disassembler/BrigImmed.h>
@@ -42,9 +44,75 @@ OperandValueRetriever::~OperandValueRetriever()
 }
 
 
+unsigned long long OperandValueRetriever::getSymbolAddress(
+		const std::string &name)
+{
+	// Get the variable
+	Variable *variable = stack_frame->getSymbol(name);
+
+	// If the variable is not found in stack frame, try kernel argument
+	if (!variable)
+		variable = work_item->getGrid()->getKernelArgument(name);
+
+	// If the variable is still not found
+	if (!variable)
+		throw misc::Error(misc::fmt("Symbol %s is not defined",
+				name.c_str()));
+
+	return variable->getAddress();
+}
+
+
 void OperandValueRetriever::Retrieve(BrigCodeEntry *instruction,
 		unsigned int index, void *buffer)
 {
+	// Use the operand decoded when the function was loaded, if the
+	// instruction is the one pointed to by the program counter
+	const Function::DecodedEntry *pc = stack_frame->getDecodedPc();
+	if (pc && pc->entry.get() == instruction && index < pc->num_operands)
+	{
+		const Function::DecodedOperand &operand = pc->operands[index];
+		switch (operand.kind)
+		{
+		case BRIG_KIND_OPERAND_CONSTANT_BYTES:
+
+			memcpy(buffer, operand.bytes, operand.bytes_size);
+			return;
+
+		case BRIG_KIND_OPERAND_WAVESIZE:
+
+			*(unsigned int *)buffer = 1;
+			return;
+
+		case BRIG_KIND_OPERAND_REGISTER:
+
+			stack_frame->getRegisterValue(operand, buffer);
+			return;
+
+		case BRIG_KIND_OPERAND_ADDRESS:
+
+		{
+			unsigned long long address = operand.offset;
+			if (!operand.symbol.empty())
+				address += getSymbolAddress(operand.symbol);
+			if (operand.has_register)
+			{
+				unsigned long long reg_address = 0;
+				stack_frame->getRegisterValue(operand,
+						&reg_address);
+				address += reg_address;
+			}
+			*(uint32_t *)buffer = address;
+			return;
+		}
+
+		default:
+
+			// Other operands are read from the BRIG entry
+			break;
+		}
+	}
+
 	// Get the operand entry
 	auto operand = instruction->getOperand(index);
 
@@ -81,27 +149,7 @@ void OperandValueRetriever::Retrieve(BrigCodeEntry *instruction,
 		if (operand->getSymbol().get())
 		{
 			auto symbol = operand->getSymbol();
-			std::string name = symbol->getName();
-
-			// Get the variable
-			Variable *variable =
-				stack_frame->getSymbol(name);
-
-			// If the variable is not found in stack frame
-			// try kernel argument
-			if (!variable)
-				variable = work_item->getGrid()->
-						getKernelArgument(name);
-
-			// If the variable is still not found
-			if (!variable)
-				throw misc::Error(misc::fmt(
-						"Symbol %s is not"
-						" defined",
-						name.c_str()));
-
-
-			address += variable->getAddress();
+			address += getSymbolAddress(symbol->getName());
 		}
 		if(operand->getReg().get())
 		{
@@ -20,6 +20,8 @@
 #ifndef ARCH_HSA_EMULATOR_OPERANDVALUEGETTER_H
 #define ARCH_HSA_EMULATOR_OPERANDVALUEGETTER_H
 
+#include <string>
+
 namespace HSA
 {
 class WorkItem;
@@ -30,9 +32,15 @@ class OperandValueRetriever
 {
 	WorkItem *work_item;
 	StackFrame *stack_frame;
+	unsigned long long getSymbolAddress(const std::string &name);
 public:
 	OperandValueRetriever(WorkItem *work_item, StackFrame *stack_frame);
 	virtual ~OperandValueRetriever();
+	void Bind(WorkItem *work_item, StackFrame *stack_frame)
+	{
+		this->work_item = work_item;
+		this->stack_frame = stack_frame;
+	}
 	virtual void Retrieve(BrigCodeEntry *instruction,
 			unsigned int index, void *buffer);
 };
@@ -41,6 +41,16 @@ OperandValueWriter::~OperandValueWriter()
 void OperandValueWriter::Write(BrigCodeEntry *instruction,
 		unsigned int index, void *buffer)
 {
+	// Use the register decoded when the function was loaded, if the
+	// instruction is the one pointed to by the program counter
+	const Function::DecodedEntry *pc = stack_frame->getDecodedPc();
+	if (pc && pc->entry.get() == instruction && index < pc->num_operands &&
+			pc->operands[index].kind == BRIG_KIND_OPERAND_REGISTER)
+	{
+		stack_frame->setRegisterValue(pc->operands[index], buffer);
+		return;
+	}
+
 	// Get the operand entry
 	auto operand = instruction->getOperand(index);
 
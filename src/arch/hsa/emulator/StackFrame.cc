@@ -37,7 +37,7 @@ StackFrame::StackFrame(Function *function, WorkItem *work_item,
 
 	// Set the program counter to be pointing to the first entry of the
 	// function
-	pc = function->getFirstEntry();
+	pc = function->getFirstDecodedEntry();
 
 	// Allocate register space
 	register_storage = misc::new_unique_array<char>(
@@ -73,7 +73,12 @@ StackFrame::~StackFrame()
 
 void StackFrame::setPc(std::unique_ptr<BrigCodeEntry> pc)
 {
-	this->pc = std::move(pc);
+	// Find the decoded entry
+	this->pc = function->getDecodedEntry(pc->getOffset());
+	if (!this->pc)
+		throw misc::Panic(misc::fmt("Entry at offset 0x%x is not in "
+				"function %s", pc->getOffset(),
+				function->getName().c_str()));
 }
 
 
@@ -106,8 +111,8 @@ void StackFrame::Dump(std::ostream &os = std::cout) const
 
 	// Dump program counter and current instruction
 	os << misc::fmt("  Program counter (offset in code section): 0x%x, ",
-			pc->getOffset());
-	pc->Dump(os);
+			getPc()->getOffset());
+	getPc()->Dump(os);
 	os << "\n";
 
 	// Dump Register status
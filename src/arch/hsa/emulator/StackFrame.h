@@ -40,8 +40,8 @@ class StackFrame
 	// The work item that this stack frame belongs to
 	WorkItem *work_item;
 
-	// Pointer to the instruction to be executed
-	std::unique_ptr<BrigCodeEntry> pc;
+	// Decoded entry of the instruction to be executed
+	const Function::DecodedEntry *pc = nullptr;
 
 	// Function input and output arguments
 	std::map<std::string, std::unique_ptr<Variable>> function_arguments;
@@ -94,11 +94,17 @@ public:
 	Function *getFunction() const { return function; }
 
 	/// Return the program counter
-	BrigCodeEntry *getPc() const { return pc.get(); }
+	BrigCodeEntry *getPc() const { return pc ? pc->entry.get() : nullptr; }
 
-	/// Set the program counter
+	/// Return the decoded entry pointed to by the program counter
+	const Function::DecodedEntry *getDecodedPc() const { return pc; }
+
+	/// Set the program counter to an entry of the function
 	void setPc(std::unique_ptr<BrigCodeEntry> pc);
 
+	/// Set the program counter to a decoded entry of the function
+	void setPc(const Function::DecodedEntry *pc) { this->pc = pc; }
+
 	/// Dump stack frame information
 	void Dump(std::ostream &os) const;
 
@@ -137,6 +143,31 @@ public:
 		return;
 	}
 
+	/// Return the value of a register operand decoded by the function
+	void getRegisterValue(const Function::DecodedOperand &operand,
+			void *buffer) const
+	{
+		if (operand.register_size)
+			memcpy(buffer, register_storage.get() +
+					operand.register_offset,
+					operand.register_size);
+		else
+			*(unsigned char *)buffer =
+					c_registers[operand.register_offset];
+	}
+
+	/// Set the value of a register operand decoded by the function
+	void setRegisterValue(const Function::DecodedOperand &operand,
+			void *value)
+	{
+		if (operand.register_size)
+			memcpy(register_storage.get() + operand.register_offset,
+					value, operand.register_size);
+		else
+			c_registers[operand.register_offset] =
+					*(unsigned char *)value;
+	}
+
 	/// Set a registers value
 	void setRegisterValue(const std::string &name, void *value)
 	{
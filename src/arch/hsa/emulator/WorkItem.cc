@@ -54,6 +54,10 @@
 namespace HSA
 {
 
+std::unique_ptr<HsaInstructionWorker> WorkItem::instruction_workers[
+		InstructionWorkerTableSize];
+
+
 WorkItem::WorkItem()
 {
 }
@@ -114,20 +118,19 @@ bool WorkItem::MovePcForwardByOne()
 	StackFrame *stack_top = stack.back().get();
 
 	// Set the stackframe's pc to the next instuction
-	auto next_pc = stack_top->getPc()->Next();
+	const Function::DecodedEntry *pc = stack_top->getDecodedPc();
+	const Function::DecodedEntry *next_pc = pc ? pc->next : nullptr;
 
-	// If next pc is beyond last inst, the last instruction of the function
-	// is executed. Return the function.
-	if (!next_pc ||
-		next_pc->getOffset() >
-		stack_top->getFunction()->getLastEntry()->getOffset())
+	// If there is no next pc, the last instruction of the function is
+	// executed. Return the function.
+	if (!next_pc)
 	{
 		ReturnFunction();
 		return false;
 	}
 
 	// Set program counter to next instruction
-	stack_top->setPc(std::move(next_pc));
+	stack_top->setPc(next_pc);
 
 	// Returns true to tell the caller that the function is not returned
 	return true;
@@ -523,10 +526,9 @@ void WorkItem::DeclareVariable()
 }
 
 
-std::unique_ptr<HsaInstructionWorker> WorkItem::getInstructionWorker(
-		BrigCodeEntry *instruction) 
+std::unique_ptr<HsaInstructionWorker> WorkItem::createInstructionWorker(
+		BrigOpcode opcode)
 {
-	BrigOpcode opcode = instruction->getOpcode();
 	StackFrame *stack_top = getStackTop();
 	switch(opcode) 
 	{
@@ -648,6 +650,26 @@ std::unique_ptr<HsaInstructionWorker> WorkItem::getInstructionWorker(
 }
 
 
+HsaInstructionWorker *WorkItem::getInstructionWorker(BrigOpcode opcode)
+{
+	// Opcodes beyond the table are not implemented
+	if (opcode >= InstructionWorkerTableSize)
+		throw misc::Panic(misc::fmt("Opcode %s (%d) not implemented.",
+				AsmService::OpcodeToString(opcode).c_str(),
+				opcode));
+
+	// Create the worker the first time the opcode is executed
+	std::unique_ptr<HsaInstructionWorker> &worker =
+			instruction_workers[opcode];
+	if (!worker.get())
+		worker = createInstructionWorker(opcode);
+
+	// Bind the worker to this work item
+	worker->Bind(this, getStackTop());
+	return worker.get();
+}
+
+
 bool WorkItem::Execute()
 {
 	// Only execute the active work item
@@ -669,9 +691,9 @@ bool WorkItem::Execute()
 
 	// Execute the instruction or directory
 	BrigCodeEntry *inst = stack_top->getPc();
-	if (inst && inst->isInstruction())
+	if (inst && stack_top->getDecodedPc()->is_instruction)
 	{
-		if (getAbsoluteFlattenedId() == 0)
+		if (Emulator::isa_debug && getAbsoluteFlattenedId() == 0)
 		{
 			Emulator::isa_debug << misc::fmt("WorkItem: %d\n",
 					getAbsoluteFlattenedId());
@@ -684,12 +706,12 @@ bool WorkItem::Execute()
 //			Emulator::isa_debug << "\n";
 		}
 
-		// Get the function according to the opcode and perform the inst
-		auto instruction_worker = getInstructionWorker(inst);
-		if (instruction_worker.get())
-		{
-			instruction_worker->Execute(inst);
-		}
+		// Get the worker according to the opcode decoded when the
+		// function was loaded and perform the inst
+		BrigOpcode opcode = stack_top->getDecodedPc()->opcode;
+		HsaInstructionWorker *instruction_worker =
+				getInstructionWorker(opcode);
+		instruction_worker->Execute(inst);
 
 		// Return false if execution finished
 		if (stack.empty())
@@ -697,15 +719,14 @@ bool WorkItem::Execute()
 		
 		// Record frame status after the instruction is executed
 		stack_top = getStackTop();
-		if (getAbsoluteFlattenedId() == 0)
+		if (Emulator::isa_debug && getAbsoluteFlattenedId() == 0)
 		{
-			if (Emulator::isa_debug)
-				stack_top->Dump(Emulator::isa_debug);
+			stack_top->Dump(Emulator::isa_debug);
 			Emulator::isa_debug << "\n";
 		}
 
 	}
-	else if (inst && !inst->isInstruction())
+	else if (inst)
 	{
 		ExecuteDirective();
 	}
@@ -101,9 +101,22 @@ private:
  	// Process directives befor an instruction
  	void ExecuteDirective();
 
-	// Get HSA instruction worker according to the instruction
-	std::unique_ptr<HsaInstructionWorker> getInstructionWorker(
-			BrigCodeEntry *instruction);
+	// Number of entries in the table of instruction workers
+	static const unsigned InstructionWorkerTableSize = BRIG_OPCODE_WAVEID + 1;
+
+	// Instruction workers indexed by opcode. Workers are shared by all
+	// work items, created the first time an opcode is executed, and bound
+	// to the work item and stack frame before each execution.
+	static std::unique_ptr<HsaInstructionWorker>
+			instruction_workers[InstructionWorkerTableSize];
+
+	// Create a new HSA instruction worker for an opcode
+	std::unique_ptr<HsaInstructionWorker> createInstructionWorker(
+			BrigOpcode opcode);
+
+	// Get HSA instruction worker according to the opcode, bound to this
+	// work item and its stack top
+	HsaInstructionWorker *getInstructionWorker(BrigOpcode opcode);
 
 
 
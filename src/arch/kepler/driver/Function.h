@@ -61,6 +61,20 @@ public:
 	/// Constructor
 	Function(int id, Module *module, const std::string &name);
 
+	/// Constructor of a function without arguments whose ISA section is
+	/// given directly in \a text_buffer, instead of being read from the
+	/// ELF file of a module. The buffer must remain allocated while
+	/// the function is used.
+	Function(int id, const std::string &name, const char *text_buffer,
+			int text_size) :
+			id(id),
+			module(nullptr),
+			name(name),
+			text_buffer(text_buffer),
+			text_size(text_size)
+	{
+	}
+
 	/// Get function id
 	int getId() const { return id; }
 
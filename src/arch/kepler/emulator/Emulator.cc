@@ -46,6 +46,9 @@ std::string Emulator::isa_debug_file;
 // Simulation kind
 comm::Arch::SimKind Emulator::sim_kind = comm::Arch::SimFunctional;
 
+// Number of host threads
+int Emulator::num_threads = 1;
+
 
 
 //
@@ -65,6 +68,11 @@ Emulator *Emulator::getInstance()
 	return instance.get();
 }
 
+void Emulator::Destroy()
+{
+	instance = nullptr;
+}
+
 Emulator::Emulator() : comm::Emulator("Kepler")
 {
 	// Initialize disassembler
@@ -84,6 +92,9 @@ Emulator::Emulator() : comm::Emulator("Kepler")
 	constant_memory = misc::new_unique<mem::Memory>();
 	constant_memory->setSafe(false);
 
+	// Lock for global memory accesses of parallel thread blocks
+	pthread_mutex_init(&global_memory_lock, nullptr);
+
 	max_instructions = 0x0;
 	max_cycles = 0x0;
 	max_functions = 0x0;
@@ -93,6 +104,9 @@ void Emulator::Dump(std::ostream &os) const
 {
 	std::cout <<"\n[ Kepler ]\nInstructions = "
 			<< num_alu_instructions << std::endl;
+	if (num_parallel_thread_blocks)
+		std::cout << "ParallelThreadBlocks = "
+				<< num_parallel_thread_blocks << std::endl;
 }
 
 
@@ -122,39 +136,24 @@ bool Emulator::Run()
 	{
 		grid = pending_grids.front();
 		pending_grids.pop_front();
+
+		// Run thread blocks on several host threads. Debug information
+		// is only dumped when they run sequentially.
+		if (num_threads > 1 && !isa_debug)
+		{
+			RunGridParallel(grid);
+			finished_grids.push_back(grid);
+			continue;
+		}
+
 		thread_block_id = 0;
 		while (grid->getPendThreadBlocksize())
 		{
-			// Threadblock.X
-			thread_block_3d_id[0] = thread_block_id /
-					(grid->getThreadBlockCount3(1) *
-							grid->getThreadBlockCount3(2));
-
-			// Threadblock.Y
-			thread_block_3d_id[1] = (thread_block_id %
-					(grid->getThreadBlockCount3(1) *
-							grid->getThreadBlockCount3(2))) /
-								grid->getThreadBlockCount3(2);
-
-			// ThreadBlock.Z
-			thread_block_3d_id[2] = ((thread_block_id %
-					(grid->getThreadBlockCount3(1) *
-							grid->getThreadBlockCount3(2))) %
-								grid->getThreadBlockCount3(2))  ;
+			grid->getThreadBlockId3(thread_block_id, thread_block_3d_id);
 			grid->WaitingToRunning(thread_block_id, thread_block_3d_id);
 			thread_block_id ++;
 			thread_block.reset(grid->getRunningThreadBlocksBegin()->release());
-			while (thread_block.get()->getNumWarpsCompletedEmu()
-					!= thread_block.get()->getWarpCount())
-			{
-				for (auto wp_p = thread_block.get()->WarpsBegin(); wp_p <
-					thread_block.get()->WarpsEnd(); ++wp_p)
-				{
-					if ((*wp_p)->getFinishedEmu() || (*wp_p)->getAtBarrier())
-						continue;
-					(*wp_p)->Execute();
-				}
-			}
+			num_alu_instructions += RunThreadBlock(thread_block.get());
 			thread_block.get()->setFinishedEmu(true);
 			grid->PopRunningThreadBlock();
 			thread_block.reset(); // free the memory of thread block
@@ -171,6 +170,134 @@ bool Emulator::Run()
 }
 
 
+long long Emulator::RunThreadBlock(ThreadBlock *thread_block)
+{
+	// Execute warps in a round-robin fashion until all finish
+	while (thread_block->getNumWarpsCompletedEmu()
+			!= thread_block->getWarpCount())
+	{
+		for (auto wp_p = thread_block->WarpsBegin(); wp_p <
+			thread_block->WarpsEnd(); ++wp_p)
+		{
+			if ((*wp_p)->getFinishedEmu() || (*wp_p)->getAtBarrier())
+				continue;
+			(*wp_p)->Execute();
+		}
+	}
+
+	// Instructions executed
+	long long num_instructions = 0;
+	for (auto wp_p = thread_block->WarpsBegin(); wp_p <
+			thread_block->WarpsEnd(); ++wp_p)
+		num_instructions += (*wp_p)->getInstructionCount();
+	return num_instructions;
+}
+
+
+void *Emulator::WorkerThread(void *arg)
+{
+	RunWorker((Worker *) arg);
+	return nullptr;
+}
+
+
+void Emulator::RunWorker(Worker *worker)
+{
+	ParallelGrid *parallel_grid = worker->parallel_grid;
+	Grid *grid = parallel_grid->grid;
+
+	// Exceptions are captured and rethrown in the main thread
+	try
+	{
+		while (true)
+		{
+			// Take next thread block
+			pthread_mutex_lock(&parallel_grid->lock);
+			int thread_block_id = parallel_grid->failed ? -1 :
+					parallel_grid->next_thread_block;
+			if (thread_block_id >= parallel_grid->num_thread_blocks)
+				thread_block_id = -1;
+			if (thread_block_id >= 0)
+				parallel_grid->next_thread_block++;
+			pthread_mutex_unlock(&parallel_grid->lock);
+			if (thread_block_id < 0)
+				break;
+
+			// Create the thread block on the worker's constant
+			// memory and run it
+			unsigned thread_block_3d_id[3];
+			grid->getThreadBlockId3(thread_block_id,
+					thread_block_3d_id);
+			ThreadBlock thread_block(grid, thread_block_id,
+					thread_block_3d_id,
+					worker->constant_memory.get());
+			worker->num_instructions += RunThreadBlock(&thread_block);
+			worker->num_thread_blocks++;
+		}
+	}
+	catch (...)
+	{
+		worker->exception = std::current_exception();
+		pthread_mutex_lock(&parallel_grid->lock);
+		parallel_grid->failed = true;
+		pthread_mutex_unlock(&parallel_grid->lock);
+	}
+}
+
+
+void Emulator::RunGridParallel(Grid *grid)
+{
+	// Thread blocks are independent except for their accesses to global
+	// memory, which are serialized while workers run. Each worker creates
+	// its thread blocks on a private copy of constant memory, where
+	// thread blocks and threads record their memory addresses. Pages of
+	// the copies are shared with the original until written.
+	ParallelGrid parallel_grid;
+	parallel_grid.grid = grid;
+	parallel_grid.num_thread_blocks = grid->getPendThreadBlocksize();
+	pthread_mutex_init(&parallel_grid.lock, nullptr);
+	int num_workers = std::min(num_threads,
+			parallel_grid.num_thread_blocks);
+	std::vector<Worker> workers(num_workers);
+	for (Worker &worker : workers)
+	{
+		worker.parallel_grid = &parallel_grid;
+		worker.constant_memory = misc::new_unique<mem::Memory>(
+				*constant_memory);
+	}
+
+	// Launch workers on host threads, except the first, which runs on
+	// the main thread.
+	parallel = true;
+	int num_launched = 1;
+	for (int i = 1; i < num_workers; i++, num_launched++)
+		if (pthread_create(&workers[i].thread, nullptr,
+				WorkerThread, &workers[i]))
+			break;
+	if (num_workers)
+		RunWorker(&workers[0]);
+
+	// Run workers that could not be launched, and wait for the rest
+	for (int i = num_launched; i < num_workers; i++)
+		RunWorker(&workers[i]);
+	for (int i = 1; i < num_launched; i++)
+		pthread_join(workers[i].thread, nullptr);
+	parallel = false;
+	pthread_mutex_destroy(&parallel_grid.lock);
+
+	// Collect results
+	grid->ClearPendingThreadBlocks();
+	for (Worker &worker : workers)
+	{
+		num_alu_instructions += worker.num_instructions;
+		num_parallel_thread_blocks += worker.num_thread_blocks;
+	}
+	for (Worker &worker : workers)
+		if (worker.exception)
+			std::rethrow_exception(worker.exception);
+}
+
+
 void Emulator::PushPendingGrid(Grid *grid)
 {
 	pending_grids.push_back(grid);
@@ -199,6 +326,16 @@ void Emulator::RegisterOptions()
 			(int &) sim_kind, comm::Arch::SimKindMap,
 			"Level of accuracy of kepler simulation");
 
+	// Option --kpl-threads <num>
+	command_line->RegisterInt32("--kpl-threads <num> (default = 1)",
+			num_threads,
+			"Number of host threads used to run the thread blocks "
+			"of a grid on Kepler functional simulation. Thread "
+			"blocks run in parallel have private shared and "
+			"constant memories, while their global memory "
+			"accesses are serialized. Thread blocks run "
+			"sequentially when --kpl-debug-isa is given.");
+
 	// Option --kpl-debug-isa <kind>
 	command_line->RegisterString("--kpl-debug-isa <file>",isa_debug_file,
 			"Dump debug information about Kepler isa implementation");
@@ -212,6 +349,11 @@ void Emulator::ProcessOptions()
 		throw misc::Error("The detailed Kepler simulation is not currently "
 				"supported in Multi2Sim.");
 
+	// Parallel emulation
+	if (num_threads < 1)
+		throw Error(misc::fmt("Invalid value for --kpl-threads (%d)",
+				num_threads));
+
 	// Set the path for the debug files
 	isa_debug.setPath(isa_debug_file);
 	isa_debug.setPrefix("[Kepler emulator]");
@@ -20,6 +20,8 @@
 #ifndef ARCH_KEPLER_EMU_EMU_H
 #define ARCH_KEPLER_EMU_EMU_H
 
+#include <pthread.h>
+#include <exception>
 #include <iostream>
 #include <list>
 #include <memory>
@@ -52,6 +54,9 @@ class Emulator : public comm::Emulator
 	// Simulation kind
 	static comm::Arch::SimKind sim_kind;
 
+	// Number of host threads used to run thread blocks in parallel
+	static int num_threads;
+
 	// Emu singleton instance
 	static std::unique_ptr<Emulator> instance;
 
@@ -94,6 +99,71 @@ class Emulator : public comm::Emulator
 	// Number of global memory instructions executed
 	long long num_global_memory_instructions = 0;
 
+	// Number of thread blocks run in parallel
+	long long num_parallel_thread_blocks = 0;
+
+	// Flag set while thread blocks run on several host threads, and lock
+	// serializing accesses to global memory during that time
+	bool parallel = false;
+	pthread_mutex_t global_memory_lock;
+
+	// Thread blocks of a grid run in parallel, shared by all workers
+	struct ParallelGrid
+	{
+		// Grid being run
+		Grid *grid;
+
+		// Number of thread blocks in the grid
+		int num_thread_blocks;
+
+		// Lock protecting the following fields
+		pthread_mutex_t lock;
+
+		// Next thread block to run
+		int next_thread_block = 0;
+
+		// Flag set when a worker fails, so that the others stop
+		bool failed = false;
+	};
+
+	// Host thread running thread blocks of a grid in parallel, and results
+	// of their execution.
+	struct Worker
+	{
+		// Host thread, unused for the first worker, which runs on the
+		// main thread.
+		pthread_t thread;
+
+		// Thread blocks to run
+		ParallelGrid *parallel_grid = nullptr;
+
+		// Private copy of constant memory, where thread blocks and
+		// threads store their memory addresses
+		std::unique_ptr<mem::Memory> constant_memory;
+
+		// Number of executed instructions
+		long long num_instructions = 0;
+
+		// Number of executed thread blocks
+		long long num_thread_blocks = 0;
+
+		// Exception thrown by a thread block, if any
+		std::exception_ptr exception;
+	};
+
+	// Entry point of a host thread running a worker
+	static void *WorkerThread(void *arg);
+
+	// Run thread blocks taken from the worker's grid until none are left
+	static void RunWorker(Worker *worker);
+
+	// Run all warps of a thread block until they finish, and return the
+	// number of instructions executed
+	static long long RunThreadBlock(ThreadBlock *thread_block);
+
+	// Run all thread blocks of a grid on several host threads
+	void RunGridParallel(Grid *grid);
+
 	/// Constructor
 	Emulator();
 
@@ -138,6 +208,16 @@ public:
 	/// end of the execution.
 	static Emulator *getInstance();
 
+	/// Destroy the emulator singleton if allocated
+	static void Destroy();
+
+	/// Set the number of host threads used to run the thread blocks of
+	/// a grid, as given with option '--kpl-threads'
+	static void setNumThreads(int num_threads)
+	{
+		Emulator::num_threads = num_threads;
+	}
+
 	/// Get grid list size
 	unsigned getGridSize() { return grids.size(); }
 
@@ -159,6 +239,12 @@ public:
 	/// Get ALU instruction count
 	unsigned getNumAluInstructions() const { return num_alu_instructions; }
 
+	/// Get the number of thread blocks run on several host threads
+	long long getNumParallelThreadBlocks() const
+	{
+		return num_parallel_thread_blocks;
+	}
+
 	/// Get Shared memory total size
 	unsigned getSharedMemoryTotalSize() const
 	{
@@ -228,12 +314,19 @@ public:
 	}
 
 	/// Write Global Memory
+	/// While thread blocks run on several host threads, accesses
+	/// are serialized, so that each access is atomic.
+	///
 	/// \param starting address to be written in
 	/// \param size of data
 	/// \param data buffer
 	void WriteGlobalMemory(unsigned address, unsigned size, const char *buffer)
 	{
+		if (parallel)
+			pthread_mutex_lock(&global_memory_lock);
 		global_memory->Write(address, size, buffer);
+		if (parallel)
+			pthread_mutex_unlock(&global_memory_lock);
 	}
 
 	/// Read Global Memory
@@ -246,12 +339,19 @@ public:
 	}
 
 	/// Read Global Memory
+	/// While thread blocks run on several host threads, accesses
+	/// are serialized, so that each access is atomic.
+	///
 	/// \param starting address to be read in
 	/// \param size of data
 	/// \param data buffer
 	void ReadGlobalMemory(unsigned address, unsigned size, char *buffer)
 	{
+		if (parallel)
+			pthread_mutex_lock(&global_memory_lock);
 		global_memory->Read(address, size, buffer);
+		if (parallel)
+			pthread_mutex_unlock(&global_memory_lock);
 	}
 
 	/// Push an element into pending grid list
@@ -109,6 +109,21 @@ void Grid::GridSetupConstantMemory()
 					(const char *) &v);
 }
 
+void Grid::getThreadBlockId3(int thread_block_id, unsigned *id_3d) const
+{
+	// Threadblock.X
+	id_3d[0] = thread_block_id / (thread_block_count3[1] *
+			thread_block_count3[2]);
+
+	// Threadblock.Y
+	id_3d[1] = (thread_block_id % (thread_block_count3[1] *
+			thread_block_count3[2])) / thread_block_count3[2];
+
+	// ThreadBlock.Z
+	id_3d[2] = (thread_block_id % (thread_block_count3[1] *
+			thread_block_count3[2])) % thread_block_count3[2];
+}
+
 void Grid::WaitingToRunning(int thread_block_id, unsigned *id_3d)
 {
 	running_thread_blocks.push_back
@@ -127,4 +142,9 @@ void Grid::PopRunningThreadBlock()
 	running_thread_blocks.pop_front();
 }
 
+void Grid::ClearPendingThreadBlocks()
+{
+	pending_thread_blocks.clear();
+}
+
 }	//namespace
@@ -142,6 +142,12 @@ public:
 		return thread_block_count3[index];
 	}
 
+	/// Compute the 3D identifier of a thread block
+	///
+	/// \param thread_block_id 1D identifier of the thread block
+	/// \param id_3d Array of 3 elements where the 3D identifier is returned
+	void getThreadBlockId3(int thread_block_id, unsigned *id_3d) const;
+
 	/// Get instruction buffer
 	std::vector<unsigned long long>::iterator getInstructionBuffer()
 	{
@@ -196,6 +202,10 @@ public:
 
 	/// pop the front thread block out of running thread block list
 	void PopRunningThreadBlock();
+
+	/// Remove all thread blocks from the pending thread block list, once
+	/// they were run in parallel without going through the running list
+	void ClearPendingThreadBlocks();
 };
 
 }   //namespace
@@ -77,8 +77,10 @@ class ReturnAddressStack
         };
 
 
-        // A counter recording every sync stack "id"
-     	static unsigned common_counter;
+        // A counter recording every sync stack "id". It is kept per stack
+        // so that warps of thread-blocks running on different host
+        // threads do not share it.
+     	unsigned common_counter = 1;
 
         // Modeled the stack as a list, recording the return address of CAL
         // and the sync stack of all previous contexts.
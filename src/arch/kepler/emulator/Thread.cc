@@ -48,7 +48,7 @@ Thread::Thread(Warp *warp, int id)
 			emulator->getSharedMemoryTotalSize();
 
 	// local mem top generic address record in const mem c[0x0][0x24]
-	emulator->WriteConstantMemory(0x24, sizeof(unsigned),
+	thread_block->WriteConstantMemory(0x24, sizeof(unsigned),
 			(const char *) &local_memory_top_generic_address);
 
 	// Initialization instruction table
@@ -32,7 +32,8 @@
 namespace Kepler
 {
 
-ThreadBlock::ThreadBlock(Grid *grid, int id, unsigned *id_3d)
+ThreadBlock::ThreadBlock(Grid *grid, int id, unsigned *id_3d,
+		mem::Memory *constant_memory)
 {
 
 	//Warp *warp;
@@ -46,6 +47,8 @@ ThreadBlock::ThreadBlock(Grid *grid, int id, unsigned *id_3d)
 	this->grid = grid;
 	for(int i = 0; i < 3; i++)
 		this->id_3d[i] = id_3d[i];
+	this->constant_memory = constant_memory ? constant_memory :
+			emulator->getConstMemory();
 
 	// Create warps
 	warp_count = (grid->getThreadBlockSize() + warp_size - 1) /
@@ -81,7 +84,7 @@ ThreadBlock::ThreadBlock(Grid *grid, int id, unsigned *id_3d)
 
 	// Shared memory top generic address is recorded in constant memory
 	// c[0x0][0x20]
-	emulator->WriteConstantMemory(0x20, sizeof(unsigned),
+	WriteConstantMemory(0x20, sizeof(unsigned),
 			(char *) &shared_memory_top_generic_address);
 
 	/* Flags */
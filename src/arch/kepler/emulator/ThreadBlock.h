@@ -100,6 +100,9 @@ class ThreadBlock
 	// Shared memory top generic address. Field initialized in constructor.
 	unsigned shared_memory_top_generic_address;
 
+	// Constant memory seen by the threads of the thread-block
+	mem::Memory *constant_memory;
+
 public:
 
 	/// Constructor
@@ -107,7 +110,14 @@ public:
 	/// \param grid Instance of class Grid that it belongs to.
 	///
 	/// \param id Thread-block global 1D ID
-	ThreadBlock(Grid *grid, int id, unsigned *id_3d);
+	///
+	/// \param constant_memory Constant memory read and written by the
+	/// threads of the thread-block. If omitted, the constant memory of the
+	/// emulator is used. Thread-blocks running on different host threads
+	/// use private copies, since the thread-block and its threads store
+	/// their memory addresses in constant memory.
+	ThreadBlock(Grid *grid, int id, unsigned *id_3d,
+			mem::Memory *constant_memory = nullptr);
 
 	/// Dump thread-block in human readable format into output stream
 	void Dump(std::ostream &os = std::cout) const;
@@ -198,6 +208,20 @@ public:
 		shared_memory->Read(address, length, buffer);
 	}
 
+	/// Write to constant memory
+	void WriteConstantMemory(unsigned address, unsigned length,
+			const char *buffer)
+	{
+		constant_memory->Write(address, length, buffer);
+	}
+
+	/// Read constant memory
+	void ReadConstantMemory(unsigned address, unsigned length,
+			char *buffer)
+	{
+		constant_memory->Read(address, length, buffer);
+	}
+
 	/// Clear barrier flag in all warps of the threadblock
 	/// To continue simulation
 	void clearWarpAtBarrier();
@@ -115,9 +115,6 @@ void Warp::Dump(std::ostream &os) const
 
 void Warp::Execute()
 {
-	// Get emu instance
-	Emulator *emulator = Emulator::getInstance();
-
 	// Instruction binary
 	Instruction::Bytes inst_bytes;
 
@@ -182,7 +179,6 @@ void Warp::Execute()
 
     inst_count++;
     emu_inst_count++;
-    emulator->incNumAluInstructions();
     pc = this->target_pc;
 
     if(pc >= instruction_buffer_size - 8)
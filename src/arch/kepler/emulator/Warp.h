@@ -197,6 +197,9 @@ public:
 	/// Get inst_size
 	int getInstructionSize() const {return inst_size;}
 
+	/// Return the number of instructions executed by the warp
+	long long getInstructionCount() const { return inst_count; }
+
 	//////////////////////////////////////////////////////////////
 
 	// Setters
@@ -136,6 +136,10 @@ Wavefront::Wavefront(WorkGroup *work_group, int id)
 	// 	self->work_items[work_item_id]->id_in_wavefront = work_item_id;
 	// }
 
+	// Vector register file, shared by all work-items
+	assert(WorkGroup::WavefrontSize == vreg_lanes);
+	vreg.reset(new Instruction::Register[256 * vreg_lanes]());
+
 	// Get emulator instance
 	Emulator *emulator = Emulator::getInstance();
 
@@ -376,13 +380,17 @@ void Wavefront::Execute()
 		emulator->incVectorAluInstCount();
 		vector_alu_instruction_count++;
 	
-		// Execute the instruction
-		for (auto it = work_items_begin, e = work_items_end;
-				it != e; ++it)
+		// Execute the instruction on all work-items at once if possible,
+		// or on each active work-item otherwise
+		if (!ExecuteVector(opcode))
 		{
-			work_item = (*it).get();
-			if (isWorkItemActive(work_item->getIdInWavefront()))
-				work_item->Execute(opcode, instruction.get());
+			for (auto it = work_items_begin, e = work_items_end;
+					it != e; ++it)
+			{
+				work_item = (*it).get();
+				if (isWorkItemActive(work_item->getIdInWavefront()))
+					work_item->Execute(opcode, instruction.get());
+			}
 		}
 
 		// Add newlines between each instruction
@@ -431,9 +439,9 @@ void Wavefront::Execute()
 				}
 			}
 		}
-		else
+		else if (!ExecuteVector(opcode))
 		{
-			// Execute the instruction
+			// Execute the instruction on each active work-item
 			for (auto it = work_items_begin, e = work_items_end; 
 				it != e; ++it)
 			{
@@ -465,14 +473,18 @@ void Wavefront::Execute()
 		emulator->incVectorAluInstCount();
 		vector_alu_instruction_count++;
 	
-		// Execute the instruction
-		for (auto it = work_items_begin, e = work_items_end; 
-				it != e; ++it)
+		// Execute the instruction on all work-items at once if possible,
+		// or on each active work-item otherwise
+		if (!ExecuteVector(opcode))
 		{
-			work_item = (*it).get();
-			if (isWorkItemActive(work_item->getIdInWavefront()))
+			for (auto it = work_items_begin, e = work_items_end; 
+					it != e; ++it)
 			{
-				work_item->Execute(opcode, instruction.get());
+				work_item = (*it).get();
+				if (isWorkItemActive(work_item->getIdInWavefront()))
+				{
+					work_item->Execute(opcode, instruction.get());
+				}
 			}
 		}
 
@@ -496,14 +508,18 @@ void Wavefront::Execute()
 		emulator->incVectorAluInstCount();
 		vector_alu_instruction_count++;
 	
-		// Execute the instruction
-		for (auto it = work_items_begin, e = work_items_end; 
-				it != e; ++it)
+		// Execute the instruction on all work-items at once if possible,
+		// or on each active work-item otherwise
+		if (!ExecuteVector(opcode))
 		{
-			work_item = (*it).get();
-			if (isWorkItemActive(work_item->getIdInWavefront()))
+			for (auto it = work_items_begin, e = work_items_end; 
+					it != e; ++it)
 			{
-				work_item->Execute(opcode, instruction.get());
+				work_item = (*it).get();
+				if (isWorkItemActive(work_item->getIdInWavefront()))
+				{
+					work_item->Execute(opcode, instruction.get());
+				}
 			}
 		}
 
@@ -89,6 +89,16 @@ class Wavefront
 	// Scalar registers
 	Instruction::Register sreg[256];
 
+	// Number of work-items with storage in each row of the vector register
+	// file, equal to WorkGroup::WavefrontSize
+	static const int vreg_lanes = 64;
+
+	// Vector registers of all work-items in the wavefront, stored
+	// lane-contiguously. The value of vector register 'v' for the
+	// work-item with identifier 'i' in the wavefront is found at position
+	// v * vreg_lanes + i.
+	std::unique_ptr<Instruction::Register[]> vreg;
+
 	// Associated wavefront pool entry
 	WavefrontPoolEntry *wavefront_pool_entry = nullptr;
 
@@ -126,6 +136,34 @@ class Wavefront
 	// Number of export instructions executed
 	long long export_instruction_count = 0;
 
+
+
+	//
+	// Wavefront-level execution of vector ALU instructions, implemented
+	// in WavefrontIsa.cc
+	//
+
+	// Execute the current vector ALU instruction on all active work-items
+	// at once, operating on whole rows of the vector register file.
+	// Return false, without any side effect, if the instruction has no
+	// wavefront-level implementation, in which case it must be executed
+	// by each active work-item.
+	bool ExecuteVector(Instruction::Opcode opcode);
+
+	// Read a source operand for all work-items into 'values'. Operands
+	// 256 and above are vector registers, and the rest are scalar
+	// registers or inline constants, replicated for all work-items.
+	void ReadOperand(int reg, Instruction::Register *values,
+			int num_active);
+
+	// Write vector register 'vdst' for the work-items in 'mask'
+	void WriteVregMasked(int vdst, const Instruction::Register *values,
+			unsigned long long mask, int num_active);
+
+	// Update the bits of 'vcc' for the work-items in 'mask'
+	void WriteVccMasked(unsigned long long value, unsigned long long mask,
+			int num_active);
+
 public:
 
 	/// Constructor
@@ -205,6 +243,15 @@ public:
 	/// Return content in scalar register as unsigned integer
 	unsigned getSregUint(int sreg_id) const;
 
+	/// Return a pointer to the values of vector register \a vreg for all
+	/// work-items in the wavefront, indexed by their identifier in the
+	/// wavefront.
+	Instruction::Register *getVregLanes(int vreg)
+	{
+		assert(vreg >= 0 && vreg < 256);
+		return this->vreg.get() + vreg * vreg_lanes;
+	}
+
 	/// Return pointer to a workitem inside this wavefront
 	WorkItem *getWorkItem(int id_in_wavefront)
 	{
@@ -0,0 +1,357 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cassert>
+#include <cstring>
+
+#include "Emulator.h"
+#include "Wavefront.h"
+#include "WorkGroup.h"
+
+
+// Wavefront-level implementation of the most common vector ALU instructions.
+// Each instruction is executed on whole rows of the vector register file,
+// with loops over all lanes that the compiler can vectorize. Results are
+// computed for all lanes and then written only for active work-items. The
+// semantics, including the register access statistics, match exactly those
+// of the per-work-item implementations in WorkItemIsa.cc.
+
+#define INST_VOP1   instruction->getBytes()->vop1
+#define INST_VOP2   instruction->getBytes()->vop2
+#define INST_VOPC   instruction->getBytes()->vopc
+#define INST_VOP3a  instruction->getBytes()->vop3a
+
+// Loop over all lanes
+#define FOR_EACH_LANE(i) for (int i = 0; i < vreg_lanes; i++)
+
+// Operands whose value changes as each work-item writes its bit of VCC
+#define READS_VCC(src) ((src) == Instruction::RegisterVcc || \
+		(src) == Instruction::RegisterVcc + 1 || \
+		(src) == Instruction::RegisterVccz)
+
+
+namespace SI
+{
+
+void Wavefront::ReadOperand(int reg, Instruction::Register *values,
+		int num_active)
+{
+	// Vector register
+	if (reg >= 256)
+	{
+		memcpy(values, getVregLanes(reg - 256),
+				vreg_lanes * sizeof(Instruction::Register));
+		work_group->incVregReadCount(num_active);
+		return;
+	}
+
+	// Scalar register or inline constant, read once per work-item by the
+	// per-work-item implementation
+	unsigned value = getSregUint(reg);
+	work_group->incSregReadCount(num_active - 1);
+	FOR_EACH_LANE(i)
+		values[i].as_uint = value;
+}
+
+
+void Wavefront::WriteVregMasked(int vdst, const Instruction::Register *values,
+		unsigned long long mask, int num_active)
+{
+	Instruction::Register *dst = getVregLanes(vdst);
+	if (mask == ~0ULL)
+	{
+		FOR_EACH_LANE(i)
+			dst[i] = values[i];
+	}
+	else
+	{
+		FOR_EACH_LANE(i)
+			if (mask & (1ULL << i))
+				dst[i] = values[i];
+	}
+	work_group->incVregWriteCount(num_active);
+}
+
+
+void Wavefront::WriteVccMasked(unsigned long long value,
+		unsigned long long mask, int num_active)
+{
+	// New value of VCC
+	unsigned long long vcc =
+			(unsigned long long) sreg[Instruction::RegisterVcc + 1]
+			.as_uint << 32 | sreg[Instruction::RegisterVcc].as_uint;
+	vcc = (vcc & ~mask) | (value & mask);
+	sreg[Instruction::RegisterVcc].as_uint = vcc;
+	sreg[Instruction::RegisterVcc + 1].as_uint = vcc >> 32;
+	sreg[Instruction::RegisterVccz].as_uint = !vcc;
+
+	// Each work-item reads and writes one half of VCC
+	work_group->incSregReadCount(num_active);
+	work_group->incSregWriteCount(num_active);
+}
+
+
+bool Wavefront::ExecuteVector(Instruction::Opcode opcode)
+{
+	// Per-work-item debug information is only produced by the
+	// per-work-item implementations
+	if (Emulator::isa_debug)
+		return false;
+
+	// Active work-items. Lanes beyond the last work-item of a partial
+	// wavefront are never active.
+	Instruction *instruction = this->instruction.get();
+	unsigned long long mask =
+			(unsigned long long) sreg[Instruction::RegisterExec + 1]
+			.as_uint << 32 | sreg[Instruction::RegisterExec].as_uint;
+	if (work_item_count < vreg_lanes)
+		mask &= (1ULL << work_item_count) - 1;
+	if (!mask)
+		return false;
+	int num_active = __builtin_popcountll(mask);
+
+	// Operands and result for all lanes
+	Instruction::Register s0[vreg_lanes];
+	Instruction::Register s1[vreg_lanes];
+	Instruction::Register s2[vreg_lanes];
+	Instruction::Register result[vreg_lanes];
+	unsigned long long bits = 0;
+
+	switch (opcode)
+	{
+
+	//
+	// VOP1
+	//
+
+#define READ_VOP1 \
+	if (INST_VOP1.src0 == 0xFF) \
+		FOR_EACH_LANE(i) s0[i].as_uint = INST_VOP1.lit_cnst; \
+	else \
+		ReadOperand(INST_VOP1.src0, s0, num_active);
+
+#define VOP1(_name, _expr) \
+	case Instruction::Opcode_##_name: \
+		READ_VOP1 \
+		FOR_EACH_LANE(i) _expr; \
+		WriteVregMasked(INST_VOP1.vdst, result, mask, num_active); \
+		return true;
+
+	VOP1(V_MOV_B32, result[i].as_uint = s0[i].as_uint)
+	VOP1(V_NOT_B32, result[i].as_uint = ~s0[i].as_uint)
+	VOP1(V_CVT_F32_I32, result[i].as_float = (float) s0[i].as_int)
+	VOP1(V_CVT_F32_U32, result[i].as_float = (float) s0[i].as_uint)
+
+#undef VOP1
+
+
+	//
+	// VOP2
+	//
+
+#define READ_VOP2 \
+	if (INST_VOP2.src0 == 0xFF) \
+		FOR_EACH_LANE(i) s0[i].as_uint = INST_VOP2.lit_cnst; \
+	else \
+		ReadOperand(INST_VOP2.src0, s0, num_active); \
+	ReadOperand(INST_VOP2.vsrc1 + 256, s1, num_active);
+
+#define VOP2(_name, _expr) \
+	case Instruction::Opcode_##_name: \
+		READ_VOP2 \
+		FOR_EACH_LANE(i) _expr; \
+		WriteVregMasked(INST_VOP2.vdst, result, mask, num_active); \
+		return true;
+
+	VOP2(V_ADD_F32, result[i].as_float = s0[i].as_float + s1[i].as_float)
+	VOP2(V_SUB_F32, result[i].as_float = s0[i].as_float - s1[i].as_float)
+	VOP2(V_SUBREV_F32, result[i].as_float = s1[i].as_float - s0[i].as_float)
+	VOP2(V_MUL_F32, result[i].as_float = s0[i].as_float * s1[i].as_float)
+	VOP2(V_MIN_F32, result[i].as_float = s0[i].as_float < s1[i].as_float ?
+			s0[i].as_float : s1[i].as_float)
+	VOP2(V_MAX_F32, result[i].as_float = s0[i].as_float > s1[i].as_float ?
+			s0[i].as_float : s1[i].as_float)
+	VOP2(V_MIN_I32, result[i].as_int = s0[i].as_int < s1[i].as_int ?
+			s0[i].as_int : s1[i].as_int)
+	VOP2(V_MAX_I32, result[i].as_int = s0[i].as_int > s1[i].as_int ?
+			s0[i].as_int : s1[i].as_int)
+	VOP2(V_MIN_U32, result[i].as_uint = s0[i].as_uint < s1[i].as_uint ?
+			s0[i].as_uint : s1[i].as_uint)
+	VOP2(V_MAX_U32, result[i].as_uint = s0[i].as_uint > s1[i].as_uint ?
+			s0[i].as_uint : s1[i].as_uint)
+	VOP2(V_AND_B32, result[i].as_uint = s0[i].as_uint & s1[i].as_uint)
+	VOP2(V_OR_B32, result[i].as_uint = s0[i].as_uint | s1[i].as_uint)
+	VOP2(V_XOR_B32, result[i].as_uint = s0[i].as_uint ^ s1[i].as_uint)
+
+#undef VOP2
+
+	// Shifts by a scalar or vector amount. Literal shift amounts of 32 or
+	// more are left to the per-work-item implementation, which asserts
+	// them.
+#define VOP2_SHIFT(_name, _expr) \
+	case Instruction::Opcode_##_name: \
+		if (INST_VOP2.src0 == 0xFF && INST_VOP2.lit_cnst >= 32) \
+			return false; \
+		READ_VOP2 \
+		FOR_EACH_LANE(i) s0[i].as_uint &= 0x1f; \
+		FOR_EACH_LANE(i) _expr; \
+		WriteVregMasked(INST_VOP2.vdst, result, mask, num_active); \
+		return true;
+
+	VOP2_SHIFT(V_LSHRREV_B32, result[i].as_uint =
+			s1[i].as_uint >> s0[i].as_uint)
+	VOP2_SHIFT(V_ASHRREV_I32, result[i].as_int =
+			s1[i].as_int >> s0[i].as_int)
+	VOP2_SHIFT(V_LSHLREV_B32, result[i].as_uint =
+			s1[i].as_uint << s0[i].as_uint)
+
+#undef VOP2_SHIFT
+
+	// D.f = S0.f * S1.f + D.f
+	case Instruction::Opcode_V_MAC_F32:
+
+		READ_VOP2
+		ReadOperand(INST_VOP2.vdst + 256, s2, num_active);
+		FOR_EACH_LANE(i)
+			result[i].as_float = s0[i].as_float * s1[i].as_float +
+					s2[i].as_float;
+		WriteVregMasked(INST_VOP2.vdst, result, mask, num_active);
+		return true;
+
+	// D.u = VCC[i] ? S1.u : S0.u
+	case Instruction::Opcode_V_CNDMASK_B32:
+	{
+		READ_VOP2
+		unsigned long long vcc =
+				(unsigned long long) sreg[Instruction::RegisterVcc + 1]
+				.as_uint << 32 |
+				sreg[Instruction::RegisterVcc].as_uint;
+		FOR_EACH_LANE(i)
+			result[i].as_uint = (vcc >> i) & 1 ?
+					s1[i].as_uint : s0[i].as_uint;
+		work_group->incSregReadCount(num_active);
+		WriteVregMasked(INST_VOP2.vdst, result, mask, num_active);
+		return true;
+	}
+
+	// Integer additions and subtractions with carry-out in VCC. Operands
+	// reading VCC are left to the per-work-item implementation, where
+	// each work-item observes the carry-out of the previous ones.
+#define VOP2_CARRY(_name, _expr, _carry) \
+	case Instruction::Opcode_##_name: \
+		if (READS_VCC(INST_VOP2.src0)) \
+			return false; \
+		READ_VOP2 \
+		FOR_EACH_LANE(i) _expr; \
+		FOR_EACH_LANE(i) bits |= (unsigned long long) (_carry) << i; \
+		WriteVregMasked(INST_VOP2.vdst, result, mask, num_active); \
+		WriteVccMasked(bits, mask, num_active); \
+		return true;
+
+	VOP2_CARRY(V_ADD_I32, result[i].as_int = s0[i].as_int + s1[i].as_int,
+			!!(((long long) s0[i].as_int +
+			(long long) s1[i].as_int) >> 32))
+	VOP2_CARRY(V_SUB_I32, result[i].as_uint = s0[i].as_int - s1[i].as_int,
+			s1[i].as_int > s0[i].as_int)
+	VOP2_CARRY(V_SUBREV_I32, result[i].as_int = s1[i].as_int - s0[i].as_int,
+			s0[i].as_int > s1[i].as_int)
+
+#undef VOP2_CARRY
+
+
+	//
+	// VOPC
+	//
+
+#define VOPC(_name, _expr) \
+	case Instruction::Opcode_##_name: \
+		if (READS_VCC(INST_VOPC.src0)) \
+			return false; \
+		if (INST_VOPC.src0 == 0xFF) \
+			FOR_EACH_LANE(i) s0[i].as_uint = INST_VOPC.lit_cnst; \
+		else \
+			ReadOperand(INST_VOPC.src0, s0, num_active); \
+		ReadOperand(INST_VOPC.vsrc1 + 256, s1, num_active); \
+		FOR_EACH_LANE(i) bits |= (unsigned long long) (_expr) << i; \
+		WriteVccMasked(bits, mask, num_active); \
+		return true;
+
+	VOPC(V_CMP_LT_F32, s0[i].as_float < s1[i].as_float)
+	VOPC(V_CMP_GT_F32, s0[i].as_float > s1[i].as_float)
+	VOPC(V_CMP_NGT_F32, !(s0[i].as_float > s1[i].as_float))
+	VOPC(V_CMP_NEQ_F32, !(s0[i].as_float == s1[i].as_float))
+	VOPC(V_CMP_LT_I32, s0[i].as_int < s1[i].as_int)
+	VOPC(V_CMP_EQ_I32, s0[i].as_int == s1[i].as_int)
+	VOPC(V_CMP_LE_I32, s0[i].as_int <= s1[i].as_int)
+	VOPC(V_CMP_GT_I32, s0[i].as_int > s1[i].as_int)
+	VOPC(V_CMP_NE_I32, s0[i].as_int != s1[i].as_int)
+	VOPC(V_CMP_GE_I32, s0[i].as_int >= s1[i].as_int)
+	VOPC(V_CMP_LT_U32, s0[i].as_uint < s1[i].as_uint)
+	VOPC(V_CMP_LE_U32, s0[i].as_uint <= s1[i].as_uint)
+	VOPC(V_CMP_GT_U32, s0[i].as_uint > s1[i].as_uint)
+
+#undef VOPC
+
+
+	//
+	// VOP3a. Instructions with input or output modifiers are left to the
+	// per-work-item implementation.
+	//
+
+#define VOP3A(_name, _num_srcs, _expr) \
+	case Instruction::Opcode_##_name: \
+		if (INST_VOP3a.abs || INST_VOP3a.neg || INST_VOP3a.clamp || \
+				INST_VOP3a.omod) \
+			return false; \
+		ReadOperand(INST_VOP3a.src0, s0, num_active); \
+		ReadOperand(INST_VOP3a.src1, s1, num_active); \
+		if (_num_srcs > 2) \
+			ReadOperand(INST_VOP3a.src2, s2, num_active); \
+		FOR_EACH_LANE(i) _expr; \
+		WriteVregMasked(INST_VOP3a.vdst, result, mask, num_active); \
+		return true;
+
+	VOP3A(V_ADD_F32_VOP3a, 2, result[i].as_float =
+			s0[i].as_float + s1[i].as_float)
+	VOP3A(V_MUL_F32_VOP3a, 2, result[i].as_float =
+			s0[i].as_float * s1[i].as_float)
+	VOP3A(V_MAD_F32, 3, result[i].as_float =
+			s0[i].as_float * s1[i].as_float + s2[i].as_float)
+	VOP3A(V_MAD_U32_U24, 3, result[i].as_uint =
+			(s0[i].as_uint & 0xffffff) *
+			(s1[i].as_uint & 0xffffff) + s2[i].as_uint)
+	VOP3A(V_MUL_LO_U32, 2, result[i].as_uint =
+			s0[i].as_uint * s1[i].as_uint)
+	VOP3A(V_MUL_LO_I32, 2, result[i].as_int =
+			s0[i].as_int * s1[i].as_int)
+	VOP3A(V_MUL_HI_U32, 2, result[i].as_uint = (unsigned)
+			(((unsigned long long) s0[i].as_uint *
+			(unsigned long long) s1[i].as_uint) >> 32))
+
+#undef VOP3A
+
+	default:
+
+		// No wavefront-level implementation
+		return false;
+	}
+}
+
+
+}  // namespace SI
@@ -281,7 +281,8 @@ unsigned WorkItem::ReadVReg(int vreg)
 	// Statistics
 	work_group->incVregReadCount();
 
-	return this->vreg[vreg].as_uint;
+	// Registers are stored in the wavefront
+	return wavefront->getVregLanes(vreg)[id_in_wavefront].as_uint;
 }
 
 
@@ -290,7 +291,7 @@ void WorkItem::WriteVReg(int vreg,
 {
 	assert(vreg >= 0);
 	assert(vreg < 256);
-	this->vreg[vreg].as_uint = value;
+	wavefront->getVregLanes(vreg)[id_in_wavefront].as_uint = value;
 
 	// Statistics
 	work_group->incVregWriteCount();
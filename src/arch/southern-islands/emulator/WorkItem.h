@@ -193,9 +193,6 @@ private:
 	// Local memory
 	mem::Memory *lds = nullptr;
 
-	// Vector registers
-	Instruction::Register vreg[256];
-
 	// Emulation of ISA. This code expands to one function per ISA
 	// instruction. For example: ISA_s_mov_b32_Impl(Instruction *inst)
 #define DEFINST(_name, _fmt_str, _fmt, _opcode, _size, _flags) \
@@ -92,7 +92,7 @@ void BranchUnit::Complete()
 			break;
 	
 		// Record trace
-		Timing::trace << misc::fmt("si.end_inst "
+		Timing::trace.fmt("si.end_inst "
 				"id=%lld "
 				"cu=%d\n ",
 				uop->getIdInComputeUnit(),
@@ -103,15 +103,19 @@ void BranchUnit::Complete()
 
 		// Access complete, remove the uop from the queue, and get the
 		// iterator for the next element
-		it = write_buffer.erase(it);
 		assert(uop->getWorkGroup()
 				->inflight_instructions > 0);
 		uop->getWorkGroup()->
 				inflight_instructions--;
+		it = write_buffer.erase(it);
 
 		// Statistics
 		num_instructions++;
-		gpu->last_complete_cycle = compute_unit->getTiming()->getCycle();
+		long long cycle = compute_unit->getTiming()->getCycle();
+		compute_unit->RunShared([gpu, cycle]
+		{
+			gpu->last_complete_cycle = cycle;
+		});
 	}
 }
 
@@ -144,7 +148,7 @@ void BranchUnit::Write()
 		if (instructions_processed > width)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -164,7 +168,7 @@ void BranchUnit::Write()
 		if ((int) write_buffer.size() == write_buffer_size) 
 		{ 		
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -183,7 +187,7 @@ void BranchUnit::Write()
 			getCycle() + write_latency;
 
 		// Trace
-		Timing::trace << misc::fmt("si.inst "
+		Timing::trace.fmt("si.inst "
 				"id=%lld "
 				"cu=%d "
 				"wf=%d "
@@ -230,7 +234,7 @@ void BranchUnit::Execute()
 		if (instructions_processed > width)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -250,7 +254,7 @@ void BranchUnit::Execute()
 		if ((int) exec_buffer.size() == exec_buffer_size)             
 		{ 		
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -269,7 +273,7 @@ void BranchUnit::Execute()
 			getCycle() + exec_latency;
 
 		// Trace
-		Timing::trace << misc::fmt("si.inst "
+		Timing::trace.fmt("si.inst "
 				"id=%lld "
 				"cu=%d "
 				"wf=%d "
@@ -316,7 +320,7 @@ void BranchUnit::Read()
 		if (instructions_processed > width)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -336,7 +340,7 @@ void BranchUnit::Read()
 		if ((int) read_buffer.size() == read_buffer_size)
 		{ 		
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -355,7 +359,7 @@ void BranchUnit::Read()
 			getCycle() + read_latency;
 
 		// Trace
-		Timing::trace << misc::fmt("si.inst "
+		Timing::trace.fmt("si.inst "
 				"id=%lld "
 				"cu=%d "
 				"wf=%d "
@@ -402,7 +406,7 @@ void BranchUnit::Decode()
 		if (instructions_processed > width)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -422,7 +426,7 @@ void BranchUnit::Decode()
 		if ((int) decode_buffer.size() == decode_buffer_size)
 		{ 		
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -441,7 +445,7 @@ void BranchUnit::Decode()
 			getCycle() + decode_latency;
 
 		// Trace
-		Timing::trace << misc::fmt("si.inst "
+		Timing::trace.fmt("si.inst "
 				"id=%lld "
 				"cu=%d "
 				"wf=%d "
@@ -127,7 +127,7 @@ void ComputeUnit::IssueToExecutionUnit(FetchBuffer *fetch_buffer,
 		fetch_buffer->Remove(oldest_uop_iterator);
 
 		// Trace
-		Timing::trace << misc::fmt("si.inst "
+		Timing::trace.fmt("si.inst "
 				"id=%lld "
 				"cu=%d "
 				"wf=%d "
@@ -173,7 +173,7 @@ void ComputeUnit::Issue(FetchBuffer *fetch_buffer)
 			continue;
 
 		// Trace
-		Timing::trace << misc::fmt("si.inst "
+		Timing::trace.fmt("si.inst "
 				"id=%lld "
 				"cu=%d "
 				"wf=%d "
@@ -265,7 +265,7 @@ void ComputeUnit::Fetch(FetchBuffer *fetch_buffer,
 				!wavefront_pool_entry->vm_cnt)
 			{
 					wavefront_pool_entry->mem_wait = false;
-					Timing::pipeline_debug << misc::fmt(
+					Timing::pipeline_debug.fmt(
 							"wg=%d/wf=%d "
 							"Mem-wait:Done\n",
 							wavefront->
@@ -277,7 +277,7 @@ void ComputeUnit::Fetch(FetchBuffer *fetch_buffer,
 			{
 				// TODO show a waiting state in Visualization
 				// tool for the wait.
-				Timing::pipeline_debug << misc::fmt(
+				Timing::pipeline_debug.fmt(
 						"wg=%d/wf=%d "
 						"Waiting-Mem\n",
 						wavefront->getWorkGroup()->
@@ -331,7 +331,7 @@ void ComputeUnit::Fetch(FetchBuffer *fetch_buffer,
 			misc::StringSingleSpaces(instruction_name);
 
 			// Trace
-			Timing::trace << misc::fmt("si.new_inst "
+			Timing::trace.fmt("si.new_inst "
 					"id=%lld "
 					"cu=%d "
 					"ib=%d "
@@ -347,7 +347,7 @@ void ComputeUnit::Fetch(FetchBuffer *fetch_buffer,
 					instruction_name.c_str());
 
 			// Debug
-			Timing::pipeline_debug << misc::fmt(
+			Timing::pipeline_debug.fmt(
 					"wg=%d/wf=%d cu=%d wfPool=%d "
 					"inst=%lld asm=%s id_in_wf=%lld\n"
 					"\tinst=%lld (Fetch)\n",
@@ -433,7 +433,7 @@ void ComputeUnit::MapWorkGroup(WorkGroup *work_group)
 	timing = Timing::getInstance();
 
 	// Debug
-	Emulator::scheduler_debug << misc::fmt("@%lld available slot %d "
+	Emulator::scheduler_debug.fmt("@%lld available slot %d "
 			"found in compute unit %d\n",
 			timing->getCycle(),
 			work_group->id_in_compute_unit,
@@ -487,7 +487,7 @@ void ComputeUnit::MapWorkGroup(WorkGroup *work_group)
 	num_mapped_work_groups++;
 
 	// Debug info
-	Emulator::scheduler_debug << misc::fmt("\t\tfirst wavefront=%d, "
+	Emulator::scheduler_debug.fmt("\t\tfirst wavefront=%d, "
 			"count=%d\n"
 			"\t\tfirst work-item=%d, count=%d\n",
 			work_group->getWavefront(0)->getId(),
@@ -496,7 +496,7 @@ void ComputeUnit::MapWorkGroup(WorkGroup *work_group)
 			work_group->getNumWorkItems());
 
 	// Trace info
-	Timing::trace << misc::fmt("si.map_wg "
+	Timing::trace.fmt("si.map_wg "
 				   "cu=%d "
 				   "wg=%d "
 				   "wi_first=%d "
@@ -538,7 +538,7 @@ void ComputeUnit::AddWorkGroup(WorkGroup *work_group)
 	work_group->compute_unit_work_groups_iterator = it;
 
 	// Debug info
-	Emulator::scheduler_debug << misc::fmt("\twork group %d "
+	Emulator::scheduler_debug.fmt("\twork group %d "
 			"added\n",
 			work_group->getId());
 }
@@ -547,7 +547,7 @@ void ComputeUnit::AddWorkGroup(WorkGroup *work_group)
 void ComputeUnit::RemoveWorkGroup(WorkGroup *work_group)
 {
 	// Debug info
-	Emulator::scheduler_debug << misc::fmt("@%lld work group %d "
+	Emulator::scheduler_debug.fmt("@%lld work group %d "
 			"removed from compute unit %d slot %d\n",
 			timing->getCycle(),
 			work_group->getId(),
@@ -583,16 +583,19 @@ void ComputeUnit::UnmapWorkGroup(WorkGroup *work_group)
 	// it there. The vector list of work groups does not shrink,
 	// when we unmap a workgroup.
 	assert((int) work_groups.size() <= gpu->getWorkGroupsPerComputeUnit());
-	if (!in_available_compute_units)
-		gpu->InsertInAvailableComputeUnits(this);
+	RunShared([this, gpu, work_group]
+	{
+		if (!in_available_compute_units)
+			gpu->InsertInAvailableComputeUnits(this);
 
-	// Trace
-	Timing::trace << misc::fmt("si.unmap_wg cu=%d wg=%d\n", index,
-			work_group->getId());
+		// Trace
+		Timing::trace.fmt("si.unmap_wg cu=%d wg=%d\n", index,
+				work_group->getId());
 
-	// Remove the work group from the running work groups list
-	NDRange *ndrange = work_group->getNDRange();
-	ndrange->RemoveWorkGroup(work_group);
+		// Remove the work group from the running work groups list
+		NDRange *ndrange = work_group->getNDRange();
+		ndrange->RemoveWorkGroup(work_group);
+	});
 }
 
 
@@ -612,7 +615,7 @@ void ComputeUnit::UpdateFetchVisualization(FetchBuffer *fetch_buffer)
 			break;
 
 		// Trace
-		Timing::trace << misc::fmt("si.inst "
+		Timing::trace.fmt("si.inst "
 				"id=%lld "
 				"cu=%d "
 				"wf=%d "
@@ -627,14 +630,25 @@ void ComputeUnit::UpdateFetchVisualization(FetchBuffer *fetch_buffer)
 
 
 void ComputeUnit::Run()
+{
+	RunExecutionUnits();
+	RunFetch();
+}
+
+
+void ComputeUnit::RunExecutionUnits(bool parallel)
 {
 	// Return if no work groups are mapped to this compute unit
-	if (!work_groups.size())
+	running = work_groups.size();
+	if (!running)
 		return;
 	
 	// Save timing simulator
 	timing = Timing::getInstance();
 
+	// Defer actions on shared state if running in parallel
+	this->parallel = parallel;
+
 	// Issue buffer chosen to issue this cycle
 	int active_issue_buffer = timing->getCycle() % num_wavefront_pools;
 	assert(active_issue_buffer >= 0 && active_issue_buffer < num_wavefront_pools);
@@ -666,6 +680,20 @@ void ComputeUnit::Run()
 			UpdateFetchVisualization(fetch_buffers[i].get());
 		}
 	}
+	this->parallel = false;
+}
+
+
+void ComputeUnit::RunFetch()
+{
+	// Apply deferred actions on shared state
+	for (auto &action : shared_actions)
+		action();
+	shared_actions.clear();
+
+	// Nothing else if no work groups were mapped in this cycle
+	if (!running)
+		return;
 
 	// Fetch
 	for (int i = 0; i < num_wavefront_pools; i++)
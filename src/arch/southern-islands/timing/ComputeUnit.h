@@ -20,7 +20,9 @@
 #ifndef ARCH_SOUTHERN_ISLANDS_TIMING_COMPUTE_UNIT_H
 #define ARCH_SOUTHERN_ISLANDS_TIMING_COMPUTE_UNIT_H
 
+#include <functional>
 #include <list>
+#include <vector>
 
 #include <memory/Module.h>
 
@@ -101,6 +103,18 @@ class ComputeUnit
 	// Counter of identifiers assigned to uops in this compute unit
 	long long uop_id_counter = 0;
 
+	// Flag indicating whether work groups were mapped to the compute unit
+	// when its execution units ran in the current cycle
+	bool running = false;
+
+	// Flag set while the execution units run in parallel with those of
+	// other compute units
+	bool parallel = false;
+
+	// Actions on state shared with other compute units, deferred while
+	// the execution units run in parallel, in the order they were found
+	std::vector<std::function<void()>> shared_actions;
+
 public:
 
 	//
@@ -158,9 +172,34 @@ public:
 	/// Constructor
 	ComputeUnit(int index, Gpu *gpu);
 
-	/// Advance compute unit state by one cycle
+	/// Advance compute unit state by one cycle. This is equivalent to
+	/// calling RunExecutionUnits() followed by RunFetch().
 	void Run();
 
+	/// Advance the execution units and the issue stage by one cycle. If
+	/// \a parallel is set, actions on state shared with other compute
+	/// units are deferred until RunFetch() is called, so that this
+	/// function can run in parallel for different compute units.
+	void RunExecutionUnits(bool parallel = false);
+
+	/// Apply the actions deferred by RunExecutionUnits() in their original
+	/// order, and advance the fetch stage by one cycle. Compute units must
+	/// run this function sequentially, in order of index.
+	void RunFetch();
+
+	/// Run an action that accesses state shared with other compute units,
+	/// such as the memory hierarchy, the MMU, or the list of available
+	/// compute units. The action runs immediately, unless the execution
+	/// units run in parallel, in which case it is deferred until
+	/// RunFetch() is called.
+	template<typename F> void RunShared(F action)
+	{
+		if (parallel)
+			shared_actions.emplace_back(action);
+		else
+			action();
+	}
+
 	/// Return the index of this compute unit in the GPU
 	int getIndex() const { return index; }
 
@@ -189,6 +228,9 @@ public:
 	/// Return the associated LDS module
 	mem::Module *getLdsModule() const { return lds_module.get(); }
 
+	/// Return the vector memory unit
+	VectorMemoryUnit *getVectorMemoryUnit() { return &vector_memory_unit; }
+
 	/// Cache used for vector data
 	mem::Module *vector_cache = nullptr;
 
@@ -227,6 +269,14 @@ public:
 	// Number of issued vector memory instructions
 	long long num_vector_memory_instructions = 0;
 
+	// Number of work-item accesses to global memory made by vector
+	// memory instructions
+	long long num_vector_memory_work_item_accesses = 0;
+
+	// Number of accesses to the vector cache after coalescing the
+	// work-item accesses of vector memory instructions
+	long long num_vector_memory_accesses = 0;
+
 	// Number of issued LDS instructions
 	long long num_lds_instructions = 0;
 
@@ -35,6 +35,7 @@ int Gpu::num_vector_registers = 65536;
 int Gpu::lds_allocation_size = 64; 
 int Gpu::lds_size = 65536;
 long long Gpu::max_cycles = 0;
+int Gpu::num_threads = 1;
 
 // String map of the argument's access type                                      
 const misc::StringMap Gpu::register_allocation_granularity_map =                                
@@ -59,6 +60,28 @@ Gpu::Gpu()
 		ComputeUnit *compute_unit = compute_units.back().get();
 		InsertInAvailableComputeUnits(compute_unit);
 	}
+
+	// Synchronization of workers
+	pthread_mutex_init(&lock, nullptr);
+	pthread_cond_init(&start_condition, nullptr);
+	pthread_cond_init(&done_condition, nullptr);
+}
+
+
+Gpu::~Gpu()
+{
+	// Finish workers running on host threads
+	pthread_mutex_lock(&lock);
+	exiting = true;
+	pthread_cond_broadcast(&start_condition);
+	pthread_mutex_unlock(&lock);
+	for (int i = 1; i < num_launched_workers; i++)
+		pthread_join(workers[i].thread, nullptr);
+
+	// Free synchronization objects
+	pthread_cond_destroy(&done_condition);
+	pthread_cond_destroy(&start_condition);
+	pthread_mutex_destroy(&lock);
 }
 
 
@@ -124,7 +147,7 @@ void Gpu::MapNDRange(NDRange *ndrange)
 	assert(work_groups_per_wavefront_pool <=
 			ComputeUnit::max_work_groups_per_wavefront_pool);
 	// Debug info
-	Emulator::scheduler_debug << misc::fmt("NDRange %d calculations:\n"
+	Emulator::scheduler_debug.fmt("NDRange %d calculations:\n"
 			"\t%d work group per wavefront pool\n"
 			"\t%d work group slot per compute unit\n",
 			ndrange->getId(),
@@ -197,8 +220,121 @@ void Gpu::CalcGetWorkGroupsPerWavefrontPool(int work_items_per_work_group,
 }
 
 
+void *Gpu::WorkerThread(void *arg)
+{
+	Worker *worker = (Worker *) arg;
+	Gpu *gpu = worker->gpu;
+
+	// Run one cycle every time the main thread starts one
+	long long num_cycles = 0;
+	pthread_mutex_lock(&gpu->lock);
+	while (true)
+	{
+		// Wait for next cycle
+		while (num_cycles == gpu->num_parallel_cycles && !gpu->exiting)
+			pthread_cond_wait(&gpu->start_condition, &gpu->lock);
+		if (gpu->exiting)
+			break;
+		num_cycles = gpu->num_parallel_cycles;
+
+		// Run compute units
+		pthread_mutex_unlock(&gpu->lock);
+		gpu->RunWorker(worker);
+		pthread_mutex_lock(&gpu->lock);
+
+		// Notify the main thread if this was the last worker
+		gpu->num_pending_workers--;
+		if (!gpu->num_pending_workers)
+			pthread_cond_signal(&gpu->done_condition);
+	}
+	pthread_mutex_unlock(&gpu->lock);
+	return nullptr;
+}
+
+
+void Gpu::RunWorker(Worker *worker)
+{
+	// Exceptions are captured and rethrown in the main thread
+	try
+	{
+		for (int i = worker->index; i < (int) compute_units.size();
+				i += workers.size())
+			compute_units[i]->RunExecutionUnits(true);
+	}
+	catch (...)
+	{
+		worker->exception = std::current_exception();
+	}
+}
+
+
+void Gpu::RunParallel()
+{
+	// Create workers the first time. The first worker runs on the main
+	// thread.
+	if (workers.empty())
+	{
+		int num_workers = std::min(num_threads, num_compute_units);
+		workers.resize(num_workers);
+		for (int i = 0; i < num_workers; i++)
+		{
+			workers[i].gpu = this;
+			workers[i].index = i;
+		}
+		num_launched_workers = 1;
+		for (int i = 1; i < num_workers; i++, num_launched_workers++)
+			if (pthread_create(&workers[i].thread, nullptr,
+					WorkerThread, &workers[i]))
+				break;
+	}
+
+	// Start the cycle in workers on host threads
+	pthread_mutex_lock(&lock);
+	num_parallel_cycles++;
+	num_pending_workers = num_launched_workers - 1;
+	pthread_cond_broadcast(&start_condition);
+	pthread_mutex_unlock(&lock);
+
+	// Run the first worker, and those that could not be launched
+	RunWorker(&workers[0]);
+	for (int i = num_launched_workers; i < (int) workers.size(); i++)
+		RunWorker(&workers[i]);
+
+	// Wait for the rest
+	pthread_mutex_lock(&lock);
+	while (num_pending_workers)
+		pthread_cond_wait(&done_condition, &lock);
+	pthread_mutex_unlock(&lock);
+
+	// Rethrow exceptions
+	for (Worker &worker : workers)
+	{
+		if (worker.exception)
+		{
+			std::exception_ptr exception = worker.exception;
+			worker.exception = nullptr;
+			std::rethrow_exception(exception);
+		}
+	}
+
+	// Apply the actions on shared state of each compute unit and fetch,
+	// in the same order as in a sequential run
+	for (auto &compute_unit : compute_units)
+		compute_unit->RunFetch();
+}
+
+
 void Gpu::Run()
 {
+	// Run compute units in parallel. Trace and debug information is only
+	// dumped when they run sequentially.
+	if (num_threads > 1 && !Timing::trace && !Timing::pipeline_debug &&
+			!Emulator::scheduler_debug)
+	{
+		RunParallel();
+		return;
+	}
+
 	// Advance one cycle in each compute unit
 	for (auto &compute_unit : compute_units)
 		compute_unit->Run();
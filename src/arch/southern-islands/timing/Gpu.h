@@ -20,6 +20,8 @@
 #ifndef ARCH_SOUTHERN_ISLANDS_TIMING_GPU_H
 #define ARCH_SOUTHERN_ISLANDS_TIMING_GPU_H
 
+#include <pthread.h>
+#include <exception>
 #include <vector>
 
 #include <lib/cpp/Misc.h>
@@ -73,6 +75,59 @@ private:
 	/// Number of work_groups allowed in a compute unit
 	int work_groups_per_compute_unit = 0;
 
+	// Host thread advancing the execution units of compute units
+	// 'index', 'index + n', 'index + 2n', ... where 'n' is the number of
+	// workers.
+	struct Worker
+	{
+		// Host thread, unused for the first worker, which runs on the
+		// main thread.
+		pthread_t thread;
+
+		// Associated GPU
+		Gpu *gpu = nullptr;
+
+		// Index of the worker and of its first compute unit
+		int index = 0;
+
+		// Exception thrown by a compute unit in the last cycle, if any
+		std::exception_ptr exception;
+	};
+
+	// Workers running compute units in parallel, created the first time
+	// they are needed
+	std::vector<Worker> workers;
+
+	// Number of workers running on their own host thread, plus the first
+	// worker
+	int num_launched_workers = 0;
+
+	// Lock protecting the following fields, and conditions signaled when
+	// workers must start running a cycle and when all of them are done
+	pthread_mutex_t lock;
+	pthread_cond_t start_condition;
+	pthread_cond_t done_condition;
+
+	// Number of cycles run in parallel so far, used by the workers to
+	// detect a new cycle
+	long long num_parallel_cycles = 0;
+
+	// Number of workers on host threads still running the current cycle
+	int num_pending_workers = 0;
+
+	// Flag telling workers on host threads to finish
+	bool exiting = false;
+
+	// Entry point of a host thread running a worker
+	static void *WorkerThread(void *arg);
+
+	// Advance the execution units of the worker's compute units
+	void RunWorker(Worker *worker);
+
+	// Advance one cycle, running the execution units of all compute units
+	// in parallel
+	void RunParallel();
+
 public:
 
 	//
@@ -85,6 +140,9 @@ public:
 
 	// Number of compute units
 	static int num_compute_units;
+
+	// Number of host threads used to run compute units in parallel
+	static int num_threads;
 	
 
 
@@ -121,6 +179,9 @@ public:
 	/// Constructor
 	Gpu();
 
+	/// Destructor
+	~Gpu();
+
 	/// Return the iterator of an available compute unit. If no compute
 	/// units are available a nullptr is returned.
 	ComputeUnit *getAvailableComputeUnit();
@@ -182,7 +243,11 @@ public:
 		return available_compute_units.end();
 	}
 
-	/// Advance one cycle in the GPU state
+	/// Advance one cycle in the GPU state. With more than one host
+	/// thread, the execution units of all compute units run in parallel,
+	/// and their actions on shared state are applied afterwards,
+	/// together with the fetch stage, one compute unit at a time. The
+	/// result is the same as running compute units sequentially.
 	void Run();
 	
 	/// Add a compute unit to the list of available compute units
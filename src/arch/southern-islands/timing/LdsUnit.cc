@@ -102,23 +102,27 @@ void LdsUnit::Complete()
 		uop->getWavefrontPoolEntry()->lgkm_cnt--;
 
 		// Trace
-		Timing::trace << misc::fmt("si.end_inst "
+		Timing::trace.fmt("si.end_inst "
 				"id=%lld "
 				"cu=%d\n",
 				uop->getIdInComputeUnit(),
 				compute_unit->getIndex());
 
 		// Access complete, remove the uop from the queue
-		it = write_buffer.erase(it);
 		assert(uop->getWorkGroup()
 				->inflight_instructions > 0);
 		uop->getWorkGroup()->
 				inflight_instructions--;
+		it = write_buffer.erase(it);
 
 		// Statistics
 		num_instructions++;
-		compute_unit->getGpu()->last_complete_cycle = compute_unit->
-				getTiming()->getCycle();
+		Gpu *gpu = compute_unit->getGpu();
+		long long cycle = compute_unit->getTiming()->getCycle();
+		compute_unit->RunShared([gpu, cycle]
+		{
+			gpu->last_complete_cycle = cycle;
+		});
 	}
 }
 
@@ -153,7 +157,7 @@ void LdsUnit::Write()
 		if (instructions_processed > width)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -173,7 +177,7 @@ void LdsUnit::Write()
 		if (int(write_buffer.size()) == write_buffer_size)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -197,7 +201,7 @@ void LdsUnit::Write()
 		instructions_processed++;
 
 		// Trace
-		Timing::trace << misc::fmt("si.inst "
+		Timing::trace.fmt("si.inst "
 				"id=%lld "
 				"cu=%d "
 				"wf=%d "
@@ -247,7 +251,7 @@ void LdsUnit::Mem()
 		if (instructions_processed > width)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -270,7 +274,7 @@ void LdsUnit::Mem()
 		if (int(mem_buffer.size()) == max_in_flight_mem_accesses)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -323,16 +327,23 @@ void LdsUnit::Mem()
 				}
 
 				// Start access
-				compute_unit->getLdsModule()->Access(
-						access_type,
-						work_item_info->lds_access[i].addr,
-						&uop->lds_witness);
+				mem::Module *lds_module =
+						compute_unit->getLdsModule();
+				unsigned address =
+						work_item_info->lds_access[i].addr;
+				int *witness = &uop->lds_witness;
+				compute_unit->RunShared([lds_module,
+						access_type, address, witness]
+				{
+					lds_module->Access(access_type,
+							address, witness);
+				});
 				uop->lds_witness--;
 			}
 		}
 
 		// Trace
-		Timing::trace << misc::fmt("si.inst "
+		Timing::trace.fmt("si.inst "
 				"id=%lld "
 				"cu=%d "
 				"wf=%d "
@@ -377,7 +388,7 @@ void LdsUnit::Read()
 		if (instructions_processed > width)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -394,7 +405,7 @@ void LdsUnit::Read()
 		if ((int) read_buffer.size() == read_buffer_size)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -416,7 +427,7 @@ void LdsUnit::Read()
 				read_latency;
 
 		// Trace
-		Timing::trace << misc::fmt("si.inst "
+		Timing::trace.fmt("si.inst "
 				"id=%lld "
 				"cu=%d "
 				"wf=%d "
@@ -465,7 +476,7 @@ void LdsUnit::Decode()
 		if (instructions_processed > width)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -485,7 +496,7 @@ void LdsUnit::Decode()
 		if (int(decode_buffer.size()) == decode_buffer_size)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -506,7 +517,7 @@ void LdsUnit::Decode()
 		//	SIComputeUnitReportNewLDSInst(lds->compute_unit);
 
 		// Trace
-		Timing::trace << misc::fmt("si.inst "
+		Timing::trace.fmt("si.inst "
 				"id=%lld "
 				"cu=%d "
 				"wf=%d "
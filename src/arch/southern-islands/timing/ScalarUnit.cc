@@ -129,7 +129,7 @@ void ScalarUnit::Complete()
 			 uop->getWavefrontPoolEntry()->exp_cnt))
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -202,7 +202,7 @@ void ScalarUnit::Complete()
 							wait_for_barrier = false;
 				}
 
-				Timing::pipeline_debug << misc::fmt(
+				Timing::pipeline_debug.fmt(
 						"wg=%d id_in_wf=%lld "
 						"Barrier:Finished (last wf=%d)\n",
 						work_group->getId(),
@@ -234,7 +234,7 @@ void ScalarUnit::Complete()
 			if (work_group->finished_timing &&
 					work_group->inflight_instructions == 1)
 			{
-				Timing::pipeline_debug << misc::fmt(
+				Timing::pipeline_debug.fmt(
 						"wg=%d "
 						"WGFinished\n",
 						work_group->getId());
@@ -243,20 +243,24 @@ void ScalarUnit::Complete()
 		}
 
 		// Trace
-		Timing::trace << misc::fmt("si.end_inst "
+		Timing::trace.fmt("si.end_inst "
 				"id=%lld "
 				"cu=%d\n",
 				uop->getIdInComputeUnit(),
 				compute_unit->getIndex());
 
 		// Access complete, remove the uop from the queue
-		it = write_buffer.erase(it);
 		assert(uop->getWorkGroup()->inflight_instructions > 0);
 		uop->getWorkGroup()->inflight_instructions--;
+		it = write_buffer.erase(it);
 
 		// Statistics
 		num_instructions++;
-		gpu->last_complete_cycle = compute_unit->getTiming()->getCycle();
+		long long cycle = compute_unit->getTiming()->getCycle();
+		compute_unit->RunShared([gpu, cycle]
+		{
+			gpu->last_complete_cycle = cycle;
+		});
 	}
 }
 
@@ -296,7 +300,7 @@ void ScalarUnit::Write()
 			if (instructions_processed > width)
 			{
 				// Trace
-				Timing::trace << misc::fmt("si.inst "
+				Timing::trace.fmt("si.inst "
 						"id=%lld "
 						"cu=%d "
 						"wf=%d "
@@ -316,7 +320,7 @@ void ScalarUnit::Write()
 			if ((int) write_buffer.size() == write_buffer_size)
 			{
 				// Trace
-				Timing::trace << misc::fmt("si.inst "
+				Timing::trace.fmt("si.inst "
 						"id=%lld "
 						"cu=%d "
 						"wf=%d "
@@ -334,7 +338,7 @@ void ScalarUnit::Write()
 					getCycle() + write_latency;
 
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -363,7 +367,7 @@ void ScalarUnit::Write()
 			if (instructions_processed > width)
 			{
 				// Trace
-				Timing::trace << misc::fmt("si.inst "
+				Timing::trace.fmt("si.inst "
 						"id=%lld "
 						"cu=%d "
 						"wf=%d "
@@ -383,7 +387,7 @@ void ScalarUnit::Write()
 			if ((int) write_buffer.size() == write_buffer_size)
 			{
 				// Trace
-				Timing::trace << misc::fmt("si.inst "
+				Timing::trace.fmt("si.inst "
 						"id=%lld "
 						"cu=%d "
 						"wf=%d "
@@ -404,7 +408,7 @@ void ScalarUnit::Write()
 			if ((int) write_buffer.size() == write_buffer_size)
 			{
 				// Trace
-				Timing::trace << misc::fmt("si.inst "
+				Timing::trace.fmt("si.inst "
 						"id=%lld "
 						"cu=%d "
 						"wf=%d "
@@ -422,7 +426,7 @@ void ScalarUnit::Write()
 					getCycle() + write_latency;
 
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -472,7 +476,7 @@ void ScalarUnit::Execute()
 		if (instructions_processed > width)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -492,7 +496,7 @@ void ScalarUnit::Execute()
 		if ((int) exec_buffer.size() == exec_buffer_size)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -515,21 +519,26 @@ void ScalarUnit::Execute()
 			uop->global_memory_access_address = uop->getWavefront()->
 					getScalarWorkItem()->global_memory_access_address;
 
-			// Translate virtual address to physical address
-			unsigned phys_addr = compute_unit->getGpu()->
-					getMmu()->TranslateVirtualAddress(
-							uop->getWorkGroup()->
-							getNDRange()->
-							address_space,
-						uop->global_memory_access_address);
-
-			// Submit the access
-			compute_unit->scalar_cache->Access(
-					mem::Module::AccessType::AccessLoad,
-					phys_addr, &uop->global_memory_witness);
+			// Translate virtual address to physical address and
+			// submit the access
+			mem::Mmu *mmu = compute_unit->getGpu()->getMmu();
+			mem::Mmu::Space *space = uop->getWorkGroup()->
+					getNDRange()->address_space;
+			mem::Module *scalar_cache = compute_unit->scalar_cache;
+			unsigned address = uop->global_memory_access_address;
+			int *witness = &uop->global_memory_witness;
+			compute_unit->RunShared([mmu, space, scalar_cache,
+					address, witness]
+			{
+				unsigned phys_addr = mmu->TranslateVirtualAddress(
+						space, address);
+				scalar_cache->Access(
+						mem::Module::AccessType::AccessLoad,
+						phys_addr, witness);
+			});
 
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -553,7 +562,7 @@ void ScalarUnit::Execute()
 					getCycle() + exec_latency;
 
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -603,7 +612,7 @@ void ScalarUnit::Read()
 		if (instructions_processed > width)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -623,7 +632,7 @@ void ScalarUnit::Read()
 		if ((int) read_buffer.size() == read_buffer_size)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -641,7 +650,7 @@ void ScalarUnit::Read()
 				read_latency;
 
 		// Trace
-		Timing::trace << misc::fmt("si.inst "
+		Timing::trace.fmt("si.inst "
 				"id=%lld "
 				"cu=%d "
 				"wf=%d "
@@ -690,7 +699,7 @@ void ScalarUnit::Decode()
 		if (instructions_processed > width)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -710,7 +719,7 @@ void ScalarUnit::Decode()
 		if ((int) decode_buffer.size() == decode_buffer_size)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -728,7 +737,7 @@ void ScalarUnit::Decode()
 				decode_latency;
 
 		// Trace
-		Timing::trace << misc::fmt("si.inst "
+		Timing::trace.fmt("si.inst "
 				"id=%lld "
 				"cu=%d "
 				"wf=%d "
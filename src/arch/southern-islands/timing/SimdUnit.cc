@@ -99,7 +99,7 @@ void SimdUnit::Complete()
 			break;
 
 		// Trace
-		Timing::trace << misc::fmt("si.end_inst "
+		Timing::trace.fmt("si.end_inst "
 				"id=%lld "
 				"cu=%d\n",
 				uop->getIdInComputeUnit(),
@@ -107,15 +107,19 @@ void SimdUnit::Complete()
 
 		// Statistics
 		num_instructions++;
-		gpu->last_complete_cycle = compute_unit->getTiming()->getCycle();
+		long long cycle = compute_unit->getTiming()->getCycle();
+		compute_unit->RunShared([gpu, cycle]
+		{
+			gpu->last_complete_cycle = cycle;
+		});
 
 		// Remove uop from the exec buffer and get the iterator to the
 		// next element
-		it = exec_buffer.erase(it);
 		assert(uop->getWorkGroup()
 				->inflight_instructions > 0);
 		uop->getWorkGroup()->
 				inflight_instructions--;
+		it = exec_buffer.erase(it);
 	}
 
 }
@@ -152,7 +156,7 @@ void SimdUnit::Execute()
 		if (instructions_processed > width)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -172,7 +176,7 @@ void SimdUnit::Execute()
 		if (int(exec_buffer.size()) == exec_buffer_size)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -194,7 +198,7 @@ void SimdUnit::Execute()
 		uop->getWavefrontPoolEntry()->ready_next_cycle = true;
 
 		// Trace
-		Timing::trace << misc::fmt("si.inst "
+		Timing::trace.fmt("si.inst "
 				"id=%lld "
 				"cu=%d "
 				"wf=%d "
@@ -245,7 +249,7 @@ void SimdUnit::Decode()
 		if (instructions_processed > width)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -265,7 +269,7 @@ void SimdUnit::Decode()
 		if (int(decode_buffer.size()) == decode_buffer_size)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -286,7 +290,7 @@ void SimdUnit::Decode()
 		//	SIComputeUnitReportNewALUInst(simd->compute_unit);
 
 		// Trace
-		Timing::trace << misc::fmt("si.inst "
+		Timing::trace.fmt("si.inst "
 				"id=%lld "
 				"cu=%d "
 				"wf=%d "
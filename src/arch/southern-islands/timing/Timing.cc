@@ -218,6 +218,10 @@ const std::string Timing::help_message =
 	"      Latency of register file writes in number of cycles.\n"
 	"  WriteBufferSize = <num> (Default = 1)\n"
 	"      Size of the buffer holding register write instructions.\n"
+	"  Coalesce = {t|f} (Default = t)\n"
+	"      Merge the accesses of the work-items of a wavefront to the same\n"
+	"      block of the vector cache into a single access. If disabled,\n"
+	"      one access is issued per active work-item.\n"
 	"\n"
 	"Section '[ LDS ]': defines the parameters of the Local Data Share\n"
 	"on each compute unit.\n"
@@ -597,13 +601,13 @@ void Timing::ParseMemoryConfigurationEntry(misc::IniFile *ini_file,
 	entry_modules.push_back(compute_unit->scalar_cache);
 	
 	// Debug
-	mem::System::debug << misc::fmt("\tSouthern Islands compute unit %d\n",
-			compute_unit_id)
-			<< "\t\tEntry for vector mem -> "
-			<< compute_unit->vector_cache->getName() << '\n'
-			<< "\t\tEntry for scalar mem -> "
-			<< compute_unit->scalar_cache->getName() << '\n'
-			<< '\n';
+	mem::System::debug.fmt("\tSouthern Islands compute unit %d\n"
+			"\t\tEntry for vector mem -> %s\n"
+			"\t\tEntry for scalar mem -> %s\n"
+			"\n",
+			compute_unit_id,
+			compute_unit->vector_cache->getName().c_str(),
+			compute_unit->scalar_cache->getName().c_str());
 }
 
 
@@ -663,6 +667,19 @@ void Timing::RegisterOptions()
 			"to run.  If this maximum is reached, the simulation "
 			"will finish with the SIMaxCycles string.");
 
+	// Option --si-threads <num>
+	command_line->RegisterInt32("--si-threads <num> (default = 1)",
+			Gpu::num_threads,
+			"Number of host threads used to run the compute units "
+			"of the GPU on Southern Islands detailed simulation. "
+			"The execution units of all compute units advance in "
+			"parallel in each cycle, while their accesses to the "
+			"memory hierarchy and the fetch stage are applied "
+			"afterwards in order of compute unit, so the "
+			"simulation is deterministic. Compute units run "
+			"sequentially when a trace or debug information is "
+			"dumped.");
+
 	// Option --si-help
 	command_line->RegisterBool("--si-help", help,
 			"Display a help message describing the format of the "
@@ -682,6 +699,11 @@ void Timing::ProcessOptions()
 	if (!config_file.empty())
 		ini_file.Load(config_file);
 		
+	// Parallel simulation
+	if (Gpu::num_threads < 1)
+		throw Error(misc::fmt("Invalid value for --si-threads (%d)",
+				Gpu::num_threads));
+
 	// Instantiate timing simulator if '--si-sim detailed' is present
 	if (sim_kind == comm::Arch::SimDetailed)
 	{
@@ -838,6 +860,7 @@ void Timing::ParseConfiguration(misc::IniFile *ini_file)
 					LdsUnit::write_buffer_size);
 
 	// Section [VectorMemUnit]
+	section = "VectorMemUnit";
 	VectorMemoryUnit::width = ini_file->ReadInt(section, "Width",
 					VectorMemoryUnit::width);
 	VectorMemoryUnit::issue_buffer_size = ini_file->ReadInt(section,
@@ -862,6 +885,9 @@ void Timing::ParseConfiguration(misc::IniFile *ini_file)
 	VectorMemoryUnit::write_buffer_size = ini_file->ReadInt(section,
 					"WriteBufferSize",
 					VectorMemoryUnit::write_buffer_size);
+	VectorMemoryUnit::coalesce = ini_file->ReadBool(section,
+					"Coalesce",
+					VectorMemoryUnit::coalesce);
 
 	// TODO Section [LDS]
 }
@@ -976,6 +1002,8 @@ void Timing::DumpConfiguration(std::ofstream &os) const
 	os << misc::fmt("WriteLatency = %d\n", VectorMemoryUnit::write_latency);
 	os << misc::fmt("WriteBufferSize = %d\n",
 			VectorMemoryUnit::write_buffer_size);
+	os << misc::fmt("Coalesce = %s\n",
+			VectorMemoryUnit::coalesce ? "True" : "False");
 	os << misc::fmt("\n");
 
 	// LDS
@@ -1081,6 +1109,15 @@ void Timing::DumpReport() const
 				compute_unit->num_simd_instructions);                          
 		report << misc::fmt("VectorMemInstructions = %lld\n",                     
 				compute_unit->num_vector_memory_instructions);                    
+		report << misc::fmt("VectorMemWorkItemAccesses = %lld\n",
+				compute_unit->num_vector_memory_work_item_accesses);
+		report << misc::fmt("VectorMemAccesses = %lld\n",
+				compute_unit->num_vector_memory_accesses);
+		report << misc::fmt("VectorMemAccessesPerInstruction = %.4g\n",
+				compute_unit->num_vector_memory_instructions ?
+				(double) compute_unit->num_vector_memory_accesses /
+				compute_unit->num_vector_memory_instructions :
+				0.0);
 		report << misc::fmt("LDSInstructions = %lld\n",                           
 				compute_unit->num_lds_instructions);                           
 		report << misc::fmt("Cycles = %lld\n", getCycle());              
@@ -131,6 +131,32 @@ public:
 	/// in wavefront.
 	std::vector<WorkItemInfo> work_item_info_list;
 
+	/// Access to one cache block of the vector cache, merging the global
+	/// memory accesses of all work-items that fall in that block.
+	struct CoalescedAccess
+	{
+		// Physical address of the block
+		unsigned address;
+
+		// Bit mask of the work-items, indexed by their identifier in
+		// the wavefront, whose accesses are merged in this one
+		unsigned long long work_item_mask;
+
+		// Flag set when the access has been submitted to the vector
+		// cache
+		bool accessed;
+	};
+
+	/// Accesses to the vector cache for a vector memory instruction,
+	/// one per cache block, in the order of the first work-item accessing
+	/// each block. Populated once when the uop reaches the memory stage
+	/// of the vector memory unit.
+	std::vector<CoalescedAccess> coalesced_accesses;
+
+	/// Flag indicating whether the accesses of the uop have already been
+	/// coalesced into 'coalesced_accesses'.
+	bool coalesced = false;
+
 	/// Return the unique identifier assigned in sequential order to the
 	/// uop when it was created.
 	long long getId() const { return id; }
@@ -40,6 +40,7 @@ int VectorMemoryUnit::read_buffer_size = 1;
 int VectorMemoryUnit::max_inflight_mem_accesses = 32;
 int VectorMemoryUnit::write_latency = 1;
 int VectorMemoryUnit::write_buffer_size = 1;
+bool VectorMemoryUnit::coalesce = true;
 
 
 void VectorMemoryUnit::Run()
@@ -105,7 +106,7 @@ void VectorMemoryUnit::Complete()
 		uop->getWavefrontPoolEntry()->lgkm_cnt--;
 		
 		// Record trace
-		Timing::trace << misc::fmt("si.end_inst "
+		Timing::trace.fmt("si.end_inst "
 				"id=%lld "
 				"cu=%d\n",
 				uop->getIdInComputeUnit(),
@@ -113,15 +114,19 @@ void VectorMemoryUnit::Complete()
 
 		// Access complete, remove the uop from the queue and get the 
 		// iterator for the next element
-		it = write_buffer.erase(it);
 		assert(uop->getWorkGroup()
 				->inflight_instructions > 0);
 		uop->getWorkGroup()->
 				inflight_instructions--;
+		it = write_buffer.erase(it);
 
 		// Statistics
 		num_instructions++;
-		gpu->last_complete_cycle = compute_unit->getTiming()->getCycle();
+		long long cycle = compute_unit->getTiming()->getCycle();
+		compute_unit->RunShared([gpu, cycle]
+		{
+			gpu->last_complete_cycle = cycle;
+		});
 	}
 }
 
@@ -154,7 +159,7 @@ void VectorMemoryUnit::Write()
 		if (instructions_processed > width)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -174,7 +179,7 @@ void VectorMemoryUnit::Write()
 		if ((int) write_buffer.size() == write_buffer_size) 
 		{ 		
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -193,7 +198,7 @@ void VectorMemoryUnit::Write()
 			getCycle() + write_latency;
 
 		// Trace
-		Timing::trace << misc::fmt("si.inst "
+		Timing::trace.fmt("si.inst "
 				"id=%lld "
 				"cu=%d "
 				"wf=%d "
@@ -211,6 +216,85 @@ void VectorMemoryUnit::Write()
 	}
 }
 
+void VectorMemoryUnit::Coalesce(Uop *uop)
+{
+	// Get compute unit and wavefront objects
+	ComputeUnit *compute_unit = getComputeUnit();
+	Wavefront *wavefront = uop->getWavefront();
+
+	// Work-item masks are 64-bit
+	assert(WorkGroup::WavefrontSize <= 64);
+	assert(uop->coalesced_accesses.empty());
+	assert(!uop->global_memory_witness);
+	unsigned block_size = compute_unit->vector_cache->getBlockSize();
+
+	// Visit active work-items in order
+	for (auto wi_it = wavefront->getWorkItemsBegin(),
+			wi_e = wavefront->getWorkItemsEnd();
+			wi_it != wi_e;
+			++wi_it)
+	{
+		// Skip inactive work-items
+		WorkItem *work_item = wi_it->get();
+		int id_in_wavefront = work_item->getIdInWavefront();
+		if (!wavefront->isWorkItemActive(id_in_wavefront))
+			continue;
+
+		// Virtual address of the block accessed. Blocks never cross
+		// page boundaries, so the address of the block is translated
+		// only once, when the block is first found.
+		Uop::WorkItemInfo *work_item_info =
+				&uop->work_item_info_list[id_in_wavefront];
+		compute_unit->num_vector_memory_work_item_accesses++;
+		unsigned address = work_item_info->global_memory_access_address;
+		if (coalesce)
+			address &= ~(block_size - 1);
+
+		// Merge with a previous access to the same block. Work-items
+		// of a wavefront usually access consecutive addresses, so the
+		// last block is checked first.
+		bool merged = false;
+		if (coalesce)
+		{
+			for (auto it = uop->coalesced_accesses.rbegin(),
+					e = uop->coalesced_accesses.rend();
+					it != e;
+					++it)
+			{
+				if (it->address != address)
+					continue;
+				it->work_item_mask |= 1ULL << id_in_wavefront;
+				merged = true;
+				break;
+			}
+		}
+		if (merged)
+			continue;
+
+		// New access. The virtual address is replaced by the physical
+		// address once all work-items have been visited.
+		uop->coalesced_accesses.push_back({address,
+				1ULL << id_in_wavefront, false});
+	}
+
+	// Translate virtual addresses to physical addresses. Accesses to the
+	// vector cache are submitted in later actions on shared state, so
+	// they see the physical addresses even if this action is deferred.
+	mem::Mmu *mmu = compute_unit->getGpu()->getMmu();
+	mem::Mmu::Space *space = uop->getWorkGroup()->getNDRange()->
+			address_space;
+	compute_unit->RunShared([uop, mmu, space]
+	{
+		for (Uop::CoalescedAccess &access : uop->coalesced_accesses)
+			access.address = mmu->TranslateVirtualAddress(
+					space, access.address);
+	});
+
+	// Done
+	uop->coalesced = true;
+}
+
+
 void VectorMemoryUnit::Memory()
 {
 	// Get compute unit object
@@ -243,7 +327,7 @@ void VectorMemoryUnit::Memory()
 		if (instructions_processed > width)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -263,7 +347,7 @@ void VectorMemoryUnit::Memory()
 		if ((int) mem_buffer.size() == max_inflight_mem_accesses)
 		{ 		
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -300,13 +384,17 @@ void VectorMemoryUnit::Memory()
 					__FUNCTION__));
 		}
 
-		// This variable keeps track if any work items are unsuccessful
-		// in making an access to the vector cache.
+		// Merge the accesses of all work-items into accesses to cache
+		// blocks, the first time the uop is processed
+		if (!uop->coalesced)
+			Coalesce(uop);
+
+		// This variable keeps track if any block accesses are
+		// unsuccessful in making an access to the vector cache.
 		bool all_work_items_accessed = true;
 
 		// Access global memory
-		assert(!uop->global_memory_witness);
-		Timing::pipeline_debug << misc::fmt(
+		Timing::pipeline_debug.fmt(
 				"\t\t@%lld inst=%lld "
 				"id_in_wf=%lld wg=%d/wf=%d (VecMem)\n",
 				compute_unit->getTiming()->getCycle(),
@@ -314,63 +402,41 @@ void VectorMemoryUnit::Memory()
 				uop->getIdInWavefront(),
 				uop->getWorkGroup()->getId(),
 				uop->getWavefront()->getId());
-		for (auto wi_it = uop->getWavefront()->getWorkItemsBegin(),
-				wi_e = uop->getWavefront()->getWorkItemsEnd();
-				wi_it != wi_e;
-				++wi_it)
+		for (Uop::CoalescedAccess &access : uop->coalesced_accesses)
 		{
-			// Get work item
-			WorkItem *work_item = wi_it->get();
-
-			// Access memory for each active work-item
-			if (uop->getWavefront()->isWorkItemActive(
-					work_item->getIdInWavefront()))
+			// Check if the block has already been accessed in a
+			// previous cycle. If so, move on to the next block.
+			if (access.accessed)
+				continue;
+
+			// Make sure we can access the vector cache. If so,
+			// submit the access and mark it as accessed, together
+			// with all work-items merged in it. The physical
+			// address is read when the access is submitted.
+			mem::Module *vector_cache = compute_unit->vector_cache;
+			if (!vector_cache->canAccess(access.address))
 			{
-				// Get the work item uop
-				Uop::WorkItemInfo *work_item_info = 
-						&uop->work_item_info_list[
-						work_item->getIdInWavefront()];
-
-				// Check if the work item info struct has
-				// already made a successful vector cache
-				// access. If so, move on to the next work item.
-				if (work_item_info->accessed_cache)	
-					continue;
-
-				// Translate virtual address to a physical 
-				// address
-				unsigned physical_address = compute_unit->
-						getGpu()->
-						getMmu()->
-						TranslateVirtualAddress(
-						uop->getWorkGroup()->
-						getNDRange()->
-						address_space,
-						work_item_info->
-						global_memory_access_address);
-		
-
-				// Make sure we can access the vector cache. If 
-				// so, submit the access. If we can access the
-				// cache, mark the accessed flag of the work 
-				// item info struct.
-				if (compute_unit->vector_cache->
-						canAccess(physical_address))
-				{
-					compute_unit->vector_cache->Access(
-							module_access_type,
-							physical_address, 
-							&uop->global_memory_witness);
-					work_item_info->accessed_cache = true;
-
-					// Access global memory
-					uop->global_memory_witness--;
-				}
-				else
-				{
-					all_work_items_accessed = false;
-				}
+				all_work_items_accessed = false;
+				continue;
 			}
+			Uop::CoalescedAccess *coalesced_access = &access;
+			int *witness = &uop->global_memory_witness;
+			compute_unit->RunShared([vector_cache, module_access_type,
+					coalesced_access, witness]
+			{
+				vector_cache->Access(module_access_type,
+						coalesced_access->address,
+						witness);
+			});
+			access.accessed = true;
+			for (unsigned i = 0; i < uop->work_item_info_list.size(); i++)
+				if (access.work_item_mask & (1ULL << i))
+					uop->work_item_info_list[i]
+							.accessed_cache = true;
+
+			// Access global memory
+			uop->global_memory_witness--;
+			compute_unit->num_vector_memory_accesses++;
 		}
 
 		// Make sure that all the work items in the wavefront have 
@@ -383,7 +449,7 @@ void VectorMemoryUnit::Memory()
 
 
 		// Trace
-		Timing::trace << misc::fmt("si.inst "
+		Timing::trace.fmt("si.inst "
 				"id=%lld "
 				"cu=%d "
 				"wf=%d "
@@ -430,7 +496,7 @@ void VectorMemoryUnit::Read()
 		if (instructions_processed > width)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -450,7 +516,7 @@ void VectorMemoryUnit::Read()
 		if ((int) read_buffer.size() == read_buffer_size)
 		{ 		
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -469,7 +535,7 @@ void VectorMemoryUnit::Read()
 			getCycle() + read_latency;
 
 		// Trace
-		Timing::trace << misc::fmt("si.inst "
+		Timing::trace.fmt("si.inst "
 				"id=%lld "
 				"cu=%d "
 				"wf=%d "
@@ -516,7 +582,7 @@ void VectorMemoryUnit::Decode()
 		if (instructions_processed > width)
 		{
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -536,7 +602,7 @@ void VectorMemoryUnit::Decode()
 		if ((int) decode_buffer.size() == decode_buffer_size)
 		{ 		
 			// Trace
-			Timing::trace << misc::fmt("si.inst "
+			Timing::trace.fmt("si.inst "
 					"id=%lld "
 					"cu=%d "
 					"wf=%d "
@@ -555,7 +621,7 @@ void VectorMemoryUnit::Decode()
 			getCycle() + decode_latency;
 
 		// Trace
-		Timing::trace << misc::fmt("si.inst "
+		Timing::trace.fmt("si.inst "
 				"id=%lld "
 				"cu=%d "
 				"wf=%d "
@@ -77,6 +77,10 @@ public:
 	/// Size of the write buffer in number of entries
 	static int write_buffer_size;
 
+	/// Whether the accesses of the work-items of a wavefront to the same
+	/// cache block are merged into a single vector cache access
+	static bool coalesce;
+
 
 
 
@@ -102,6 +106,12 @@ public:
 	/// Read stage of the execution pipeline.
 	void Read();
 
+	/// Merge the global memory accesses of the active work-items of a uop
+	/// into one access per cache block of the vector cache, populating
+	/// the uop's list of coalesced accesses. If coalescing is disabled,
+	/// one access is created per active work-item.
+	void Coalesce(Uop *uop);
+
 	/// Decode stage of the execution pipeline.
 	void Decode();
 	
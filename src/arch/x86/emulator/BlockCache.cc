@@ -0,0 +1,123 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "BlockCache.h"
+
+
+namespace x86
+{
+
+const int BlockCache::log_num_blocks;
+const int BlockCache::num_blocks;
+
+
+BlockCache::BlockCache() : blocks(num_blocks)
+{
+}
+
+
+bool BlockCache::isBlockEnd(Instruction::Opcode opcode)
+{
+	switch (opcode)
+	{
+
+	// Calls and returns
+	case Instruction::Opcode_call_rel32:
+	case Instruction::Opcode_call_rm32:
+	case Instruction::Opcode_ret:
+	case Instruction::Opcode_ret_imm16:
+	case Instruction::Opcode_repz_ret:
+
+	// Jumps
+	case Instruction::Opcode_jmp_rel8:
+	case Instruction::Opcode_jmp_rel32:
+	case Instruction::Opcode_jmp_rm32:
+
+	// Conditional jumps
+	case Instruction::Opcode_ja_rel8:
+	case Instruction::Opcode_jae_rel8:
+	case Instruction::Opcode_jb_rel8:
+	case Instruction::Opcode_jbe_rel8:
+	case Instruction::Opcode_je_rel8:
+	case Instruction::Opcode_jcxz_rel8:
+	case Instruction::Opcode_jecxz_rel8:
+	case Instruction::Opcode_jg_rel8:
+	case Instruction::Opcode_jge_rel8:
+	case Instruction::Opcode_jl_rel8:
+	case Instruction::Opcode_jle_rel8:
+	case Instruction::Opcode_jne_rel8:
+	case Instruction::Opcode_jno_rel8:
+	case Instruction::Opcode_jnp_rel8:
+	case Instruction::Opcode_jns_rel8:
+	case Instruction::Opcode_jo_rel8:
+	case Instruction::Opcode_jp_rel8:
+	case Instruction::Opcode_js_rel8:
+	case Instruction::Opcode_ja_rel32:
+	case Instruction::Opcode_jae_rel32:
+	case Instruction::Opcode_jb_rel32:
+	case Instruction::Opcode_jbe_rel32:
+	case Instruction::Opcode_je_rel32:
+	case Instruction::Opcode_jg_rel32:
+	case Instruction::Opcode_jge_rel32:
+	case Instruction::Opcode_jl_rel32:
+	case Instruction::Opcode_jle_rel32:
+	case Instruction::Opcode_jne_rel32:
+	case Instruction::Opcode_jno_rel32:
+	case Instruction::Opcode_jnp_rel32:
+	case Instruction::Opcode_jns_rel32:
+	case Instruction::Opcode_jo_rel32:
+	case Instruction::Opcode_jp_rel32:
+	case Instruction::Opcode_js_rel32:
+
+	// Interrupts and system calls
+	case Instruction::Opcode_int_3:
+	case Instruction::Opcode_int_imm8:
+	case Instruction::Opcode_into:
+	case Instruction::Opcode_hlt:
+
+	// Repeated string instructions
+	case Instruction::Opcode_rep_insb:
+	case Instruction::Opcode_rep_insd:
+	case Instruction::Opcode_rep_movsb:
+	case Instruction::Opcode_rep_movsd:
+	case Instruction::Opcode_rep_outsb:
+	case Instruction::Opcode_rep_outsd:
+	case Instruction::Opcode_rep_lodsb:
+	case Instruction::Opcode_rep_lodsd:
+	case Instruction::Opcode_rep_stosb:
+	case Instruction::Opcode_rep_stosd:
+	case Instruction::Opcode_repz_cmpsb:
+	case Instruction::Opcode_repz_cmpsd:
+	case Instruction::Opcode_repz_scasb:
+	case Instruction::Opcode_repz_scasd:
+	case Instruction::Opcode_repnz_cmpsb:
+	case Instruction::Opcode_repnz_cmpsd:
+	case Instruction::Opcode_repnz_scasb:
+	case Instruction::Opcode_repnz_scasd:
+
+		return true;
+
+	default:
+
+		return false;
+	}
+}
+
+
+}  // namespace x86
+
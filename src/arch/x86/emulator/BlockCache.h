@@ -0,0 +1,111 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef ARCH_X86_EMU_BLOCK_CACHE_H
+#define ARCH_X86_EMU_BLOCK_CACHE_H
+
+#include <vector>
+
+#include <arch/x86/disassembler/Instruction.h>
+
+
+namespace x86
+{
+
+/// Direct-mapped cache of decoded basic blocks, indexed by the address of
+/// the first instruction. A basic block is a sequence of instructions
+/// executed one after another, ending at a control transfer instruction or
+/// after a maximum number of instructions. As in the InstructionCache,
+/// blocks are tagged with the code version of the memory object at the time
+/// they were decoded.
+class BlockCache
+{
+public:
+
+	/// Decoded basic block
+	struct Block
+	{
+		// Address of the first instruction
+		unsigned eip = 0;
+
+		// Memory code version when the block was decoded, or -1 for
+		// an invalid block
+		long long version = -1;
+
+		// Decoded instructions
+		std::vector<Instruction> insts;
+	};
+
+private:
+
+	// Log base 2 of the number of entries
+	static const int log_num_blocks = 12;
+
+	// Number of entries
+	static const int num_blocks = 1 << log_num_blocks;
+
+	// Cache entries
+	std::vector<Block> blocks;
+
+public:
+
+	/// Constructor
+	BlockCache();
+
+	/// Return whether an instruction with the given opcode ends a basic
+	/// block. This is the case for branches, calls, returns, software
+	/// interrupts (system calls), and string instructions with a repeat
+	/// prefix, which execute one iteration at a time.
+	static bool isBlockEnd(Instruction::Opcode opcode);
+
+	/// Return whether an instruction with the given opcode can interact
+	/// with other contexts or the emulator, and so it must not be executed
+	/// while other contexts run in parallel. This is the case for
+	/// software interrupts, used to invoke system calls. These
+	/// instructions always end a basic block.
+	static bool isBarrier(Instruction::Opcode opcode)
+	{
+		return opcode == Instruction::Opcode_int_3 ||
+				opcode == Instruction::Opcode_int_imm8 ||
+				opcode == Instruction::Opcode_into ||
+				opcode == Instruction::Opcode_hlt;
+	}
+
+	/// Return the entry where a block starting at \a eip is mapped
+	Block &getBlock(unsigned eip)
+	{
+		return blocks[(eip ^ (eip >> log_num_blocks)) &
+				(num_blocks - 1)];
+	}
+
+	/// Return the block starting at address \a eip decoded when the
+	/// memory code version was \a version, or `nullptr` if not present.
+	Block *Lookup(unsigned eip, long long version)
+	{
+		Block &block = getBlock(eip);
+		if (block.eip != eip || block.version != version)
+			return nullptr;
+		return &block;
+	}
+};
+
+
+}  // namespace x86
+
+#endif
+
@@ -17,6 +17,7 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
 #include <cstring>
 #include <fcntl.h>
 #include <poll.h>
@@ -25,6 +26,7 @@
 #include <arch/common/Arch.h>
 #include <arch/x86/timing/Cpu.h>
 #include <arch/x86/timing/Timing.h>
+#include <lib/cpp/Checkpoint.h>
 #include <lib/cpp/Environment.h>
 #include <lib/cpp/Misc.h>
 
@@ -355,6 +357,8 @@ void Context::Initialize()
 	// Create new memory image
 	assert(!memory.get());
 	memory = misc::new_shared<mem::Memory>();
+	inst_cache = misc::new_shared<InstructionCache>();
+	block_cache = misc::new_shared<BlockCache>();
 
 	// Creating a new independent context forces the creation of a new
 	// virtual memory space within the context's associated MMU.
@@ -390,6 +394,8 @@ void Context::Load(const std::vector<std::string> &args,
 	// Create new memory image
 	assert(!memory.get());
 	memory = misc::new_shared<mem::Memory>();
+	inst_cache = misc::new_shared<InstructionCache>();
+	block_cache = misc::new_shared<BlockCache>();
 
 	// Loading a context from an executable file creates a new virtual
 	// address space within the context's associated MMU.
@@ -438,6 +444,8 @@ void Context::Clone(Context *parent)
 	// structure must be only freed by the parent when all its children have
 	// been killed. The set of signal handlers is the same, too.
 	memory = parent->memory;
+	inst_cache = parent->inst_cache;
+	block_cache = parent->block_cache;
 
 	// Cloning a context makes the new context share the same virtual memory
 	// address space as the parent in the parent's associated MMU.
@@ -471,6 +479,8 @@ void Context::Fork(Context *parent)
 	// Memory
 	memory = misc::new_shared<mem::Memory>();
 	memory->Clone(*parent->memory);
+	inst_cache = misc::new_shared<InstructionCache>();
+	block_cache = misc::new_shared<BlockCache>();
 	
 	// Forking a context creates a new virtual memory space in the parent
 	// context's associated MMU.
@@ -494,6 +504,228 @@ void Context::Fork(Context *parent)
 	// Update other fields
 	this->parent = parent;
 }
+
+
+// Write the index of an object shared among contexts into a checkpoint file,
+// and add it to the list of objects written so far if it is not present.
+// Return whether the object was not written before, in which case its
+// content must follow.
+template<typename T> static bool SaveSharedObject(
+		misc::Checkpoint &checkpoint,
+		std::vector<std::shared_ptr<T>> &objects,
+		const std::shared_ptr<T> &object)
+{
+	auto it = std::find(objects.begin(), objects.end(), object);
+	checkpoint.WriteValue<int>(it - objects.begin());
+	if (it != objects.end())
+		return false;
+	objects.push_back(object);
+	return true;
+}
+
+
+// Read the index of an object shared among contexts from a checkpoint file,
+// and return it in 'object'. If the object was not read before, a new object
+// is created, and the function returns true to indicate that its content
+// must be read next.
+template<typename T> static bool LoadSharedObject(
+		misc::Checkpoint &checkpoint,
+		std::vector<std::shared_ptr<T>> &objects,
+		std::shared_ptr<T> &object)
+{
+	int index = checkpoint.ReadValue<int>();
+	if (misc::inRange(index, 0, (int) objects.size() - 1))
+	{
+		object = objects[index];
+		return false;
+	}
+	if (index != (int) objects.size())
+		throw misc::Error(misc::fmt("%s: invalid shared object in "
+				"checkpoint file",
+				checkpoint.getPath().c_str()));
+	object = misc::new_shared<T>();
+	objects.push_back(object);
+	return true;
+}
+
+
+bool Context::canSaveCheckpoint() const
+{
+	return !(state & (StateSuspended | StateSpecMode | StateExclusive |
+			StateLocked));
+}
+
+
+void Context::SaveCheckpoint(misc::Checkpoint &checkpoint,
+		CheckpointState &checkpoint_state) const
+{
+	// Check state
+	assert(canSaveCheckpoint());
+	assert(!(state & StateFinished));
+
+	// Context identifiers. Parent contexts are saved first, since they
+	// appear first in the emulator context list.
+	checkpoint.WriteTag("context");
+	checkpoint.WriteValue(getId());
+	checkpoint.WriteValue(state & ~(StateAlloc | StateMapped));
+	checkpoint.WriteValue(parent ? parent->getId() : -1);
+	checkpoint.WriteValue(group_parent ? group_parent->getId() : -1);
+
+	// Process information
+	checkpoint.WriteValue(exit_signal);
+	checkpoint.WriteValue(exit_code);
+	checkpoint.WriteValue(clear_child_tid);
+	checkpoint.WriteValue(robust_list_head);
+	checkpoint.WriteValue(glibc_segment_base);
+	checkpoint.WriteValue(glibc_segment_limit);
+
+	// Registers
+	checkpoint.WriteValue(last_eip);
+	checkpoint.WriteValue(current_eip);
+	checkpoint.WriteValue(target_eip);
+	regs.SaveCheckpoint(checkpoint);
+	signal_mask_table.SaveCheckpoint(checkpoint);
+
+	// Loader information. The program binary is not saved, but read
+	// again from the executable file when the checkpoint is loaded.
+	if (SaveSharedObject(checkpoint, checkpoint_state.loaders, loader))
+	{
+		checkpoint.WriteString(loader->exe);
+		checkpoint.WriteValue<unsigned>(loader->args.size());
+		for (const std::string &arg : loader->args)
+			checkpoint.WriteString(arg);
+		checkpoint.WriteValue<unsigned>(loader->env.size());
+		for (const std::string &var : loader->env)
+			checkpoint.WriteString(var);
+		checkpoint.WriteString(loader->interp);
+		checkpoint.WriteString(loader->cwd);
+		checkpoint.WriteString(loader->stdin_file_name);
+		checkpoint.WriteString(loader->stdout_file_name);
+		checkpoint.WriteValue(loader->stack_base);
+		checkpoint.WriteValue(loader->stack_top);
+		checkpoint.WriteValue(loader->stack_size);
+		checkpoint.WriteValue(loader->environ_base);
+		checkpoint.WriteValue(loader->bottom);
+		checkpoint.WriteValue(loader->prog_entry);
+		checkpoint.WriteValue(loader->interp_prog_entry);
+		checkpoint.WriteValue(loader->phdt_base);
+		checkpoint.WriteValue(loader->phdr_count);
+		checkpoint.WriteValue(loader->at_random_addr);
+		checkpoint.WriteValue(loader->at_random_addr_holder);
+	}
+
+	// Memory image
+	if (SaveSharedObject(checkpoint, checkpoint_state.memories, memory))
+		memory->SaveCheckpoint(checkpoint);
+
+	// Signal handlers
+	if (SaveSharedObject(checkpoint,
+			checkpoint_state.signal_handler_tables,
+			signal_handler_table))
+		signal_handler_table->SaveCheckpoint(checkpoint);
+
+	// File descriptors
+	if (SaveSharedObject(checkpoint, checkpoint_state.file_tables,
+			file_table))
+		file_table->SaveCheckpoint(checkpoint);
+}
+
+
+void Context::LoadCheckpoint(misc::Checkpoint &checkpoint,
+		CheckpointState &checkpoint_state)
+{
+	// Context must not have been initialized before
+	if (loader.get() || memory.get())
+		throw misc::Panic("Context already initialized");
+
+	// Context identifiers
+	checkpoint.ReadTag("context");
+	setId(checkpoint.ReadValue<int>());
+	unsigned saved_state = checkpoint.ReadValue<unsigned>();
+	parent = emulator->getContext(checkpoint.ReadValue<int>());
+	group_parent = emulator->getContext(checkpoint.ReadValue<int>());
+
+	// Process information
+	exit_signal = checkpoint.ReadValue<int>();
+	exit_code = checkpoint.ReadValue<int>();
+	clear_child_tid = checkpoint.ReadValue<unsigned>();
+	robust_list_head = checkpoint.ReadValue<unsigned>();
+	glibc_segment_base = checkpoint.ReadValue<unsigned>();
+	glibc_segment_limit = checkpoint.ReadValue<unsigned>();
+
+	// Registers
+	last_eip = checkpoint.ReadValue<unsigned>();
+	current_eip = checkpoint.ReadValue<unsigned>();
+	target_eip = checkpoint.ReadValue<unsigned>();
+	regs.LoadCheckpoint(checkpoint);
+	signal_mask_table.LoadCheckpoint(checkpoint);
+
+	// Loader information
+	if (LoadSharedObject(checkpoint, checkpoint_state.loaders, loader))
+	{
+		loader->exe = checkpoint.ReadString();
+		loader->args.resize(checkpoint.ReadValue<unsigned>());
+		for (std::string &arg : loader->args)
+			arg = checkpoint.ReadString();
+		loader->env.resize(checkpoint.ReadValue<unsigned>());
+		for (std::string &var : loader->env)
+			var = checkpoint.ReadString();
+		loader->interp = checkpoint.ReadString();
+		loader->cwd = checkpoint.ReadString();
+		loader->stdin_file_name = checkpoint.ReadString();
+		loader->stdout_file_name = checkpoint.ReadString();
+		loader->stack_base = checkpoint.ReadValue<unsigned>();
+		loader->stack_top = checkpoint.ReadValue<unsigned>();
+		loader->stack_size = checkpoint.ReadValue<unsigned>();
+		loader->environ_base = checkpoint.ReadValue<unsigned>();
+		loader->bottom = checkpoint.ReadValue<unsigned>();
+		loader->prog_entry = checkpoint.ReadValue<unsigned>();
+		loader->interp_prog_entry = checkpoint.ReadValue<unsigned>();
+		loader->phdt_base = checkpoint.ReadValue<unsigned>();
+		loader->phdr_count = checkpoint.ReadValue<unsigned>();
+		loader->at_random_addr = checkpoint.ReadValue<unsigned>();
+		loader->at_random_addr_holder = checkpoint.ReadValue<unsigned>();
+		loader->binary.reset(new ELFReader::File(loader->exe));
+	}
+	call_stack = misc::new_unique<comm::CallStack>(loader->exe);
+
+	// Memory image. Contexts sharing the memory image also share the
+	// virtual memory space and the decoded instruction caches, as done
+	// in Clone().
+	if (LoadSharedObject(checkpoint, checkpoint_state.memories, memory))
+	{
+		memory->LoadCheckpoint(checkpoint);
+		inst_cache = misc::new_shared<InstructionCache>();
+		block_cache = misc::new_shared<BlockCache>();
+		mmu_space = mmu->newSpace();
+		checkpoint_state.memory_owners.push_back(this);
+	}
+	else
+	{
+		auto it = std::find(checkpoint_state.memories.begin(),
+				checkpoint_state.memories.end(), memory);
+		Context *owner = checkpoint_state.memory_owners[it -
+				checkpoint_state.memories.begin()];
+		inst_cache = owner->inst_cache;
+		block_cache = owner->block_cache;
+		mmu_space = owner->mmu_space;
+	}
+	spec_mem = misc::new_unique<mem::SpecMem>(memory.get());
+
+	// Signal handlers
+	if (LoadSharedObject(checkpoint,
+			checkpoint_state.signal_handler_tables,
+			signal_handler_table))
+		signal_handler_table->LoadCheckpoint(checkpoint);
+
+	// File descriptors
+	if (LoadSharedObject(checkpoint, checkpoint_state.file_tables,
+			file_table))
+		file_table->LoadCheckpoint(checkpoint);
+
+	// Update state, which places the context in the emulator lists
+	UpdateState(saved_state);
+}
 	
 
 void Context::DebugCallInst()
@@ -750,21 +982,11 @@ void Context::HostThreadTimerCancel()
 }
 
 
-void Context::Execute()
+const unsigned char *Context::FetchInstruction(unsigned eip, char *buffer)
 {
-	// Memory permissions should not be checked if the context is executing in
-	// speculative mode. This will prevent guest segmentation faults to occur.
-	bool spec_mode = getState(StateSpecMode);
-	if (spec_mode)
-		memory->setSafe(false);
-	else
-		memory->setSafeDefault();
-
-	// Read instruction from memory. Memory should be accessed here in unsafe mode
-	// (i.e., allowing segmentation faults) if executing speculatively.
-	char buffer[20];
-	unsigned char *buffer_ptr = (unsigned char *)memory->getBuffer(
-			regs.getEip(), 20, mem::Memory::AccessExec);
+	// Read instruction bytes directly from the memory page
+	const unsigned char *buffer_ptr = (unsigned char *)memory->getBuffer(
+			eip, 20, mem::Memory::AccessExec);
 	if (!buffer_ptr)
 	{
 		// Disable safe mode. If a part of the 20 read bytes does not
@@ -772,23 +994,120 @@ void Context::Execute()
 		// no permissions, this would generate an undesired protection
 		// fault.
 		memory->setSafe(false);
+		memory->Access(eip, 20, buffer, mem::Memory::AccessExec);
 		buffer_ptr = (unsigned char *)buffer;
-		memory->Access(regs.getEip(), 20, (char *)buffer_ptr,
-				mem::Memory::AccessExec);
 	}
 
 	// Return to default safe mode
 	memory->setSafeDefault();
+	return buffer_ptr;
+}
+
+
+BlockCache::Block *Context::BuildBlock(unsigned eip, int max_size)
+{
+	// Decode instructions until a block end is found
+	BlockCache::Block &block = block_cache->getBlock(eip);
+	block.version = -1;
+	block.insts.clear();
+	unsigned next_eip = eip;
+	while ((int) block.insts.size() < max_size)
+	{
+		// Stop at pages that cannot be executed. The instruction will
+		// be executed individually, raising the appropriate fault.
+		mem::Memory::Page *page = memory->getPage(next_eip);
+		if (!page || !(page->getPerm() & mem::Memory::AccessExec))
+			break;
+
+		// Decode instruction. Invalid instructions are also left to
+		// be reported when executed individually.
+		char buffer[20];
+		Instruction block_inst;
+		block_inst.Decode((const char *) FetchInstruction(next_eip,
+				buffer), next_eip);
+		if (block_inst.getOpcode() == Instruction::OpcodeInvalid ||
+				!memory->AddCode(next_eip,
+				block_inst.getSize()))
+			break;
+
+		// Add to block
+		block.insts.push_back(block_inst);
+		next_eip += block_inst.getSize();
+		if (BlockCache::isBlockEnd(block_inst.getOpcode()))
+			break;
+	}
+
+	// Empty block
+	if (block.insts.empty())
+		return nullptr;
+
+	// Valid block
+	block.eip = eip;
+	block.version = memory->getCodeVersion();
+	return &block;
+}
+
+
+bool Context::canExecuteBlock() const
+{
+	return !getState(StateSpecMode) &&
+			!getState(StateHandler) &&
+			!uinst_active &&
+			!emulator->isa_debug &&
+			!emulator->call_debug;
+}
 
-	// Disassemble
-	inst.Decode((char *)buffer_ptr, regs.getEip());
-	if (inst.getOpcode() == Instruction::OpcodeInvalid && !spec_mode)
+
+void Context::Execute()
+{
+	// Memory permissions should not be checked if the context is executing in
+	// speculative mode. This will prevent guest segmentation faults to occur.
+	bool spec_mode = getState(StateSpecMode);
+	if (spec_mode)
+		memory->setSafe(false);
+	else
+		memory->setSafeDefault();
+
+	// Look up the instruction in the decoded instruction cache. The cache
+	// is not used in speculative mode, where instructions can be fetched
+	// from invalid addresses.
+	bool cached = !spec_mode && Emulator::inst_cache_enabled &&
+			inst_cache->Lookup(regs.getEip(),
+			memory->getCodeVersion(), inst);
+	if (cached)
 	{
-		inst.Dump(std::cout);
-		throw Error(misc::fmt("Unsupported instruction "
-				"(%02x %02x %02x %02x...)\n",
-				buffer_ptr[0], buffer_ptr[1],
-				buffer_ptr[2], buffer_ptr[3]));
+		emulator->incNumInstCacheHits();
+	}
+	else
+	{
+		// Read instruction from memory. Memory should be accessed here
+		// in unsafe mode (i.e., allowing segmentation faults) if
+		// executing speculatively.
+		char buffer[20];
+		const unsigned char *buffer_ptr = FetchInstruction(
+				regs.getEip(), buffer);
+
+		// Disassemble
+		inst.Decode((char *)buffer_ptr, regs.getEip());
+		if (inst.getOpcode() == Instruction::OpcodeInvalid && !spec_mode)
+		{
+			inst.Dump(std::cout);
+			throw Error(misc::fmt("Unsupported instruction "
+					"(%02x %02x %02x %02x...)\n",
+					buffer_ptr[0], buffer_ptr[1],
+					buffer_ptr[2], buffer_ptr[3]));
+		}
+
+		// Insert in the decoded instruction cache. Pages holding the
+		// instruction are marked in the memory object, so that any
+		// later write to them invalidates the cache.
+		if (!spec_mode && Emulator::inst_cache_enabled)
+		{
+			emulator->incNumInstCacheMisses();
+			if (memory->AddCode(regs.getEip(), inst.getSize()))
+				inst_cache->Insert(regs.getEip(),
+						memory->getCodeVersion(), inst);
+		}
 	}
 
 	// Clear existing list of microinstructions, though the architectural
@@ -863,6 +1182,141 @@ void Context::Execute()
 }
 
 
+int Context::ExecuteBlock(int max_size)
+{
+	// Execute a single instruction if not possible as a block
+	if (!canExecuteBlock())
+	{
+		Execute();
+		return 1;
+	}
+
+	// Find block in cache, or decode it
+	BlockCache::Block *block = getBlock(max_size);
+	if (!block)
+	{
+		Execute();
+		return 1;
+	}
+
+	// Keep the block cache alive, since a system call at the end of the
+	// block could replace it.
+	std::shared_ptr<BlockCache> cache = block_cache;
+
+	// Run block
+	int count = RunBlock(block, block->insts.size());
+
+	// Stats
+	emulator->addNumInstructions(count);
+	emulator->incNumBlocks(count);
+	return count;
+}
+
+
+BlockCache::Block *Context::getBlock(int max_size)
+{
+	memory->setSafeDefault();
+	unsigned eip = regs.getEip();
+	BlockCache::Block *block = block_cache->Lookup(eip,
+			memory->getCodeVersion());
+	if (!block || (int) block->insts.size() > max_size)
+		block = BuildBlock(eip, max_size);
+	return block;
+}
+
+
+int Context::RunBlock(const BlockCache::Block *block, int max_size)
+{
+	// Run instructions
+	int count = 0;
+	long long version = block->version;
+	try
+	{
+		for (const Instruction &block_inst : block->insts)
+		{
+			// Limit
+			if (count == max_size)
+				break;
+
+			// Set last, current, and target instruction addresses
+			inst = block_inst;
+			last_eip = current_eip;
+			current_eip = regs.getEip();
+			target_eip = 0;
+			last_effective_address = 0;
+
+			// Advance instruction pointer and emulate
+			regs.incEip(inst.getSize());
+			ExecuteInstFn fn = execute_inst_fn[inst.getOpcode()];
+			(this->*fn)();
+			count++;
+
+			// Stop if the context was suspended or finished, if it
+			// took a branch, or if its code was modified.
+			if (!getState(StateRunning) ||
+					regs.getEip() != inst.getEip() +
+					inst.getSize() ||
+					memory->getCodeVersion() != version)
+				break;
+		}
+	}
+	catch (mem::Memory::Error &e)
+	{
+		// Guest stack back trace
+		if (call_stack != nullptr)
+			call_stack->BackTrace(inst.getEip(), std::cerr);
+
+		// Propagate exception
+		e.PrependPrefix("x86");
+		throw e;
+	}
+	catch (misc::Error &e)
+	{
+		// Add context information to the error message
+		e.AppendPrefix(misc::fmt("pid %d", getId()));
+		e.AppendPrefix(misc::fmt("eip 0x%x", regs.getEip()));
+		throw e;
+	}
+
+	// Done
+	return count;
+}
+
+
+long long Context::ExecuteParallel(long long max_instructions,
+		long long &num_blocks)
+{
+	long long count = 0;
+	while (count < max_instructions && canExecuteBlock() &&
+			getState(StateRunning))
+	{
+		// Get block
+		int max_size = std::min(max_instructions - count,
+				(long long) Emulator::getParallelBlockSize());
+		BlockCache::Block *block = getBlock(max_size);
+		if (!block)
+			break;
+
+		// Leave system calls to the serial phase
+		int size = block->insts.size();
+		if (BlockCache::isBarrier(block->insts.back().getOpcode()))
+			size--;
+		if (!size)
+			break;
+
+		// Run block
+		int block_count = RunBlock(block, size);
+		count += block_count;
+		num_blocks++;
+		if (block_count < size)
+			break;
+	}
+
+	// Done
+	return count;
+}
+
+
 void Context::FinishGroup(int exit_code)
 {
 	// Make call on group parent only
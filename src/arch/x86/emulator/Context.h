@@ -22,6 +22,8 @@
 
 #include <deque>
 #include <memory>
+#include <sys/uio.h>
+#include <vector>
 
 #include <arch/common/CallStack.h>
 #include <arch/common/Context.h>
@@ -34,6 +36,8 @@
 #include <memory/Mmu.h>
 #include <memory/SpecMem.h>
 
+#include "BlockCache.h"
+#include "InstructionCache.h"
 #include "Regs.h"
 #include "Signal.h"
 #include "Uinst.h"
@@ -154,6 +158,14 @@ private:
 	// this memory object will be the one automatically freeing it.
 	std::shared_ptr<mem::Memory> memory;
 
+	// Cache of instructions decoded from 'memory', shared by all contexts
+	// sharing the same memory object.
+	std::shared_ptr<InstructionCache> inst_cache;
+
+	// Cache of basic blocks decoded from 'memory', shared in the same way
+	// as 'inst_cache'.
+	std::shared_ptr<BlockCache> block_cache;
+
 	// Memory management unit, which can be shared by multiple contexts.
 	// NOTE: For now, the MMU of each context is taken directly from the
 	// associated emulator's MMU. This will change with fused memory.
@@ -685,6 +697,25 @@ private:
 	// Auxiliary system call functions
 	int SyscallMmapAux(unsigned int addr, unsigned int len, int prot,
 			int flags, int guest_fd, int offset);
+
+	// Append to 'iovecs' host I/O vectors pointing straight to the guest
+	// memory data of 'size' bytes at 'address'. Argument 'access' is
+	// AccessRead for data sent to a host file, or AccessWrite for data
+	// received from it. In safe mode, the vectors stop at the first page
+	// that is not allocated. Return the number of bytes covered.
+	unsigned SyscallIovecs(unsigned address, unsigned size,
+			mem::Memory::AccessType access,
+			std::vector<struct iovec> &iovecs);
+
+	// Read from ('write' = false) or write to ('write' = true) a host file
+	// the guest memory described by 'iovecs', with as few host calls to
+	// readv() or writev() as the host vector limit allows. The transfer
+	// continues after a complete call only if 'repeat' is true, since
+	// another call could block on pipes or sockets. Return the number of
+	// bytes transferred, or -errno.
+	int SyscallTransferIovecs(int host_fd,
+			std::vector<struct iovec> &iovecs,
+			bool write, bool repeat);
 	comm::FileDescriptor *SyscallOpenVirtualFile(const std::string &path,
 			int flags, int mode);
 	comm::FileDescriptor *SyscallOpenVirtualDevice(const std::string &path,
@@ -760,6 +791,43 @@ public:
 	/// Initialize the context by forking a parent context.
 	void Fork(Context *parent);
 
+	/// State shared among contexts while a checkpoint file is written or
+	/// read. Memory images, signal handler tables, file tables, and loader
+	/// information can be shared by several contexts, and they are only
+	/// written for the first context using them. Later contexts refer to
+	/// them by their order of appearance in the file.
+	struct CheckpointState
+	{
+		// Shared objects, in order of appearance
+		std::vector<std::shared_ptr<mem::Memory>> memories;
+		std::vector<std::shared_ptr<SignalHandlerTable>>
+				signal_handler_tables;
+		std::vector<std::shared_ptr<comm::FileTable>> file_tables;
+		std::vector<std::shared_ptr<Loader>> loaders;
+
+		// First context read with each memory image in 'memories',
+		// sharing its MMU space and decoded instruction caches with
+		// the rest of contexts using the same memory.
+		std::vector<Context *> memory_owners;
+	};
+
+	/// Return whether the context state can be saved in a checkpoint. A
+	/// context cannot be saved while it is suspended in a system call,
+	/// executing speculatively, or running in exclusive mode.
+	bool canSaveCheckpoint() const;
+
+	/// Write the state of the context into a checkpoint file, including
+	/// its registers, memory image, signal state, and file descriptors.
+	/// Finished contexts are not saved.
+	void SaveCheckpoint(misc::Checkpoint &checkpoint,
+			CheckpointState &checkpoint_state) const;
+
+	/// Initialize the context with the state read from a checkpoint file,
+	/// as an alternative to Load(), Clone(), or Fork(). The parent of the
+	/// context must have been read before from the same file.
+	void LoadCheckpoint(misc::Checkpoint &checkpoint,
+			CheckpointState &checkpoint_state);
+
 	/// Return the MMU used by the context.
 	mem::Mmu *getMmu() const { return mmu; }
 
@@ -840,10 +908,61 @@ public:
 	//    \c -EINTR.
 	void CheckSignalHandlerIntr();
 
+
+
+
+	//
+	// Instruction execution (Context.cc)
+	//
+
+	// Read the bytes of the instruction at address \a eip and return a
+	// pointer to them. If the bytes cross a page boundary, they are copied
+	// into \a buffer, which must have space for 20 bytes.
+	const unsigned char *FetchInstruction(unsigned eip, char *buffer);
+
+	// Decode the basic block starting at address \a eip, of at most
+	// \a max_size instructions, and insert it in the block cache. Return
+	// the block, or \c nullptr if not even the first instruction could
+	// be decoded.
+	BlockCache::Block *BuildBlock(unsigned eip, int max_size);
+
+	// Return whether the next instruction can be executed as part of a
+	// basic block, or must be executed with Execute() instead.
+	bool canExecuteBlock() const;
+
+	// Return the basic block starting at the current instruction pointer
+	// with at most \a max_size instructions, taken from the block cache
+	// or decoded, or \c nullptr if no block could be decoded.
+	BlockCache::Block *getBlock(int max_size);
+
+	// Run the first \a max_size instructions of \a block, stopping
+	// earlier if the context stops running, takes a branch, or modifies
+	// its code. Return the number of executed instructions.
+	int RunBlock(const BlockCache::Block *block, int max_size);
+
 	/// Run one instruction for the context at the position pointed to by
 	/// register \c eip.
 	void Execute();
 
+	/// Run a basic block of at most \a max_size instructions starting at
+	/// the position pointed to by register \c eip, and return the number
+	/// of instructions executed. The context falls back to executing a
+	/// single instruction with Execute() if it is in speculative mode,
+	/// running a signal handler, generating micro-instructions, or
+	/// dumping debug information per instruction. The block is
+	/// interrupted if the context stops running or its code is modified.
+	int ExecuteBlock(int max_size);
+
+	/// Run basic blocks of up to Emulator::getBlockSize() instructions,
+	/// up to a total of \a max_instructions, stopping before the next
+	/// system call or when the context can no longer execute blocks. The
+	/// function can run on a worker thread concurrently with other
+	/// contexts not sharing the same memory, so it does not update any
+	/// emulator state. The number of executed instructions is returned,
+	/// and the number of executed blocks is added to \a num_blocks.
+	long long ExecuteParallel(long long max_instructions,
+			long long &num_blocks);
+
 	/// Return a reference of the register file
 	Regs &getRegs() { return regs; }
 
@@ -855,6 +974,12 @@ public:
 		return memory.get();
 	}
 
+	/// Return whether the memory is shared with other contexts
+	bool isMemoryShared() const { return memory.use_count() > 1; }
+
+	/// Return the file descriptor table
+	comm::FileTable *getFileTable() const { return file_table.get(); }
+
 	/// Force a new 'eip' value for the context. The forced value should be
 	/// the same as the current 'eip' under normal circumstances. If it is
 	/// not, speculative execution starts, which will end on the next call
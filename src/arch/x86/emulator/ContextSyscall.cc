@@ -334,6 +334,86 @@ int Context::ExecuteSyscall_fork()
 
 
 
+//
+// Host I/O on guest memory
+//
+
+unsigned Context::SyscallIovecs(unsigned address, unsigned size,
+		mem::Memory::AccessType access,
+		std::vector<struct iovec> &iovecs)
+{
+	unsigned covered = 0;
+	while (covered < size)
+	{
+		// Buffer within one page
+		unsigned offset = address & (mem::Memory::PageSize - 1);
+		unsigned chunk = std::min(size - covered,
+				mem::Memory::PageSize - offset);
+		char *buffer = memory->getBuffer(address, chunk, access);
+
+		// The page is not allocated. In safe mode, the host stops at
+		// the invalid address. Otherwise, the page is allocated as in
+		// any other access.
+		if (!buffer)
+		{
+			if (memory->getSafe())
+				break;
+			memory->Map(address, chunk, mem::Memory::AccessRead |
+					mem::Memory::AccessWrite |
+					mem::Memory::AccessExec |
+					mem::Memory::AccessInit);
+			buffer = memory->getBuffer(address, chunk, access);
+		}
+
+		// Extend the last vector if the data is contiguous in the host
+		struct iovec *last = iovecs.size() ? &iovecs.back() : nullptr;
+		if (last && (char *) last->iov_base + last->iov_len == buffer)
+			last->iov_len += chunk;
+		else
+			iovecs.push_back({ buffer, chunk });
+
+		// Next page
+		address += chunk;
+		covered += chunk;
+	}
+
+	// Bytes covered by the vectors
+	return covered;
+}
+
+
+int Context::SyscallTransferIovecs(int host_fd,
+		std::vector<struct iovec> &iovecs, bool write, bool repeat)
+{
+	int total = 0;
+	for (unsigned index = 0; index < iovecs.size(); index += IOV_MAX)
+	{
+		// Vectors in this call
+		int count = std::min<int>(iovecs.size() - index, IOV_MAX);
+		long long size = 0;
+		for (int i = 0; i < count; i++)
+			size += iovecs[index + i].iov_len;
+
+		// Host call
+		ssize_t result = write ?
+				writev(host_fd, &iovecs[index], count) :
+				readv(host_fd, &iovecs[index], count);
+		if (result < 0)
+			return total ? total : -errno;
+		total += result;
+
+		// Stop on partial transfers
+		if (result < size || !repeat)
+			break;
+	}
+
+	// Bytes transferred
+	return total;
+}
+
+
+
+
 //
 // System call 'read'
 //
@@ -377,15 +457,26 @@ bool Context::SyscallReadCanWakeup()
 	if (host_fds.revents)
 	{
 		unsigned pbuf = regs.getEcx();
-		int count = regs.getEdx();
-		auto buf = misc::new_unique_array<char>(count);
-
-		count = read(desc->getHostIndex(), buf.get(), count);
-		if (count < 0)
-			throw misc::Panic("Unexpected error in host 'read'");
+		unsigned count = regs.getEdx();
+		std::vector<struct iovec> iovecs;
+		int err;
+		if (!SyscallIovecs(pbuf, count, mem::Memory::AccessWrite,
+				iovecs) && count)
+		{
+			// No valid buffer in safe mode
+			err = -EFAULT;
+		}
+		else
+		{
+			err = SyscallTransferIovecs(desc->getHostIndex(),
+					iovecs, false, desc->getType() ==
+					comm::FileDescriptor::TypeRegular);
+			if (err < 0)
+				throw misc::Panic("Unexpected error in "
+						"host 'read'");
+		}
 
-		regs.setEax(count);
-		memory->Write(pbuf, count, buf.get());
+		regs.setEax(err);
 
 		emulator->syscall_debug << misc::fmt("[%s] Syscall 'read' - "
 				"continue\n",
@@ -420,7 +511,6 @@ int Context::ExecuteSyscall_read()
 	emulator->syscall_debug << misc::fmt("  host_fd=%d\n", host_fd);
 
 	// Poll the file descriptor to check if read is blocking
-	auto buf = misc::new_unique_array<char>(count);
 	struct pollfd fds;
 	fds.fd = host_fd;
 	fds.events = POLLIN;
@@ -431,18 +521,19 @@ int Context::ExecuteSyscall_read()
 	// Non-blocking read
 	if (fds.revents || (desc->getFlags() & O_NONBLOCK))
 	{
-		// Host system call
-		err = read(host_fd, buf.get(), count);
-		if (err == -1)
-			return -errno;
-
-		// Write in guest memory
+		// Host system call, reading straight into guest memory
+		std::vector<struct iovec> iovecs;
+		if (!SyscallIovecs(buf_ptr, count, mem::Memory::AccessWrite,
+				iovecs) && count)
+			return -EFAULT;
+		err = SyscallTransferIovecs(host_fd, iovecs, false,
+				desc->getType() ==
+				comm::FileDescriptor::TypeRegular);
 		if (err > 0)
-		{
-			memory->Write(buf_ptr, err, buf.get());
-			emulator->syscall_debug << misc::StringBinaryBuffer(buf.get(),
-					count, 40);
-		}
+			emulator->syscall_debug << misc::StringBinaryBuffer(
+					(char *) iovecs[0].iov_base,
+					std::min<int>(err, iovecs[0].iov_len),
+					40);
 
 		// Return number of read bytes
 		return err;
@@ -506,15 +597,27 @@ bool Context::SyscallWriteCanWakeup()
 	if (host_fds.revents)
 	{
 		unsigned pbuf = regs.getEcx();
-		int count = regs.getEdx();
-		auto buf = misc::new_unique_array<char>(count);
-		
-		memory->Read(pbuf, count, buf.get());
-		count = write(desc->getHostIndex(), buf.get(), count);
-		if (count < 0)
-			throw misc::Panic("Unexpected error in host 'write'");
+		unsigned count = regs.getEdx();
+		std::vector<struct iovec> iovecs;
+		int err;
+		if (!SyscallIovecs(pbuf, count, mem::Memory::AccessRead,
+				iovecs) && count)
+		{
+			// The buffer was unmapped while the context was
+			// suspended, in safe mode
+			err = -EFAULT;
+		}
+		else
+		{
+			err = SyscallTransferIovecs(desc->getHostIndex(),
+					iovecs, true, desc->getType() ==
+					comm::FileDescriptor::TypeRegular);
+			if (err < 0)
+				throw misc::Panic("Unexpected error in "
+						"host 'write'");
+		}
 
-		regs.setEax(count);
+		regs.setEax(err);
 		emulator->syscall_debug << misc::fmt("[%s] Syscall write - "
 				"continue\n",
 				getName().c_str());
@@ -548,12 +651,17 @@ int Context::ExecuteSyscall_write()
 	int host_fd = desc->getHostIndex();
 	emulator->syscall_debug << misc::fmt("  host_fd=%d\n", host_fd);
 
-	// Read buffer from memory
-	auto buf = misc::new_unique_array<char>(count);
-	memory->Read(buf_ptr, count, buf.get());
-	emulator->syscall_debug << "  buf=\""
-			<< misc::StringBinaryBuffer(buf.get(), count, 40)
-			<< "\"\n";
+	// Locate buffer in guest memory
+	std::vector<struct iovec> iovecs;
+	if (!SyscallIovecs(buf_ptr, count, mem::Memory::AccessRead, iovecs) &&
+			count)
+		return -EFAULT;
+	if (count)
+		emulator->syscall_debug << "  buf=\""
+				<< misc::StringBinaryBuffer(
+				(char *) iovecs[0].iov_base,
+				iovecs[0].iov_len, 40)
+				<< "\"\n";
 
 	// Poll the file descriptor to check if write is blocking
 	struct pollfd fds;
@@ -564,13 +672,11 @@ int Context::ExecuteSyscall_write()
 	// Non-blocking write
 	if (fds.revents)
 	{
-		// Host write
-		int err = write(host_fd, buf.get(), count);
-		if (err == -1)
-			err = -errno;
-
-		// Return written bytes
-		return err;
+		// Host write, straight from guest memory. Return written
+		// bytes.
+		return SyscallTransferIovecs(host_fd, iovecs, true,
+				desc->getType() ==
+				comm::FileDescriptor::TypeRegular);
 	}
 
 	// Blocking write - suspend thread
@@ -2591,23 +2697,37 @@ int Context::SyscallMmapAux(unsigned addr, unsigned len,
 	// Host mapping
 	if (host_fd >= 0)
 	{
-		// Save previous position
-		unsigned last_pos = lseek(host_fd, 0, SEEK_CUR);
-		lseek(host_fd, offset, SEEK_SET);
-
-		// Read pages
+		// Back the pages with the file. The host reads each page
+		// upon its first access, and pages are only copied when
+		// written.
 		assert(len_aligned % mem::Memory::PageSize == 0);
 		assert(addr % mem::Memory::PageSize == 0);
-		unsigned curr_addr = addr;
-		for (int size = len_aligned; size > 0; size -= mem::Memory::PageSize)
+		if (!memory->MapFile(addr, len_aligned, host_fd, offset))
 		{
-			char buf[mem::Memory::PageSize];
-			memset(buf, 0, mem::Memory::PageSize);
-			int count = read(host_fd, buf, mem::Memory::PageSize);
-			if (count)
-				memory->Access(curr_addr, mem::Memory::PageSize,
-						buf, mem::Memory::AccessInit);
-			curr_addr += mem::Memory::PageSize;
+			// The host cannot map the file, so read it now. Save
+			// previous position.
+			unsigned last_pos = lseek(host_fd, 0, SEEK_CUR);
+			lseek(host_fd, offset, SEEK_SET);
+
+			// Read pages
+			unsigned curr_addr = addr;
+			for (int size = len_aligned; size > 0;
+					size -= mem::Memory::PageSize)
+			{
+				char buf[mem::Memory::PageSize];
+				memset(buf, 0, mem::Memory::PageSize);
+				int count = read(host_fd, buf,
+						mem::Memory::PageSize);
+				if (count > 0)
+					memory->Access(curr_addr,
+							mem::Memory::PageSize,
+							buf,
+							mem::Memory::AccessInit);
+				curr_addr += mem::Memory::PageSize;
+			}
+
+			// Return file to last position
+			lseek(host_fd, last_pos, SEEK_SET);
 		}
 
 		// Record map in call stack
@@ -2617,9 +2737,6 @@ int Context::SyscallMmapAux(unsigned addr, unsigned len,
 					addr,
 					len,
 					true);
-
-		// Return file to last position
-		lseek(host_fd, last_pos, SEEK_SET);
 	}
 
 	// Return mapped address
@@ -3581,7 +3698,44 @@ int Context::ExecuteSyscall_msync()
 
 int Context::ExecuteSyscall_readv()
 {
-	__UNIMPLEMENTED__
+	unsigned iov_base;
+	unsigned iov_len;
+
+	// Arguments
+	int guest_fd = regs.getEbx();
+	unsigned iovec_ptr = regs.getEcx();
+	unsigned vlen = regs.getEdx();
+	emulator->syscall_debug << misc::fmt("  guest_fd=%d, iovec_ptr = 0x%x, vlen=0x%x\n",
+		guest_fd, iovec_ptr, vlen);
+
+	// Check file descriptor
+	comm::FileDescriptor *desc = file_table->getFileDescriptor(guest_fd);
+	if (!desc)
+		return -EBADF;
+	int host_fd = desc->getHostIndex();
+	emulator->syscall_debug << misc::fmt("  host_fd=%d\n", host_fd);
+
+	// No pipes allowed
+	if (desc->getType() == comm::FileDescriptor::TypePipe)
+		throw misc::Panic("readv: Unsupported for pipes");
+
+	// Host I/O vectors pointing to the guest buffers
+	std::vector<struct iovec> iovecs;
+	for (unsigned v = 0; v < vlen; v++)
+	{
+		// Read io vector element
+		memory->Read(iovec_ptr, 4, (char *)&iov_base);
+		memory->Read(iovec_ptr + 4, 4, (char *)&iov_len);
+		iovec_ptr += 8;
+
+		// Stop at the first invalid buffer
+		if (SyscallIovecs(iov_base, iov_len, mem::Memory::AccessWrite,
+				iovecs) < iov_len)
+			break;
+	}
+
+	// Return total number of bytes read
+	return SyscallTransferIovecs(host_fd, iovecs, false, true);
 }
 
 
@@ -3593,7 +3747,6 @@ int Context::ExecuteSyscall_readv()
 
 int Context::ExecuteSyscall_writev()
 {
-	int len;
 	unsigned iov_base;
 	unsigned iov_len;
 
@@ -3615,8 +3768,8 @@ int Context::ExecuteSyscall_writev()
 	if (desc->getType() == comm::FileDescriptor::TypePipe)
 		throw misc::Panic("writev: Unsupported for pipes");
 
-	// Proceed 
-	int total_len = 0;
+	// Host I/O vectors pointing to the guest buffers
+	std::vector<struct iovec> iovecs;
 	for (unsigned v = 0; v < vlen; v++)
 	{
 		// Read io vector element 
@@ -3624,24 +3777,14 @@ int Context::ExecuteSyscall_writev()
 		memory->Read(iovec_ptr + 4, 4, (char *)&iov_len);
 		iovec_ptr += 8;
 
-		// Read buffer from memory and write it to file 
-		char *buf = (char *)malloc(iov_len);
-		memory->Read(iov_base, iov_len, buf);
-		len = write(host_fd, buf, iov_len);
-		if (len == -1)
-		{
-			free(buf);
-			return -errno;
-		}
-
-		// Accumulate written bytes 
-		total_len += len;
-		free(buf);
+		// Stop at the first invalid buffer
+		if (SyscallIovecs(iov_base, iov_len, mem::Memory::AccessRead,
+				iovecs) < iov_len)
+			break;
 	}
 
 	// Return total number of bytes written 
-	return total_len;
-
+	return SyscallTransferIovecs(host_fd, iovecs, true, true);
 }
 
 
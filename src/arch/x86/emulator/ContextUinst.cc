@@ -18,6 +18,7 @@
  */
 
 #include <lib/cpp/Misc.h>
+#include <lib/esim/FramePool.h>
 
 #include "Context.h"
 #include "Uinst.h"
@@ -92,7 +93,7 @@ void Context::EmitUinstEffectiveAddress(Uinst *uinst, int index)
 	uinst_effaddr_emitted = true;
 
 	// Create micro-instruction
-	uinsts.emplace_back(misc::new_unique<Uinst>(Uinst::OpcodeEffaddr));
+	uinsts.emplace_back(esim::new_frame<Uinst>(Uinst::OpcodeEffaddr));
 	Uinst *new_uinst = uinsts.back().get();
 	
 	// Emit micro-instruction
@@ -246,7 +247,7 @@ void Context::ParseUinstIDep(Uinst *uinst, int index)
 		}
 
 		// Load
-		uinsts.emplace_back(misc::new_unique<Uinst>(Uinst::OpcodeLoad));
+		uinsts.emplace_back(esim::new_frame<Uinst>(Uinst::OpcodeLoad));
 		Uinst *new_uinst = uinsts.back().get();
 		new_uinst->setIDep(0, Uinst::DepEa);
 		new_uinst->setODep(0, mem_std_dep);
@@ -292,7 +293,7 @@ void Context::ParseUinstODep(Uinst *uinst, int index)
 		}
 
 		// Store
-		uinsts.emplace_back(misc::new_unique<Uinst>(Uinst::OpcodeStore));
+		uinsts.emplace_back(esim::new_frame<Uinst>(Uinst::OpcodeStore));
 		Uinst *new_uinst = uinsts.back().get();
 		new_uinst->setIDep(0, Uinst::DepEa);
 		new_uinst->setIDep(1, mem_std_dep);
@@ -325,8 +326,10 @@ void Context::newMemoryUinst(
 	if (!uinst_active)
 		return;
 
-	// Create micro-instruction
-	auto uinst = misc::new_shared<Uinst>(opcode);
+	// Create micro-instruction. Micro-instructions are allocated from a
+	// pool, since they are created for every emulated instruction in
+	// detailed simulation.
+	auto uinst = esim::new_frame<Uinst>(opcode);
 
 	// Initialize
 	uinst->setMemoryAccess(address, size);
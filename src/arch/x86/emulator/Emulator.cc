@@ -17,7 +17,10 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
+
 #include <arch/x86/disassembler/Disassembler.h>
+#include <lib/cpp/Checkpoint.h>
 #include <lib/esim/Engine.h>
 
 #include "Context.h"
@@ -35,6 +38,24 @@ std::string Emulator::syscall_debug_file;
 
 long long Emulator::max_instructions;
 
+bool Emulator::no_inst_cache = false;
+
+bool Emulator::inst_cache_enabled = true;
+
+int Emulator::block_size = 1;
+
+int Emulator::num_threads = 1;
+
+long long Emulator::quantum = 10000;
+
+const int Emulator::parallel_block_size;
+
+std::string Emulator::save_checkpoint_file;
+
+long long Emulator::checkpoint_instructions = 0;
+
+std::string Emulator::load_checkpoint_file;
+
 std::unique_ptr<Emulator> Emulator::instance;
 
 misc::Debug Emulator::call_debug;
@@ -91,6 +112,77 @@ void Emulator::RegisterOptions()
 			"instructions. On x86 detailed simulation, it is given as "
 			"the number of committed (non-speculative) instructions. "
 			"A value of 0 means no limit.");
+
+	// Option --x86-no-inst-cache
+	command_line->RegisterBool("--x86-no-inst-cache", no_inst_cache,
+			"Disable the cache of decoded instructions. By default, "
+			"each x86 address space keeps the instructions decoded "
+			"so far, which are invalidated when their code is "
+			"modified.");
+
+	// Option --x86-block-size <size>
+	command_line->RegisterInt32("--x86-block-size <size> (default = 1)",
+			block_size,
+			"Maximum number of instructions executed in a row by "
+			"an x86 context on functional simulation. Values "
+			"larger than 1 enable basic block mode, where each "
+			"context runs a whole basic block in each iteration "
+			"of the emulation loop, reducing the per-instruction "
+			"overhead. A basic block ends at control transfer "
+			"instructions and system calls.");
+
+	// Option --x86-threads <num>
+	command_line->RegisterInt32("--x86-threads <num> (default = 1)",
+			num_threads,
+			"Number of host threads used on x86 functional "
+			"simulation. With a value larger than 1, contexts that "
+			"do not share their memory with other contexts run in "
+			"parallel until their next system call, for at most "
+			"the number of instructions given in --x86-quantum. "
+			"System calls and all other contexts run sequentially "
+			"in between, so the simulation is deterministic for a "
+			"given number of threads larger than 1. The order in "
+			"which system calls of different contexts reach the "
+			"host differs from a run with 1 thread, where contexts "
+			"interleave one instruction or basic block at a time. "
+			"For example, writes of several processes to a shared "
+			"output file or pipe can appear in a different order.");
+
+	// Option --x86-quantum <num>
+	command_line->RegisterInt64("--x86-quantum <num> (default = 10000)",
+			quantum,
+			"Maximum number of instructions run by a context in "
+			"parallel before synchronizing with other contexts, "
+			"used together with option --x86-threads.");
+
+	// Option --x86-save-checkpoint <file>
+	command_line->RegisterString("--x86-save-checkpoint <file>",
+			save_checkpoint_file,
+			"Save the state of all x86 contexts into a compressed "
+			"checkpoint file on functional simulation, after the "
+			"number of instructions "
+			"given in --x86-checkpoint-inst, and finish the "
+			"simulation. The checkpoint is saved at the first "
+			"point after that where no context is suspended in "
+			"a system call. Contexts using pipes, sockets, or "
+			"devices cannot be saved.");
+
+	// Option --x86-checkpoint-inst <number>
+	command_line->RegisterInt64("--x86-checkpoint-inst <number> "
+			"(default = 0)",
+			checkpoint_instructions,
+			"Number of x86 instructions emulated before saving the "
+			"checkpoint file given in --x86-save-checkpoint.");
+
+	// Option --x86-load-checkpoint <file>
+	command_line->RegisterString("--x86-load-checkpoint <file>",
+			load_checkpoint_file,
+			"Create the x86 contexts from a checkpoint file saved "
+			"with --x86-save-checkpoint, instead of loading "
+			"programs from their executable files. This allows a "
+			"detailed simulation to start directly at the point "
+			"where the checkpoint was saved. Executable files and "
+			"files opened by the program must still exist.");
 }
 
 
@@ -102,6 +194,30 @@ void Emulator::ProcessOptions()
 	isa_debug.setPath(isa_debug_file);
 	loader_debug.setPath(loader_debug_file);
 	syscall_debug.setPath(syscall_debug_file);
+
+	// Decoded instruction cache
+	inst_cache_enabled = !no_inst_cache;
+
+	// Basic block size
+	if (block_size < 1)
+		throw Error(misc::fmt("Invalid value for --x86-block-size "
+				"(%d)", block_size));
+
+	// Parallel simulation
+	if (num_threads < 1)
+		throw Error(misc::fmt("Invalid value for --x86-threads (%d)",
+				num_threads));
+	if (quantum < 1)
+		throw Error(misc::fmt("Invalid value for --x86-quantum (%lld)",
+				quantum));
+
+	// Checkpoints
+	if (checkpoint_instructions < 0)
+		throw Error(misc::fmt("Invalid value for --x86-checkpoint-inst "
+				"(%lld)", checkpoint_instructions));
+	if (checkpoint_instructions && save_checkpoint_file.empty())
+		throw Error("Option --x86-checkpoint-inst requires "
+				"--x86-save-checkpoint");
 }
 
 
@@ -280,6 +396,73 @@ void Emulator::LoadProgram(const std::vector<std::string> &args,
 }
 
 
+bool Emulator::canSaveCheckpoint() const
+{
+	for (auto &context : contexts)
+		if (!context->getState(Context::StateFinished) &&
+				!context->canSaveCheckpoint())
+			return false;
+	return true;
+}
+
+
+void Emulator::SaveCheckpoint(const std::string &path) const
+{
+	// Finished contexts are about to be freed, so they are not saved
+	int num_contexts = 0;
+	for (auto &context : contexts)
+		if (!context->getState(Context::StateFinished))
+			num_contexts++;
+
+	// Header
+	misc::Checkpoint checkpoint(path, true);
+	checkpoint.WriteTag("x86");
+	checkpoint.WriteValue(num_instructions);
+	checkpoint.WriteValue(num_contexts);
+
+	// Contexts
+	Context::CheckpointState checkpoint_state;
+	for (auto &context : contexts)
+		if (!context->getState(Context::StateFinished))
+			context->SaveCheckpoint(checkpoint, checkpoint_state);
+
+	// Debug
+	context_debug << misc::fmt("Checkpoint '%s' saved at instruction "
+			"%lld, %d contexts\n", path.c_str(), num_instructions,
+			num_contexts);
+}
+
+
+void Emulator::LoadCheckpoint(const std::string &path)
+{
+	// No contexts must exist
+	if (contexts.size())
+		throw Error(misc::fmt("%s: checkpoint loaded after other "
+				"contexts were created", path.c_str()));
+
+	// Header. The number of instructions emulated before the checkpoint
+	// is only informative, and statistics start from zero.
+	misc::Checkpoint checkpoint(path, false);
+	checkpoint.ReadTag("x86");
+	long long checkpoint_num_instructions =
+			checkpoint.ReadValue<long long>();
+	int num_contexts = checkpoint.ReadValue<int>();
+
+	// Contexts
+	Context::CheckpointState checkpoint_state;
+	for (int i = 0; i < num_contexts; i++)
+	{
+		Context *context = newContext();
+		context->LoadCheckpoint(checkpoint, checkpoint_state);
+	}
+
+	// Debug
+	context_debug << misc::fmt("Checkpoint '%s' loaded, saved at "
+			"instruction %lld, %d contexts\n", path.c_str(),
+			checkpoint_num_instructions, num_contexts);
+}
+
+
 void Emulator::FreeContext(Context *context)
 {
 	// Remove context from all context lists
@@ -431,10 +614,25 @@ bool Emulator::Run()
 	if (max_instructions && num_instructions >= max_instructions)
 		esim->Finish("x86MaxInst");
 
+	// Save checkpoint and stop once the requested number of instructions
+	// has been emulated, as soon as all contexts can be saved
+	if (!save_checkpoint_file.empty() && !esim->hasFinished() &&
+			num_instructions >= checkpoint_instructions &&
+			canSaveCheckpoint())
+	{
+		SaveCheckpoint(save_checkpoint_file);
+		esim->Finish("x86Checkpoint");
+	}
+
 	// Stop if any previous reason met
 	if (esim->hasFinished())
 		return true;
 
+	// Run contexts in parallel up to their next system call. This is only
+	// done on functional simulation, invoked with this function.
+	if (num_threads > 1)
+		RunParallel();
+
 	// Run an instruction from every running context. During execution, a
 	// context can remove itself from the running list, so traversing the
 	// running list is not an option.
@@ -444,8 +642,18 @@ bool Emulator::Run()
 		if (!context->getState(Context::StateRunning))
 			continue;
 
+		// Do not exceed the maximum number of instructions
+		int max_size = block_size;
+		if (max_instructions && max_instructions - num_instructions <
+				max_size)
+			max_size = std::max(1LL, max_instructions -
+					num_instructions);
+
 		// Run one iteration
-		context->Execute();
+		if (max_size > 1)
+			context->ExecuteBlock(max_size);
+		else
+			context->Execute();
 	}
 
 	// Free finished contexts
@@ -459,5 +667,125 @@ bool Emulator::Run()
 	return true;
 }
 
+
+void *Emulator::WorkerThread(void *arg)
+{
+	RunWorker((Worker *) arg);
+	return nullptr;
+}
+
+
+void Emulator::RunWorker(Worker *worker)
+{
+	// Exceptions are captured and rethrown in the main thread
+	try
+	{
+		for (Context *context : worker->contexts)
+			worker->num_instructions += context->ExecuteParallel(
+					worker->quantum, worker->num_blocks);
+	}
+	catch (...)
+	{
+		worker->exception = std::current_exception();
+	}
+}
+
+
+void Emulator::RunParallel()
+{
+	// Find running contexts with a private memory
+	std::vector<Context *> parallel_contexts;
+	for (auto &context : contexts)
+		if (context->getState(Context::StateRunning) &&
+				!context->isMemoryShared())
+			parallel_contexts.push_back(context.get());
+	int num_contexts = parallel_contexts.size();
+	if (!num_contexts)
+		return;
+
+	// Do not exceed the maximum number of instructions
+	long long max_quantum = quantum;
+	if (max_instructions)
+		max_quantum = std::min(max_quantum, (max_instructions -
+				num_instructions) / num_contexts);
+	if (max_quantum < 1)
+		return;
+
+	// Assign contexts to workers in a round-robin fashion
+	int num_workers = std::min(num_threads, num_contexts);
+	std::vector<Worker> workers(num_workers);
+	for (int i = 0; i < num_contexts; i++)
+		workers[i % num_workers].contexts.push_back(
+				parallel_contexts[i]);
+
+	// Launch workers on host threads, except the first, which runs on
+	// the main thread.
+	int num_launched = 1;
+	for (Worker &worker : workers)
+		worker.quantum = max_quantum;
+	for (int i = 1; i < num_workers; i++, num_launched++)
+		if (pthread_create(&workers[i].thread, nullptr,
+				WorkerThread, &workers[i]))
+			break;
+	RunWorker(&workers[0]);
+
+	// Run workers that could not be launched, and wait for the rest
+	for (int i = num_launched; i < num_workers; i++)
+		RunWorker(&workers[i]);
+	for (int i = 1; i < num_launched; i++)
+		pthread_join(workers[i].thread, nullptr);
+
+	// Collect results
+	for (Worker &worker : workers)
+	{
+		num_instructions += worker.num_instructions;
+		num_parallel_instructions += worker.num_instructions;
+		num_blocks += worker.num_blocks;
+		num_block_instructions += worker.num_instructions;
+	}
+	for (Worker &worker : workers)
+		if (worker.exception)
+			std::rethrow_exception(worker.exception);
+}
+
+
+void Emulator::DumpSummary(std::ostream &os) const
+{
+	// Common statistics
+	comm::Emulator::DumpSummary(os);
+
+	// Decoded instruction cache
+	long long num_lookups = num_inst_cache_hits + num_inst_cache_misses;
+	if (num_lookups)
+	{
+		os << misc::fmt("InstCacheHits = %lld\n", num_inst_cache_hits);
+		os << misc::fmt("InstCacheMisses = %lld\n",
+				num_inst_cache_misses);
+		os << misc::fmt("InstCacheHitRatio = %.4g\n",
+				(double) num_inst_cache_hits / num_lookups);
+	}
+
+	// Basic block mode
+	if (block_size > 1)
+	{
+		long long time = getTimerValue();
+		os << misc::fmt("BlockSize = %d\n", block_size);
+		os << misc::fmt("Blocks = %lld\n", num_blocks);
+		os << misc::fmt("AverageBlockLength = %.2f\n", num_blocks ?
+				(double) num_block_instructions / num_blocks :
+				0.0);
+		os << misc::fmt("MIPS = %.2f\n", time ?
+				(double) num_instructions / time : 0.0);
+	}
+
+	// Parallel simulation
+	if (num_threads > 1)
+	{
+		os << misc::fmt("Threads = %d\n", num_threads);
+		os << misc::fmt("ParallelInstructions = %lld\n",
+				num_parallel_instructions);
+	}
+}
+
 } // namespace x86
 
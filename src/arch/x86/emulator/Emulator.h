@@ -20,7 +20,9 @@
 #ifndef ARCH_X86_EMULATOR_EMULATOR_H
 #define ARCH_X86_EMULATOR_EMULATOR_H
 
+#include <exception>
 #include <pthread.h>
+#include <vector>
 
 #include <arch/common/Arch.h>
 #include <arch/common/Emulator.h>
@@ -68,6 +70,30 @@ class Emulator : public comm::Emulator
 	// Maximum number of instructions
 	static long long max_instructions;
 
+	// Disable the decoded instruction cache
+	static bool no_inst_cache;
+
+	// Maximum number of instructions executed as a basic block
+	static int block_size;
+
+	// Number of host threads used to run contexts in parallel
+	static int num_threads;
+
+	// Maximum number of instructions run by each context in parallel
+	static long long quantum;
+
+	// Maximum number of instructions in a basic block run in parallel
+	// when basic block mode is off.
+	static const int parallel_block_size = 64;
+
+	// Checkpoint file to save, and number of instructions after which it
+	// is saved
+	static std::string save_checkpoint_file;
+	static long long checkpoint_instructions;
+
+	// Checkpoint file to load contexts from
+	static std::string load_checkpoint_file;
+
 	// Unique instance of singleton
 	static std::unique_ptr<Emulator> instance;
 
@@ -110,6 +136,59 @@ class Emulator : public comm::Emulator
 	// for FIFO wakeups.
 	long long futex_sleep_count = 0;
 
+	// Number of instructions found in the decoded instruction caches
+	long long num_inst_cache_hits = 0;
+
+	// Number of instructions decoded and inserted in the decoded
+	// instruction caches
+	long long num_inst_cache_misses = 0;
+
+	// Number of basic blocks executed with Context::ExecuteBlock()
+	long long num_blocks = 0;
+
+	// Number of instructions executed in basic blocks
+	long long num_block_instructions = 0;
+
+	// Number of instructions executed by contexts running in parallel
+	long long num_parallel_instructions = 0;
+
+	// Contexts assigned to a host thread in parallel functional
+	// simulation, and results of their execution.
+	struct Worker
+	{
+		// Host thread, unused for the first worker, which runs on the
+		// main thread.
+		pthread_t thread;
+
+		// Contexts to run
+		std::vector<Context *> contexts;
+
+		// Maximum number of instructions per context
+		long long quantum = 0;
+
+		// Number of executed instructions
+		long long num_instructions = 0;
+
+		// Number of executed basic blocks
+		long long num_blocks = 0;
+
+		// Exception thrown by a context, if any
+		std::exception_ptr exception;
+	};
+
+	// Entry point of a host thread running a worker
+	static void *WorkerThread(void *arg);
+
+	// Run the contexts assigned to a worker
+	static void RunWorker(Worker *worker);
+
+	// Run all running contexts that do not share their memory with other
+	// contexts in parallel for one quantum, until they reach their next
+	// system call. Since each context can run a whole quantum before the
+	// sequential phase, system calls of different contexts can reach the
+	// host in a different order than with one thread.
+	void RunParallel();
+
 
 public:
 
@@ -132,6 +211,23 @@ public:
 	/// Return the maximum number of instructions, as set up by the user
 	static long long getMaxInstructions() { return max_instructions; }
 
+	/// Return the checkpoint file to load contexts from, as set up by the
+	/// user, or an empty string if none.
+	static const std::string &getLoadCheckpointFile()
+	{
+		return load_checkpoint_file;
+	}
+
+	/// Flag indicating whether contexts use a decoded instruction cache
+	static bool inst_cache_enabled;
+
+	/// Return the maximum number of instructions in a basic block run by
+	/// contexts in parallel mode
+	static int getParallelBlockSize()
+	{
+		return block_size > 1 ? block_size : parallel_block_size;
+	}
+
 	/// Debugger for function calls
 	static misc::Debug call_debug;
 
@@ -207,11 +303,39 @@ public:
 	/// locked before invoking this function.
 	void ProcessEventsScheduleUnsafe() { process_events_force = true; }
 
+	/// Return whether the state of all contexts can be saved in a
+	/// checkpoint. See Context::canSaveCheckpoint().
+	bool canSaveCheckpoint() const;
+
+	/// Save the state of all contexts into checkpoint file \a path
+	void SaveCheckpoint(const std::string &path) const;
+
+	/// Create contexts from the state saved in checkpoint file \a path,
+	/// as an alternative to loading programs with LoadProgram(). No
+	/// contexts must have been created before.
+	void LoadCheckpoint(const std::string &path);
+
 	/// Run one iteration of the emulation loop.
 	/// \return This function \c true if the iteration had a useful
 	/// emulation, and \c false if all contexts finished execution.
 	bool Run();
 
+	/// Dump emulator statistics
+	void DumpSummary(std::ostream &os) const override;
+
+	/// Record a hit in a decoded instruction cache
+	void incNumInstCacheHits() { num_inst_cache_hits++; }
+
+	/// Record a miss in a decoded instruction cache
+	void incNumInstCacheMisses() { num_inst_cache_misses++; }
+
+	/// Record the execution of a basic block of \a size instructions
+	void incNumBlocks(int size)
+	{
+		num_blocks++;
+		num_block_instructions += size;
+	}
+
 
 
 
@@ -0,0 +1,99 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ARCH_X86_EMU_INSTRUCTION_CACHE_H
+#define ARCH_X86_EMU_INSTRUCTION_CACHE_H
+
+#include <vector>
+
+#include <arch/x86/disassembler/Instruction.h>
+
+
+namespace x86
+{
+
+/// Direct-mapped cache of decoded instructions, indexed by instruction
+/// address. One instruction cache is shared by all contexts sharing the same
+/// memory object. Entries are tagged with the code version of the memory
+/// (see mem::Memory::getCodeVersion()) at the time they were decoded, so any
+/// modification of a page holding cached instructions invalidates them.
+class InstructionCache
+{
+	// Cache entry
+	struct Entry
+	{
+		// Instruction address
+		unsigned eip = 0;
+
+		// Memory code version when the instruction was decoded, or -1
+		// for an invalid entry
+		long long version = -1;
+
+		// Decoded instruction
+		Instruction inst;
+	};
+
+	// Log base 2 of the number of entries
+	static const int log_num_entries = 13;
+
+	// Number of entries
+	static const int num_entries = 1 << log_num_entries;
+
+	// Cache entries
+	std::vector<Entry> entries;
+
+	// Return the entry where an instruction address is mapped
+	Entry &getEntry(unsigned eip)
+	{
+		return entries[(eip ^ (eip >> log_num_entries)) &
+				(num_entries - 1)];
+	}
+
+public:
+
+	/// Constructor
+	InstructionCache();
+
+	/// Look up the instruction at address \a eip decoded when the memory
+	/// code version was \a version. If found, copy it into \a inst and
+	/// return `true`. Otherwise, return `false`.
+	bool Lookup(unsigned eip, long long version, Instruction &inst)
+	{
+		Entry &entry = getEntry(eip);
+		if (entry.eip != eip || entry.version != version)
+			return false;
+		inst = entry.inst;
+		return true;
+	}
+
+	/// Insert a decoded instruction, replacing any other instruction
+	/// mapped to the same entry.
+	void Insert(unsigned eip, long long version, const Instruction &inst)
+	{
+		Entry &entry = getEntry(eip);
+		entry.eip = eip;
+		entry.version = version;
+		entry.inst = inst;
+	}
+};
+
+
+}  // namespace x86
+
+#endif
@@ -20,6 +20,7 @@
 #include <cstring>
 
 #include <arch/x86/disassembler/Instruction.h>
+#include <lib/cpp/Checkpoint.h>
 #include <lib/cpp/Misc.h>
 #include <lib/cpp/String.h>
 
@@ -237,5 +238,52 @@ void Regs::Dump(std::ostream &os) const
 }
 
 
-}  // namespace x86
+void Regs::SaveCheckpoint(misc::Checkpoint &checkpoint) const
+{
+	// Main registers
+	checkpoint.WriteTag("regs");
+	checkpoint.Write(bytes, sizeof bytes);
+	checkpoint.WriteValue(eip);
+	checkpoint.WriteValue(eflags);
+
+	// Floating-point stack
+	for (int i = 0; i < 8; i++)
+	{
+		checkpoint.WriteValue(fpu_stack[i].value);
+		checkpoint.WriteValue(fpu_stack[i].valid);
+	}
+	checkpoint.WriteValue(fpu_top);
+	checkpoint.WriteValue(fpu_code);
+	checkpoint.WriteValue(fpu_ctrl);
 
+	// XMM registers
+	for (int i = 0; i < 8; i++)
+		checkpoint.WriteValue(xmm[i]);
+}
+
+
+void Regs::LoadCheckpoint(misc::Checkpoint &checkpoint)
+{
+	// Main registers
+	checkpoint.ReadTag("regs");
+	checkpoint.Read(bytes, sizeof bytes);
+	eip = checkpoint.ReadValue<unsigned>();
+	eflags = checkpoint.ReadValue<unsigned>();
+
+	// Floating-point stack
+	for (int i = 0; i < 8; i++)
+	{
+		fpu_stack[i].value = checkpoint.ReadValue<Extended>();
+		fpu_stack[i].valid = checkpoint.ReadValue<bool>();
+	}
+	fpu_top = checkpoint.ReadValue<int>();
+	fpu_code = checkpoint.ReadValue<int>();
+	fpu_ctrl = checkpoint.ReadValue<unsigned short>();
+
+	// XMM registers
+	for (int i = 0; i < 8; i++)
+		xmm[i] = checkpoint.ReadValue<XmmValue>();
+}
+
+
+}  // namespace x86
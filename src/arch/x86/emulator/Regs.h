@@ -29,6 +29,11 @@
 #include "XmmValue.h"
 
 
+namespace misc
+{
+class Checkpoint;
+}
+
 namespace x86
 {
 
@@ -441,6 +446,12 @@ public:
 	/// output stream (or standard output if argument \a os is omitted).
 	void DumpFpuStack(std::ostream &os = std::cout) const;
 
+	/// Write the register file into a checkpoint file
+	void SaveCheckpoint(misc::Checkpoint &checkpoint) const;
+
+	/// Read the register file from a checkpoint file
+	void LoadCheckpoint(misc::Checkpoint &checkpoint);
+
 	/// Operator \c << overloaded, invoking function Dump()
 	friend std::ostream &operator<<(std::ostream &os, const Regs &regs) {
 		regs.Dump(os);
@@ -17,6 +17,8 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <lib/cpp/Checkpoint.h>
+
 #include "Signal.h"
 
 
@@ -104,6 +106,53 @@ void SignalSet::Dump(std::ostream &os) const
 }
 
 
+void SignalSet::SaveCheckpoint(misc::Checkpoint &checkpoint) const
+{
+	assert(bitmap.getSizeInBytes() == 8);
+	checkpoint.Write(bitmap.getBuffer(), 8);
+}
+
+
+void SignalSet::LoadCheckpoint(misc::Checkpoint &checkpoint)
+{
+	assert(bitmap.getSizeInBytes() == 8);
+	checkpoint.Read(bitmap.getBuffer(), 8);
+}
+
+
+void SignalMaskTable::SaveCheckpoint(misc::Checkpoint &checkpoint) const
+{
+	checkpoint.WriteTag("signal-mask-table");
+	pending.SaveCheckpoint(checkpoint);
+	blocked.SaveCheckpoint(checkpoint);
+	backup.SaveCheckpoint(checkpoint);
+	checkpoint.WriteValue(ret_code_ptr);
+
+	// Register file backup
+	checkpoint.WriteValue<bool>(regs.get());
+	if (regs.get())
+		regs->SaveCheckpoint(checkpoint);
+}
+
+
+void SignalMaskTable::LoadCheckpoint(misc::Checkpoint &checkpoint)
+{
+	checkpoint.ReadTag("signal-mask-table");
+	pending.LoadCheckpoint(checkpoint);
+	blocked.LoadCheckpoint(checkpoint);
+	backup.LoadCheckpoint(checkpoint);
+	ret_code_ptr = checkpoint.ReadValue<unsigned>();
+
+	// Register file backup
+	regs.reset();
+	if (checkpoint.ReadValue<bool>())
+	{
+		regs.reset(new Regs());
+		regs->LoadCheckpoint(checkpoint);
+	}
+}
+
+
 void SignalHandler::ReadFromMemory(mem::Memory *memory, unsigned address)
 {
 	memory->Read(address, 4, (char *) &handler);
@@ -122,6 +171,24 @@ void SignalHandler::WriteToMemory(mem::Memory *memory, unsigned address)
 }
 
 
+void SignalHandler::SaveCheckpoint(misc::Checkpoint &checkpoint) const
+{
+	checkpoint.WriteValue(handler);
+	checkpoint.WriteValue(flags);
+	checkpoint.WriteValue(restorer);
+	mask.SaveCheckpoint(checkpoint);
+}
+
+
+void SignalHandler::LoadCheckpoint(misc::Checkpoint &checkpoint)
+{
+	handler = checkpoint.ReadValue<unsigned>();
+	flags = checkpoint.ReadValue<unsigned>();
+	restorer = checkpoint.ReadValue<unsigned>();
+	mask.LoadCheckpoint(checkpoint);
+}
+
+
 void SignalHandler::Dump(std::ostream &os) const
 {
 	os << misc::fmt("handler = 0x%x, ", handler)
@@ -131,5 +198,20 @@ void SignalHandler::Dump(std::ostream &os) const
 }
 
 
-}  // namespace x86
+void SignalHandlerTable::SaveCheckpoint(misc::Checkpoint &checkpoint) const
+{
+	checkpoint.WriteTag("signal-handler-table");
+	for (const SignalHandler &handler : signal_handler)
+		handler.SaveCheckpoint(checkpoint);
+}
 
+
+void SignalHandlerTable::LoadCheckpoint(misc::Checkpoint &checkpoint)
+{
+	checkpoint.ReadTag("signal-handler-table");
+	for (SignalHandler &handler : signal_handler)
+		handler.LoadCheckpoint(checkpoint);
+}
+
+
+}  // namespace x86
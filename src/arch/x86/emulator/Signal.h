@@ -45,7 +45,7 @@ extern const misc::StringMap signal_handler_flags_map;
 struct SignalFrame
 {
 	// Pointer to return code
-	unsigned ret_code_ptr;
+	unsigned ret_code_ptr = 0;
 
 	// Signal received
 	unsigned sig;
@@ -201,6 +201,12 @@ public:
 		assert(bitmap.getSizeInBytes() == 8);
 		memory->Write(address, 8, bitmap.getBuffer());
 	}
+
+	/// Write signal set into a checkpoint file
+	void SaveCheckpoint(misc::Checkpoint &checkpoint) const;
+
+	/// Read signal set from a checkpoint file
+	void LoadCheckpoint(misc::Checkpoint &checkpoint);
 };
 
 
@@ -217,7 +223,7 @@ class SignalMaskTable
 	std::unique_ptr<Regs> regs;
 
 	// Base address of a memory page allocated for execution of return code
-	unsigned ret_code_ptr;
+	unsigned ret_code_ptr = 0;
 
 public:
 
@@ -266,6 +272,13 @@ public:
 
 	/// Return address where the return code can be found.
 	unsigned getRetCodePtr() const { return ret_code_ptr; }
+
+	/// Write signal masks into a checkpoint file, including the backup
+	/// of the register file if a signal handler is running.
+	void SaveCheckpoint(misc::Checkpoint &checkpoint) const;
+
+	/// Read signal masks from a checkpoint file
+	void LoadCheckpoint(misc::Checkpoint &checkpoint);
 };
 
 
@@ -308,6 +321,12 @@ public:
 
 	/// Write the content of the signal handler to memory
 	void WriteToMemory(mem::Memory *memory, unsigned address);
+
+	/// Write signal handler into a checkpoint file
+	void SaveCheckpoint(misc::Checkpoint &checkpoint) const;
+
+	/// Read signal handler from a checkpoint file
+	void LoadCheckpoint(misc::Checkpoint &checkpoint);
 };
 
 
@@ -326,6 +345,12 @@ public:
 		assert(misc::inRange(sig, 1, 64));
 		return &signal_handler[sig - 1];
 	}
+
+	/// Write all signal handlers into a checkpoint file
+	void SaveCheckpoint(misc::Checkpoint &checkpoint) const;
+
+	/// Read all signal handlers from a checkpoint file
+	void LoadCheckpoint(misc::Checkpoint &checkpoint);
 };
 
 
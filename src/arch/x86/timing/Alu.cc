@@ -17,6 +17,9 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
+#include <limits>
+
 #include "Alu.h"
 #include "Timing.h"
 
@@ -124,6 +127,15 @@ void Alu::ParseConfiguration(misc::IniFile *ini_file)
 }
 
 
+int Alu::getMaxOperationLatency()
+{
+	int max_latency = 0;
+	for (int i = 1; i < FunctionalUnit::TypeCount; i++)
+		max_latency = std::max(max_latency, configuration[i][1]);
+	return max_latency;
+}
+
+
 void Alu::DumpConfiguration(std::ostream &os)
 {
 	// Title
@@ -198,6 +210,23 @@ void Alu::ReleaseAll()
 }
 
 
+long long Alu::getWakeupCycle(long long cycle) const
+{
+	long long wakeup_cycle = std::numeric_limits<long long>::max();
+	for (int type = 1; type < FunctionalUnit::TypeCount; type++)
+		wakeup_cycle = std::min(wakeup_cycle,
+				functional_units[type]->getWakeupCycle(cycle));
+	return wakeup_cycle;
+}
+
+
+void Alu::SkipCycles(long long cycle, long long num_cycles)
+{
+	for (int type = 1; type < FunctionalUnit::TypeCount; type++)
+		functional_units[type]->SkipCycles(cycle, num_cycles);
+}
+
+
 void Alu::DumpReport(std::ostream &os) const
 {
 	// Header
@@ -92,6 +92,21 @@ public:
 	/// Release all functional units
 	void ReleaseAll();
 
+	/// Return the functional unit of the given type
+	FunctionalUnit *getFunctionalUnit(FunctionalUnit::Type type) const
+	{
+		return functional_units[type].get();
+	}
+
+	/// Return the earliest cycle after \a cycle in which a busy functional
+	/// unit becomes free, or the maximum value of type `long long` if all
+	/// of them are free.
+	long long getWakeupCycle(long long cycle) const;
+
+	/// Update statistics of all functional units for the given number of
+	/// idle cycles skipped after \a cycle.
+	void SkipCycles(long long cycle, long long num_cycles);
+
 	/// Dump report for functional units.
 	void DumpReport(std::ostream &os = std::cout) const;
 	
@@ -111,6 +126,9 @@ public:
 	// Get the issue latency based on given type count
 	static int getAluIssueLatency(int type_count) { return configuration[type_count][2]; }
 
+	/// Return the largest operation latency among all functional units
+	static int getMaxOperationLatency();
+
 };
 
 }
@@ -388,22 +388,29 @@ unsigned int BranchPredictor::LookupBtb(Uop *uop)
 
 
 void BranchPredictor::UpdateBtb(Uop *uop)
+{
+	// No update for perfect branch predictor
+	if (kind == KindPerfect)
+		return;
+
+	// Update entry
+	UpdateBtb(uop->eip, uop->neip);
+}
+
+
+void BranchPredictor::UpdateBtb(unsigned source, unsigned target)
 {
 	// Local variable
 	BtbEntry *entry;
 	BtbEntry *found_entry;
 	bool found = false;
 
-	// No update for perfect branch predictor
-	if (kind == KindPerfect)
-		return;
-
 	// Search address in BTB
-	int set = uop->eip & (btb_num_sets - 1);
+	int set = source & (btb_num_sets - 1);
 	for (int way = 0; way < btb_num_ways; way++)
 	{
 		entry = &btb[set * btb_num_ways + way];
-		if (entry->source == uop->eip)
+		if (entry->source == source)
 		{
 			found = true;
 			found_entry = entry;
@@ -420,8 +427,8 @@ void BranchPredictor::UpdateBtb(Uop *uop)
 			entry->counter--;
 			if (entry->counter < 0) {
 				entry->counter = btb_num_ways - 1;
-				entry->source = uop->eip;
-				entry->target = uop->neip;
+				entry->source = source;
+				entry->target = target;
 			}
 		}
 	}
@@ -436,11 +443,117 @@ void BranchPredictor::UpdateBtb(Uop *uop)
 				entry->counter--;
 		}
 		found_entry->counter = btb_num_ways - 1;
-		found_entry->target = uop->neip;
+		found_entry->target = target;
 	}
 }
 
 
+void BranchPredictor::Warm(Uinst *uinst, unsigned eip, unsigned size,
+		unsigned neip)
+{
+	// No state in perfect branch predictor
+	assert(uinst->getFlags() & Uinst::FlagCtrl);
+	if (kind == KindPerfect)
+		return;
+
+	// Return address stack, updated as on a BTB hit in LookupBtb()
+	Uinst::Opcode opcode = uinst->getOpcode();
+	if (opcode == Uinst::OpcodeCall || opcode == Uinst::OpcodeRet)
+	{
+		bool hit = false;
+		int set = eip & (btb_num_sets - 1);
+		for (int way = 0; way < btb_num_ways; way++)
+			if (btb[set * btb_num_ways + way].source == eip)
+				hit = true;
+		if (hit && opcode == Uinst::OpcodeCall)
+		{
+			ras[ras_index] = eip + size;
+			ras_index = (ras_index + 1) % ras_size;
+		}
+		if (hit && opcode == Uinst::OpcodeRet)
+			ras_index = (ras_index + ras_size - 1) % ras_size;
+	}
+
+	// Direction predictors, only trained by conditional branches. The
+	// predictions are computed as in Lookup(), and the tables updated as
+	// in Update().
+	if (!(uinst->getFlags() & Uinst::FlagUncond) &&
+			opcode != Uinst::OpcodeIbranch)
+	{
+		bool taken = neip != eip + size;
+		Prediction bimod_prediction = PredictionNotTaken;
+		Prediction two_level_prediction = PredictionNotTaken;
+		Prediction choice_prediction = PredictionNotTaken;
+		char *bimod_ptr = nullptr;
+		unsigned int *bht_ptr = nullptr;
+		char *pht_ptr = nullptr;
+		char *choice_ptr = nullptr;
+
+		// Bimodal
+		if (kind == KindBimod || kind == KindCombined)
+		{
+			bimod_ptr = &bimod[eip & (bimod_size - 1)];
+			bimod_prediction = *bimod_ptr > 1 ? PredictionTaken :
+					PredictionNotTaken;
+		}
+
+		// Two-level adaptive
+		if (kind == KindTwoLevel || kind == KindCombined)
+		{
+			bht_ptr = &two_level_bht[eip & (two_level_l1_size - 1)];
+			pht_ptr = &two_level_pht[*bht_ptr * two_level_l2_size +
+					(eip & (two_level_l2_size - 1))];
+			two_level_prediction = *pht_ptr > 1 ? PredictionTaken :
+					PredictionNotTaken;
+		}
+
+		// Combined
+		if (kind == KindCombined)
+		{
+			choice_ptr = &choice[eip & (choice_size - 1)];
+			choice_prediction = *choice_ptr > 1 ?
+					two_level_prediction :
+					bimod_prediction;
+		}
+
+		// Update bimodal predictor
+		if (kind == KindBimod || (kind == KindCombined &&
+				choice_prediction == PredictionNotTaken))
+		{
+			if (taken)
+				*bimod_ptr = *bimod_ptr + 1 > 3 ? 3 : *bimod_ptr + 1;
+			else
+				*bimod_ptr = *bimod_ptr - 1 < 0 ? 0 : *bimod_ptr - 1;
+		}
+
+		// Update two-level predictor
+		if (kind == KindTwoLevel || (kind == KindCombined &&
+				choice_prediction == PredictionTaken))
+		{
+			if (taken)
+				*pht_ptr = *pht_ptr + 1 > 3 ? 3 : *pht_ptr + 1;
+			else
+				*pht_ptr = *pht_ptr - 1 < 0 ? 0 : *pht_ptr - 1;
+			*bht_ptr = ((*bht_ptr << 1) | taken) &
+					(two_level_l2_height - 1);
+		}
+
+		// Update choice predictor
+		if (kind == KindCombined &&
+				bimod_prediction != two_level_prediction)
+		{
+			if (bimod_prediction == PredictionTaken)
+				*choice_ptr = *choice_ptr - 1 < 0 ? 0 : *choice_ptr - 1;
+			else
+				*choice_ptr = *choice_ptr + 1 > 3 ? 3 : *choice_ptr + 1;
+		}
+	}
+
+	// Branch target buffer
+	UpdateBtb(eip, neip);
+}
+
+
 unsigned int BranchPredictor::getNextBranch(unsigned int eip,
 		unsigned int block_size)
 {
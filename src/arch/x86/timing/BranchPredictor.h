@@ -142,6 +142,10 @@ private:
 	long long accesses = 0;
 	long long hits = 0;
 
+	// Update the BTB entry of the branch at address 'source' with the
+	// given target address.
+	void UpdateBtb(unsigned source, unsigned target);
+
 public:
 
 	//
@@ -269,6 +273,25 @@ public:
 	///
 	void UpdateBtb(Uop *uop);
 
+	/// Train the branch predictor, BTB, and RAS with a committed branch
+	/// executed functionally, outside of the pipeline. This is used to
+	/// warm up the predictor during sampled simulation. Statistics are
+	/// not updated.
+	///
+	/// \param uinst
+	///	Control micro-instruction
+	///
+	/// \param eip
+	///	Address of the macro-instruction
+	///
+	/// \param size
+	///	Size of the macro-instruction
+	///
+	/// \param neip
+	///	Address of the next macro-instruction executed
+	///
+	void Warm(Uinst *uinst, unsigned eip, unsigned size, unsigned neip);
+
 	/// Find address of next branch after eip within current block.
 	/// This is useful for accessing the trace cache. At that point, the
 	/// uop is not ready to call \c LookupBtb(), since functional simulation
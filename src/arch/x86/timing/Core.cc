@@ -17,6 +17,8 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
+
 #include "Core.h"
 #include "Cpu.h"
 #include "Timing.h"
@@ -28,7 +30,8 @@ namespace x86
 Core::Core(Cpu *cpu,
 		int id) :
 		cpu(cpu),
-		id(id)
+		id(id),
+		event_queue(Alu::getMaxOperationLatency() + 1)
 {
 	// Assign name
 	name = misc::fmt("Core %d", id);
@@ -53,26 +56,15 @@ void Core::InsertInEventQueue(std::shared_ptr<Uop> uop, int latency)
 	// Sanity
 	assert(!uop->in_event_queue);
 
+	// Record activity in the pipeline
+	cpu->setPipelineChanged();
+
 	// Set completion time for the instruction
 	assert(!uop->completed);
 	uop->complete_when = cpu->getCycle() + latency;
 
-	// Find position in event queue
-	auto it = event_queue.begin();
-	auto e = event_queue.end();
-	while (it != e)
-	{
-		// Check if position found
-		if (uop->Compare(it->get()) < 0)
-			break;
-
-		// Next
-		++it;
-	}
-
 	// Insert
-	uop->event_queue_iterator = event_queue.insert(it, uop);
-	uop->in_event_queue = true;
+	event_queue.Insert(uop);
 }
 
 
@@ -81,15 +73,11 @@ void Core::ExtractFromEventQueue(Uop *uop)
 	// Uop must be in the queue
 	assert(uop->in_event_queue);
 
-	// Save iterator
-	auto it = uop->event_queue_iterator;
+	// Record activity in the pipeline
+	cpu->setPipelineChanged();
 
-	// Indicate that the uop is not in the queue anymore
-	uop->in_event_queue = false;
-	uop->event_queue_iterator = event_queue.end();
-
-	// Remove it as the last step, as this may free the uop
-	event_queue.erase(it);
+	// Extract
+	event_queue.Extract(uop);
 }
 
 
@@ -307,16 +295,12 @@ void Core::Writeback()
 	// Traverse event queue
 	for (;;)
 	{
-		// No more elements in the event queue
-		if (event_queue.empty())
-			break;
-
-		// Pick uop from the head of the event queue
-		std::shared_ptr<Uop> uop = event_queue.front();
-
-		// If the uop is set to complete later than the current cycle,
-		// there is nothing else to extract from the event queue.
-		if (uop->complete_when > cpu->getCycle())
+		// Pick uop from the head of the event queue. If there is none
+		// or it is set to complete later than the current cycle, there
+		// is nothing else to extract from the event queue.
+		std::shared_ptr<Uop> uop = event_queue.getCompleted(
+				cpu->getCycle());
+		if (!uop)
 			break;
 
 		// Sanity
@@ -345,7 +329,7 @@ void Core::Writeback()
 		// loads that were squashed, or stores that committed before
 		// being issued.
 		if (uop->in_reorder_buffer)
-			Timing::trace << misc::fmt("x86.inst "
+			Timing::trace.fmt("x86.inst "
 					"id=%lld "
 					"core=%d "
 					"stg=\"wb\"\n",
@@ -452,6 +436,10 @@ void Core::Commit()
 
 void Core::Run()
 {
+	// Reset dispatch stalls of this cycle
+	for (auto &stall : cycle_dispatch_stall)
+		stall = 0;
+
 	// Run stages in reverse order
 	Commit();
 	Writeback();
@@ -461,5 +449,33 @@ void Core::Run()
 	Fetch();
 }
 
+
+long long Core::getWakeupCycle(long long cycle) const
+{
+	// Writeback of the first uop in the event queue
+	long long wakeup_cycle = event_queue.getFirstCompletion();
+
+	// Functional unit becoming free
+	wakeup_cycle = std::min(wakeup_cycle, alu.getWakeupCycle(cycle));
+
+	// Commit stall detection in threads
+	for (auto &thread : threads)
+		wakeup_cycle = std::min(wakeup_cycle, thread->getWakeupCycle());
+	return wakeup_cycle;
+}
+
+
+void Core::SkipCycles(long long cycle, long long num_cycles)
+{
+	// Dispatch stalls repeat in every skipped cycle
+	for (int i = 0; i < Thread::DispatchStallMax; i++)
+		dispatch_stall[i] += cycle_dispatch_stall[i] * num_cycles;
+
+	// Functional units and threads
+	alu.SkipCycles(cycle, num_cycles);
+	for (auto &thread : threads)
+		thread->SkipCycles(num_cycles);
+}
+
 }
 
@@ -27,6 +27,7 @@
 #include <arch/x86/emulator/Uinst.h>
 
 #include "Alu.h"
+#include "EventQueue.h"
 #include "Thread.h"
 
 
@@ -58,7 +59,7 @@ private:
 	Alu alu;
 
 	// Event queue
-	std::list<std::shared_ptr<Uop>> event_queue;
+	EventQueue event_queue;
 
 
 
@@ -138,6 +139,10 @@ private:
 	// Number of stalled micro-instruction when dispatch divded by reason
 	long long dispatch_stall[Thread::DispatchStallMax] = {};
 
+	// Dispatch stalls in the current cycle, used to update the counters
+	// above for cycles skipped while the core is idle
+	long long cycle_dispatch_stall[Thread::DispatchStallMax] = {};
+
 	// Number of dispatched micro-instructions for every opcode
 	long long num_dispatched_uinst_array[Uinst::OpcodeCount] = {};
 
@@ -290,21 +295,12 @@ public:
 	/// set to the current cycle plus \a latency in the function.
 	void InsertInEventQueue(std::shared_ptr<Uop> uop, int latency);
 
-	/// Extract uop from event queue. The given uop must be placed at the
-	/// head of the event queue.
+	/// Extract uop from event queue. The given uop must be currently
+	/// present in the event queue.
 	void ExtractFromEventQueue(Uop *uop);
 
-	/// Return an iterator to the first element of the event queue
-	std::list<std::shared_ptr<Uop>>::iterator getEventQueueBegin()
-	{
-		return event_queue.begin();
-	}
-
-	/// Return a past-the-end iterator to the event queue
-	std::list<std::shared_ptr<Uop>>::iterator getEventQueueEnd()
-	{
-		return event_queue.end();
-	}
+	/// Return the event queue
+	EventQueue *getEventQueue() { return &event_queue; }
 
 
 
@@ -400,6 +396,16 @@ public:
 	/// Commit stage
 	void Commit();
 
+	/// Return the earliest cycle after \a cycle, the last simulated one,
+	/// in which the core needs to run again, assuming that its pipelines
+	/// did not change in that cycle. Return the maximum value of type
+	/// `long long` if only an event can wake the core up.
+	long long getWakeupCycle(long long cycle) const;
+
+	/// Update per-cycle statistics for the given number of idle cycles
+	/// skipped after \a cycle, the last simulated one.
+	void SkipCycles(long long cycle, long long num_cycles);
+
 
 
 
@@ -413,6 +419,7 @@ public:
 	{
 		assert(stall > Thread::DispatchStallInvalid && stall < Thread::DispatchStallMax);
 		dispatch_stall[stall] += quantum;
+		cycle_dispatch_stall[stall] += quantum;
 	}
 
 	/// Return the counter for dispatch stalls of a particular reason.
@@ -78,6 +78,10 @@ int Cpu::context_quantum;
 int Cpu::thread_quantum;
 int Cpu::thread_switch_penalty;
 long long Cpu::num_fast_forward_instructions;
+long long Cpu::sampling_period;
+long long Cpu::sampling_warmup;
+long long Cpu::sampling_length;
+bool Cpu::sampling_functional_warming;
 long long Cpu::max_cycles = 0;
 int Cpu::recover_penalty;
 Cpu::RecoverKind Cpu::recover_kind;
@@ -142,6 +146,27 @@ void Cpu::ParseConfiguration(misc::IniFile *ini_file)
 	recover_kind = (RecoverKind)ini_file->ReadEnum(section, "RecoverKind",
 			recover_kind_map, RecoverKindWriteback);
 	recover_penalty = ini_file->ReadInt(section, "RecoverPenalty", 0);
+	num_fast_forward_instructions = ini_file->ReadInt64(section,
+			"FastForward", 0);
+
+	// Sampled simulation
+	sampling_period = ini_file->ReadInt64(section, "SamplingPeriod", 0);
+	sampling_warmup = ini_file->ReadInt64(section, "SamplingWarmup", 2000);
+	sampling_length = ini_file->ReadInt64(section, "SamplingLength", 1000);
+	sampling_functional_warming = ini_file->ReadBool(section,
+			"SamplingFunctionalWarming", true);
+	if (num_fast_forward_instructions < 0)
+		throw Timing::Error(misc::fmt("%s: Invalid value for 'FastForward'",
+				ini_file->getPath().c_str()));
+	if (sampling_period < 0 || sampling_warmup < 0 || sampling_length < 1)
+		throw Timing::Error(misc::fmt("%s: Invalid sampling parameters",
+				ini_file->getPath().c_str()));
+	if (sampling_period && sampling_period < sampling_warmup +
+			sampling_length)
+		throw Timing::Error(misc::fmt("%s: 'SamplingPeriod' must be at least "
+				"the sum of 'SamplingWarmup' and "
+				"'SamplingLength'",
+				ini_file->getPath().c_str()));
 
 	// Section '[ Pipeline ]'
 	section = "Pipeline";
@@ -179,6 +204,9 @@ void Cpu::ParseConfiguration(misc::IniFile *ini_file)
 
 void Cpu::Run()
 {
+	// No activity yet in this cycle
+	pipeline_changed = false;
+
 	// Invoke scheduler
 	Schedule();
 
@@ -188,6 +216,31 @@ void Cpu::Run()
 }
 
 
+long long Cpu::getWakeupCycle(long long cycle) const
+{
+	// Pipelines changed, or the emulator requested a scheduler call
+	Emulator *emulator = Emulator::getInstance();
+	if (pipeline_changed || emulator->schedule_signal)
+		return cycle + 1;
+
+	// Expiration of a context quantum
+	long long wakeup_cycle = min_context_allocate_cycle + context_quantum;
+
+	// Cores
+	for (auto &core : cores)
+		wakeup_cycle = std::min(wakeup_cycle,
+				core->getWakeupCycle(cycle));
+	return wakeup_cycle;
+}
+
+
+void Cpu::SkipCycles(long long cycle, long long num_cycles)
+{
+	for (auto &core : cores)
+		core->SkipCycles(cycle, num_cycles);
+}
+
+
 void Cpu::MemoryAccess(mem::Module *module,
 			mem::Module::AccessType access_type,
 			unsigned address,
@@ -243,12 +296,22 @@ long long Cpu::getCycle() const
 }
 
 
+bool Cpu::isPipelineEmpty() const
+{
+	for (auto &core : cores)
+		for (int i = 0; i < core->getNumThreads(); i++)
+			if (!core->getThread(i)->isPipelineEmpty())
+				return false;
+	return true;
+}
+
+
 void Cpu::InsertInTraceList(std::shared_ptr<Uop> uop)
 {
 	assert(Timing::trace == true);
 	assert(!uop->in_trace_list);
 	uop->in_trace_list = true;
-	uop->trace_list_iterator = trace_list.insert(trace_list.end(), uop);
+	trace_list.push_back(uop);
 }
 
 
@@ -263,10 +326,9 @@ void Cpu::EmptyTraceList()
 		// Remove from trace list
 		trace_list.pop_front();
 		uop->in_trace_list = false;
-		uop->trace_list_iterator = trace_list.end();
 
 		// Trace
-		Timing::trace << misc::fmt("x86.end_inst "
+		Timing::trace.fmt("x86.end_inst "
 				"id=%lld "
 				"core=%d\n",
 				uop->getIdInCore(),
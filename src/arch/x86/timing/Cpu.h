@@ -24,6 +24,7 @@
 #include <list>
 #include <vector>
 
+#include <lib/cpp/RingBuffer.h>
 #include <memory/Mmu.h>
 #include <memory/Module.h>
 #include <arch/x86/emulator/Emulator.h>
@@ -161,6 +162,20 @@ private:
 	// Number of fast forward instructions
 	static long long num_fast_forward_instructions;
 
+	// Number of instructions between the beginning of two consecutive
+	// samples in sampled simulation, or 0 if sampling is disabled
+	static long long sampling_period;
+
+	// Number of instructions simulated in detail before each sample is
+	// measured
+	static long long sampling_warmup;
+
+	// Number of instructions measured in each sample
+	static long long sampling_length;
+
+	// Warm up caches and branch predictors between samples
+	static bool sampling_functional_warming;
+
 
 
 	//
@@ -183,7 +198,16 @@ private:
 	std::string stage;
 
 	// List containing uops that need to report an 'end_inst' trace event 
-	std::list<std::shared_ptr<Uop>> trace_list;
+	misc::RingBuffer<std::shared_ptr<Uop>> trace_list;
+
+	// Flag indicating that no new instructions are fetched, to let the
+	// pipelines empty before switching to functional simulation
+	bool draining = false;
+
+	// Flag set whenever the state of any pipeline changes. It is cleared
+	// at the beginning of each cycle, so that an idle cycle can be told
+	// apart from the others.
+	bool pipeline_changed = true;
 
 
 
@@ -441,6 +465,24 @@ public:
 	/// Return the maximum number of cycles to simulate, as configured by
 	/// the user
 	static long long getMaxCycles() { return max_cycles; }
+
+	/// Return the number of instructions between consecutive samples in
+	/// sampled simulation, or 0 if sampling is disabled
+	static long long getSamplingPeriod() { return sampling_period; }
+
+	/// Return the number of instructions simulated in detail before each
+	/// sample is measured
+	static long long getSamplingWarmup() { return sampling_warmup; }
+
+	/// Return the number of instructions measured in each sample
+	static long long getSamplingLength() { return sampling_length; }
+
+	/// Return whether caches and branch predictors are warmed up during
+	/// functional simulation between samples
+	static bool getSamplingFunctionalWarming()
+	{
+		return sampling_functional_warming;
+	}
 	
 	/// Read branch predictor configuration from configuration file
 	static void ParseConfiguration(misc::IniFile *ini_file);
@@ -477,6 +519,16 @@ public:
 	/// classes Cpu and Timing.
 	long long getCycle() const;
 
+	/// Stop or resume instruction fetch in all threads. While draining,
+	/// instructions already in the pipelines continue to execute.
+	void setDraining(bool draining) { this->draining = draining; }
+
+	/// Return whether instruction fetch is stopped to drain the pipelines
+	bool isDraining() const { return draining; }
+
+	/// Return true if there is no uop in the pipeline of any thread
+	bool isPipelineEmpty() const;
+
 	/// Insert an uop into a list of uops that still need to dump an
 	/// 'end_inst' trace event. This will happen when the trace list is
 	/// emptied with a call to EmptyUopTraceList().
@@ -489,6 +541,20 @@ public:
 	/// Simulate one cycle of the CPU for all its cores and threads.
 	void Run();
 
+	/// Record that the state of a pipeline changed in the current cycle
+	void setPipelineChanged() { pipeline_changed = true; }
+
+	/// Return the earliest cycle after \a cycle, the last simulated one,
+	/// in which the CPU needs to run again, assuming that no event occurs
+	/// in the meantime. If the pipelines changed in \a cycle, this is the
+	/// next cycle. The maximum value of type `long long` is returned if
+	/// only an event can wake the CPU up.
+	long long getWakeupCycle(long long cycle) const;
+
+	/// Update per-cycle statistics of all cores for the given number of
+	/// idle cycles skipped after \a cycle.
+	void SkipCycles(long long cycle, long long num_cycles);
+
 	/// Update structure occupancy statistics
 	void UpdateOccupancyStats();
 
@@ -46,7 +46,7 @@ void Cpu::AllocateContext(Context *context)
 	thread->setFetchNeip(context->getRegs().getEip());
 
 	// Debug
-	Emulator::context_debug << misc::fmt("@%lld Context %d "
+	Emulator::context_debug.fmt("@%lld Context %d "
 			"allocated in Core %d Thread %d\n",
 			getCycle(),
 			context->getId(),
@@ -54,7 +54,7 @@ void Cpu::AllocateContext(Context *context)
 			thread->getIdInCore());
 
 	// Trace
-	Timing::trace << misc::fmt("x86.map_ctx "
+	Timing::trace.fmt("x86.map_ctx "
 			"ctx=%d "
 			"core=%d "
 			"thread=%d "
@@ -149,13 +149,16 @@ void Cpu::Schedule()
 	if (!quantum_expired && !emulator->schedule_signal)
 		return;
 
+	// Scheduling may map, evict, or allocate contexts
+	setPipelineChanged();
+
 	// Debug
 	if (Emulator::context_debug)
 	{
-		Emulator::context_debug << misc::fmt("@%lld Schedule: ",
+		Emulator::context_debug.fmt("@%lld Schedule: ",
 				getCycle());
 		if (quantum_expired)
-			Emulator::context_debug << misc::fmt("quantum expired "
+			Emulator::context_debug.fmt("quantum expired "
 					"(set at %lld)\n",
 					min_context_allocate_cycle);
 		else if (emulator->schedule_signal)
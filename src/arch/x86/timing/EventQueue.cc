@@ -0,0 +1,191 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <limits>
+
+#include "EventQueue.h"
+#include "Uop.h"
+
+
+namespace x86
+{
+
+EventQueue::EventQueue(int num_buckets) :
+		num_buckets(num_buckets),
+		buckets(num_buckets)
+{
+	assert(num_buckets > 0);
+}
+
+
+std::list<std::shared_ptr<Uop>> &EventQueue::getList(long long complete_when)
+{
+	assert(complete_when >= cycle);
+	if (complete_when < cycle + num_buckets)
+		return buckets[complete_when % num_buckets];
+	else
+		return overflow;
+}
+
+
+void EventQueue::InsertInList(std::list<std::shared_ptr<Uop>> &list,
+		std::shared_ptr<Uop> uop)
+{
+	// Find position. Uops are usually inserted after those already in
+	// the list, so it is traversed from the tail.
+	auto it = list.end();
+	while (it != list.begin() && uop->Compare(std::prev(it)->get()) < 0)
+		--it;
+
+	// Insert
+	uop->event_queue_iterator = list.insert(it, uop);
+}
+
+
+void EventQueue::Advance(long long cycle)
+{
+	// Move window
+	assert(cycle > this->cycle);
+	this->cycle = cycle;
+
+	// Move uops from the overflow list that fall now within the window
+	// into their bucket.
+	while (overflow.size() && overflow.front()->complete_when <
+			cycle + num_buckets)
+	{
+		std::shared_ptr<Uop> uop = overflow.front();
+		overflow.pop_front();
+		InsertInList(buckets[uop->complete_when % num_buckets], uop);
+		wheel_size++;
+	}
+}
+
+
+void EventQueue::Insert(std::shared_ptr<Uop> uop)
+{
+	// Sanity
+	assert(!uop->in_event_queue);
+
+	// Insert in bucket or overflow list
+	auto &list = getList(uop->complete_when);
+	InsertInList(list, uop);
+	uop->in_event_queue = true;
+	if (&list != &overflow)
+		wheel_size++;
+	size++;
+}
+
+
+void EventQueue::Extract(Uop *uop)
+{
+	// Sanity
+	assert(uop->in_event_queue);
+
+	// Save iterator
+	auto &list = getList(uop->complete_when);
+	auto it = uop->event_queue_iterator;
+
+	// Indicate that the uop is not in the queue anymore
+	uop->in_event_queue = false;
+	uop->event_queue_iterator = list.end();
+	if (&list != &overflow)
+		wheel_size--;
+	size--;
+
+	// Remove it as the last step, as this may free the uop
+	list.erase(it);
+}
+
+
+std::shared_ptr<Uop> EventQueue::getCompleted(long long cycle)
+{
+	// Look for the first non-empty bucket up to the given cycle
+	assert(cycle >= this->cycle);
+	while (size)
+	{
+		// Uops in this bucket complete in the current window cycle
+		auto &bucket = buckets[this->cycle % num_buckets];
+		if (bucket.size())
+			return bucket.front();
+
+		// Nothing else completes up to the given cycle
+		if (this->cycle == cycle)
+			return nullptr;
+
+		// If the wheel is empty, jump directly to the cycle of the
+		// first uop in the overflow list. Otherwise, go to the next
+		// bucket.
+		if (!wheel_size)
+			Advance(std::min(cycle, overflow.front()->complete_when));
+		else
+			Advance(this->cycle + 1);
+	}
+
+	// The queue is empty, move the window to the given cycle
+	if (this->cycle < cycle)
+		Advance(cycle);
+	return nullptr;
+}
+
+
+long long EventQueue::getFirstCompletion() const
+{
+	// Empty queue
+	if (!size)
+		return std::numeric_limits<long long>::max();
+
+	// First non-empty bucket in the window
+	if (wheel_size)
+	{
+		for (long long cycle = this->cycle; ; cycle++)
+			if (buckets[cycle % num_buckets].size())
+				return cycle;
+	}
+
+	// First uop in the overflow list
+	return overflow.front()->complete_when;
+}
+
+
+void EventQueue::ExtractSpeculative(Thread *thread)
+{
+	// Traverse buckets and overflow list
+	for (int i = 0; i <= num_buckets; i++)
+	{
+		auto &list = i < num_buckets ? buckets[i] : overflow;
+		auto it = list.begin();
+		auto e = list.end();
+		while (it != e)
+		{
+			// Get instruction
+			Uop *uop = it->get();
+			++it;
+
+			// Remove if it is a speculative uop in the given thread
+			if (uop->getThread() == thread && uop->speculative_mode)
+				Extract(uop);
+		}
+	}
+}
+
+
+}  // namespace x86
@@ -0,0 +1,121 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ARCH_X86_TIMING_EVENT_QUEUE_H
+#define ARCH_X86_TIMING_EVENT_QUEUE_H
+
+#include <list>
+#include <memory>
+#include <vector>
+
+
+namespace x86
+{
+
+// Forward declarations
+class Thread;
+class Uop;
+
+
+/// Queue of uops in flight in a core, waiting for their completion cycle,
+/// given in field `complete_when` of the uop. Uops are extracted in
+/// increasing order of completion cycle, and uops completing in the same
+/// cycle in increasing order of identifier, as given by Uop::Compare().
+///
+/// The queue is implemented as a timing wheel. A circular array of buckets
+/// covers a window of upcoming cycles, with one bucket per cycle. Uops
+/// completing beyond the window, such as those with long functional unit
+/// latencies, are kept in a sorted overflow list, and moved into the wheel
+/// as the window advances. Insertion in the wheel only needs to order the
+/// uops completing in the same cycle, and finding the next uop to complete
+/// takes constant time.
+class EventQueue
+{
+	// Number of buckets in the wheel
+	int num_buckets;
+
+	// Circular array of buckets. The bucket for a cycle within the window
+	// contains the uops completing in that cycle, sorted by identifier.
+	std::vector<std::list<std::shared_ptr<Uop>>> buckets;
+
+	// Uops completing beyond the window, sorted by completion cycle and
+	// identifier.
+	std::list<std::shared_ptr<Uop>> overflow;
+
+	// First cycle in the window. No uop in the queue completes earlier,
+	// and all uops completing before 'cycle + num_buckets' are in the
+	// wheel.
+	long long cycle = 0;
+
+	// Total number of uops in the queue
+	int size = 0;
+
+	// Number of uops in the wheel, not counting the overflow list
+	int wheel_size = 0;
+
+	// Return the list where a uop completing in the given cycle belongs,
+	// either its bucket in the wheel or the overflow list.
+	std::list<std::shared_ptr<Uop>> &getList(long long complete_when);
+
+	// Insert a uop in a list, keeping it sorted
+	void InsertInList(std::list<std::shared_ptr<Uop>> &list,
+			std::shared_ptr<Uop> uop);
+
+	// Move the window to start at the given cycle. All buckets of the
+	// cycles left behind must be empty.
+	void Advance(long long cycle);
+
+public:
+
+	/// Constructor. The wheel covers \a num_buckets cycles, which should
+	/// be greater than the common latencies of uops inserted in the queue.
+	EventQueue(int num_buckets);
+
+	/// Insert a uop in the queue. Its field `complete_when` must be set
+	/// already, and must not be earlier than the last cycle passed to
+	/// getCompleted().
+	void Insert(std::shared_ptr<Uop> uop);
+
+	/// Extract a uop from the queue. The uop must be currently present in
+	/// the queue.
+	void Extract(Uop *uop);
+
+	/// Return the first uop in the queue if it completes in \a cycle or
+	/// earlier, or `nullptr` otherwise. Calls to this function must be
+	/// made with non-decreasing values of \a cycle.
+	std::shared_ptr<Uop> getCompleted(long long cycle);
+
+	/// Return the completion cycle of the first uop in the queue, or the
+	/// maximum value of type `long long` if the queue is empty.
+	long long getFirstCompletion() const;
+
+	/// Extract all uops of the given thread that are in speculative mode
+	void ExtractSpeculative(Thread *thread);
+
+	/// Return the number of uops in the queue
+	int getSize() const { return size; }
+
+	/// Return whether the queue is empty
+	bool isEmpty() const { return size == 0; }
+};
+
+
+}  // namespace x86
+
+#endif
@@ -17,6 +17,9 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
+#include <limits>
+
 #include "FunctionalUnit.h"
 #include "Timing.h"
 
@@ -82,6 +85,12 @@ int FunctionalUnit::Reserve(Uop *uop)
 
 	// No free instance found
 	num_denied_accesses++;
+	if (denied_cycle != cycle)
+	{
+		denied_cycle = cycle;
+		num_cycle_denied_accesses = 0;
+	}
+	num_cycle_denied_accesses++;
 	return 0;
 }
 
@@ -93,5 +102,22 @@ void FunctionalUnit::Release()
 		cycle_free[i] = 0;
 }
 
+
+
+long long FunctionalUnit::getWakeupCycle(long long cycle) const
+{
+	long long wakeup_cycle = std::numeric_limits<long long>::max();
+	for (int i = 0; i < num_instances; i++)
+		if (cycle_free[i] > cycle)
+			wakeup_cycle = std::min(wakeup_cycle, cycle_free[i]);
+	return wakeup_cycle;
+}
+
+
+void FunctionalUnit::SkipCycles(long long cycle, long long num_cycles)
+{
+	if (denied_cycle == cycle)
+		num_denied_accesses += num_cycle_denied_accesses * num_cycles;
 }
 
+}
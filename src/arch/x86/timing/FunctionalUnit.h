@@ -108,6 +108,11 @@ private:
 	// Number of times that this functional unit was denied
 	long long num_denied_accesses = 0;
 
+	// Last cycle when an access was denied, and number of accesses denied
+	// in that cycle
+	long long denied_cycle = -1;
+	int num_cycle_denied_accesses = 0;
+
 	// Waiting time of functional unit
 	long long waiting_time = 0;
 
@@ -142,6 +147,15 @@ public:
 	/// Release all instances of this functional unit
 	void Release();
 
+	/// Return the earliest cycle after \a cycle in which a busy instance
+	/// becomes free, or the maximum value of type `long long` if no
+	/// instance is busy.
+	long long getWakeupCycle(long long cycle) const;
+
+	/// Repeat the accesses denied in \a cycle for the given number of
+	/// idle cycles skipped after it.
+	void SkipCycles(long long cycle, long long num_cycles);
+
 
 
 	//
@@ -262,7 +262,7 @@ int RegisterFile::RequestIntegerRegister()
 	assert(!integer_registers[physical_register].pending);
 
 	// Debug
-	debug << misc::fmt("  Integer register %d allocated, %d available\n",
+	debug.fmt("  Integer register %d allocated, %d available\n",
 			physical_register, num_free_integer_registers);
 
 	// Return allocated register
@@ -282,7 +282,7 @@ int RegisterFile::RequestFloatingPointRegister()
 	assert(!floating_point_registers[physical_register].pending);
 
 	// Debug
-	debug << misc::fmt("  Floating-point register %d allocated, "
+	debug.fmt("  Floating-point register %d allocated, "
 			"%d available\n",
 			physical_register,
 			num_free_floating_point_registers);
@@ -304,7 +304,7 @@ int RegisterFile::RequestXmmRegister()
 	assert(!xmm_registers[physical_register].pending);
 
 	// Debug
-	debug << misc::fmt("  XMM register %d allocated, %d available\n",
+	debug.fmt("  XMM register %d allocated, %d available\n",
 			physical_register,
 			num_free_xmm_registers);
 
@@ -372,7 +372,7 @@ void RegisterFile::Rename(Uop *uop)
 		floating_point_top = (floating_point_top + 1) % 8;
 
 		// Debug
-		debug << misc::fmt("  Floating-point stack popped, top = %d\n",
+		debug.fmt("  Floating-point stack popped, top = %d\n",
 				floating_point_top);
 	}
 	else if (uop->getOpcode() == Uinst::OpcodeFpPush)
@@ -381,7 +381,7 @@ void RegisterFile::Rename(Uop *uop)
 		floating_point_top = (floating_point_top + 7) % 8;
 
 		// Debug
-		debug << misc::fmt("  Floating-point stack pushed, top = %d\n",
+		debug.fmt("  Floating-point stack pushed, top = %d\n",
 				floating_point_top);
 	}
 
@@ -610,6 +610,57 @@ bool RegisterFile::isUopReady(Uop *uop)
 }
 
 
+bool RegisterFile::WatchUop(std::shared_ptr<Uop> uop)
+{
+	// Traverse dependencies
+	uop->num_pending_inputs = 0;
+	for (int dep = 0; dep < Uinst::MaxIDeps; dep++)
+	{
+		// Get dependencies
+		int logical_register = uop->getUinst()->getIDep(dep);
+		int physical_register = uop->getInput(dep);
+
+		// Physical register read by this input
+		PhysicalRegister *reg;
+		if (Uinst::isIntegerDependency(logical_register))
+			reg = &integer_registers[physical_register];
+		else if (Uinst::isFloatingPointDependency(logical_register))
+			reg = &floating_point_registers[physical_register];
+		else if (Uinst::isXmmDependency(logical_register))
+			reg = &xmm_registers[physical_register];
+		else
+			continue;
+
+		// Wait for the register if its value is still being computed
+		if (reg->pending)
+		{
+			reg->consumers.push_back(uop);
+			uop->num_pending_inputs++;
+		}
+	}
+
+	// Return whether all inputs are available
+	return uop->num_pending_inputs == 0;
+}
+
+
+void RegisterFile::WriteRegister(PhysicalRegister &physical_register)
+{
+	// Result is available
+	physical_register.pending = false;
+
+	// Wake up consumers with no more pending inputs
+	for (auto &uop : physical_register.consumers)
+	{
+		assert(uop->num_pending_inputs > 0);
+		uop->num_pending_inputs--;
+		if (!uop->num_pending_inputs)
+			thread->WakeupUop(uop);
+	}
+	physical_register.consumers.clear();
+}
+
+
 void RegisterFile::WriteUop(Uop *uop)
 {
 
@@ -618,11 +669,11 @@ void RegisterFile::WriteUop(Uop *uop)
 		int logical_register = uop->getUinst()->getODep(dep);
 		int physical_register = uop->getOutput(dep);
 		if (Uinst::isIntegerDependency(logical_register))
-			integer_registers[physical_register].pending = false;
+			WriteRegister(integer_registers[physical_register]);
 		else if (Uinst::isFloatingPointDependency(logical_register))
-			floating_point_registers[physical_register].pending = false;
+			WriteRegister(floating_point_registers[physical_register]);
 		else if (Uinst::isXmmDependency(logical_register))
-			xmm_registers[physical_register].pending = false;
+			WriteRegister(xmm_registers[physical_register]);
 	}
 }
 
@@ -663,7 +714,7 @@ void RegisterFile::UndoUop(Uop *uop)
 				num_occupied_integer_registers--;
 
 				// Debug
-				debug << misc::fmt("  Integer register %d freed\n",
+				debug.fmt("  Integer register %d freed\n",
 						physical_register);
 			}
 
@@ -706,7 +757,7 @@ void RegisterFile::UndoUop(Uop *uop)
 				num_occupied_floating_point_registers--;
 
 				// Debug
-				debug << misc::fmt("  Floating-point register %d freed\n",
+				debug.fmt("  Floating-point register %d freed\n",
 						physical_register);
 			}
 
@@ -742,7 +793,7 @@ void RegisterFile::UndoUop(Uop *uop)
 				num_occupied_xmm_registers--;
 
 				// Debug
-				debug << misc::fmt("  XMM register %d freed\n",
+				debug.fmt("  XMM register %d freed\n",
 						physical_register);
 			}
 
@@ -814,7 +865,7 @@ void RegisterFile::CommitUop(Uop *uop)
 				num_occupied_integer_registers--;
 
 				// Debug
-				debug << misc::fmt("  Integer register %d freed\n",
+				debug.fmt("  Integer register %d freed\n",
 						physical_register);
 			}
 		}
@@ -840,7 +891,7 @@ void RegisterFile::CommitUop(Uop *uop)
 				num_occupied_floating_point_registers--;
 
 				// Debug
-				debug << misc::fmt("  Floating-point register %d freed\n",
+				debug.fmt("  Floating-point register %d freed\n",
 						physical_register);
 			}
 		}
@@ -866,7 +917,7 @@ void RegisterFile::CommitUop(Uop *uop)
 				num_occupied_xmm_registers--;
 
 				// Debug
-				debug << misc::fmt("  XMM register %d freed\n",
+				debug.fmt("  XMM register %d freed\n",
 						physical_register);
 			}
 		}
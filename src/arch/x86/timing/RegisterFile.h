@@ -20,6 +20,9 @@
 #ifndef ARCH_X86_TIMING_REGISTER_FILE_H
 #define ARCH_X86_TIMING_REGISTER_FILE_H
 
+#include <memory>
+#include <vector>
+
 #include <lib/cpp/Debug.h>
 #include <lib/cpp/IniFile.h>
 #include <arch/x86/emulator/Uinst.h>
@@ -80,8 +83,17 @@ private:
 
 		// Number of logical registers mapped to this physical register
 		int busy = 0;
+
+		// Uops waiting for the result of this physical register, woken
+		// up when it is written back. A uop appears once for each of
+		// its input operands mapped to this register.
+		std::vector<std::shared_ptr<Uop>> consumers;
 	};
 
+	// Clear the pending flag of a physical register, and wake up the
+	// consumers for which it was the last pending input.
+	void WriteRegister(PhysicalRegister &physical_register);
+
 
 
 
@@ -286,6 +298,12 @@ public:
 	/// Check if input dependencies are resolved
 	bool isUopReady(Uop *uop);
 
+	/// Register a renamed uop as a consumer of those of its input
+	/// registers that are still pending, and return true if there are
+	/// none. Otherwise, the uop is passed to Thread::WakeupUop() as soon
+	/// as the last of them is written back.
+	bool WatchUop(std::shared_ptr<Uop> uop);
+
 	/// Update the state of the register file when an uop completes, that
 	/// is, when its results are written back.
 	void WriteUop(Uop *uop);
@@ -17,6 +17,8 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <iterator>
+
 #include "Cpu.h"
 #include "Timing.h"
 #include "Thread.h"
@@ -33,7 +35,8 @@ const misc::StringMap Thread::fetch_stall_map =
 	{ "Context", FetchStallContext },
 	{ "Suspended", FetchStallSuspended },
 	{ "FetchQueue", FetchStallFetchQueue },
-	{ "InstructionMemory", FetchStallInstructionMemory }
+	{ "InstructionMemory", FetchStallInstructionMemory },
+	{ "Drain", FetchStallDrain }
 };
 
 
@@ -76,6 +79,15 @@ Thread::Thread(Core *core,
 
 	// Initialize register file
 	register_file = misc::new_unique<RegisterFile>(this);
+
+	// Allocate pipeline queues for their configured size, so that they
+	// don't need to grow during the simulation in the common case. The
+	// fetch queue size is given in bytes, which bounds the number of
+	// macro-instructions it holds.
+	fetch_queue.reserve(Cpu::getFetchQueueSize());
+	uop_queue.reserve(Cpu::getUopQueueSize());
+	reorder_buffer.reserve(Cpu::getReorderBufferSize());
+	store_queue.reserve(Cpu::getLoadStoreQueueSize());
 }
 
 
@@ -110,7 +122,7 @@ void Thread::InsertInFetchQueue(std::shared_ptr<Uop> uop)
 
 	// Insert in queue
 	uop->in_fetch_queue = true;
-	uop->fetch_queue_iterator = fetch_queue.insert(fetch_queue.end(), uop);
+	fetch_queue.push_back(uop);
 
 	// Increase occupancy of fetch queue or trace queue
 	if (uop->from_trace_cache)
@@ -135,17 +147,15 @@ void Thread::ExtractFromFetchQueue(Uop *uop)
 	// Sanity: uop must be in the fetch queue, and must be either the first
 	// or the last element in it.
 	assert(uop->in_fetch_queue);
-	assert(uop->fetch_queue_iterator != fetch_queue.end());
 	assert(fetch_queue.size() > 0);
 	assert(uop == fetch_queue.front().get() ||
 			uop == fetch_queue.back().get());
 	
-	// Save iterator
-	auto it = uop->fetch_queue_iterator;
+	// Record activity in the pipeline
+	cpu->setPipelineChanged();
 
 	// Mark uop as extracted
 	uop->in_fetch_queue = false;
-	uop->fetch_queue_iterator = fetch_queue.end();
 
 	// Decrease occupancy of fetch queue or trace queue
 	if (uop->from_trace_cache)
@@ -168,7 +178,10 @@ void Thread::ExtractFromFetchQueue(Uop *uop)
 	}
 
 	// Extract uop as last step, since uop may be freed here
-	fetch_queue.erase(it);
+	if (uop == fetch_queue.front().get())
+		fetch_queue.pop_front();
+	else
+		fetch_queue.pop_back();
 }
 
 
@@ -201,7 +214,7 @@ void Thread::InsertInUopQueue(std::shared_ptr<Uop> uop)
 {
 	assert(!uop->in_uop_queue);
 	uop->in_uop_queue = true;
-	uop->uop_queue_iterator = uop_queue.insert(uop_queue.end(), uop);
+	uop_queue.push_back(uop);
 }
 
 
@@ -211,17 +224,20 @@ void Thread::ExtractFromUopQueue(Uop *uop)
 	// or the last element in it.
 	assert(uop->in_uop_queue);
 	assert(uop_queue.size() > 0);
-	assert(uop == uop_queue.front().get() || uop_queue.back().get());
+	assert(uop == uop_queue.front().get() ||
+			uop == uop_queue.back().get());
 
-	// Save iterator
-	auto it = uop->uop_queue_iterator;
+	// Record activity in the pipeline
+	cpu->setPipelineChanged();
 
 	// Mark uop as extracted
 	uop->in_uop_queue = false;
-	uop->uop_queue_iterator = uop_queue.end();
 
 	// Extract uop as last step, since this may free it
-	uop_queue.erase(it);
+	if (uop == uop_queue.front().get())
+		uop_queue.pop_front();
+	else
+		uop_queue.pop_back();
 }
 
 
@@ -285,7 +301,7 @@ void Thread::InsertInReorderBuffer(std::shared_ptr<Uop> uop)
 
 	// Insert into reorder buffer
 	uop->in_reorder_buffer = true;
-	uop->reorder_buffer_iterator = reorder_buffer.insert(reorder_buffer.end(), uop);
+	reorder_buffer.push_back(uop);
 
 	// Increase per-core counter
 	core->incReorderBufferOccupancy();
@@ -298,17 +314,20 @@ void Thread::ExtractFromReorderBuffer(Uop *uop)
 	// first or the last instruction in that queue.
 	assert(uop->in_reorder_buffer);
 	assert(reorder_buffer.size() > 0);
-	assert(uop == reorder_buffer.front().get() || reorder_buffer.back().get());
+	assert(uop == reorder_buffer.front().get() ||
+			uop == reorder_buffer.back().get());
 
-	// Save iterator
-	auto it = uop->reorder_buffer_iterator;
+	// Record activity in the pipeline
+	cpu->setPipelineChanged();
 
 	// Mark uop as extracted
 	uop->in_reorder_buffer = false;
-	uop->reorder_buffer_iterator = reorder_buffer.end();
 
 	// Extract uop as last step, since this may free it
-	reorder_buffer.erase(it);
+	if (uop == reorder_buffer.front().get())
+		reorder_buffer.pop_front();
+	else
+		reorder_buffer.pop_back();
 
 	// Decrease per-core counter
 	core->decReorderBufferOccupancy();
@@ -420,6 +439,13 @@ void Thread::ExtractFromInstructionQueue(Uop *uop)
 	assert(!uop->in_store_queue);
 	assert(uop->in_instruction_queue);
 
+	// Record activity in the pipeline
+	cpu->setPipelineChanged();
+
+	// Remove from ready list
+	if (uop->in_ready_list)
+		ExtractFromReadyList(uop);
+
 	// Save iterator
 	auto it = uop->instruction_queue_iterator;
 
@@ -506,7 +532,7 @@ void Thread::InsertInLoadStoreQueue(std::shared_ptr<Uop> uop)
 
 	case Uinst::OpcodeStore:
 
-		uop->store_queue_iterator = store_queue.insert(store_queue.end(), uop);
+		store_queue.push_back(uop);
 		uop->in_store_queue = true;
 		break;
 	
@@ -527,6 +553,13 @@ void Thread::ExtractFromLoadQueue(Uop *uop)
 	assert(!uop->in_store_queue);
 	assert(!uop->in_instruction_queue);
 
+	// Record activity in the pipeline
+	cpu->setPipelineChanged();
+
+	// Remove from ready list
+	if (uop->in_ready_list)
+		ExtractFromReadyList(uop);
+
 	// Save iterator
 	auto it = uop->load_queue_iterator;
 
@@ -548,22 +581,81 @@ void Thread::ExtractFromStoreQueue(Uop *uop)
 	assert(!uop->in_instruction_queue);
 	assert(!uop->in_load_queue);
 	assert(uop->in_store_queue);
+	assert(uop == store_queue.front().get() ||
+			uop == store_queue.back().get());
 
-	// Save iterator
-	auto it = uop->store_queue_iterator;
+	// Record activity in the pipeline
+	cpu->setPipelineChanged();
 
 	// Mark as not present in the queue
 	uop->in_store_queue = false;
-	uop->store_queue_iterator = store_queue.end();
 
 	// Remove from queue as last step, as this may free uop
-	store_queue.erase(it);
+	if (uop == store_queue.front().get())
+		store_queue.pop_front();
+	else
+		store_queue.pop_back();
 
 	// Decrease per-core counter
 	core->decLoadStoreQueueOccupancy();
 }
 
 
+void Thread::InsertInReadyList(std::shared_ptr<Uop> uop)
+{
+	// Sanity
+	assert(uop->in_instruction_queue || uop->in_load_queue);
+	assert(!uop->in_ready_list);
+
+	// Find the position after the last older uop. Uops usually become
+	// ready in program order, so the list is traversed from the tail.
+	auto &ready_list = uop->in_instruction_queue ?
+			instruction_ready_list : load_ready_list;
+	auto it = ready_list.end();
+	while (it != ready_list.begin() &&
+			(*std::prev(it))->getId() > uop->getId())
+		--it;
+
+	// Insert
+	uop->in_ready_list = true;
+	uop->ready_list_iterator = ready_list.insert(it, uop);
+}
+
+
+void Thread::ExtractFromReadyList(Uop *uop)
+{
+	// Sanity
+	assert(uop->in_instruction_queue || uop->in_load_queue);
+	assert(uop->in_ready_list);
+
+	// Save iterator
+	auto &ready_list = uop->in_instruction_queue ?
+			instruction_ready_list : load_ready_list;
+	auto it = uop->ready_list_iterator;
+
+	// Mark as not present in the list
+	uop->in_ready_list = false;
+	uop->ready_list_iterator = ready_list.end();
+
+	// Remove from list as last step, as this may free uop
+	ready_list.erase(it);
+}
+
+
+void Thread::WakeupUop(std::shared_ptr<Uop> uop)
+{
+	// Mark uop as ready
+	assert(!uop->num_pending_inputs);
+	uop->ready = true;
+	uop->ready_when = cpu->getCycle();
+
+	// Make it a candidate for issue. Uops that were squashed or that are
+	// in the store queue are not issued from a ready list.
+	if (uop->in_instruction_queue || uop->in_load_queue)
+		InsertInReadyList(uop);
+}
+
+
 void Thread::DumpLoadStoreQueue(std::ostream &os) const
 {
 	// Load queue
@@ -23,6 +23,7 @@
 #include <deque>
 #include <string>
 
+#include <lib/cpp/RingBuffer.h>
 #include <memory/Module.h>
 #include <arch/x86/emulator/Uinst.h>
 #include <arch/x86/emulator/Context.h>
@@ -82,7 +83,7 @@ private:
 	//
 
 	// Fetch queue
-	std::list<std::shared_ptr<Uop>> fetch_queue;
+	misc::RingBuffer<std::shared_ptr<Uop>> fetch_queue;
 
 	// Insert a uop into the tail of the fetch queue
 	void InsertInFetchQueue(std::shared_ptr<Uop> uop);
@@ -102,7 +103,7 @@ private:
 	//
 
 	// Uop queue
-	std::list<std::shared_ptr<Uop>> uop_queue;
+	misc::RingBuffer<std::shared_ptr<Uop>> uop_queue;
 
 	// Insert a uop into the tail of the uop queue
 	void InsertInUopQueue(std::shared_ptr<Uop> uop);
@@ -122,7 +123,7 @@ private:
 	//
 
 	// Reorder buffer
-	std::list<std::shared_ptr<Uop>> reorder_buffer;
+	misc::RingBuffer<std::shared_ptr<Uop>> reorder_buffer;
 
 	// Insert a uop into the tail of the reorder buffer
 	void InsertInReorderBuffer(std::shared_ptr<Uop> uop);
@@ -150,6 +151,10 @@ private:
 	// Instruction queue
 	std::list<std::shared_ptr<Uop>> instruction_queue;
 
+	// Uops in the instruction queue whose input operands are available,
+	// in program order. Only these are considered by the issue stage.
+	std::list<std::shared_ptr<Uop>> instruction_ready_list;
+
 	// Insert a uop into the tail of the instruction queue
 	void InsertInInstructionQueue(std::shared_ptr<Uop> uop);
 
@@ -175,8 +180,22 @@ private:
 	// Load queue
 	std::list<std::shared_ptr<Uop>> load_queue;
 
-	// Store queue
-	std::list<std::shared_ptr<Uop>> store_queue;
+	// Store queue. Stores are inserted in program order and leave the
+	// queue either from the head, when they issue after commit, or from
+	// the tail, when they are squashed.
+	misc::RingBuffer<std::shared_ptr<Uop>> store_queue;
+
+	// Uops in the load queue whose input operands are available, in
+	// program order.
+	std::list<std::shared_ptr<Uop>> load_ready_list;
+
+	// Insert a uop present in the instruction queue or load queue into
+	// the corresponding ready list, keeping the list sorted by age.
+	void InsertInReadyList(std::shared_ptr<Uop> uop);
+
+	// Remove a uop from the ready list of the instruction queue or load
+	// queue. The uop must be currently present in said list.
+	void ExtractFromReadyList(Uop *uop);
 
 	// Determine whether a new uop can be inserted into this thread's
 	// load-store queue, based on whether the queue was configured as
@@ -192,8 +211,8 @@ private:
 	// in said queue.
 	void ExtractFromLoadQueue(Uop *uop);
 
-	// Remove a uop from the store queue. The uop must be currently present
-	// in said queue.
+	// Remove a uop from the store queue. The uop must be located either
+	// at the head or at the tail of the store queue.
 	void ExtractFromStoreQueue(Uop *uop);
 
 	// Dump content of load_store queue
@@ -379,6 +398,11 @@ public:
 	/// Return the thread's register file
 	RegisterFile *getRegisterFile() const { return register_file.get(); }
 
+	/// Mark a uop as ready once all its input operands are available. If
+	/// the uop is waiting in the instruction queue or load queue, it
+	/// becomes a candidate for issue.
+	void WakeupUop(std::shared_ptr<Uop> uop);
+
 	/// Increment the number of writes to integer registers
 	void incNumIntegerRegisterWrites(int count = 1)
 	{
@@ -412,7 +436,8 @@ public:
 		FetchStallContext,		// No context mapped to thread
 		FetchStallSuspended,		// Mapped context is suspended
 		FetchStallFetchQueue,		// Fetch queue is full
-		FetchStallInstructionMemory	// Instruction memory is busy
+		FetchStallInstructionMemory,	// Instruction memory is busy
+		FetchStallDrain			// Pipeline is being drained
 	};
 
 	/// String map for values of type FetchStall
@@ -449,6 +474,17 @@ public:
 	/// Fetch stage function
 	void Fetch();
 
+	/// Warm up the branch predictor and the caches with the last
+	/// instruction emulated by \a context outside of the pipeline, using
+	/// the micro-instructions it generated. The context must be mapped to
+	/// this thread.
+	void Warm(Context *context);
+
+	/// Restart instruction fetch at the current instruction pointer of
+	/// the allocated context, after the context advanced outside of the
+	/// pipeline. The pipeline must be empty.
+	void ResetFetch();
+
 	/// Get the fetch queue size in number of uops
 	int getFetchQueueSize() const { return fetch_queue.size(); }
 
@@ -528,6 +564,30 @@ public:
 	/// The function returns the remaining quantum.
 	int IssueInstructionQueue(int quantum);
 
+	/// Return the instruction queue
+	const std::list<std::shared_ptr<Uop>> &getInstructionQueue() const
+	{
+		return instruction_queue;
+	}
+
+	/// Return the uops of the instruction queue considered for issue
+	const std::list<std::shared_ptr<Uop>> &getInstructionReadyList() const
+	{
+		return instruction_ready_list;
+	}
+
+	/// Return the load queue
+	const std::list<std::shared_ptr<Uop>> &getLoadQueue() const
+	{
+		return load_queue;
+	}
+
+	/// Return the uops of the load queue considered for issue
+	const std::list<std::shared_ptr<Uop>> &getLoadReadyList() const
+	{
+		return load_ready_list;
+	}
+
 
 
 
@@ -538,12 +598,25 @@ public:
 	/// Error message for stalls
 	static const char *commit_stall_error;
 
+	/// Number of cycles without committing a uop after which a thread
+	/// with a running context is considered deadlocked
+	static const long long commit_stall_cycles = 1000000;
+
 	/// Return true if at least one uop can be committed for the thread
 	bool canCommit();
 
 	/// Commit stage for the thread
 	void Commit(int quantum);
 
+	/// Return the cycle in which the commit stall detection triggers if
+	/// no uop commits, or the maximum value of type `long long` if the
+	/// thread has no running context.
+	long long getWakeupCycle() const;
+
+	/// Update per-cycle state for the given number of idle cycles skipped
+	/// by the main simulation loop.
+	void SkipCycles(long long num_cycles);
+
 
 
 	
@@ -17,6 +17,8 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <limits>
+
 #include "Cpu.h"
 #include "Thread.h"
 #include "Timing.h"
@@ -32,6 +34,23 @@ const char *Thread::commit_stall_error =
 	"cache system, core queues, etc.).\n";
 
 
+long long Thread::getWakeupCycle() const
+{
+	if (!context || !context->getState(Context::StateRunning))
+		return std::numeric_limits<long long>::max();
+	return last_commit_cycle + commit_stall_cycles + 1;
+}
+
+
+void Thread::SkipCycles(long long num_cycles)
+{
+	// Without a running context, the last commit cycle follows the
+	// current cycle.
+	if (!context || !context->getState(Context::StateRunning))
+		last_commit_cycle += num_cycles;
+}
+
+
 bool Thread::canCommit()
 {
 	// Get current cycle
@@ -41,7 +60,7 @@ bool Thread::canCommit()
 	// going wrong if more than 1M cycles go by without committing a uop.
 	if (!context || !context->getState(Context::StateRunning))
 		last_commit_cycle = cycle;
-	if (cycle - last_commit_cycle > 1000000)
+	if (cycle - last_commit_cycle > commit_stall_cycles)
 	{
 		// Show warning
 		misc::Warning("[x86] %s: simulation ended due to a commit "
@@ -157,7 +176,7 @@ void Thread::Commit(int quantum)
 		if (Timing::trace)
 		{
 			// Output
-			Timing::trace << misc::fmt("x86.inst "
+			Timing::trace.fmt("x86.inst "
 					"id=%lld "
 					"core=%d "
 					"stg=\"co\"\n",
@@ -83,7 +83,7 @@ void Thread::Decode()
 				InsertInUopQueue(uop);
 
 				// Trace
-				Timing::trace << misc::fmt("x86.inst "
+				Timing::trace.fmt("x86.inst "
 						"id=%lld "
 						"core=%d "
 						"stg=\"dec\"\n",
@@ -104,6 +104,10 @@ int Thread::Dispatch(int quantum)
 			num_load_store_queue_writes++;
 		}
 
+		// Wait for input operands, or make the uop ready for issue
+		if (register_file->WatchUop(uop))
+			WakeupUop(uop);
+
 		// Increment dispatch slot
 		core->incDispatchStall(uop->speculative_mode ?
 				DispatchStallSpeculative :
@@ -124,7 +128,7 @@ int Thread::Dispatch(int quantum)
 		quantum--;
 
 		// Trace
-		Timing::trace << misc::fmt("x86.inst "
+		Timing::trace.fmt("x86.inst "
 				"id=%lld "
 				"core=%d "
 				"stg=\"di\"\n",
@@ -17,6 +17,8 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <lib/esim/FramePool.h>
+
 #include "Cpu.h"
 #include "Timing.h"
 #include "Thread.h"
@@ -40,6 +42,10 @@ Thread::FetchStall Thread::canFetch()
 	if (context->evict_signal)
 		return FetchStallContext;
 
+	// No new instructions enter the pipeline while it is being drained
+	if (cpu->isDraining())
+		return FetchStallDrain;
+
 	// Fetch queue must have not exceeded the limit of stored bytes to be
 	// able to store new macro-instructions.
 	if (fetch_queue_occupancy >= Cpu::getFetchQueueSize())
@@ -104,8 +110,9 @@ Uop *Thread::FetchInstruction(bool fetch_from_trace_cache)
 		// Get micro-instruction from head of list
 		std::shared_ptr<Uinst> uinst = context->ExtractUinst();
 
-		// Create uop
-		auto uop = misc::new_shared<Uop>(this,
+		// Create uop. Uops are allocated from a pool, since one is
+		// created and destroyed for every fetched micro-instruction.
+		auto uop = esim::new_frame<Uop>(this,
 				context,
 				uinst);
 
@@ -144,7 +151,7 @@ Uop *Thread::FetchInstruction(bool fetch_from_trace_cache)
 		if (Timing::trace)
 		{
 			// New instruction
-			Timing::trace << misc::fmt("x86.new_inst "
+			Timing::trace.fmt("x86.new_inst "
 					"id=%lld "
 					"core=%d",
 					uop->getIdInCore(),
@@ -257,6 +264,9 @@ void Thread::Fetch()
 	// Sanity
 	assert(context);
 
+	// Record activity in the pipeline
+	cpu->setPipelineChanged();
+
 	// Try to fetch from trace cache first
 	if (TraceCache::isPresent() && FetchFromTraceCache())
 		return;
@@ -341,5 +351,54 @@ void Thread::Fetch()
 	}
 }
 
+
+void Thread::Warm(Context *context)
+{
+	// Sanity
+	assert(context->thread == this);
+
+	// Instruction cache
+	mem::Mmu *mmu = context->getMmu();
+	mem::Mmu::Space *mmu_space = context->getMmuSpace();
+	Instruction *inst = context->getInstruction();
+	instruction_module->Warm(mmu->TranslateVirtualAddress(mmu_space,
+			inst->getEip()), false);
+
+	// Traverse micro-instructions created by the x86 emulator
+	while (context->getNumUinsts())
+	{
+		// Get micro-instruction from head of list
+		std::shared_ptr<Uinst> uinst = context->ExtractUinst();
+
+		// Branch predictor
+		if (uinst->getFlags() & Uinst::FlagCtrl)
+			branch_predictor->Warm(uinst.get(),
+					inst->getEip(),
+					inst->getSize(),
+					context->getRegs().getEip());
+
+		// Data cache
+		if (uinst->getOpcode() == Uinst::OpcodeLoad ||
+				uinst->getOpcode() == Uinst::OpcodeStore)
+			data_module->Warm(mmu->TranslateVirtualAddress(
+					mmu_space,
+					uinst->getAddress()),
+					uinst->getOpcode() ==
+					Uinst::OpcodeStore);
+	}
+}
+
+
+void Thread::ResetFetch()
+{
+	// Sanity
+	assert(context);
+	assert(isPipelineEmpty());
+
+	// Fetch from the current instruction, accessing the instruction
+	// cache again.
+	fetch_neip = context->getRegs().getEip();
+	fetch_block_address = -1;
 }
 
+}
@@ -29,9 +29,10 @@ namespace x86
 
 int Thread::IssueLoadQueue(int quantum)
 {
-	// List iterators
-	auto it = load_queue.begin();
-	auto e = load_queue.end();
+	// List iterators. Only uops with their input operands available are
+	// traversed, in program order.
+	auto it = load_ready_list.begin();
+	auto e = load_ready_list.end();
 
 	// Traverse list
 	while (it != e && quantum > 0)
@@ -40,9 +41,8 @@ int Thread::IssueLoadQueue(int quantum)
 		std::shared_ptr<Uop> uop = *it;
 		++it;
 
-		// If the uop is not ready, skip it
-		if (!register_file->isUopReady(uop.get()))
-			continue;
+		// Sanity
+		assert(uop->ready);
 
 		// Check that memory system is accessible
 		if (!data_module->canAccess(uop->physical_address))
@@ -89,7 +89,7 @@ int Thread::IssueLoadQueue(int quantum)
 		quantum--;
 
 		// Trace
-		Timing::trace << misc::fmt("x86.inst "
+		Timing::trace.fmt("x86.inst "
 				"id=%lld "
 				"core=%d "
 				"stg=\"i\"\n",
@@ -104,16 +104,11 @@ int Thread::IssueLoadQueue(int quantum)
 
 int Thread::IssueStoreQueue(int quantum)
 {
-	// List iterators
-	auto it = store_queue.begin();
-	auto e = store_queue.end();
-
-	// Traverse list
-	while (it != e && quantum > 0)
+	// Issue stores from the head of the queue
+	while (store_queue.size() && quantum > 0)
 	{
-		// Get the uop and forward iterator
-		std::shared_ptr<Uop> uop = *it;
-		++it;
+		// Get the uop
+		std::shared_ptr<Uop> uop = store_queue.front();
 
 		// Sanity
 		assert(uop->getOpcode() == Uinst::OpcodeStore);
@@ -185,9 +180,10 @@ int Thread::IssueLoadStoreQueue(int quantum)
 
 int Thread::IssueInstructionQueue(int quantum)
 {
-	// List iterators
-	auto it = instruction_queue.begin();
-	auto e = instruction_queue.end();
+	// List iterators. Only uops with their input operands available are
+	// traversed, in program order.
+	auto it = instruction_ready_list.begin();
+	auto e = instruction_ready_list.end();
 
 	// Traverse list
 	while (it != e && quantum > 0)
@@ -198,10 +194,7 @@ int Thread::IssueInstructionQueue(int quantum)
 
 		// Sanity
 		assert(!(uop->getFlags() & Uinst::FlagMem));
-
-		// If the uop is not ready, skip it
-		if (!register_file->isUopReady(uop.get()))
-			continue;
+		assert(uop->ready);
 
 		// Run the instruction in its corresponding functional unit in
 		// the ALU. If the instruction does not require a functional
@@ -252,7 +245,7 @@ int Thread::IssueInstructionQueue(int quantum)
 		quantum--;
 		
 		// Trace
-		Timing::trace << misc::fmt("x86.inst "
+		Timing::trace.fmt("x86.inst "
 				"id=%lld "
 				"core=%d "
 				"stg=\"i\"\n",
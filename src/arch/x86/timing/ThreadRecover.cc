@@ -44,7 +44,7 @@ void Thread::RecoverFetchQueue()
 		if (Timing::trace)
 		{
 			// Output
-			Timing::trace << misc::fmt("x86.inst "
+			Timing::trace.fmt("x86.inst "
 					"id=%lld "
 					"core=%d "
 					"stg=\"sq\"\n",
@@ -82,7 +82,7 @@ void Thread::RecoverUopQueue()
 		if (Timing::trace)
 		{
 			// Output
-			Timing::trace << misc::fmt("x86.inst "
+			Timing::trace.fmt("x86.inst "
 					"id=%lld "
 					"core=%d "
 					"stg=\"sq\"\n",
@@ -134,37 +134,17 @@ void Thread::RecoverLoadQueue()
 
 void Thread::RecoverStoreQueue()
 {
-	// Traverse store queue
-	auto it = store_queue.begin();
-	auto e = store_queue.end();
-	while (it != e)
-	{
-		// Get instruction
-		Uop *uop = it->get();
-		++it;
-
-		// Remove if it is a speculative uop
-		if (uop->speculative_mode)
-			ExtractFromStoreQueue(uop);
-	}
+	// Speculative uops are the youngest ones in the store queue, so they
+	// are removed from its tail.
+	while (store_queue.size() && store_queue.back()->speculative_mode)
+		ExtractFromStoreQueue(store_queue.back().get());
 }
 
 
 void Thread::RecoverEventQueue()
 {
-	// Traverse event queue
-	auto it = core->getEventQueueBegin();
-	auto e = core->getEventQueueEnd();
-	while (it != e)
-	{
-		// Get instruction
-		Uop *uop = it->get();
-		++it;
-
-		// Remove if it is a speculative uop in the current thread
-		if (uop->getThread() == this && uop->speculative_mode)
-			core->ExtractFromEventQueue(uop);
-	}
+	// Remove speculative uops of the current thread
+	core->getEventQueue()->ExtractSpeculative(this);
 }
 
 
@@ -209,7 +189,7 @@ void Thread::Recover()
 		if (Timing::trace)
 		{
 			// Output
-			Timing::trace << misc::fmt("x86.inst "
+			Timing::trace.fmt("x86.inst "
 					"id=%lld "
 					"core=%d "
 					"stg=\"sq\"\n",
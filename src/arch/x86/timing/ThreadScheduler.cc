@@ -105,7 +105,7 @@ void Thread::MapContext(Context *context)
 			mapped_contexts.end(), context);
 
 	// Debug
-	Emulator::context_debug << misc::fmt("@%lld Context %d mapped "
+	Emulator::context_debug.fmt("@%lld Context %d mapped "
 			"to Core %d Thread %d\n",
 			cpu->getCycle(),
 			context->getId(),
@@ -132,7 +132,7 @@ void Thread::UnmapContext(Context *context)
 	context->thread = nullptr;
 
 	// Debug
-	Emulator::context_debug << misc::fmt("@%lld Context %d unmapped "
+	Emulator::context_debug.fmt("@%lld Context %d unmapped "
 			"from thread %s\n",
 			cpu->getCycle(),
 			context->getId(),
@@ -142,7 +142,7 @@ void Thread::UnmapContext(Context *context)
 	if (context->getState(Context::StateFinished))
 	{
 		// Trace
-		Timing::trace << misc::fmt("x86.end_ctx "
+		Timing::trace.fmt("x86.end_ctx "
 				"ctx=%d\n",
 				context->getId());
 
@@ -167,7 +167,7 @@ void Thread::EvictContextSignal()
 	context->evict_signal = true;
 
 	// Debug
-	Emulator::context_debug << misc::fmt("@%lld Context %d signaled for "
+	Emulator::context_debug.fmt("@%lld Context %d signaled for "
 			"eviction from thread %s\n",
 			cpu->getCycle(),
 			context->getId(),
@@ -196,7 +196,7 @@ void Thread::EvictContext()
 	context->evict_signal = 0;
 
 	// Debug
-	Emulator::context_debug << misc::fmt("@%lld Context %d evicted "
+	Emulator::context_debug.fmt("@%lld Context %d evicted "
 			"from Core %d Thread %d\n",
 			cpu->getCycle(),
 			context->getId(),
@@ -204,7 +204,7 @@ void Thread::EvictContext()
 			getIdInCore());
 
 	// Trace
-	Timing::trace << misc::fmt("x86.unmap_ctx "
+	Timing::trace.fmt("x86.unmap_ctx "
 			"ctx=%d "
 			"core=%d "
 			"thread=%d\n",
@@ -231,7 +231,7 @@ void Thread::Schedule()
 		if (!context->evict_signal && !context->getState(Context::StateRunning))
 		{
 			// Debug
-			Emulator::context_debug << misc::fmt(
+			Emulator::context_debug.fmt(
 					"@%lld Context %d "
 					"in Core %d Thread %d not "
 					"in Running state anymore\n",
@@ -244,11 +244,13 @@ void Thread::Schedule()
 			EvictContextSignal();
 		}
 
-		// Context lost affinity with the thread
-		if (!context->evict_signal && !context->thread_affinity->Test(id_in_cpu))
+		// Context lost affinity with the thread. The context is not
+		// checked again if it was evicted right away above, since its
+		// pipeline was empty.
+		else if (!context->evict_signal && !context->thread_affinity->Test(id_in_cpu))
 		{
 			// Debug
-			Emulator::context_debug << misc::fmt(
+			Emulator::context_debug.fmt(
 					"@%lld Context %d "
 					"lost affinity with Core %d "
 					"Thread %d - rescheduling\n",
@@ -262,12 +264,12 @@ void Thread::Schedule()
 		}
 
 		// Context quantum expired
-		if (!context->evict_signal && cpu->getCycle()
+		else if (!context->evict_signal && cpu->getCycle()
 				>= context->allocate_cycle
 				+ Cpu::getContextQuantum())
 		{
 			// Debug
-			Emulator::context_debug << misc::fmt("@%lld Context "
+			Emulator::context_debug.fmt("@%lld Context "
 					"%d quantum expired\n",
 					cpu->getCycle(),
 					context->getId());
@@ -278,7 +280,7 @@ void Thread::Schedule()
 			if (mapped_contexts.size() == 1)
 			{
 				// Debug
-				Emulator::context_debug << misc::fmt(
+				Emulator::context_debug.fmt(
 						"\tOnly context %d mapped\n",
 						context->getId());
 				
@@ -293,7 +295,7 @@ void Thread::Schedule()
 			for (Context *temp_context : mapped_contexts)
 			{
 				// Debug
-				Emulator::context_debug << misc::fmt(
+				Emulator::context_debug.fmt(
 						"\tCandidate context %d (%s)\n",
 						temp_context->getId(),
 						Context::StateMap.MapFlags(
@@ -332,7 +334,7 @@ void Thread::Schedule()
 				+ Cpu::getContextQuantum())
 		{
 			// Debug
-			Emulator::context_debug << misc::fmt("@%lld Context %d "
+			Emulator::context_debug.fmt("@%lld Context %d "
 					"interrupted\n",
 					cpu->getCycle(),
 					context->getId());
@@ -342,11 +344,11 @@ void Thread::Schedule()
 			for (Context *temp_context : mapped_contexts)
 			{
 				// Debug
-				Emulator::context_debug << misc::fmt(
+				Emulator::context_debug.fmt(
 						"\tContext %d "
 						"is a candidate\n",
 						temp_context->getId());
-				Emulator::context_debug << misc::fmt(
+				Emulator::context_debug.fmt(
 						"\t\tPriority = %d, "
 						"state = %s\n",
 						temp_context->sched_priority,
@@ -381,7 +383,7 @@ void Thread::Schedule()
 			if (found)
 			{
 				// Debug
-				Emulator::context_debug << misc::fmt(
+				Emulator::context_debug.fmt(
 						"\tContext %d begin evicted\n",
 						context->getId());
 
@@ -391,7 +393,7 @@ void Thread::Schedule()
 			else
 			{
 				// Debug
-				Emulator::context_debug << misc::fmt(
+				Emulator::context_debug.fmt(
 						"\tContext %d continuing\n",
 						context->getId());
 			}
@@ -431,7 +433,7 @@ void Thread::Schedule()
 		for (Context *temp_context : mapped_contexts)
 		{
 			// Debug
-			Emulator::context_debug << misc::fmt("@%lld Context %d "
+			Emulator::context_debug.fmt("@%lld Context %d "
 					"(priority %d)\n",
 					cpu->getCycle(),
 					temp_context->getId(),
@@ -455,7 +457,7 @@ void Thread::Schedule()
 				allocate_context = temp_context;
 
 				// Debug
-				Emulator::context_debug << misc::fmt(
+				Emulator::context_debug.fmt(
 						"@%lld Context %d "
 						"(priority %d) "
 						"is a candidate\n",
@@ -466,7 +468,7 @@ void Thread::Schedule()
 			else
 			{
 				// Debug
-				Emulator::context_debug << misc::fmt(
+				Emulator::context_debug.fmt(
 						"@%lld Context %d "
 						"(priority %d) "
 						"is not a candidate\n",
@@ -483,7 +485,7 @@ void Thread::Schedule()
 			cpu->AllocateContext(allocate_context);
 
 			// Debug
-			Emulator::context_debug << misc::fmt(
+			Emulator::context_debug.fmt(
 					"Allocating context %d\n",
 					allocate_context->getId());
 		}
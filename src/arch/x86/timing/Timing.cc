@@ -17,6 +17,8 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <cmath>
+
 #include <arch/common/Arch.h>
 #include <memory/System.h>
 
@@ -69,6 +71,20 @@ const std::string Timing::help_message =
 		"  FastForward = <num_inst> (Default = 0)\n"
 		"      Number of x86 instructions to run with a fast functional simulation before\n"
 		"      the architectural simulation starts.\n"
+		"  SamplingPeriod = <num_inst> (Default = 0)\n"
+		"      If other than 0, enable sampled simulation. After the fast-forward\n"
+		"      execution, short intervals of detailed simulation are taken periodically\n"
+		"      every <num_inst> instructions, with the rest of the instructions running\n"
+		"      in a fast functional simulation. The report includes the average IPC\n"
+		"      measured in the samples with its confidence intervals.\n"
+		"  SamplingWarmup = <num_inst> (Default = 2000)\n"
+		"      Number of instructions simulated in detail before each sample, to warm\n"
+		"      up the pipeline structures. These instructions are not measured.\n"
+		"  SamplingLength = <num_inst> (Default = 1000)\n"
+		"      Number of instructions measured in each sample.\n"
+		"  SamplingFunctionalWarming = {t|f} (Default = True)\n"
+		"      Keep caches and branch predictors up to date during the functional\n"
+		"      simulation between samples.\n"
 		"  ContextQuantum = <cycles> (Default = 100k)\n"
 		"      If ContextSwitch is true, maximum number of cycles that a context can occupy\n"
 		"      a Cpu hardware thread before it is replaced by other pending context.\n"
@@ -286,10 +302,15 @@ bool Timing::Run()
 			< Cpu::getNumFastForwardInstructions())
 		FastForward();
 
+	// Sampled simulation
+	if (Cpu::getSamplingPeriod())
+		Sample();
+
 	// Stop if maximum number of CPU instructions exceeded
 	esim::Engine *esim_engine = esim::Engine::getInstance();
 	if (Emulator::getMaxInstructions()
 			&& cpu->getNumCommittedInstructions()
+			+ num_sampling_functional_instructions
 			>= Emulator::getMaxInstructions()
 			- Cpu::getNumFastForwardInstructions())
 		esim_engine->Finish("X86MaxInstructions");
@@ -309,7 +330,10 @@ bool Timing::Run()
 	// Run processor stages
 	cpu->Run();
 
-	// Process host threads generating events
+	// Process host threads generating events. Suspended contexts can wake
+	// up in any cycle, which prevents the cycle from being idle.
+	if (emulator->getNumSuspendedContexts())
+		cpu->setPipelineChanged();
 	emulator->ProcessEvents();
 
 	// Still simulating
@@ -317,6 +341,32 @@ bool Timing::Run()
 }
 
 
+long long Timing::getWakeupCycle()
+{
+	// Fast-forward and sampled simulation run every cycle
+	Emulator *emulator = Emulator::getInstance();
+	if ((Cpu::getNumFastForwardInstructions() &&
+			emulator->getNumInstructions() <
+			Cpu::getNumFastForwardInstructions()) ||
+			Cpu::getSamplingPeriod())
+		return getCycle();
+
+	// CPU pipelines
+	long long cycle = cpu->getWakeupCycle(getLastSimulationCycle());
+
+	// Maximum number of cycles
+	if (Cpu::max_cycles)
+		cycle = std::min(cycle, Cpu::max_cycles);
+	return cycle;
+}
+
+
+void Timing::SkipCycles(long long num_cycles)
+{
+	cpu->SkipCycles(getLastSimulationCycle(), num_cycles);
+}
+
+
 void Timing::FastForward()
 {
 	// Fast-forward simulation
@@ -334,6 +384,124 @@ void Timing::FastForward()
 }
 
 
+void Timing::Sample()
+{
+	long long num_committed_instructions = cpu->getNumCommittedInstructions();
+	switch (sampling_phase)
+	{
+
+	case SamplingPhaseWarmup:
+
+		// Start measuring after the warm-up instructions
+		if (num_committed_instructions - sampling_phase_instructions
+				< Cpu::getSamplingWarmup())
+			break;
+		sampling_phase = SamplingPhaseMeasure;
+		sampling_phase_instructions = num_committed_instructions;
+		sampling_phase_cycle = getCycle();
+		break;
+
+	case SamplingPhaseMeasure:
+	{
+		// Record sample
+		long long num_instructions = num_committed_instructions -
+				sampling_phase_instructions;
+		if (num_instructions < Cpu::getSamplingLength())
+			break;
+		sample_cpis.push_back((double) (getCycle() -
+				sampling_phase_cycle) / num_instructions);
+
+		// Stop fetching
+		sampling_phase = SamplingPhaseDrain;
+		cpu->setDraining(true);
+		break;
+	}
+
+	case SamplingPhaseDrain:
+
+		// Wait for instructions in flight to commit
+		if (!cpu->isPipelineEmpty())
+			break;
+		cpu->setDraining(false);
+
+		// Functional simulation up to the next sample
+		FunctionalWarming(Cpu::getSamplingPeriod() -
+				Cpu::getSamplingWarmup() -
+				Cpu::getSamplingLength());
+		sampling_phase = SamplingPhaseWarmup;
+		sampling_phase_instructions = cpu->getNumCommittedInstructions();
+		break;
+	}
+}
+
+
+void Timing::FunctionalWarming(long long num_instructions)
+{
+	// Do not exceed the maximum number of instructions
+	Emulator *emulator = Emulator::getInstance();
+	if (Emulator::getMaxInstructions())
+		num_instructions = std::min(num_instructions,
+				Emulator::getMaxInstructions()
+				- Cpu::getNumFastForwardInstructions()
+				- cpu->getNumCommittedInstructions()
+				- num_sampling_functional_instructions);
+
+	// Run contexts without freeing them, since finished contexts may
+	// still be mapped to hardware threads. Stop if all contexts are
+	// suspended, letting the timing simulation advance time.
+	esim::Engine *esim_engine = esim::Engine::getInstance();
+	long long start = emulator->getNumInstructions();
+	while (emulator->getNumInstructions() - start < num_instructions
+			&& emulator->getNumRunningContexts()
+			&& !esim_engine->hasFinished())
+	{
+		for (auto it = emulator->getContextsBegin(),
+				e = emulator->getContextsEnd();
+				it != e;
+				++it)
+		{
+			// Skip if not running
+			Context *context = it->get();
+			if (!context->getState(Context::StateRunning))
+				continue;
+
+			// Run one instruction
+			context->Execute();
+			if (Cpu::getSamplingFunctionalWarming() && context->thread)
+				context->thread->Warm(context);
+		}
+
+		// Process list of suspended contexts
+		emulator->ProcessEvents();
+	}
+	num_sampling_functional_instructions +=
+			emulator->getNumInstructions() - start;
+
+	// Free finished contexts not mapped to any hardware thread. Mapped
+	// contexts are freed by the scheduler.
+	for (auto it = emulator->getFinishedContextsBegin();
+			it != emulator->getFinishedContextsEnd();)
+	{
+		Context *context = *it;
+		++it;
+		if (!context->getState(Context::StateMapped))
+			emulator->FreeContext(context);
+	}
+
+	// Resume fetch at the new instruction pointers
+	for (int i = 0; i < cpu->getNumCores(); i++)
+	{
+		Core *core = cpu->getCore(i);
+		for (int j = 0; j < core->getNumThreads(); j++)
+		{
+			Thread *thread = core->getThread(j);
+			if (thread->context)
+				thread->ResetFetch();
+		}
+	}
+}
+
+
 void Timing::WriteMemoryConfiguration(misc::IniFile *ini_file)
 {
 	// Cache geometry for L1
@@ -727,6 +895,42 @@ void Timing::DumpSummary(std::ostream &os) const
 			/ cpu->getNumBranches()
 			: 0.0;
 	os << misc::fmt("BranchPredictionAccuracy = %.4g\n", branch_accuracy);
+
+	// Sampled simulation
+	if (!Cpu::getSamplingPeriod())
+		return;
+	os << misc::fmt("FunctionalInstructions = %lld\n",
+			num_sampling_functional_instructions);
+	os << misc::fmt("Samples = %d\n", (int) sample_cpis.size());
+	if (sample_cpis.empty())
+		return;
+
+	// Mean and standard deviation of the CPI across samples
+	double mean = 0.0;
+	for (double cpi : sample_cpis)
+		mean += cpi;
+	mean /= sample_cpis.size();
+	double variance = 0.0;
+	for (double cpi : sample_cpis)
+		variance += (cpi - mean) * (cpi - mean);
+	if (sample_cpis.size() > 1)
+		variance /= sample_cpis.size() - 1;
+	double error = sqrt(variance / sample_cpis.size());
+	os << misc::fmt("SampledCyclesPerInstruction = %.4g\n", mean);
+	os << misc::fmt("SampledCyclesPerInstructionStdDev = %.4g\n",
+			sqrt(variance));
+
+	// IPC is estimated from the mean CPI, since samples have the same
+	// number of instructions. Confidence intervals for 95% and 99.7%.
+	os << misc::fmt("SampledInstructionsPerCycle = %.4g\n", 1.0 / mean);
+	os << misc::fmt("SampledInstructionsPerCycleInterval95 = "
+			"[%.4g, %.4g]\n",
+			1.0 / (mean + 1.96 * error),
+			mean > 1.96 * error ? 1.0 / (mean - 1.96 * error) : 0.0);
+	os << misc::fmt("SampledInstructionsPerCycleInterval997 = "
+			"[%.4g, %.4g]\n",
+			1.0 / (mean + 3.0 * error),
+			mean > 3.0 * error ? 1.0 / (mean - 3.0 * error) : 0.0);
 }
 
 
@@ -1074,6 +1278,11 @@ void Timing::DumpConfiguration(std::ofstream &os) const
 	os << misc::fmt("Cores = %d\n", cpu->getNumCores());
 	os << misc::fmt("Threads = %d\n", cpu->getNumThreads());
 	os << misc::fmt("FastForward = %lld\n", cpu->getNumFastForwardInstructions());
+	os << misc::fmt("SamplingPeriod = %lld\n", cpu->getSamplingPeriod());
+	os << misc::fmt("SamplingWarmup = %lld\n", cpu->getSamplingWarmup());
+	os << misc::fmt("SamplingLength = %lld\n", cpu->getSamplingLength());
+	os << misc::fmt("SamplingFunctionalWarming = %s\n",
+			cpu->getSamplingFunctionalWarming() ? "True" : "False");
 	os << misc::fmt("ContextQuantum = %d\n", cpu->getContextQuantum());
 	os << misc::fmt("ThreadQuantum = %d\n", cpu->getThreadQuantum());
 	os << misc::fmt("ThreadSwitchPenalty = %d\n", cpu->getThreadSwitchPenalty());
@@ -42,6 +42,19 @@ class Cpu;
 // Class Timing
 class Timing : public comm::Timing
 {
+public:
+
+	/// Phases of sampled simulation
+	enum SamplingPhase
+	{
+		SamplingPhaseWarmup = 0,	// Detailed, not measured
+		SamplingPhaseMeasure,		// Detailed, measured
+		SamplingPhaseDrain		// Pipelines emptying
+	};
+
+
+private:
+
 	//
 	// Static fields
 	//
@@ -83,6 +96,30 @@ class Timing : public comm::Timing
 	// List of entry modules to the memory hierarchy
 	std::vector<mem::Module *> entry_modules;
 
+	// Current phase of sampled simulation
+	SamplingPhase sampling_phase = SamplingPhaseWarmup;
+
+	// Number of committed instructions when the current phase started
+	long long sampling_phase_instructions = 0;
+
+	// Cycle when the current phase started
+	long long sampling_phase_cycle = 0;
+
+	// Number of instructions emulated functionally between samples
+	long long num_sampling_functional_instructions = 0;
+
+	// Cycles per instruction measured in each sample
+	std::vector<double> sample_cpis;
+
+	// Advance the phase of sampled simulation, running the functional
+	// simulation between samples when the pipelines are drained.
+	void Sample();
+
+	// Run the given number of instructions functionally on all running
+	// contexts, warming up caches and branch predictors if configured.
+	// Contexts remain allocated to their hardware threads.
+	void FunctionalWarming(long long num_instructions);
+
 	// Dump a specific part of a statistics report related with uops.
 	void DumpUopReport(std::ostream &os, const long long *uop_stats,
 			const std::string &prefix, int peak_ipc) const;
@@ -143,12 +180,34 @@ public:
 	/// Fast forward instructions set up by the user
 	void FastForward();
 
+	/// Return the current phase of sampled simulation
+	SamplingPhase getSamplingPhase() const { return sampling_phase; }
+
+	/// Return the number of instructions emulated functionally between
+	/// samples in sampled simulation
+	long long getNumSamplingFunctionalInstructions() const
+	{
+		return num_sampling_functional_instructions;
+	}
+
+	/// Return the cycles per instruction measured in each sample
+	const std::vector<double> &getSampleCpis() const { return sample_cpis; }
+
 	/// Run one iteration of the cpu timing simuation.
 	/// \return This function \c true if the iteration had a useful
 	/// timing simulation, and \c false if all timing simulation finished
 	/// execution.
 	bool Run() override;
 
+	/// Return the earliest cycle in which the CPU needs to run again,
+	/// assuming that no event occurs in the memory hierarchy. Cycles are
+	/// never skipped during fast-forward or sampled simulation.
+	long long getWakeupCycle() override;
+
+	/// Update per-cycle statistics for idle cycles skipped by the main
+	/// simulation loop.
+	void SkipCycles(long long num_cycles) override;
+
 	/// Dump a default memory configuration for the architecture. This
 	/// function is invoked by the memory system configuration parser when
 	/// no specific memory configuration is given by the user for the
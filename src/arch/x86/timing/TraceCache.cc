@@ -172,9 +172,9 @@ bool TraceCache::Lookup(unsigned int eip,
 		unsigned int &neip)
 {
 	// Debug
-	debug << misc::fmt("** Lookup **\n");
-	debug << misc::fmt("eip = 0x%x, pred = ", eip);
-	debug << misc::fmt("\n");
+	debug.fmt("** Lookup **\n");
+	debug.fmt("eip = 0x%x, pred = ", eip);
+	debug.fmt("\n");
 
 	// Look for trace cache line
 	int way;
@@ -198,8 +198,8 @@ bool TraceCache::Lookup(unsigned int eip,
 	// Miss
 	if (!found_entry)
 	{
-		debug << misc::fmt("Miss\n");
-		debug << misc::fmt("\n");
+		debug.fmt("Miss\n");
+		debug.fmt("\n");
 		return false;
 	}
 
@@ -210,10 +210,10 @@ bool TraceCache::Lookup(unsigned int eip,
 	neip = taken ? found_entry->target : found_entry->fall_through;
 
 	// Debug
-	debug << misc::fmt("Hit - Set = %d, Way = %d\n", set, way);
-	debug << misc::fmt("Next trace prediction = %c\n", taken ? 'T' : 'N');
-	debug << misc::fmt("Next fetch address = 0x%x\n", neip);
-	debug << misc::fmt("\n");
+	debug.fmt("Hit - Set = %d, Way = %d\n", set, way);
+	debug.fmt("Next trace prediction = %c\n", taken ? 'T' : 'N');
+	debug.fmt("Next fetch address = 0x%x\n", neip);
+	debug.fmt("\n");
 
 	// Hit
 	return true;
@@ -292,9 +292,9 @@ void TraceCache::Flush()
 	memset(temp_ptr, 0, sizeof(Entry));
 
 	// Debug
-	debug << misc::fmt("** Commit trace **\n");
-	debug << misc::fmt("Set = %d, Way = %d\n", set, found_way);
-	debug << misc::fmt("\n");
+	debug.fmt("** Commit trace **\n");
+	debug.fmt("Set = %d, Way = %d\n", set, found_way);
+	debug.fmt("\n");
 
 	// Statistics
 	trace_length_acc += found_entry->uop_count;
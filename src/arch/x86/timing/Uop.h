@@ -265,15 +265,9 @@ public:
 	/// True if the instruction is currently in the fetch queue
 	bool in_fetch_queue = false;
 
-	/// Position of the uop in the thread's fetch queue
-	std::list<std::shared_ptr<Uop>>::iterator fetch_queue_iterator;
-
 	/// True if the instruction is currently in the uop queue
 	bool in_uop_queue = false;
 
-	/// Position of the uop in the thread's uop queue
-	std::list<std::shared_ptr<Uop>>::iterator uop_queue_iterator;
-
 	/// True if the instruction is currently in the core's event queue
 	bool in_event_queue = false;
 
@@ -285,9 +279,6 @@ public:
 	/// reorder buffer
 	bool in_reorder_buffer = false;
 
-	/// Position of the uop in the reorder buffer, if present
-	std::list<std::shared_ptr<Uop>>::iterator reorder_buffer_iterator;
-
 	/// True if the instruction is currently present in the thread's
 	/// instruction queue
 	bool in_instruction_queue = false;
@@ -308,17 +299,17 @@ public:
 	/// store queue
 	bool in_store_queue = false;
 
-	/// Position of the uop in the thread's store queue, or past-the-end
-	/// iterator to this queue if not present.
-	std::list<std::shared_ptr<Uop>>::iterator store_queue_iterator;
+	/// True if the instruction is currently present in the ready list of
+	/// the thread's instruction queue or load queue
+	bool in_ready_list = false;
+
+	/// Position of the uop in the thread's ready list, if present
+	std::list<std::shared_ptr<Uop>>::iterator ready_list_iterator;
 
 	/// True if the instruction is currently present in the uop trace list
 	/// of the CPU
 	bool in_trace_list = false;
 
-	/// Position of the uop in the CPU's trace list, if present
-	std::list<std::shared_ptr<Uop>>::iterator trace_list_iterator;
-
 
 
 	
@@ -433,6 +424,10 @@ public:
 	/// Cycle when uop was made ready, or 0 if not ready yet
 	long long ready_when = 0;
 
+	/// Number of input operands still waiting to be written back by their
+	/// producers, as tracked by RegisterFile::WatchUop()
+	int num_pending_inputs = 0;
+
 	/// True if uop was already issued
 	bool issued = false;
 
@@ -76,7 +76,7 @@ void Address::DecodeAddress()
 	physical = decoding & int(pow(2, physical_size) - 1);
 
 	// Debug
-	// System::debug << misc::fmt("Sizes: %d, %d, %d, %d, %d, %d\n",
+	// System::debug.fmt("Sizes: %d, %d, %d, %d, %d, %d\n",
 	// 		physical_size, logical_size, rank_size, bank_size,
 	// 		row_size, column_size);
 	// dump(System::debug);
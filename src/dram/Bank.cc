@@ -27,6 +27,8 @@
 #include "Controller.h"
 #include "System.h"
 #include "Rank.h"
+#include "Request.h"
+#include "Scheduler.h"
 
 namespace dram
 {
@@ -62,9 +64,61 @@ void Bank::ProcessRequest(std::shared_ptr<Request> request)
 	// Get the current cycle.
 	long long cycle = System::frequency_domain->getCycle();
 
+	// Channel that the bank belongs to
+	Channel *channel = getRank()->getChannel();
+
+	// Queue the request, and start it now if the bank is idle.
+	request->setCycleQueued(cycle);
+	request_queue.push_back(request);
+	channel->incQueuedRequests(request->getType());
+	ScheduleRequest();
+
+	// Ensure the scheduler is running.
+	channel->CallScheduler();
+
+	// Debug
+	System::debug.fmt("[%lld] Processed request for 0x%llx in "
+			"bank %d\n", cycle,
+			request->getAddress()->getEncoded(), id);
+}
+
+
+bool Bank::ScheduleRequest()
+{
+	// Nothing to do if the bank is still busy with a previous request or
+	// no request is waiting.
+	if (command_queue.size() || !request_queue.size())
+		return false;
+
+	// Ask the scheduler for the request to start. It may decide to hold
+	// all of them for now.
+	Scheduler *scheduler = getRank()->getChannel()->getScheduler();
+	scheduler->UpdateWriteDrain();
+	int position = scheduler->FindNextRequest(this);
+	if (position < 0)
+		return false;
+
+	// Remove it from the request queue and create its commands
+	std::shared_ptr<Request> request = request_queue[position];
+	request_queue.erase(request_queue.begin() + position);
+	getRank()->getChannel()->decQueuedRequests(request->getType());
+	CreateCommands(request);
+	return true;
+}
+
+
+void Bank::CreateCommands(std::shared_ptr<Request> request)
+{
+	// Commands take the age of their request, so that schedulers order
+	// them by the time the request reached the bank.
+	long long cycle = request->getCycleQueued();
+
 	// Pull the address out of the request.
 	Address *address = request->getAddress();
 
+	// Channel that the bank belongs to
+	Channel *channel = getRank()->getChannel();
+
 	// Break the request down into its commands and add them to the queue.
 	// For all checks to the active row, the checks are made to what the
 	// active row will be when all commands in the queue have run, because
@@ -84,6 +138,9 @@ void Bank::ProcessRequest(std::shared_ptr<Request> request)
 
 		// Set the future active row.
 		future_active_row = address->getRow();
+
+		// Stats
+		channel->incRowMisses();
 	}
 
 	// Create the precharge and activate commands if the wrong row will
@@ -102,6 +159,16 @@ void Bank::ProcessRequest(std::shared_ptr<Request> request)
 
 		// Set the future active row.
 		future_active_row = address->getRow();
+
+		// Stats
+		channel->incRowConflicts();
+	}
+
+	// The desired row will already be open. (Row hit)
+	else
+	{
+		// Stats
+		channel->incRowHits();
 	}
 
 	// Check that the desired row will actually be open.
@@ -113,11 +180,17 @@ void Bank::ProcessRequest(std::shared_ptr<Request> request)
 	// the appropriate access command (read or write).
 	std::shared_ptr<Command> access_command;
 	if (request->getType() == RequestRead)
+	{
 		access_command = std::make_shared<Command>(
 				request, CommandRead, cycle, this);
+		channel->incReads(request->getSize());
+	}
 	else if (request->getType() == RequestWrite)
+	{
 		access_command = std::make_shared<Command>(
 				request, CommandWrite, cycle, this);
+		channel->incWrites(request->getSize());
+	}
 	else
 		// Invalid request type
 		throw misc::Panic("Invalid request type");
@@ -127,8 +200,7 @@ void Bank::ProcessRequest(std::shared_ptr<Request> request)
 
 	// If the the page policy is set to closed page, then also add a
 	// precharge command to the end of the queue.
-	if (getRank()->getChannel()->getController()->getPagePolicy() ==
-			PagePolicyClosed)
+	if (channel->getController()->getPagePolicy() == PagePolicyClosed)
 	{
 		// Create the command.
 		auto precharge_command = std::make_shared<Command>(
@@ -140,14 +212,6 @@ void Bank::ProcessRequest(std::shared_ptr<Request> request)
 		// Set the future active row to indicate precharged.
 		future_active_row = -1;
 	}
-
-	// Ensure the scheduler is running.
-	getRank()->getChannel()->CallScheduler();
-
-	// Debug
-	System::debug << misc::fmt("[%lld] Processed request for 0x%llx in "
-			"bank %d\n", cycle,
-			address->getEncoded(), id);
 }
 
 
@@ -184,6 +248,10 @@ void Bank::RunFrontCommand()
 
 	// Command is being run, remove it from the queue.
 	command_queue.pop_front();
+
+	// Start the next request as soon as the last command of the current
+	// one is on its way.
+	ScheduleRequest();
 }
 
 
@@ -196,6 +264,10 @@ void Bank::dump(std::ostream &os) const
 	os << misc::fmt("\t\t\t%d Rows, %d Columns, %d Bits per Column\n",
 			num_rows, num_columns, num_bits);
 
+	// Print the requests waiting to be started
+	os << misc::fmt("\t\t\t%d Requests in queue\n",
+			(int) request_queue.size());
+
 	// Print the commands currently in queue
 	os << misc::fmt("\t\t\t%d Commands in queue\n", (int)command_queue.size());
 	for (int i = 0; i < (int)command_queue.size(); i++)
@@ -47,6 +47,10 @@ class Bank
 	int num_columns;
 	int num_bits;
 
+	// Requests waiting to be broken down into commands, in order of
+	// arrival
+	std::deque<std::shared_ptr<Request>> request_queue;
+
 	// Queue of commands to be sent to the Bank
 	std::deque<std::shared_ptr<Command>> command_queue;
 
@@ -59,6 +63,10 @@ class Bank
 	int current_active_row = -1;
 	int future_active_row = -1;
 
+	// Break a request down into its component commands and add them to
+	// the command queue.
+	void CreateCommands(std::shared_ptr<Request> request);
+
 public:
 
 	Bank(int id,
@@ -103,6 +111,17 @@ public:
 	/// Returns what row will be activated.
 	int getActiveRowFuture() const { return future_active_row; }
 
+	/// Returns how many requests are waiting to be broken down into
+	/// commands.
+	int getNumRequestsInQueue() const { return (int) request_queue.size(); }
+
+	/// Returns the request waiting in the queue at a certain position.
+	/// Requests are kept in order of arrival.
+	Request *getRequestInQueue(int position) const
+	{
+		return request_queue[position].get();
+	}
+
 	/// Returns how many commands are in the queue.
 	int getNumCommandsInQueue() const { return (int) command_queue.size(); }
 
@@ -112,6 +131,9 @@ public:
 		return command_queue[position]->getTypeString();
 	}
 
+	/// Returns the command at the front of the queue.
+	Command *getFrontCommand() const { return command_queue.front().get(); }
+
 	/// Returns the cycle when the command at the front of the queue was
 	/// created.
 	long long getFrontCommandCycleCreated()
@@ -126,10 +148,18 @@ public:
 	/// Pops off the top command in the queue.
 	void RunFrontCommand();
 
-	/// Breaks a request down into it's component commands and adds them to the
-	/// bank's command queue.
+	/// Adds a request to the bank's request queue, and starts it right
+	/// away if the bank has no commands pending.
 	void ProcessRequest(std::shared_ptr<Request> request);
 
+	/// If the command queue is empty, let the channel's scheduler pick the
+	/// next request from the request queue and break it down into its
+	/// commands. Requests are only broken down once the bank is done with
+	/// the previous one, so that the scheduler can decide on the row
+	/// buffer state that the request will actually find. Returns true if
+	/// a request was started.
+	bool ScheduleRequest();
+
 	/// Dump the object to an output stream.
 	void dump(std::ostream &os = std::cout) const;
 
@@ -65,6 +65,18 @@ Channel::Channel(int id,
 		scheduler = std::unique_ptr<Scheduler>(
 				new OldestFirst(this));
 		break;
+
+	// Create a First-Ready First-Come First-Served scheduler.
+	case SchedulerFRFCFS:
+		scheduler = std::unique_ptr<Scheduler>(
+				new FRFCFS(this));
+		break;
+
+	// Create a batch scheduler.
+	case SchedulerBatch:
+		scheduler = std::unique_ptr<Scheduler>(
+				new Batch(this));
+		break;
 	}
 }
 
@@ -110,9 +122,15 @@ void Channel::RunScheduler()
 	long long cycle = System::frequency_domain->getCycle();
 
 	// Debug
-	System::debug << misc::fmt("[%lld] Controller %d Channel %d running "
+	System::debug.fmt("[%lld] Controller %d Channel %d running "
 			"scheduler\n", cycle, getController()->getId(), id);
 
+	// Start requests held in bank request queues, which the scheduling
+	// policy may have decided to release by now.
+	if (num_queued_reads || num_queued_writes)
+		for (int i = 0; i < getNumBanksTotal(); i++)
+			getBankTotal(i)->ScheduleRequest();
+
 	// Get a pointer to the bank whose front command should be run next.
 	// This is either the result of the scheduling algorithm from a previous
 	// cycle (if timing constraints prevented it from being run then), or
@@ -334,6 +352,37 @@ long long Channel::CalculateReadyCycle(Command *cmd)
 }
 
 
+void Channel::DumpReport(std::ostream &os) const
+{
+	// Section header
+	os << misc::fmt("[ MemoryController %s Channel %d ]\n\n",
+			controller->getName().c_str(), id);
+
+	// Requests
+	os << misc::fmt("Reads = %lld\n", num_reads);
+	os << misc::fmt("Writes = %lld\n", num_writes);
+	os << misc::fmt("BytesRead = %lld\n", num_bytes_read);
+	os << misc::fmt("BytesWritten = %lld\n", num_bytes_written);
+
+	// Bandwidth, given the simulated time in picoseconds
+	long long time = esim::Engine::getInstance()->getTime();
+	long long num_bytes = num_bytes_read + num_bytes_written;
+	os << misc::fmt("Bandwidth = %.4g GB/s\n", time ?
+			(double) num_bytes * 1000 / time : 0.0);
+	os << "\n";
+
+	// Row buffer
+	long long num_requests = num_row_hits + num_row_misses +
+			num_row_conflicts;
+	os << misc::fmt("RowHits = %lld\n", num_row_hits);
+	os << misc::fmt("RowMisses = %lld\n", num_row_misses);
+	os << misc::fmt("RowConflicts = %lld\n", num_row_conflicts);
+	os << misc::fmt("RowHitRatio = %.4g\n", num_requests ?
+			(double) num_row_hits / num_requests : 0.0);
+	os << "\n\n";
+}
+
+
 void Channel::dump(std::ostream &os) const
 {
 	// Print header
@@ -61,6 +61,24 @@ class Channel
 	// Total number of commands in bank queues under this channel
 	int num_commands_in_queue = 0;
 
+	// Number of requests waiting in bank request queues under this
+	// channel, not broken down into commands yet
+	int num_queued_reads = 0;
+	int num_queued_writes = 0;
+
+	// Statistics for requests
+	long long num_reads = 0;
+	long long num_writes = 0;
+	long long num_bytes_read = 0;
+	long long num_bytes_written = 0;
+
+	// Statistics for the row buffer. A request is a row hit if its row is
+	// open, a row miss if the bank is precharged, and a row conflict if a
+	// different row is open.
+	long long num_row_hits = 0;
+	long long num_row_misses = 0;
+	long long num_row_conflicts = 0;
+
 public:
 
 	Channel(int id,
@@ -91,6 +109,42 @@ public:
 	/// Returns the total number of banks in this channel.
 	int getNumBanksTotal() const { return num_banks * num_ranks; }
 
+	/// Returns the bank with index \a index among all banks of the
+	/// channel, where banks of the same rank have consecutive indices.
+	Bank *getBankTotal(int index) const
+	{
+		return ranks[index / num_banks]->getBank(index % num_banks);
+	}
+
+	/// Returns the scheduler of this channel.
+	Scheduler *getScheduler() const { return scheduler.get(); }
+
+	/// Record a request of type \a type entering a bank request queue.
+	void incQueuedRequests(RequestType type)
+	{
+		if (type == RequestWrite)
+			num_queued_writes++;
+		else
+			num_queued_reads++;
+	}
+
+	/// Record a request of type \a type leaving a bank request queue to
+	/// be broken down into commands.
+	void decQueuedRequests(RequestType type)
+	{
+		if (type == RequestWrite)
+			num_queued_writes--;
+		else
+			num_queued_reads--;
+	}
+
+	/// Returns the number of read requests waiting in bank request queues.
+	int getNumQueuedReads() const { return num_queued_reads; }
+
+	/// Returns the number of write requests waiting in bank request
+	/// queues.
+	int getNumQueuedWrites() const { return num_queued_writes; }
+
 	/// Call the scheduler for this channel.  This function will only
 	/// invoke the scheduler if it is not already scheduled to run.  The
 	/// scheduler will keep reinvoking itself while there are commands in
@@ -114,6 +168,53 @@ public:
 	/// given the current state of the system.
 	long long CalculateReadyCycle(Command *cmd);
 
+	/// Record a read request of \a size bytes served by the channel.
+	void incReads(int size)
+	{
+		num_reads++;
+		num_bytes_read += size;
+	}
+
+	/// Record a write request of \a size bytes served by the channel.
+	void incWrites(int size)
+	{
+		num_writes++;
+		num_bytes_written += size;
+	}
+
+	/// Record a request that found its row open.
+	void incRowHits() { num_row_hits++; }
+
+	/// Record a request that found its bank precharged.
+	void incRowMisses() { num_row_misses++; }
+
+	/// Record a request that found a different row open in its bank.
+	void incRowConflicts() { num_row_conflicts++; }
+
+	/// Return the number of read requests served by the channel.
+	long long getNumReads() const { return num_reads; }
+
+	/// Return the number of write requests served by the channel.
+	long long getNumWrites() const { return num_writes; }
+
+	/// Return the number of bytes read through the channel.
+	long long getNumBytesRead() const { return num_bytes_read; }
+
+	/// Return the number of bytes written through the channel.
+	long long getNumBytesWritten() const { return num_bytes_written; }
+
+	/// Return the number of requests that found their row open.
+	long long getNumRowHits() const { return num_row_hits; }
+
+	/// Return the number of requests that found their bank precharged.
+	long long getNumRowMisses() const { return num_row_misses; }
+
+	/// Return the number of requests that found another row open.
+	long long getNumRowConflicts() const { return num_row_conflicts; }
+
+	/// Dump the channel statistics in the format of the memory report.
+	void DumpReport(std::ostream &os = std::cout) const;
+
 	/// Dump the object to an output stream.
 	void dump(std::ostream &os = std::cout) const;
 
@@ -94,6 +94,9 @@ public:
 	/// Returns the cycle when the command was created.
 	long long getCycleCreated() { return cycle_created; }
 
+	/// Returns the request that the command was created for.
+	Request *getRequest() const { return request.get(); }
+
 	/// Returns the bank that the command was created in.
 	Bank *getBank() { return bank; }
 
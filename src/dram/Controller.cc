@@ -90,6 +90,33 @@ void Controller::ParseConfiguration(misc::IniFile *config,
 			"SchedulingPolicy", SchedulerTypeMap,
 			SchedulerOldestFirst);
 
+	// Load the write drain watermarks, disabled by default
+	write_drain_high_watermark = config->ReadInt(section,
+			"WriteDrainHighWatermark", 0);
+	write_drain_low_watermark = config->ReadInt(section,
+			"WriteDrainLowWatermark", 0);
+	if (write_drain_high_watermark < 0)
+		throw Error(misc::fmt("%s: WriteDrainHighWatermark cannot be "
+				"negative.\n%s",
+				config->getPath().c_str(),
+				System::err_config_note));
+	if (write_drain_high_watermark && (write_drain_low_watermark < 0 ||
+			write_drain_low_watermark >=
+			write_drain_high_watermark))
+		throw Error(misc::fmt("%s: WriteDrainLowWatermark must be "
+				"between 0 and WriteDrainHighWatermark - 1.\n%s",
+				config->getPath().c_str(),
+				System::err_config_note));
+
+	// Load the batch size of the batch scheduler
+	batch_marking_cap = config->ReadInt(section, "BatchMarkingCap",
+			batch_marking_cap);
+	if (batch_marking_cap <= 0)
+		throw Error(misc::fmt("%s: BatchMarkingCap must be at least "
+				"1.\n%s",
+				config->getPath().c_str(),
+				System::err_config_note));
+
 	// Read DRAM size settings
 	num_channels = config->ReadInt(section, "NumChannels", 1);
 	if (num_channels <= 0)
@@ -212,6 +239,7 @@ void Controller::ParseConfigurationTiming(misc::IniFile *ini_file,
 void Controller::AddRequest(std::shared_ptr<Request> request)
 {
 	// Add the request to the controller incoming request queue.
+	request->setCycleIssued(System::frequency_domain->getCycle());
 	incoming_requests.push(request);
 
 	// Ensure the request processor is running.
@@ -290,11 +318,13 @@ void Controller::RunRequestProcessor()
 	// Get the front request in the queue.
 	std::shared_ptr<Request> request = incoming_requests.front();
 
-	// Get the bank the request is destined for.
+	// Get the bank the request is destined for. The address components
+	// are sized for the largest controller in the system, so they are
+	// folded into the geometry of this one.
 	Address *address = request->getAddress();
-	Bank *bank = channels[address->getLogical()]->
-			getRank(address->getRank())->
-			getBank(address->getBank());
+	Bank *bank = channels[address->getLogical() % num_channels]->
+			getRank(address->getRank() % num_ranks)->
+			getBank(address->getBank() % num_banks);
 
 	// Send the request to the bank to be processed.
 	bank->ProcessRequest(request);
@@ -330,6 +360,13 @@ void Controller::CommandReturnHandler(esim::Event *type, esim::Frame *frame)
 }
 
 
+void Controller::DumpReport(std::ostream &os) const
+{
+	for (auto const &channel : channels)
+		channel->DumpReport(os);
+}
+
+
 void Controller::dump(std::ostream &os) const
 {
 	// Print header
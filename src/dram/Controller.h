@@ -90,6 +90,15 @@ class Controller
 	// The page policy that command processors in this controller follow
 	PagePolicyType page_policy;
 
+	// Number of queued writes in a channel that starts and stops a write
+	// drain. A high watermark of 0 disables the write drain mode.
+	int write_drain_high_watermark = 0;
+	int write_drain_low_watermark = 0;
+
+	// Maximum number of requests per bank marked in a batch by the batch
+	// scheduler
+	int batch_marking_cap = 5;
+
 	// Timing matrix
 	int timings[4][4][2][2] = {};
 
@@ -118,6 +127,10 @@ public:
 	/// controllers.
 	int getId() const { return id; }
 
+	/// Returns the name of this controller, as given in its section of
+	/// the dram configuration file.
+	const std::string &getName() const { return name; }
+
 	/// Returns a channel that belongs to this controller with the
 	/// specified id.
 	Channel *getChannel(int id) { return channels[id].get(); }
@@ -132,6 +145,24 @@ public:
 	/// controller follow.
 	PagePolicyType getPagePolicy() { return page_policy; }
 
+	/// Returns the number of queued writes in a channel that starts a
+	/// write drain, or 0 if the write drain mode is disabled.
+	int getWriteDrainHighWatermark() const
+	{
+		return write_drain_high_watermark;
+	}
+
+	/// Returns the number of queued writes in a channel that ends a write
+	/// drain.
+	int getWriteDrainLowWatermark() const
+	{
+		return write_drain_low_watermark;
+	}
+
+	/// Returns the maximum number of requests per bank in a batch of the
+	/// batch scheduler.
+	int getBatchMarkingCap() const { return batch_marking_cap; }
+
 	/// Returns the minimum timing seperation (in number of cycles) between
 	/// two commands in two locations, based on the timing protocol matrix.
 	int getTiming(TimingCommand prev, TimingCommand next,
@@ -189,6 +220,10 @@ public:
 	/// Event handler that for when a command finishes executing.
 	static void CommandReturnHandler(esim::Event *, esim::Frame *);
 
+	/// Dump the statistics of every channel in the controller in the
+	/// format of the memory report.
+	void DumpReport(std::ostream &os = std::cout) const;
+
 	/// Dump the object to an output stream.
 	void dump(std::ostream &os = std::cout) const;
 
@@ -35,11 +35,14 @@ Request::Request()
 
 void Request::setFinished()
 {
-	// FIXME: If not in stand alone DRAM sim, return request back up
-	// through cache hierarchy.
+	// Record completion time
+	long long cycle = System::frequency_domain->getCycle();
+	cycle_finished = cycle;
+
+	// Return the request back up through the memory hierarchy
+	queue.WakeupAll();
 
 	// Debug
-	long long cycle = System::frequency_domain->getCycle();
 	System::activity << misc::fmt("[%lld] Request complete for 0x%llx\n",
 		cycle, address->getEncoded());
 }
@@ -22,6 +22,8 @@
 
 #include <memory>
 
+#include <lib/esim/Queue.h>
+
 
 namespace dram
 {
@@ -43,6 +45,22 @@ class Request
 	RequestType type;
 	std::unique_ptr<Address> address;
 
+	// Number of bytes transferred by the request
+	int size = 0;
+
+	// Event chains suspended until the request completes
+	esim::Queue queue;
+
+	// Cycles when the request was added to its controller, queued in its
+	// bank, and completed.
+	long long cycle_issued = -1;
+	long long cycle_queued = -1;
+	long long cycle_finished = -1;
+
+	// Whether the request belongs to the current batch of a batch
+	// scheduler.
+	bool marked = false;
+
 public:
 
 	Request();
@@ -53,8 +71,44 @@ public:
 	/// Sets the type of the request.
 	void setType(RequestType new_type) { type = new_type; }
 
+	/// Returns the number of bytes transferred by the request.
+	int getSize() const { return size; }
+
+	/// Sets the number of bytes transferred by the request.
+	void setSize(int size) { this->size = size; }
+
+	/// Returns the cycle when the request was added to its controller.
+	long long getCycleIssued() const { return cycle_issued; }
+
+	/// Sets the cycle when the request was added to its controller.
+	void setCycleIssued(long long cycle) { cycle_issued = cycle; }
+
+	/// Returns the cycle when the request was queued in its bank. This is
+	/// the age that schedulers use to order requests.
+	long long getCycleQueued() const { return cycle_queued; }
+
+	/// Sets the cycle when the request was queued in its bank.
+	void setCycleQueued(long long cycle) { cycle_queued = cycle; }
+
+	/// Returns the cycle when the request completed, or -1 if it is still
+	/// in flight.
+	long long getCycleFinished() const { return cycle_finished; }
+
+	/// Returns whether the request is part of the current batch.
+	bool isMarked() const { return marked; }
+
+	/// Adds the request to or removes it from the current batch.
+	void setMarked(bool marked) { this->marked = marked; }
+
+	/// Suspend the current event chain until the request completes. When
+	/// the request finishes, \a event is scheduled with the suspended
+	/// event frame. This function should only be invoked in the body of
+	/// an event handler.
+	void Wait(esim::Event *event) { queue.Wait(event); }
+
 	/// Marks the request as completed, which should happen when the
-	/// associated read or write command finishes.
+	/// associated read or write command finishes. Event chains waiting
+	/// for the request are resumed.
 	void setFinished();
 
 	/// Returns a pointer to the address object of the request.
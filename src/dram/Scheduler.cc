@@ -17,12 +17,16 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
  */
 
+#include <algorithm>
 #include <climits>
 
 #include <lib/cpp/String.h>
 
+#include "Address.h"
 #include "Bank.h"
 #include "Channel.h"
+#include "Controller.h"
+#include "Request.h"
 #include "System.h"
 #include "Scheduler.h"
 
@@ -33,10 +37,73 @@ namespace dram
 misc::StringMap SchedulerTypeMap
 {
 	{ "RankBankRoundRobin", SchedulerRankBankRoundRobin},
-	{ "OldestFirst", SchedulerOldestFirst }
+	{ "OldestFirst", SchedulerOldestFirst },
+	{ "FRFCFS", SchedulerFRFCFS },
+	{ "Batch", SchedulerBatch }
 };
 
 
+bool Scheduler::isEligible(Request *request) const
+{
+	// Write drain mode disabled
+	if (!channel->getController()->getWriteDrainHighWatermark())
+		return true;
+
+	// While draining, only writes are started. Otherwise, writes wait
+	// until no read is queued in the channel.
+	if (draining)
+		return request->getType() == RequestWrite;
+	return request->getType() != RequestWrite ||
+			!channel->getNumQueuedReads();
+}
+
+
+bool Scheduler::isRowHit(Bank *bank, Request *request)
+{
+	return bank->getActiveRowFuture() == request->getAddress()->getRow();
+}
+
+
+int Scheduler::FindNextRequest(Bank *bank)
+{
+	// Oldest request allowed to start
+	for (int i = 0; i < bank->getNumRequestsInQueue(); i++)
+		if (isEligible(bank->getRequestInQueue(i)))
+			return i;
+
+	// All requests held
+	return -1;
+}
+
+
+void Scheduler::UpdateWriteDrain()
+{
+	// Write drain mode disabled
+	Controller *controller = channel->getController();
+	int high_watermark = controller->getWriteDrainHighWatermark();
+	if (!high_watermark)
+		return;
+
+	// Enter or leave the drain mode
+	int num_writes = channel->getNumQueuedWrites();
+	long long cycle = System::frequency_domain->getCycle();
+	if (!draining && num_writes >= high_watermark)
+	{
+		draining = true;
+		System::debug.fmt("[%lld] Channel %d starts draining %d "
+				"writes\n", cycle, channel->getId(),
+				num_writes);
+	}
+	else if (draining && num_writes <=
+			controller->getWriteDrainLowWatermark())
+	{
+		draining = false;
+		System::debug.fmt("[%lld] Channel %d stops draining "
+				"writes\n", cycle, channel->getId());
+	}
+}
+
+
 Bank *OldestFirst::FindNext()
 {
 	// Keep track of the bank with the oldest command found so far.
@@ -112,7 +179,7 @@ Bank *RankBankRoundRobin::FindNext()
 
 		// Debug
 		long long cycle = System::frequency_domain->getCycle();
-		System::debug << misc::fmt("[%lld] Scheduler returns %d : %d "
+		System::debug.fmt("[%lld] Scheduler returns %d : %d "
 				"for next command scheduling\n", cycle,
 				current_rank, current_bank);
 
@@ -128,4 +195,145 @@ Bank *RankBankRoundRobin::FindNext()
 	return nullptr;
 }
 
+
+Bank *FRFCFS::FindFirstReady(bool batch)
+{
+	// Get the current cycle
+	long long cycle = System::frequency_domain->getCycle();
+
+	// Best bank found so far. Lower priority values go first. Among banks
+	// with the same priority, the command that is ready first wins, and
+	// then the oldest one.
+	Bank *best_bank = nullptr;
+	int best_priority = INT_MAX;
+	long long best_ready = LLONG_MAX;
+	long long best_created = LLONG_MAX;
+
+	// Iterate through all the ranks and banks.
+	for (int i = 0; i < channel->getNumBanksTotal(); i++)
+	{
+		// Move to the next bank if this one has no commands in queue.
+		Bank *bank = channel->getBankTotal(i);
+		if (bank->getNumCommandsInQueue() == 0)
+			continue;
+
+		// Commands that can run now go first. Among them, commands of
+		// the current batch go first if 'batch' is set, and then
+		// column accesses, which hit an open row.
+		Command *command = bank->getFrontCommand();
+		long long ready = std::max(bank->getFrontCommandTiming(),
+				cycle);
+		int priority = 4;
+		if (ready == cycle)
+		{
+			priority = command->getType() == CommandRead ||
+					command->getType() == CommandWrite ?
+					0 : 1;
+			if (batch && !command->getRequest()->isMarked())
+				priority += 2;
+		}
+
+		// Keep the best one
+		long long created = command->getCycleCreated();
+		if (priority < best_priority || (priority == best_priority &&
+				(ready < best_ready || (ready == best_ready &&
+				created < best_created))))
+		{
+			best_bank = bank;
+			best_priority = priority;
+			best_ready = ready;
+			best_created = created;
+		}
+	}
+
+	// Return the best bank, or nullptr if no bank has commands
+	return best_bank;
+}
+
+
+int FRFCFS::FindFirstReadyRequest(Bank *bank, bool batch)
+{
+	// Oldest request found for each priority. Row hits go first, and if
+	// 'batch' is set, requests outside of the current batch go last.
+	int candidates[4] = { -1, -1, -1, -1 };
+	for (int i = 0; i < bank->getNumRequestsInQueue(); i++)
+	{
+		// Skip requests held by the write drain mode
+		Request *request = bank->getRequestInQueue(i);
+		if (!isEligible(request))
+			continue;
+
+		// Record the first request of each priority, since the queue
+		// is sorted by age.
+		int priority = isRowHit(bank, request) ? 0 : 1;
+		if (batch && !request->isMarked())
+			priority += 2;
+		if (candidates[priority] < 0)
+			candidates[priority] = i;
+
+		// Nothing beats the oldest row hit
+		if (priority == 0)
+			break;
+	}
+
+	// Return the candidate with the highest priority
+	for (int position : candidates)
+		if (position >= 0)
+			return position;
+	return -1;
+}
+
+
+Bank *FRFCFS::FindNext()
+{
+	return FindFirstReady(false);
+}
+
+
+int FRFCFS::FindNextRequest(Bank *bank)
+{
+	return FindFirstReadyRequest(bank, false);
+}
+
+
+void Batch::FormBatch()
+{
+	// Mark the oldest requests of each bank
+	int marking_cap = channel->getController()->getBatchMarkingCap();
+	for (int i = 0; i < channel->getNumBanksTotal(); i++)
+	{
+		Bank *bank = channel->getBankTotal(i);
+		int num_requests = std::min(bank->getNumRequestsInQueue(),
+				marking_cap);
+		for (int j = 0; j < num_requests; j++)
+			bank->getRequestInQueue(j)->setMarked(true);
+		num_marked += num_requests;
+	}
+
+	// Debug
+	long long cycle = System::frequency_domain->getCycle();
+	System::debug.fmt("[%lld] Channel %d forms a batch of %d requests\n",
+			cycle, channel->getId(), num_marked);
+}
+
+
+Bank *Batch::FindNext()
+{
+	return FindFirstReady(true);
+}
+
+
+int Batch::FindNextRequest(Bank *bank)
+{
+	// Form a new batch when all requests of the current one started
+	if (!num_marked)
+		FormBatch();
+
+	// Requests in the batch go first
+	int position = FindFirstReadyRequest(bank, true);
+	if (position >= 0 && bank->getRequestInQueue(position)->isMarked())
+		num_marked--;
+	return position;
+}
+
 }  // namespace dram
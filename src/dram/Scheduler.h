@@ -33,13 +33,16 @@ namespace dram
 // Forward declarations
 class Bank;
 class Channel;
+class Request;
 
 
 // Possible scheduling algorithms
 enum SchedulerType
 {
 	SchedulerRankBankRoundRobin,
-	SchedulerOldestFirst
+	SchedulerOldestFirst,
+	SchedulerFRFCFS,
+	SchedulerBatch
 };
 
 // String map for SchedulerType
@@ -51,16 +54,34 @@ extern misc::StringMap SchedulerTypeMap;
 /// and should call the base class constructor.  The FindNext method should
 /// be implemented with the scheduling algorithm, and any state variables
 /// required should be added to the class.
+/// The order in which each bank starts its queued requests can be changed
+/// by overriding FindNextRequest as well.
 /// After the new scheduler is made, add it to the SchedulerType enum,
 /// SchedulerTypeMap StringMap and the switch block in Channel::Channel.
+///
+/// All schedulers support the write drain mode. When the controller sets a
+/// write drain high watermark, writes are held in the bank request queues
+/// while reads are waiting. Once the number of queued writes in the channel
+/// reaches the high watermark, writes are started ahead of reads until it
+/// falls to the low watermark.
 class Scheduler
 {
+	// True while queued writes are being drained
+	bool draining = false;
 
 protected:
 
 	// Pointer to the owning channel.
 	Channel *channel;
 
+	// Return whether the write drain mode allows the request to be
+	// started now.
+	bool isEligible(Request *request) const;
+
+	// Return whether the request will find its row open in the bank,
+	// given the commands already created for the bank.
+	static bool isRowHit(Bank *bank, Request *request);
+
 public:
 
 	Scheduler(Channel *owner)
@@ -69,10 +90,28 @@ public:
 	{
 	}
 
+	virtual ~Scheduler()
+	{
+	}
+
 	/// Returns the pointer to the next bank that should have its command
 	/// scheduled next.  In the case that one isn't found, nullptr is
 	/// returned.
 	virtual Bank *FindNext() = 0;
+
+	/// Returns the position in the request queue of \a bank of the
+	/// request that should be broken down into commands next, or -1 if
+	/// all requests should be held for now. The returned request is
+	/// started right away. The default implementation returns the oldest
+	/// request allowed by the write drain mode.
+	virtual int FindNextRequest(Bank *bank);
+
+	/// Enter or leave the write drain mode based on the number of writes
+	/// queued in the channel and the watermarks of the controller.
+	void UpdateWriteDrain();
+
+	/// Returns whether queued writes are being drained.
+	bool isDraining() const { return draining; }
 };
 
 
@@ -111,6 +150,75 @@ public:
 	Bank *FindNext();
 };
 
+
+/// First-Ready First-Come First-Served. Each bank starts the oldest request
+/// that hits its open row before any other request. Across banks, commands
+/// that can run this cycle are preferred, column accesses to an open row
+/// first, and the oldest one wins among equals.
+class FRFCFS : public Scheduler
+{
+
+protected:
+
+	// Return the bank whose front command should run next. If 'batch' is
+	// true, commands of requests in the current batch go first.
+	Bank *FindFirstReady(bool batch);
+
+	// Return the position of the request that the bank should start
+	// next. If 'batch' is true, requests in the current batch go first.
+	int FindFirstReadyRequest(Bank *bank, bool batch);
+
+public:
+
+	FRFCFS(Channel *owner)
+			:
+			Scheduler(owner)
+	{
+	}
+
+	/// Returns the pointer to the next bank that should have its command
+	/// scheduled next based on the FR-FCFS algorithm.
+	Bank *FindNext();
+
+	/// Returns the position of the oldest queued request that hits the
+	/// open row of \a bank, or the oldest request if none does.
+	int FindNextRequest(Bank *bank);
+};
+
+
+/// Batch scheduler in the style of PAR-BS. When no request of the current
+/// batch is left, the oldest requests in each bank queue, up to the
+/// controller's marking cap, are marked as the new batch. Among requests
+/// and commands that can be served, marked ones go first, following FR-FCFS
+/// among themselves, which keeps row hit streams from starving older
+/// requests. Requests carry no thread identifier in this model, so the cap
+/// is applied per bank and there is no thread ranking within a batch.
+class Batch : public FRFCFS
+{
+	// Number of marked requests that have not been started yet
+	int num_marked = 0;
+
+	// Mark the oldest requests of every bank queue as the new batch.
+	void FormBatch();
+
+public:
+
+	Batch(Channel *owner)
+			:
+			FRFCFS(owner)
+	{
+	}
+
+	/// Returns the pointer to the next bank that should have its command
+	/// scheduled next, giving priority to the current batch.
+	Bank *FindNext();
+
+	/// Returns the position of the request that \a bank should start next,
+	/// giving priority to the current batch and forming a new one when it
+	/// is exhausted.
+	int FindNextRequest(Bank *bank);
+};
+
 }  // namespace dram
 
 #endif
@@ -47,8 +47,6 @@ std::string activity_file;
 
 std::string config_file;
 
-bool System::stand_alone = false;
-
 bool System::help = false;
 
 int System::frequency = 667;
@@ -89,12 +87,25 @@ const std::string System::help_message =
 		"Section [MemoryController <name>] defines a generic DRAM device. This section is\n"
 		"used to define the modes of the DRAM, the size of the componants and the timings.\n"
 		"The default configuration results in an 8GB DRAM device with typical timings for \n"
-		"a DDR3 device running at 1600MHz.\n"
+		"a DDR3 device running at 1600MHz. A main memory module in the memory\n"
+		"configuration file is backed by a controller with variable 'DRAM = <name>'.\n"
 		"\n"
 		"  PagePolicy = {Open|Closed} (Default = Open) \n"
 		"      Policy that dictates whether the row of a bank remains open or closed.\n"
-		"  SchedulingPolicy = {OldestFirst|BankRoundRobin} (Default = OldestFirst)\n"
+		"  SchedulingPolicy = {OldestFirst|RankBankRoundRobin|FRFCFS|Batch}\n"
+		"          (Default = OldestFirst)\n"
 		"      Policy that determines which bank is allowed to execute a command.\n"
+		"      FRFCFS serves requests that hit an open row first. Batch groups\n"
+		"      the oldest requests of each bank into batches, served first, and\n"
+		"      uses FRFCFS within a batch.\n"
+		"  BatchMarkingCap = <num> (Default = 5)\n"
+		"      Maximum number of requests per bank in a batch of the Batch policy.\n"
+		"  WriteDrainHighWatermark = <num> (Default = 0)\n"
+		"      Number of writes queued in a channel that starts a write drain. While\n"
+		"      not draining, writes wait until no read is queued. While draining,\n"
+		"      writes go before reads. A value of 0 disables write draining.\n"
+		"  WriteDrainLowWatermark = <num> (Default = 0)\n"
+		"      Number of queued writes at which a write drain ends.\n"
 		"  NumChannels = <num> (Default =  1)\n"
 		"      Number of channels in the DRAM system.\n"
 		"  NumRanks = <num> (Default = 2)\n"
@@ -148,6 +159,15 @@ System::System()
 }
 
 
+Controller *System::getController(const std::string &name)
+{
+	for (auto &controller : controllers)
+		if (controller->getName() == name)
+			return controller.get();
+	return nullptr;
+}
+
+
 int System::getCapacity()
 {
 	int num_controllers = 1;
@@ -181,20 +201,10 @@ int System::getCapacity()
 
 void System::RegisterOptions()
 {
-/*
-	//
-	// FIXME: These options are removed, in order to be excluded from
-	// the m2s --help. However, later when we hook up the DRAM model to
-	// the memory system, it will come back.
-	// 
-	// FIXME 2: A whole --dram-trace option should be added as an 
-	// input to the stand-alone DRAM. Otherwise, the stand-alone
-	// does not make any sense. It cannot be actions, as part of the
-	// configuration file.
-	//
-	// FIXME 3: The debug and debug_activity files should be combined
+	// FIXME: The debug and debug_activity files should be combined
 	// into one. It does not make sense to have both of them as two
-	// separate file.  
+	// separate file.
+
 	// Get command line object
 	misc::CommandLine *command_line = misc::CommandLine::getInstance();
 
@@ -217,27 +227,21 @@ void System::RegisterOptions()
 	command_line->RegisterString("--dram-config <file>",
 			config_file,
 			"DRAM configuration file. Memory controllers and "
-			"their components can be defined here.");
+			"their components can be defined here. Main memory "
+			"modules of the memory hierarchy refer to these "
+			"controllers with variable 'DRAM' in their section of "
+			"the memory configuration file.");
 
 	// Help message for dram configuration
 	command_line->RegisterBool("--dram-help",
 			help,
-			"Print help message describing the network configuration"
+			"Print help message describing the DRAM configuration"
 			" file, passed in option '--dram-config <file>'.");
-
-	// Stand-alone simulator
-	command_line->RegisterBool("--dram-sim",
-			stand_alone,
-			"Runs a DRAM simulation using the actions provided "
-			"in the DRAM configuration file (option "
-			"'--dram-config').");
-*/
 }
 
 
 void System::ProcessOptions()
 {
-/*
 	// DRAM help
 	if (help)
 	{
@@ -252,12 +256,6 @@ void System::ProcessOptions()
 	// Activity Debugger
 	if (!activity_file.empty())
 		setActivityDebugPath(activity_file);
-
-	// Stand-Alone requires config file
-	if (stand_alone && config_file.empty())
-		throw Error(misc::fmt("Option --dram-sim requires "
-				" --dram-config option "));
-*/
 }
 
 
@@ -346,7 +344,7 @@ void System::AddRequest(std::shared_ptr<Request> request)
 	controllers[address->getPhysical()]->AddRequest(request);
 
 	// Debug
-	debug << misc::fmt("[%lld] Adding request for 0x%llx to controller %d\n",
+	debug.fmt("[%lld] Adding request for 0x%llx to controller %d\n",
 			frequency_domain->getCycle(), address->getEncoded(),
 			address->getPhysical());
 }
@@ -428,6 +426,13 @@ void System::Write(long long address)
 }
 
 
+void System::DumpReport(std::ostream &os) const
+{
+	for (auto &controller : controllers)
+		controller->DumpReport(os);
+}
+
+
 void System::Dump(std::ostream &os) const
 {
 	
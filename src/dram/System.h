@@ -77,9 +77,6 @@ class System
 	/// Frequency
 	static int frequency;
 
-	// Stand-alone simulator instantiator
-	static bool stand_alone;
-
 	// Message to display with '--net-help'
 	static const std::string help_message;
 
@@ -119,12 +116,16 @@ public:
 	/// Obtain the instance of the dram simulator singleton.
 	static System *getInstance();
 
+	/// Return whether the dram simulator singleton was instantiated.
+	static bool hasInstance() { return instance.get(); }
+
 	/// Returns a channel that belongs to this controller with the
 	/// specified id.
 	Controller *getController(int id) { return controllers[id].get(); }
 
-	/// Returns whether or not DRAM is running as a stand alone simulator.
-	static bool isStandAlone() { return stand_alone; }
+	/// Returns the controller with the given name, or `nullptr` if no
+	/// controller was defined with that name in the configuration file.
+	Controller *getController(const std::string &name);
 
 	/// Returns the size in bits of the physical channel address component.
 	int getPhysicalSize() const { return physical_size; }
@@ -201,6 +202,10 @@ public:
 	/// Send a write request to the dram device
 	void Write(long long address);
 
+	/// Dump the per-channel statistics of all controllers in the format
+	/// of the memory report.
+	void DumpReport(std::ostream &os = std::cout) const;
+
 	/// Dump the object to an output stream.
 	void Dump(std::ostream &os = std::cout) const;
 
@@ -0,0 +1,123 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2014  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cassert>
+
+#include <lib/cpp/Error.h>
+#include <lib/cpp/String.h>
+
+#include "Checkpoint.h"
+
+
+namespace misc
+{
+
+// Identifier at the beginning of every checkpoint file, including a version
+// number to be incremented when the format changes.
+static const char checkpoint_magic[] = "m2s-checkpoint-1";
+
+
+Checkpoint::Checkpoint(const std::string &path, bool write) :
+		path(path),
+		write(write)
+{
+	// Open file
+	gz_file = gzopen(path.c_str(), write ? "wb" : "rb");
+	if (!gz_file)
+		throw Error(fmt("%s: cannot open checkpoint file",
+				path.c_str()));
+
+	// Write or check header
+	try
+	{
+		if (write)
+			WriteTag(checkpoint_magic);
+		else
+			ReadTag(checkpoint_magic);
+	}
+	catch (...)
+	{
+		gzclose(gz_file);
+		throw;
+	}
+}
+
+
+Checkpoint::~Checkpoint()
+{
+	gzclose(gz_file);
+}
+
+
+void Checkpoint::Write(const void *buffer, unsigned size)
+{
+	assert(write);
+	if (size && gzwrite(gz_file, buffer, size) != (int) size)
+		throw Error(fmt("%s: error writing checkpoint file",
+				path.c_str()));
+}
+
+
+void Checkpoint::Read(void *buffer, unsigned size)
+{
+	assert(!write);
+	if (size && gzread(gz_file, buffer, size) != (int) size)
+		throw Error(fmt("%s: unexpected end of checkpoint file",
+				path.c_str()));
+}
+
+
+void Checkpoint::WriteString(const std::string &s)
+{
+	WriteValue<unsigned>(s.length());
+	Write(s.data(), s.length());
+}
+
+
+std::string Checkpoint::ReadString()
+{
+	unsigned length = ReadValue<unsigned>();
+	std::string s(length, '\0');
+	Read(&s[0], length);
+	return s;
+}
+
+
+void Checkpoint::WriteTag(const std::string &tag)
+{
+	WriteString(tag);
+}
+
+
+void Checkpoint::ReadTag(const std::string &tag)
+{
+	// Read length first, to avoid allocating a huge string when reading
+	// a file that is not a checkpoint.
+	unsigned length = ReadValue<unsigned>();
+	std::string s(std::min(length, 256u), '\0');
+	if (length == tag.length())
+		Read(&s[0], length);
+	if (length != tag.length() || s != tag)
+		throw Error(fmt("%s: invalid checkpoint file, expected "
+				"section '%s'", path.c_str(), tag.c_str()));
+}
+
+
+}  // namespace misc
@@ -0,0 +1,104 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2014  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LIB_CPP_CHECKPOINT_H
+#define LIB_CPP_CHECKPOINT_H
+
+#include <string>
+#include <zlib.h>
+
+
+namespace misc
+{
+
+/// Compressed binary file storing a snapshot of the simulation state. The
+/// file is written or read sequentially, in the same order. Values are
+/// stored in the host byte order, so a checkpoint can only be loaded by a
+/// simulator built for the same host architecture. Sections of the file are
+/// delimited with tags, which are verified while reading to detect corrupt
+/// or mismatching files.
+class Checkpoint
+{
+	// Path of the checkpoint file
+	std::string path;
+
+	// Flag indicating whether the file is open for writing
+	bool write;
+
+	// ZIP file object
+	gzFile gz_file;
+
+public:
+
+	/// Open checkpoint file \a path for writing if \a write is `true`, or
+	/// for reading otherwise.
+	///
+	/// \throw
+	///	A misc::Error is thrown if the file cannot be opened, or if it
+	///	is opened for reading and it is not a valid checkpoint file.
+	Checkpoint(const std::string &path, bool write);
+
+	/// Destructor, closing the file
+	~Checkpoint();
+
+	/// Return the path of the checkpoint file
+	const std::string &getPath() const { return path; }
+
+	/// Return whether the checkpoint is open for writing
+	bool isWrite() const { return write; }
+
+	/// Write \a size bytes from \a buffer
+	void Write(const void *buffer, unsigned size);
+
+	/// Read \a size bytes into \a buffer. A misc::Error is thrown if the
+	/// end of the file is reached.
+	void Read(void *buffer, unsigned size);
+
+	/// Write a value of a plain data type
+	template<typename T> void WriteValue(const T &value)
+	{
+		Write(&value, sizeof(T));
+	}
+
+	/// Read a value of a plain data type
+	template<typename T> T ReadValue()
+	{
+		T value;
+		Read(&value, sizeof(T));
+		return value;
+	}
+
+	/// Write a string, preceded by its length
+	void WriteString(const std::string &s);
+
+	/// Read a string written with WriteString()
+	std::string ReadString();
+
+	/// Write a tag marking the beginning of a section
+	void WriteTag(const std::string &tag);
+
+	/// Read a tag written with WriteTag(). A misc::Error is thrown if it
+	/// does not match \a tag.
+	void ReadTag(const std::string &tag);
+};
+
+
+}  // namespace misc
+
+#endif
@@ -21,6 +21,7 @@
 #include <iostream>
 
 #include "Debug.h"
+#include "String.h"
 
 
 namespace misc
@@ -78,6 +79,13 @@ void Debug::setPath(const std::string &path)
 }
 
 
+void Debug::Dump(const char *fmt_str, va_list va)
+{
+	*os << prefix << misc::vfmt(fmt_str, va);
+	Flush();
+}
+
+
 void Debug::Flush()
 {
 	if (os)
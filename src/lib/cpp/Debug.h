@@ -21,6 +21,7 @@
 #define LIB_CPP_DEBUG_H
 
 #include <cassert>
+#include <cstdarg>
 #include <string>
 
 
@@ -49,6 +50,10 @@ namespace misc
 ///   This can be useful to avoid formating debug information in
 ///   performance-critical code sections, if the debug category is disabled.
 ///
+/// - Formatted messages should be dumped with fmt(), which takes the same
+///   arguments as misc::fmt() but only formats the message if the debug
+///   category is active.
+///
 class Debug
 {
 	// Path to dump debug info
@@ -66,6 +71,9 @@ class Debug
 	// Close debugger
 	void Close();
 
+	// Format a message and dump it into the output stream
+	void Dump(const char *fmt_str, va_list va);
+
 public:
 	
 	/// Constructor
@@ -95,14 +103,31 @@ public:
 	/// debug object. If the debugger has not been initialized with a call
 	/// to setPath(), this call is ignored. The argument can be of any
 	/// type accepted by an \c std::ostream object.
-	template<typename T> Debug& operator<<(T val)
+	template<typename T> Debug& operator<<(const T &val)
 	{
 		if (os && active)
+		{
 			*os << prefix << val;
-		Flush();
+			Flush();
+		}
 		return *this;
 	}
 
+	/// Dump a message formatted with the same rules as misc::fmt(). The
+	/// message is only formatted if the debugger is active, so this call
+	/// is cheap in performance-critical code when debug information is
+	/// not requested.
+	void fmt(const char *fmt_str, ...)
+			__attribute__ ((format(printf, 2, 3)))
+	{
+		if (!os || !active)
+			return;
+		va_list va;
+		va_start(va, fmt_str);
+		Dump(fmt_str, va);
+		va_end(va);
+	}
+
 	/// A debugger can be cast into a \c bool (e.g. within an \c if
 	/// condition)
 	/// to check whether it has an active output stream or not. This is
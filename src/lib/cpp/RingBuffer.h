@@ -0,0 +1,240 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LIB_CPP_RING_BUFFER_H
+#define LIB_CPP_RING_BUFFER_H
+
+#include <cassert>
+#include <utility>
+#include <vector>
+
+
+namespace misc
+{
+
+/// Double-ended queue stored in a circular array, intended for FIFO
+/// structures with a known typical occupancy. Elements are inserted and
+/// removed at both ends without allocating memory, as long as the number of
+/// elements does not exceed the capacity. Beyond that, the array doubles its
+/// size. The interface follows that of std::deque, so that the ring buffer
+/// can replace standard containers with no changes in the code using them.
+template<typename T> class RingBuffer
+{
+	// Circular array, with a power-of-two size
+	std::vector<T> buffer;
+
+	// Mask applied to indexes, equal to the size of the array minus one
+	unsigned mask;
+
+	// Position of the first element in the array
+	unsigned head = 0;
+
+	// Number of elements
+	unsigned count = 0;
+
+	// Double the size of the array
+	void Grow()
+	{
+		std::vector<T> new_buffer(buffer.size() * 2);
+		for (unsigned i = 0; i < count; i++)
+			new_buffer[i] = std::move(buffer[(head + i) & mask]);
+		buffer.swap(new_buffer);
+		mask = buffer.size() - 1;
+		head = 0;
+	}
+
+public:
+
+	/// Iterator to an element in the ring buffer, where \a R is the ring
+	/// buffer type and \a V is the element type, both of them const for
+	/// constant iterators.
+	template<typename R, typename V> class IteratorBase
+	{
+		// Ring buffer
+		R *ring;
+
+		// Position of the element, relative to the head
+		int index;
+
+	public:
+
+		/// Constructor
+		IteratorBase(R *ring, int index) :
+				ring(ring),
+				index(index)
+		{
+		}
+
+		/// Compare iterators
+		bool operator!=(const IteratorBase &right) const
+		{
+			return index != right.index;
+		}
+
+		/// Compare iterators
+		bool operator==(const IteratorBase &right) const
+		{
+			return index == right.index;
+		}
+
+		/// Advance to the next element
+		IteratorBase &operator++()
+		{
+			index++;
+			return *this;
+		}
+
+		/// Return the element
+		V &operator*() const
+		{
+			return (*ring)[index];
+		}
+
+		/// Access a field of the element
+		V *operator->() const
+		{
+			return &(*ring)[index];
+		}
+	};
+
+	/// Iterator
+	typedef IteratorBase<RingBuffer, T> Iterator;
+
+	/// Constant iterator
+	typedef IteratorBase<const RingBuffer, const T> ConstIterator;
+
+	/// Constructor. The ring buffer initially holds up to \a capacity
+	/// elements, rounded up to a power of two.
+	explicit RingBuffer(int capacity = 16)
+	{
+		unsigned size = 1;
+		while ((int) size < capacity)
+			size <<= 1;
+		buffer.resize(size);
+		mask = size - 1;
+	}
+
+	/// Make room for at least \a capacity elements
+	void reserve(int capacity)
+	{
+		while ((int) buffer.size() < capacity)
+			Grow();
+	}
+
+	/// Return the number of elements
+	int size() const { return count; }
+
+	/// Return whether the ring buffer is empty
+	bool empty() const { return count == 0; }
+
+	/// Return the number of elements that fit without growing the array
+	int capacity() const { return buffer.size(); }
+
+	/// Return the element at position \a index, counting from the head
+	T &operator[](int index)
+	{
+		assert(index >= 0 && index < (int) count);
+		return buffer[(head + index) & mask];
+	}
+
+	/// Return the element at position \a index, counting from the head
+	const T &operator[](int index) const
+	{
+		assert(index >= 0 && index < (int) count);
+		return buffer[(head + index) & mask];
+	}
+
+	/// Return the first element
+	T &front()
+	{
+		assert(count > 0);
+		return buffer[head];
+	}
+
+	/// Return the last element
+	T &back()
+	{
+		assert(count > 0);
+		return buffer[(head + count - 1) & mask];
+	}
+
+	/// Insert an element at the end
+	void push_back(T value)
+	{
+		if (count == buffer.size())
+			Grow();
+		buffer[(head + count) & mask] = std::move(value);
+		count++;
+	}
+
+	/// Insert an element at the beginning
+	void push_front(T value)
+	{
+		if (count == buffer.size())
+			Grow();
+		head = (head - 1) & mask;
+		buffer[head] = std::move(value);
+		count++;
+	}
+
+	/// Remove the first element. The slot is reset to a default value,
+	/// so that resources held by the element, such as a shared pointer,
+	/// are released.
+	void pop_front()
+	{
+		assert(count > 0);
+		T value = std::move(buffer[head]);
+		buffer[head] = T();
+		head = (head + 1) & mask;
+		count--;
+	}
+
+	/// Remove the last element, releasing its resources
+	void pop_back()
+	{
+		assert(count > 0);
+		count--;
+		T value = std::move(buffer[(head + count) & mask]);
+		buffer[(head + count) & mask] = T();
+	}
+
+	/// Remove all elements
+	void clear()
+	{
+		while (count)
+			pop_back();
+	}
+
+	/// Return an iterator to the first element
+	Iterator begin() { return Iterator(this, 0); }
+
+	/// Return a past-the-end iterator
+	Iterator end() { return Iterator(this, count); }
+
+	/// Return a constant iterator to the first element
+	ConstIterator begin() const { return ConstIterator(this, 0); }
+
+	/// Return a constant past-the-end iterator
+	ConstIterator end() const { return ConstIterator(this, count); }
+};
+
+
+}  // namespace misc
+
+#endif
@@ -50,10 +50,17 @@ const char *StringErrorToString(StringError error)
 
 std::string fmt(const char *fmt_str, ...)
 {
-	char buf[1024];
 	va_list va;
-
 	va_start(va, fmt_str);
+	std::string s = vfmt(fmt_str, va);
+	va_end(va);
+	return s;
+}
+
+
+std::string vfmt(const char *fmt_str, va_list va)
+{
+	char buf[1024];
 	vsnprintf(buf, sizeof buf, fmt_str, va);
 	return buf;
 }
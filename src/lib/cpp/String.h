@@ -21,6 +21,7 @@
 #define LIB_CPP_STRING_H
 
 #include <cassert>
+#include <cstdarg>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -52,6 +53,10 @@ const char *StringErrorToString(StringError error);
 std::string fmt(const char *fmt_str, ...)
 		__attribute__ ((format(printf, 1, 2)));
 
+/// Version of fmt() taking a variable argument list.
+std::string vfmt(const char *fmt_str, va_list va)
+		__attribute__ ((format(printf, 1, 0)));
+
 /// Return \c true if the character given in \a c is present in string \a set.
 inline bool StringHasChar(const std::string &set, char c)
 {
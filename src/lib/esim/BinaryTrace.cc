@@ -0,0 +1,1189 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2014  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cctype>
+#include <cstring>
+#include <zlib.h>
+
+#include <lib/cpp/Error.h>
+#include <lib/cpp/Misc.h>
+#include <lib/cpp/String.h>
+
+#include "BinaryTrace.h"
+
+
+namespace esim
+{
+
+// Magic strings and version
+static const char binary_trace_magic[8] = { 'm', '2', 's', 't', 'r', 'a', 'c', 'e' };
+static const char binary_trace_index_magic[8] = { 'm', '2', 's', 'i', 'n', 'd', 'e', 'x' };
+static const unsigned binary_trace_version = 2;
+
+// Size of the file header and footer
+static const long long binary_trace_header_size = 12;
+static const long long binary_trace_footer_size = 16;
+
+
+// Characters allowed in commands, field names, and unquoted values of the
+// text trace. Same as in the visualization tool.
+static bool isIdChar(char c)
+{
+	return isalnum((unsigned char) c) || c == '.' || c == '_' || c == '-';
+}
+
+
+// Append a varint to a string
+static void WriteVarint(std::string &s, unsigned long long value)
+{
+	while (value >= 0x80)
+	{
+		s += (char) (value | 0x80);
+		value >>= 7;
+	}
+	s += (char) value;
+}
+
+
+// Write fixed-size little-endian integers
+static void WriteUInt32(FILE *f, unsigned value)
+{
+	unsigned char bytes[4];
+	for (int i = 0; i < 4; i++)
+		bytes[i] = value >> (i * 8);
+	fwrite(bytes, 1, 4, f);
+}
+
+static void WriteUInt64(FILE *f, unsigned long long value)
+{
+	unsigned char bytes[8];
+	for (int i = 0; i < 8; i++)
+		bytes[i] = value >> (i * 8);
+	fwrite(bytes, 1, 8, f);
+}
+
+
+// Read fixed-size little-endian integers. Return false on end of file.
+static bool ReadUInt32(FILE *f, unsigned &value)
+{
+	unsigned char bytes[4];
+	if (fread(bytes, 1, 4, f) != 4)
+		return false;
+	value = 0;
+	for (int i = 0; i < 4; i++)
+		value |= (unsigned) bytes[i] << (i * 8);
+	return true;
+}
+
+static bool ReadUInt64(FILE *f, unsigned long long &value)
+{
+	unsigned char bytes[8];
+	if (fread(bytes, 1, 8, f) != 8)
+		return false;
+	value = 0;
+	for (int i = 0; i < 8; i++)
+		value |= (unsigned long long) bytes[i] << (i * 8);
+	return true;
+}
+
+
+// Check whether a string of digits has no leading zeros and fits in a
+// signed 64-bit integer
+static bool isCanonicalDigits(const char *s, unsigned size)
+{
+	if (size < 1 || size > 18)
+		return false;
+	if (s[0] == '0' && size > 1)
+		return false;
+	for (unsigned i = 0; i < size; i++)
+		if (!isdigit((unsigned char) s[i]))
+			return false;
+	return true;
+}
+
+
+// Convert a string of digits, not null-terminated, into an integer
+static long long ParseDecimal(const char *s, unsigned size)
+{
+	long long value = 0;
+	for (unsigned i = 0; i < size; i++)
+		value = value * 10 + s[i] - '0';
+	return value;
+}
+
+
+// Append an integer to a string, in the format of printf's %llu
+static void AppendUnsigned(std::string &s, unsigned long long value)
+{
+	char buffer[24];
+	char *p = buffer + sizeof buffer;
+	do
+	{
+		*--p = '0' + value % 10;
+		value /= 10;
+	} while (value);
+	s.append(p, buffer + sizeof buffer - p);
+}
+
+
+// Append an integer to a string, in the format of printf's %lld
+static void AppendDecimal(std::string &s, long long value)
+{
+	if (value < 0)
+		s += '-';
+	AppendUnsigned(s, value < 0 ? -(unsigned long long) value : value);
+}
+
+
+// Append an integer to a string, in the format of printf's %llx
+static void AppendHexDigits(std::string &s, unsigned long long value)
+{
+	char buffer[24];
+	char *p = buffer + sizeof buffer;
+	do
+	{
+		*--p = "0123456789abcdef"[value & 0xf];
+		value >>= 4;
+	} while (value);
+	s.append(p, buffer + sizeof buffer - p);
+}
+
+
+// Append an integer to a string, in the format of printf's 0x%llx
+static void AppendHex(std::string &s, unsigned long long value)
+{
+	s += "0x";
+	AppendHexDigits(s, value);
+}
+
+
+//
+// Class 'BinaryTraceWriter'
+//
+
+BinaryTraceWriter::BinaryTraceWriter(const std::string &path) :
+		path(path)
+{
+	// Create file
+	f = fopen(path.c_str(), "wb");
+	if (!f)
+		throw misc::Error(misc::fmt("%s: cannot open trace file",
+				path.c_str()));
+
+	// Header
+	fwrite(binary_trace_magic, 1, sizeof binary_trace_magic, f);
+	WriteUInt32(f, binary_trace_version);
+
+	// Start background thread
+	pthread_mutex_init(&lock, nullptr);
+	pthread_cond_init(&cond, nullptr);
+	if (pthread_create(&thread, nullptr, ThreadFunc, this))
+	{
+		pthread_mutex_destroy(&lock);
+		pthread_cond_destroy(&cond);
+		fclose(f);
+		throw misc::Error(misc::fmt("%s: cannot create trace thread",
+				path.c_str()));
+	}
+}
+
+
+BinaryTraceWriter::~BinaryTraceWriter()
+{
+	Close();
+}
+
+
+void BinaryTraceWriter::Write(const std::string &s)
+{
+	// Encode complete lines, the first one possibly starting in a
+	// previous call
+	const char *data = s.data();
+	unsigned size = s.size();
+	unsigned start = 0;
+	for (unsigned i = 0; i < size; i++)
+	{
+		if (data[i] != '\n')
+			continue;
+		if (partial_line.empty())
+		{
+			EncodeLine(data + start, i - start);
+		}
+		else
+		{
+			partial_line.append(data + start, i - start);
+			EncodeLine(partial_line.data(), partial_line.size());
+			partial_line.clear();
+		}
+		start = i + 1;
+	}
+	partial_line.append(data + start, size - start);
+}
+
+
+bool BinaryTraceWriter::WriteFormat(const char *fmt_str, va_list va)
+{
+	// A line is in progress
+	if (!partial_line.empty())
+		return false;
+
+	// Parse format string the first time it is seen
+	std::unique_ptr<Format> &format = formats[fmt_str];
+	if (!format || format->text != fmt_str)
+		format = ParseFormat(fmt_str);
+	if (!format->valid)
+		return false;
+
+	// Encode line, without consuming the caller's arguments
+	va_list args;
+	va_copy(args, va);
+	bool result = EncodeFormat(*format, args);
+	va_end(args);
+	return result;
+}
+
+
+void BinaryTraceWriter::WriteCycle(long long cycle)
+{
+	// A line is in progress, so the cycle is appended to it as text
+	if (!partial_line.empty())
+	{
+		std::string s = "c clk=";
+		AppendDecimal(s, cycle);
+		s += '\n';
+		Write(s);
+		return;
+	}
+
+	// Cycle record
+	EncodeCycle(cycle);
+}
+
+
+void BinaryTraceWriter::Close()
+{
+	// Already closed
+	if (!f)
+		return;
+
+	// Last line without a newline character, and last block
+	if (!partial_line.empty())
+	{
+		EncodeLine(partial_line.data(), partial_line.size());
+		partial_line.clear();
+	}
+	FlushBlock();
+
+	// Stop background thread after it wrote all blocks
+	pthread_mutex_lock(&lock);
+	done = true;
+	pthread_cond_broadcast(&cond);
+	pthread_mutex_unlock(&lock);
+	pthread_join(thread, nullptr);
+	pthread_mutex_destroy(&lock);
+	pthread_cond_destroy(&cond);
+
+	// Close file
+	bool error = ferror(f);
+	fclose(f);
+	f = nullptr;
+	if (error)
+		misc::Warning("%s: error writing trace file", path.c_str());
+}
+
+
+void *BinaryTraceWriter::ThreadFunc(void *arg)
+{
+	BinaryTraceWriter *writer = (BinaryTraceWriter *) arg;
+	while (true)
+	{
+		// Wait for a block
+		pthread_mutex_lock(&writer->lock);
+		while (writer->queue.empty() && !writer->done)
+			pthread_cond_wait(&writer->cond, &writer->lock);
+		if (writer->queue.empty())
+		{
+			pthread_mutex_unlock(&writer->lock);
+			break;
+		}
+		Block block = std::move(writer->queue.front());
+		writer->queue.pop_front();
+		pthread_cond_broadcast(&writer->cond);
+		pthread_mutex_unlock(&writer->lock);
+
+		// Compress and write it
+		writer->WriteBlock(block);
+	}
+
+	// Index
+	writer->WriteIndex();
+	return nullptr;
+}
+
+
+unsigned BinaryTraceWriter::getStringId(const char *s, unsigned size)
+{
+	// Existing string
+	key.assign(s, size);
+	auto it = string_ids.find(key);
+	if (it != string_ids.end())
+		return it->second;
+
+	// Define new string
+	unsigned id = strings.size();
+	string_ids[key] = id;
+	strings.push_back(key);
+	block += (char) BinaryTraceRecordString;
+	WriteVarint(block, id);
+	WriteVarint(block, size);
+	block.append(s, size);
+	return id;
+}
+
+
+void BinaryTraceWriter::EncodeValue(const char *s, unsigned size, bool quoted)
+{
+	// Decimal integer
+	bool negative = size && s[0] == '-';
+	if (isCanonicalDigits(s + negative, size - negative) &&
+			!(negative && s[1] == '0'))
+	{
+		long long number = ParseDecimal(s + negative, size - negative);
+		if (negative)
+			number = -number;
+		record += (char) (BinaryTraceValueInt | quoted);
+		WriteVarint(record, ((unsigned long long) number << 1) ^
+				(unsigned long long) (number >> 63));
+		return;
+	}
+
+	// Hexadecimal integer
+	if (size > 2 && size <= 18 && s[0] == '0' && s[1] == 'x' &&
+			(s[2] != '0' || size == 3))
+	{
+		bool valid = true;
+		for (unsigned i = 2; i < size; i++)
+			if (!isdigit((unsigned char) s[i]) &&
+					!(s[i] >= 'a' && s[i] <= 'f'))
+				valid = false;
+		if (valid)
+		{
+			record += (char) (BinaryTraceValueHex | quoted);
+			unsigned long long number = 0;
+			for (unsigned i = 2; i < size; i++)
+				number = number * 16 + (isdigit((unsigned char) s[i]) ?
+						s[i] - '0' : s[i] - 'a' + 10);
+			WriteVarint(record, number);
+			return;
+		}
+	}
+
+	// String followed by a decimal integer, such as an access name
+	unsigned prefix_size = size;
+	while (prefix_size && isdigit((unsigned char) s[prefix_size - 1]))
+		prefix_size--;
+	if (prefix_size && isCanonicalDigits(s + prefix_size,
+			size - prefix_size))
+	{
+		unsigned id = getStringId(s, prefix_size);
+		record += (char) (BinaryTraceValuePrefixInt | quoted);
+		WriteVarint(record, id);
+		WriteVarint(record, ParseDecimal(s + prefix_size,
+				size - prefix_size));
+		return;
+	}
+
+	// Plain string
+	unsigned id = getStringId(s, size);
+	record += (char) (BinaryTraceValueString | quoted);
+	WriteVarint(record, id);
+}
+
+
+void BinaryTraceWriter::EncodeCycle(long long cycle)
+{
+	this->cycle = cycle;
+	if (block.size() >= block_size)
+		FlushBlock();
+	if (block.empty())
+		block_first_cycle = cycle;
+	block += (char) BinaryTraceRecordCycle;
+	WriteVarint(block, cycle);
+}
+
+
+void BinaryTraceWriter::EncodeLine(const char *line, unsigned size)
+{
+	// Command
+	unsigned command_size = 0;
+	while (command_size < size && isIdChar(line[command_size]))
+		command_size++;
+
+	// Fields. Lines not following the trace syntax exactly are stored as
+	// raw text, so that the text trace can be reproduced.
+	fields.clear();
+	bool raw = !command_size;
+	unsigned i = command_size;
+	while (!raw && i < size)
+	{
+		// Field name
+		Field field;
+		field.name = i + 1;
+		if (line[i] != ' ')
+		{
+			raw = true;
+			break;
+		}
+		for (i = field.name; i < size && isIdChar(line[i]); i++);
+		if (i == field.name || i == size || line[i] != '=')
+		{
+			raw = true;
+			break;
+		}
+		field.name_size = i - field.name;
+		i++;
+
+		// Quoted value
+		field.quoted = i < size && line[i] == '"';
+		if (field.quoted)
+		{
+			field.value = ++i;
+			while (i < size && line[i] != '"')
+				i++;
+			if (i == size)
+			{
+				raw = true;
+				break;
+			}
+			field.value_size = i - field.value;
+			fields.push_back(field);
+			i++;
+			continue;
+		}
+
+		// Unquoted value
+		for (field.value = i; i < size && isIdChar(line[i]); i++);
+		field.value_size = i - field.value;
+		if (!field.value_size)
+		{
+			raw = true;
+			break;
+		}
+		fields.push_back(field);
+	}
+
+	// New cycle
+	if (!raw && command_size == 1 && line[0] == 'c' &&
+			fields.size() == 1 && fields[0].name_size == 3 &&
+			!strncmp(line + fields[0].name, "clk", 3) &&
+			!fields[0].quoted &&
+			isCanonicalDigits(line + fields[0].value,
+					fields[0].value_size))
+	{
+		EncodeCycle(ParseDecimal(line + fields[0].value,
+				fields[0].value_size));
+		return;
+	}
+
+	// Raw line
+	if (block.empty())
+		block_first_cycle = cycle;
+	if (raw)
+	{
+		block += (char) BinaryTraceRecordRaw;
+		WriteVarint(block, size);
+		block.append(line, size);
+		return;
+	}
+
+	// Encode line. Strings are defined in the block as they are found,
+	// before the line record.
+	record.clear();
+	record += (char) BinaryTraceRecordLine;
+	WriteVarint(record, getStringId(line, command_size));
+	WriteVarint(record, fields.size());
+	for (auto &field : fields)
+	{
+		WriteVarint(record, getStringId(line + field.name,
+				field.name_size));
+		EncodeValue(line + field.value, field.value_size,
+				field.quoted);
+	}
+	block += record;
+}
+
+
+std::unique_ptr<BinaryTraceWriter::Format> BinaryTraceWriter::ParseFormat(
+		const char *fmt_str)
+{
+	std::unique_ptr<Format> format(new Format());
+	format->text = fmt_str;
+	format->valid = false;
+
+	// Command
+	const char *s = fmt_str;
+	while (isIdChar(*s))
+		s++;
+	if (s == fmt_str)
+		return format;
+	format->command = getStringId(fmt_str, s - fmt_str);
+
+	// Fields, until the final newline character
+	while (*s != '\n' || s[1])
+	{
+		// Field name
+		FormatField field;
+		if (*s++ != ' ')
+			return format;
+		const char *name = s;
+		while (isIdChar(*s))
+			s++;
+		if (s == name || *s != '=')
+			return format;
+		field.name = getStringId(name, s - name);
+		s++;
+
+		// Value
+		field.quoted = *s == '"';
+		s += field.quoted;
+		while (true)
+		{
+			// End of value
+			if (field.quoted && *s == '"')
+			{
+				s++;
+				break;
+			}
+			if (!field.quoted && (*s == ' ' || *s == '\n'))
+				break;
+			if (!*s || *s == '\n')
+				return format;
+
+			// Literal text. Unquoted values can only contain
+			// identifier characters.
+			if (*s != '%' || s[1] == '%')
+			{
+				if (!field.quoted && !isIdChar(*s))
+					return format;
+				if (field.pieces.empty() || field.pieces.back().kind
+						!= FormatPiece::KindText)
+					field.pieces.push_back({ FormatPiece::KindText,
+							0, "" });
+				field.pieces.back().text += *s;
+				s += *s == '%' ? 2 : 1;
+				continue;
+			}
+
+			// Conversion specification, with up to two 'l'
+			// modifiers and no flags, width, or precision
+			FormatPiece piece = { FormatPiece::KindText, 0, "" };
+			for (s++; *s == 'l' && piece.size < 2; s++)
+				piece.size++;
+			if (*s == 'd' || *s == 'i')
+				piece.kind = FormatPiece::KindInt;
+			else if (*s == 'u')
+				piece.kind = FormatPiece::KindUnsigned;
+			else if (*s == 'x')
+				piece.kind = FormatPiece::KindHex;
+			else if (*s == 's' && !piece.size)
+				piece.kind = FormatPiece::KindString;
+			else
+				return format;
+			field.pieces.push_back(piece);
+			s++;
+		}
+		if (!field.quoted && field.pieces.empty())
+			return format;
+
+		// Encoding of the value
+		auto &pieces = field.pieces;
+		field.kind = FormatField::KindGeneric;
+		if (pieces.size() == 1 && pieces[0].kind ==
+				FormatPiece::KindString)
+		{
+			field.kind = FormatField::KindString;
+		}
+		else if (pieces.size() == 1 && (pieces[0].kind ==
+				FormatPiece::KindInt || pieces[0].kind ==
+				FormatPiece::KindUnsigned))
+		{
+			field.kind = FormatField::KindInt;
+		}
+		else if (pieces.size() == 2 && pieces[0].kind ==
+				FormatPiece::KindText && pieces[0].text == "0x" &&
+				pieces[1].kind == FormatPiece::KindHex)
+		{
+			field.kind = FormatField::KindHex;
+		}
+		else if (pieces.size() == 2 && pieces[0].kind ==
+				FormatPiece::KindText && (pieces[1].kind ==
+				FormatPiece::KindInt || pieces[1].kind ==
+				FormatPiece::KindUnsigned))
+		{
+			// The text must not end in a digit, and the value must
+			// not read as a decimal or hexadecimal integer, for the
+			// encoding to match the one of the formatted text.
+			const std::string &text = pieces[0].text;
+			if (!isdigit((unsigned char) text.back()) &&
+					text != "-" && text.compare(0, 2, "0x"))
+			{
+				field.kind = FormatField::KindPrefixInt;
+				field.prefix = getStringId(text.data(),
+						text.size());
+			}
+		}
+		format->fields.push_back(std::move(field));
+	}
+
+	// Valid format
+	format->valid = true;
+	return format;
+}
+
+
+bool BinaryTraceWriter::EncodeFormat(const Format &format, va_list va)
+{
+	// Largest integer encoded as a decimal varint, as in EncodeValue()
+	const unsigned long long max_decimal = 999999999999999999ull;
+
+	// Line
+	if (block.empty())
+		block_first_cycle = cycle;
+	record.clear();
+	record += (char) BinaryTraceRecordLine;
+	WriteVarint(record, format.command);
+	WriteVarint(record, format.fields.size());
+	for (auto &field : format.fields)
+	{
+		WriteVarint(record, field.name);
+
+		// Read arguments of the value
+		long long number = 0;
+		const char *text = nullptr;
+		value.clear();
+		for (auto &piece : field.pieces)
+		{
+			switch (piece.kind)
+			{
+
+			case FormatPiece::KindText:
+
+				value += piece.text;
+				continue;
+
+			case FormatPiece::KindInt:
+
+				number = piece.size == 2 ? va_arg(va, long long) :
+						piece.size == 1 ? va_arg(va, long) :
+						va_arg(va, int);
+				break;
+
+			case FormatPiece::KindUnsigned:
+			case FormatPiece::KindHex:
+
+				number = piece.size == 2 ?
+						va_arg(va, unsigned long long) :
+						piece.size == 1 ?
+						va_arg(va, unsigned long) :
+						va_arg(va, unsigned);
+				break;
+
+			case FormatPiece::KindString:
+
+				text = va_arg(va, const char *);
+				break;
+			}
+
+			// Value built as text
+			if (field.kind != FormatField::KindGeneric)
+				continue;
+			if (piece.kind == FormatPiece::KindString)
+				value += text;
+			else if (piece.kind == FormatPiece::KindHex)
+				AppendHexDigits(value, number);
+			else if (piece.kind == FormatPiece::KindInt)
+				AppendDecimal(value, number);
+			else
+				AppendUnsigned(value, number);
+		}
+
+		// Integers that can be encoded without converting them into
+		// text
+		bool is_signed = !field.pieces.empty() &&
+				field.pieces.back().kind ==
+				FormatPiece::KindInt;
+		unsigned long long magnitude = number;
+		if (is_signed && number < 0)
+			magnitude = -magnitude;
+		switch (field.kind)
+		{
+
+		case FormatField::KindInt:
+
+			if (magnitude <= max_decimal)
+			{
+				record += (char) (BinaryTraceValueInt |
+						field.quoted);
+				WriteVarint(record, ((unsigned long long)
+						number << 1) ^
+						(unsigned long long)
+						(number >> 63));
+				continue;
+			}
+			if (is_signed)
+				AppendDecimal(value, number);
+			else
+				AppendUnsigned(value, number);
+			break;
+
+		case FormatField::KindHex:
+
+			record += (char) (BinaryTraceValueHex | field.quoted);
+			WriteVarint(record, number);
+			continue;
+
+		case FormatField::KindPrefixInt:
+
+			if (magnitude <= max_decimal && !(is_signed &&
+					number < 0))
+			{
+				record += (char) (BinaryTraceValuePrefixInt |
+						field.quoted);
+				WriteVarint(record, field.prefix);
+				WriteVarint(record, number);
+				continue;
+			}
+			if (is_signed)
+				AppendDecimal(value, number);
+			else
+				AppendUnsigned(value, number);
+			break;
+
+		case FormatField::KindString:
+
+			value = text;
+			break;
+
+		case FormatField::KindGeneric:
+
+			break;
+		}
+
+		// Values that do not fit the trace syntax are left to the
+		// caller, who writes the formatted text
+		if (!field.quoted && value.empty())
+			return false;
+		for (char c : value)
+			if (c == '\n' || (field.quoted ? c == '"' :
+					!isIdChar(c)))
+				return false;
+		EncodeValue(value.data(), value.size(), field.quoted);
+	}
+
+	// Add line to the block
+	block += record;
+	return true;
+}
+
+
+void BinaryTraceWriter::FlushBlock()
+{
+	// Nothing to write
+	if (block.empty())
+		return;
+
+	// Wait for room in the queue, and enqueue block
+	pthread_mutex_lock(&lock);
+	while (queue.size() >= max_queued_blocks)
+		pthread_cond_wait(&cond, &lock);
+	queue.push_back({ std::move(block), block_first_cycle });
+	block.clear();
+	pthread_cond_broadcast(&cond);
+	pthread_mutex_unlock(&lock);
+}
+
+
+void BinaryTraceWriter::WriteBlock(const Block &block)
+{
+	// Compress
+	const std::string &data = block.data;
+	uLongf compressed_size = compressBound(data.size());
+	std::string compressed(compressed_size, '\0');
+	if (compress2((Bytef *) &compressed[0], &compressed_size,
+			(const Bytef *) data.data(), data.size(),
+			Z_BEST_SPEED) != Z_OK)
+		throw misc::Panic("Cannot compress trace block");
+
+	// Write
+	index.push_back({ (long long) ftell(f), block.first_cycle });
+	WriteUInt32(f, data.size());
+	WriteUInt32(f, compressed_size);
+	fwrite(compressed.data(), 1, compressed_size, f);
+}
+
+
+void BinaryTraceWriter::WriteIndex()
+{
+	// End of blocks
+	WriteUInt32(f, 0);
+	WriteUInt32(f, 0);
+
+	// String table
+	long long offset = ftell(f);
+	WriteUInt32(f, strings.size());
+	for (auto &s : strings)
+	{
+		WriteUInt32(f, s.size());
+		fwrite(s.data(), 1, s.size(), f);
+	}
+
+	// Blocks
+	WriteUInt32(f, index.size());
+	for (auto &entry : index)
+	{
+		WriteUInt64(f, entry.offset);
+		WriteUInt64(f, entry.first_cycle);
+	}
+
+	// Footer
+	WriteUInt64(f, offset);
+	fwrite(binary_trace_index_magic, 1, sizeof binary_trace_index_magic, f);
+}
+
+
+
+
+//
+// Class 'BinaryTraceReader'
+//
+
+bool BinaryTraceReader::isBinaryTrace(const std::string &path)
+{
+	char magic[sizeof binary_trace_magic];
+	FILE *f = fopen(path.c_str(), "rb");
+	if (!f)
+		return false;
+	bool result = fread(magic, 1, sizeof magic, f) == sizeof magic &&
+			!memcmp(magic, binary_trace_magic, sizeof magic);
+	fclose(f);
+	return result;
+}
+
+
+BinaryTraceReader::BinaryTraceReader(const std::string &path) :
+		path(path)
+{
+	// Open file
+	f = fopen(path.c_str(), "rb");
+	if (!f)
+		throw misc::Error(misc::fmt("%s: cannot open trace file",
+				path.c_str()));
+
+	// Read header and index
+	try
+	{
+		ReadIndex();
+	}
+	catch (...)
+	{
+		fclose(f);
+		throw;
+	}
+}
+
+
+void BinaryTraceReader::ReadIndex()
+{
+	// Header
+	char magic[sizeof binary_trace_magic];
+	unsigned version;
+	if (fread(magic, 1, sizeof magic, f) != sizeof magic ||
+			memcmp(magic, binary_trace_magic, sizeof magic) ||
+			!ReadUInt32(f, version))
+		throw misc::Error(misc::fmt("%s: not a binary trace",
+				path.c_str()));
+	if (version != binary_trace_version)
+		throw misc::Error(misc::fmt("%s: unsupported binary trace "
+				"version %u", path.c_str(), version));
+
+	// Footer
+	fseek(f, 0, SEEK_END);
+	end_offset = ftell(f);
+	unsigned long long index_offset = 0;
+	bool has_index = false;
+	if (end_offset >= binary_trace_header_size + binary_trace_footer_size)
+	{
+		fseek(f, -binary_trace_footer_size, SEEK_END);
+		has_index = ReadUInt64(f, index_offset) &&
+				fread(magic, 1, sizeof magic, f) ==
+				sizeof magic &&
+				!memcmp(magic, binary_trace_index_magic,
+				sizeof magic) &&
+				(long long) index_offset <= end_offset;
+	}
+
+	// Index
+	if (has_index)
+	{
+		// String table
+		unsigned num_strings;
+		fseek(f, index_offset, SEEK_SET);
+		if (!ReadUInt32(f, num_strings))
+			throw misc::Error(misc::fmt("%s: invalid index",
+					path.c_str()));
+		strings.resize(num_strings);
+		for (auto &s : strings)
+		{
+			unsigned size;
+			if (!ReadUInt32(f, size))
+				throw misc::Error(misc::fmt("%s: invalid "
+						"index", path.c_str()));
+			s.resize(size);
+			if (size && fread(&s[0], 1, size, f) != size)
+				throw misc::Error(misc::fmt("%s: invalid "
+						"index", path.c_str()));
+		}
+
+		// Blocks
+		unsigned num_blocks;
+		if (!ReadUInt32(f, num_blocks))
+			throw misc::Error(misc::fmt("%s: invalid index",
+					path.c_str()));
+		index.resize(num_blocks);
+		for (auto &entry : index)
+		{
+			unsigned long long offset;
+			unsigned long long first_cycle;
+			if (!ReadUInt64(f, offset) ||
+					!ReadUInt64(f, first_cycle))
+				throw misc::Error(misc::fmt("%s: invalid "
+						"index", path.c_str()));
+			entry.offset = offset;
+			entry.first_cycle = first_cycle;
+		}
+		end_offset = index_offset;
+	}
+
+	// Start reading after the header
+	fseek(f, binary_trace_header_size, SEEK_SET);
+}
+
+
+BinaryTraceReader::~BinaryTraceReader()
+{
+	fclose(f);
+}
+
+
+bool BinaryTraceReader::ReadBlock()
+{
+	// End of blocks
+	if (ftell(f) >= end_offset)
+		return false;
+
+	// Block sizes. A truncated block at the end of a trace without index
+	// is ignored.
+	unsigned raw_size;
+	unsigned compressed_size;
+	if (!ReadUInt32(f, raw_size) || !ReadUInt32(f, compressed_size))
+		return false;
+
+	// End of blocks
+	if (!raw_size && !compressed_size)
+		return false;
+	std::string compressed(compressed_size, '\0');
+	if (fread(&compressed[0], 1, compressed_size, f) != compressed_size)
+		return false;
+
+	// Decompress
+	uLongf size = raw_size;
+	block.resize(raw_size);
+	if (uncompress((Bytef *) &block[0], &size,
+			(const Bytef *) compressed.data(),
+			compressed_size) != Z_OK || size != raw_size)
+		throw misc::Error(misc::fmt("%s: corrupted trace block",
+				path.c_str()));
+	position = 0;
+	return true;
+}
+
+
+unsigned long long BinaryTraceReader::ReadVarint()
+{
+	unsigned long long value = 0;
+	for (int shift = 0; shift < 64; shift += 7)
+	{
+		if (position >= block.size())
+			break;
+		unsigned char byte = block[position++];
+		value |= (unsigned long long) (byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+			return value;
+	}
+	throw misc::Error(misc::fmt("%s: corrupted trace block",
+			path.c_str()));
+}
+
+
+const std::string &BinaryTraceReader::getString(unsigned long long id)
+{
+	if (id >= strings.size())
+		throw misc::Error(misc::fmt("%s: undefined string %lld",
+				path.c_str(), id));
+	return strings[id];
+}
+
+
+void BinaryTraceReader::SeekCycle(long long cycle)
+{
+	// Find last block starting at or before the cycle
+	if (index.empty())
+		throw misc::Panic("Trace has no index");
+	unsigned i = 0;
+	while (i + 1 < index.size() && index[i + 1].first_cycle <= cycle)
+		i++;
+
+	// Position at the beginning of the block
+	fseek(f, index[i].offset, SEEK_SET);
+	block.clear();
+	position = 0;
+	this->cycle = index[i].first_cycle;
+}
+
+
+bool BinaryTraceReader::ReadLine(std::string &line)
+{
+	while (true)
+	{
+		// Next block
+		if (position >= block.size())
+		{
+			if (!ReadBlock())
+				return false;
+			continue;
+		}
+
+		// Record type
+		int type = (unsigned char) block[position++];
+		switch (type)
+		{
+
+		case BinaryTraceRecordString:
+		{
+			unsigned long long id = ReadVarint();
+			unsigned long long size = ReadVarint();
+			if (position + size > block.size() || id > (1 << 30))
+				throw misc::Error(misc::fmt("%s: corrupted "
+						"trace block", path.c_str()));
+			if (id >= strings.size())
+				strings.resize(id + 1);
+			strings[id].assign(block, position, size);
+			position += size;
+			break;
+		}
+
+		case BinaryTraceRecordCycle:
+
+			cycle = ReadVarint();
+			line = "c clk=";
+			AppendDecimal(line, cycle);
+			return true;
+
+		case BinaryTraceRecordLine:
+		{
+			line = getString(ReadVarint());
+			unsigned long long num_fields = ReadVarint();
+			for (unsigned long long i = 0; i < num_fields; i++)
+			{
+				// Name
+				line += ' ';
+				line += getString(ReadVarint());
+				line += '=';
+
+				// Value
+				if (position >= block.size())
+					throw misc::Error(misc::fmt("%s: "
+							"corrupted trace "
+							"block",
+							path.c_str()));
+				int kind = block[position++];
+				bool quoted = kind & 1;
+				if (quoted)
+					line += '"';
+				switch (kind & ~1)
+				{
+
+				case BinaryTraceValueString:
+
+					line += getString(ReadVarint());
+					break;
+
+				case BinaryTraceValueInt:
+				{
+					unsigned long long value = ReadVarint();
+					AppendDecimal(line, (long long)
+							(value >> 1) ^
+							-(long long) (value & 1));
+					break;
+				}
+
+				case BinaryTraceValueHex:
+
+					AppendHex(line, ReadVarint());
+					break;
+
+				case BinaryTraceValuePrefixInt:
+
+					line += getString(ReadVarint());
+					AppendDecimal(line, ReadVarint());
+					break;
+
+				default:
+
+					throw misc::Error(misc::fmt("%s: "
+							"invalid value type",
+							path.c_str()));
+				}
+				if (quoted)
+					line += '"';
+			}
+			return true;
+		}
+
+		case BinaryTraceRecordRaw:
+		{
+			unsigned long long size = ReadVarint();
+			if (position + size > block.size())
+				throw misc::Error(misc::fmt("%s: corrupted "
+						"trace block", path.c_str()));
+			line.assign(block, position, size);
+			position += size;
+			return true;
+		}
+
+		default:
+
+			throw misc::Error(misc::fmt("%s: invalid record type",
+					path.c_str()));
+		}
+	}
+}
+
+
+}  // namespace esim
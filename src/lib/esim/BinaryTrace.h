@@ -0,0 +1,383 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2014  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LIB_ESIM_BINARY_TRACE_H
+#define LIB_ESIM_BINARY_TRACE_H
+
+#include <pthread.h>
+#include <cstdarg>
+#include <cstdio>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace esim
+{
+
+// Binary trace format. The file contains the same information as the text
+// trace, line by line, with the following layout. Integers of fixed size
+// are little-endian.
+//
+//	Header	8-byte magic "m2strace", 4-byte version
+//	Blocks	4-byte raw size, 4-byte compressed size, zlib data
+//	End	4-byte raw size and 4-byte compressed size, both 0
+//	Index	4-byte number of strings, each with a 4-byte size and data
+//		4-byte number of blocks, each with an 8-byte file offset and
+//		an 8-byte first cycle (-1 for the block with header lines)
+//	Footer	8-byte offset of the index, 8-byte magic "m2sindex"
+//
+// Blocks are compressed independently, and each block except the first
+// starts with a cycle record, so that a reader can start decoding at any
+// block listed in the index. A decompressed block is a sequence of
+// records, each starting with a byte of type BinaryTraceRecord. Variable
+// size integers (varint) are encoded in groups of 7 bits, least
+// significant first, with the most significant bit of each byte set if
+// more bytes follow.
+//
+//	String	varint identifier, varint size, data
+//	Cycle	varint cycle
+//	Line	varint command string identifier, varint number of fields,
+//		and for each field a varint name string identifier, a byte
+//		of type BinaryTraceValue, and the value
+//	Raw	varint size, text of a line not following the trace syntax
+//
+// Strings are defined before their first use in a line. The index repeats
+// the complete string table, to allow readers to seek to any block. Readers
+// decoding the trace sequentially can ignore the index and stop at the end
+// marker, or at the end of the file if the simulation did not finish.
+
+/// Record types in a binary trace block
+enum BinaryTraceRecord
+{
+	BinaryTraceRecordString = 0,
+	BinaryTraceRecordCycle,
+	BinaryTraceRecordLine,
+	BinaryTraceRecordRaw
+};
+
+/// Value types of a field in a binary trace line. Bit 0 of the value type
+/// is set if the value was quoted in the text trace.
+enum BinaryTraceValue
+{
+	BinaryTraceValueString = 0,	// String identifier
+	BinaryTraceValueInt = 2,	// Zigzag varint, printed as %lld
+	BinaryTraceValueHex = 4,	// Varint, printed as 0x%llx
+	BinaryTraceValuePrefixInt = 6	// String identifier, then varint
+					// printed right after it as %lld
+};
+
+
+/// Writer of binary traces. Lines are encoded by the simulation thread,
+/// either from the text passed to Write(), or directly from the format
+/// string and arguments of a trace message passed to WriteFormat(). Full
+/// blocks are compressed and written to the file by a background thread.
+class BinaryTraceWriter
+{
+	// Entry of the block index
+	struct IndexEntry
+	{
+		long long offset;
+		long long first_cycle;
+	};
+
+	// Block handed to the background thread
+	struct Block
+	{
+		std::string data;
+		long long first_cycle;
+	};
+
+	// Part of a field value in a format string, either literal text or a
+	// conversion specification
+	struct FormatPiece
+	{
+		enum Kind
+		{
+			KindText = 0,
+			KindInt,		// %d, %ld, %lld
+			KindUnsigned,		// %u, %lu, %llu
+			KindHex,		// %x, %lx, %llx
+			KindString		// %s
+		};
+
+		Kind kind;
+
+		// Number of 'l' modifiers of an integer conversion
+		int size;
+
+		// Literal text
+		std::string text;
+	};
+
+	// Field in a format string
+	struct FormatField
+	{
+		// Encodings that skip converting the value into text
+		enum Kind
+		{
+			KindGeneric = 0,	// Value built as text
+			KindInt,		// Single integer conversion
+			KindHex,		// '0x' followed by %x
+			KindPrefixInt,		// Text followed by an integer
+			KindString		// Single %s conversion
+		};
+
+		Kind kind;
+
+		// Name string identifier
+		unsigned name;
+
+		// Whether the value is quoted
+		bool quoted;
+
+		// Parts of the value
+		std::vector<FormatPiece> pieces;
+
+		// Prefix string identifier for KindPrefixInt
+		unsigned prefix;
+	};
+
+	// Format string of a trace message, parsed once for all messages
+	// using it. Formats that do not produce exactly one line following
+	// the trace syntax are invalid, and their messages are formatted as
+	// text.
+	struct Format
+	{
+		std::string text;
+		bool valid;
+		unsigned command;
+		std::vector<FormatField> fields;
+	};
+
+	// Maximum number of blocks queued before the simulation thread
+	// blocks
+	static const unsigned max_queued_blocks = 16;
+
+	// Minimum size of a decompressed block before a new one is started
+	static const unsigned block_size = 1 << 18;
+
+	// Path of the trace file
+	std::string path;
+
+	// Output file
+	FILE *f = nullptr;
+
+	// Background thread, and lock and condition variable protecting the
+	// following fields
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+
+	// Blocks waiting for the background thread
+	std::list<Block> queue;
+
+	// Flag set by Close() to stop the background thread
+	bool done = false;
+
+	// Text of the last incomplete line passed to Write()
+	std::string partial_line;
+
+	// Current block, decompressed, and the cycle when it starts
+	std::string block;
+	long long block_first_cycle = -1;
+
+	// Interned strings
+	std::unordered_map<std::string, unsigned> string_ids;
+	std::vector<std::string> strings;
+
+	// Formats seen so far, indexed by the address of the format string
+	std::unordered_map<const char *, std::unique_ptr<Format>> formats;
+
+	// Field of a text line being encoded, given as offsets and sizes in
+	// the line text
+	struct Field
+	{
+		unsigned name;
+		unsigned name_size;
+		unsigned value;
+		unsigned value_size;
+		bool quoted;
+	};
+
+	// Buffers reused across lines to avoid allocations
+	std::vector<Field> fields;
+	std::string record;
+	std::string key;
+	std::string value;
+
+	// Index of blocks written so far, only accessed by the background
+	// thread
+	std::vector<IndexEntry> index;
+
+	// Last cycle seen
+	long long cycle = -1;
+
+	// Background thread
+	static void *ThreadFunc(void *arg);
+
+	// Encode a complete text line into the current block
+	void EncodeLine(const char *line, unsigned size);
+
+	// Encode a field value given as text into 'record'
+	void EncodeValue(const char *value, unsigned size, bool quoted);
+
+	// Encode a line from a format and its arguments into the current
+	// block. Return false if an argument does not fit the trace syntax,
+	// in which case nothing is encoded.
+	bool EncodeFormat(const Format &format, va_list va);
+
+	// Parse a format string
+	std::unique_ptr<Format> ParseFormat(const char *fmt_str);
+
+	// Encode a cycle record, starting a new block if the current one is
+	// full
+	void EncodeCycle(long long cycle);
+
+	// Return the identifier of a string, defining it in the current block
+	// if it is new
+	unsigned getStringId(const char *s, unsigned size);
+
+	// Hand the current block to the background thread
+	void FlushBlock();
+
+	// Compress a block and write it to the file
+	void WriteBlock(const Block &block);
+
+	// Write the index and the footer
+	void WriteIndex();
+
+public:
+
+	/// Create the trace file and start the background thread. An
+	/// exception of type misc::Error is thrown if the file cannot be
+	/// created.
+	BinaryTraceWriter(const std::string &path);
+
+	/// Destructor, closing the trace if not closed yet
+	~BinaryTraceWriter();
+
+	/// Append text to the trace. The text can contain any number of
+	/// complete or partial lines.
+	void Write(const std::string &s);
+
+	/// Append the line produced by formatting the arguments in \a va
+	/// with \a fmt_str, following the rules of misc::fmt(), without
+	/// converting it into text. The format string must remain valid
+	/// while the trace is open. Return false if the line cannot be
+	/// encoded this way, for example because the format string does not
+	/// produce exactly one complete line, or a partial line was passed
+	/// to Write() before. The caller must then pass the formatted text
+	/// to Write(). The arguments in \a va are not consumed.
+	bool WriteFormat(const char *fmt_str, va_list va);
+
+	/// Append a line starting a new cycle
+	void WriteCycle(long long cycle);
+
+	/// Wait for the background thread to write all blocks, and write the
+	/// index. No more lines can be written afterwards.
+	void Close();
+};
+
+
+/// Reader of binary traces, producing the lines of the equivalent text
+/// trace.
+class BinaryTraceReader
+{
+	// Entry of the block index
+	struct IndexEntry
+	{
+		long long offset;
+		long long first_cycle;
+	};
+
+	// Path of the trace file
+	std::string path;
+
+	// Input file
+	FILE *f = nullptr;
+
+	// Offset where blocks end, which is the file size if the trace has
+	// no index
+	long long end_offset = 0;
+
+	// String table
+	std::vector<std::string> strings;
+
+	// Block index, empty if the file has no index
+	std::vector<IndexEntry> index;
+
+	// Current block, decompressed, and position in it
+	std::string block;
+	unsigned position = 0;
+
+	// Current cycle
+	long long cycle = -1;
+
+	// Read the header and the index, if present, and position the file
+	// at the first block
+	void ReadIndex();
+
+	// Read the next block. Return false if there are no more blocks.
+	bool ReadBlock();
+
+	// Read a varint from the current block
+	unsigned long long ReadVarint();
+
+	// Return a string from the string table
+	const std::string &getString(unsigned long long id);
+
+public:
+
+	/// Return whether the given file is a binary trace
+	static bool isBinaryTrace(const std::string &path);
+
+	/// Open a binary trace. An exception of type misc::Error is thrown if
+	/// the file cannot be opened or has an invalid format.
+	BinaryTraceReader(const std::string &path);
+
+	/// Destructor
+	~BinaryTraceReader();
+
+	/// Return whether the trace has a block index. Traces of simulations
+	/// that did not finish have no index, and can only be read
+	/// sequentially.
+	bool hasIndex() const { return !index.empty(); }
+
+	/// Position the reader at the beginning of the last block that starts
+	/// at or before \a cycle, so that the following calls to ReadLine()
+	/// return the lines of that cycle, possibly after lines of previous
+	/// cycles. The trace must have an index.
+	void SeekCycle(long long cycle);
+
+	/// Read the next line of the trace, in the format of the text trace
+	/// and without the final newline character. Return false if the end
+	/// of the trace was reached.
+	bool ReadLine(std::string &line);
+
+	/// Return the cycle of the last line read, or -1 for header lines
+	long long getCycle() const { return cycle; }
+};
+
+
+}  // namespace esim
+
+#endif
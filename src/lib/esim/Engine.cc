@@ -17,7 +17,9 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
 #include <csignal>
+#include <limits>
 
 #include <lib/cpp/IniFile.h>
 
@@ -30,6 +32,8 @@ namespace esim
 
 misc::Debug Engine::debug;
 
+EventQueueKind Engine::event_queue_kind = EventQueueHeap;
+
 std::unique_ptr<Engine> Engine::instance;
 
 const char *engine_err_finalization =
@@ -56,6 +60,9 @@ Engine::Engine() : timer("esim::Timer")
 	// Initialize timer
 	timer.Start();
 
+	// Create event queue
+	event_queue = EventQueue::Create(event_queue_kind);
+
 	// Create null event
 	null_event = RegisterEvent("Null event", nullptr, nullptr);
 
@@ -94,22 +101,19 @@ bool Engine::Drain(int max_events)
 	while (1)
 	{
 		// No more elements in heap
-		if (heap.size() == 0)
+		if (event_queue->isEmpty())
 			return false;
 
-		// Get frame from top of the heap
+		// Extract frame from top of the heap
 		assert(current_frame == nullptr);
-		current_frame = heap.top();
+		current_frame = event_queue->Pop();
 		assert(current_frame->in_heap);
-
-		// Extract from heap
-		heap.pop();
 		current_frame->in_heap = false;
 
 		// Debug
 		Event *event = current_frame->event;
 		FrequencyDomain *frequency_domain = event->getFrequencyDomain();
-		debug << misc::fmt("[%.2fns] Event '%s/%s' drained\n",
+		debug.fmt("[%.2fns] Event '%s/%s' drained\n",
 				(double) current_time / 1000,
 				frequency_domain->getName().c_str(),
 				event->getName().c_str());
@@ -151,7 +155,7 @@ void Engine::ProcessEndEvents()
 
 		// Debug
 		Event *event = current_frame->event;
-		debug << misc::fmt("[%.2fns] End event '%s' triggered\n",
+		debug.fmt("[%.2fns] End event '%s' triggered\n",
 				(double) current_time / 1000,
 				event->getName().c_str());
 
@@ -205,30 +209,29 @@ void Engine::ProcessEvents()
 	}
 	
 	// Process events scheduled for this cycle
+	processed_events = false;
 	while (1)
 	{
 		// No more elements in heap
-		if (heap.size() == 0)
+		if (event_queue->isEmpty())
 			break;
 
 		// Stop when we find the first event that should run in the
 		// future.
-		if (heap.top()->time > current_time)
+		if (event_queue->Top()->time > current_time)
 			break;
 		
-		// Get frame from top of heap
+		// Extract frame from top of heap
 		assert(current_frame == nullptr);
-		current_frame = heap.top();
+		current_frame = event_queue->Pop();
+		processed_events = true;
 		assert(current_frame->in_heap);
-
-		// Remove frame from the heap
-		heap.pop();
 		current_frame->in_heap = false;
 
 		// Debug
 		Event *event = current_frame->event;
 		FrequencyDomain *frequency_domain = event->getFrequencyDomain();
-		debug << misc::fmt("[%.2fns] Event '%s/%s' triggered\n",
+		debug.fmt("[%.2fns] Event '%s/%s' triggered\n",
 				(double) current_time / 1000,
 				frequency_domain->getName().c_str(),
 				event->getName().c_str());
@@ -255,6 +258,36 @@ void Engine::ProcessEvents()
 }
 
 
+long long Engine::SkipIdleCycles(long long time)
+{
+	// Events in the last cycle could have woken up a timing simulator
+	if (processed_events || finish)
+		return current_time;
+
+	// Stop at the earliest event
+	if (!event_queue->isEmpty())
+		time = std::min(time, event_queue->Top()->time);
+
+	// Nothing to wait for. This is a deadlock that timing simulators
+	// should detect in the cycles that follow.
+	if (time == std::numeric_limits<long long>::max())
+		return current_time;
+
+	// Round up to a cycle of the fastest frequency domain
+	time = (time + shortest_cycle_time - 1) / shortest_cycle_time *
+			shortest_cycle_time;
+	if (time <= current_time)
+		return current_time;
+
+	// Skip cycles
+	debug.fmt("[%.2fns] Skipping %lld idle cycles\n",
+			(double) current_time / 1000,
+			(time - current_time) / shortest_cycle_time);
+	current_time = time;
+	return current_time;
+}
+
+
 FrequencyDomain *Engine::RegisterFrequencyDomain(const std::string &name,
 		int frequency)
 {
@@ -266,6 +299,7 @@ FrequencyDomain *Engine::RegisterFrequencyDomain(const std::string &name,
 	{
 		fastest_frequency = frequency;
 		shortest_cycle_time = 1000000ll / frequency;
+		event_queue->setCycleTime(shortest_cycle_time);
 	}
 
 	// Return created frequency domain
@@ -285,6 +319,26 @@ void Engine::UpdateFastestFrequency()
 			shortest_cycle_time = frequency_domain.getCycleTime();
 		}
 	}
+	event_queue->setCycleTime(shortest_cycle_time);
+}
+
+
+void Engine::setEventQueueKind(EventQueueKind kind)
+{
+	// Save kind for future instances
+	event_queue_kind = kind;
+
+	// Replace event queue of current instance
+	if (!instance.get())
+		return;
+	Engine *engine = instance.get();
+	if (!engine->event_queue->isEmpty())
+		throw misc::Panic("Cannot change the event queue while "
+				"events are pending");
+	engine->event_queue = EventQueue::Create(kind);
+	if (engine->shortest_cycle_time)
+		engine->event_queue->setCycleTime(
+				engine->shortest_cycle_time);
 }
 
 
@@ -325,7 +379,7 @@ void Engine::Schedule(Event *event,
 	// Null event
 	if (event == nullptr || event == null_event)
 	{
-		debug << misc::fmt("[%.2fns] Null event discarded\n",
+		debug.fmt("[%.2fns] Null event discarded\n",
 				(double) current_time / 1000);
 		return;
 	}
@@ -354,22 +408,23 @@ void Engine::Schedule(Event *event,
 	// the order of those events scheduled for the same cycle
 	frame->schedule_sequence = ++schedule_sequence_counter;
 
-	// Insert frame into the heap
-	heap.emplace(frame);
-	frame->in_heap = true;
-
-	// Increment the number of in-flight events of this type.
-	event->incInFlight();
-
 	// Debug
-	debug << misc::fmt("[%.2fns] Event '%s/%s' scheduled for [%.2fns]\n",
+	debug.fmt("[%.2fns] Event '%s/%s' scheduled for [%.2fns]\n",
 			(double) current_time / 1000,
 			frequency_domain->getName().c_str(),
 			event->getName().c_str(),
 			(double) frame->time / 1000);
 
+	// Insert frame into the heap. The frame is passed by value, so it can
+	// be moved into the heap without updating its reference count.
+	frame->in_heap = true;
+	event_queue->Push(std::move(frame));
+
+	// Increment the number of in-flight events of this type.
+	event->incInFlight();
+
 	// Warn when heap is overloaded
-	if (!max_inflight_events_warning && (int) heap.size() >=
+	if (!max_inflight_events_warning && event_queue->getSize() >=
 			max_inflight_events)
 	{
 		max_inflight_events_warning = true;
@@ -389,10 +444,10 @@ void Engine::Next(Event *event,
 	// event handler, or create new frame otherwise.
 	std::shared_ptr<Frame> frame = current_frame;
 	if (!frame)
-		frame = misc::new_shared<Frame>();
+		frame = new_frame<Frame>();
 
 	// Schedule event
-	Schedule(event, frame, after, period);
+	Schedule(event, std::move(frame), after, period);
 }
 
 
@@ -428,14 +483,14 @@ void Engine::Call(Event *event,
 {
 	// Create new frame if none passed
 	if (frame == nullptr)
-		frame = misc::new_shared<Frame>();
+		frame = new_frame<Frame>();
 
 	// Set return event and frame
 	frame->return_event = return_event;
 	frame->parent_frame = current_frame;
 
 	// Schedule event
-	Schedule(event, frame, after, period);
+	Schedule(event, std::move(frame), after, period);
 }
 
 
@@ -464,7 +519,7 @@ void Engine::EndEvent(Event *event)
 		return;
 	
 	// Create frame
-	auto frame = misc::new_shared<Frame>();
+	auto frame = new_frame<Frame>();
 	frame->event = event;
 
 	// Add event to queue of end events
@@ -34,7 +34,9 @@
 #include <lib/cpp/Timer.h>
 
 #include "Event.h"
+#include "EventQueue.h"
 #include "Frame.h"
+#include "FramePool.h"
 #include "FrequencyDomain.h"
 
 
@@ -69,6 +71,9 @@ class Engine
 	/// Debugger
 	static misc::Debug debug;
 
+	// Kind of event queue used for new instances of the engine
+	static EventQueueKind event_queue_kind;
+
 	// Flag set when simulation should finish
 	bool finish = false;
 
@@ -87,10 +92,8 @@ class Engine
 	// Registered frequency domains
 	std::list<FrequencyDomain> frequency_domains;
 
-	// Heap of pending events
-	std::priority_queue<std::shared_ptr<Frame>,
-			std::vector<std::shared_ptr<Frame>>,
-			Frame::CompareSharedPointers> heap;
+	// Pending events, sorted by time and schedule sequence number
+	std::unique_ptr<EventQueue> event_queue;
 
 	// Queue of frames associated with the end events
 	std::queue<std::shared_ptr<Frame>> end_frames;
@@ -110,6 +113,9 @@ class Engine
 	// Cycle time of the fastest frequency domain
 	long long shortest_cycle_time = 0;
 
+	// True if any event was processed in the last call to ProcessEvents()
+	bool processed_events = false;
+
 	// When an event handler is being executed, this is the current frame.
 	// Otherwise, it is null.
 	std::shared_ptr<Frame> current_frame;
@@ -186,6 +192,16 @@ public:
 	/// and advances the event-driven simulation time.
 	void ProcessEvents();
 
+	/// Skip cycles of the fastest frequency domain in which no event is
+	/// scheduled, advancing the simulation time to the given time in
+	/// picoseconds, or to the earliest event if it comes first. The new
+	/// time is rounded up to a cycle of the fastest frequency domain. No
+	/// time is skipped if any event was processed in the last call to
+	/// ProcessEvents(), since event handlers could have changed the state
+	/// observed by timing simulators in the next cycle. The function
+	/// returns the new simulation time.
+	long long SkipIdleCycles(long long time);
+
 	/// Function invoked after the main simulation loop has finished. The
 	/// function processes all events remaining in the heap and then runs
 	/// all events that were scheduled for the end of the simulation with
@@ -415,6 +431,11 @@ public:
 		debug.setPath(path);
 		debug.setPrefix("[esim]");
 	}
+
+	/// Select the data structure used to keep pending events. If the
+	/// engine has already been instantiated, its event queue is replaced,
+	/// which is only allowed when no event is pending.
+	static void setEventQueueKind(EventQueueKind kind);
 };
 
 
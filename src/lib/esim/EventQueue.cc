@@ -0,0 +1,194 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2014  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <lib/cpp/Error.h>
+#include <lib/cpp/Misc.h>
+
+#include "EventQueue.h"
+
+
+namespace esim
+{
+
+const misc::StringMap EventQueueKindMap =
+{
+	{ "heap", EventQueueHeap },
+	{ "calendar", EventQueueCalendar }
+};
+
+
+std::unique_ptr<EventQueue> EventQueue::Create(EventQueueKind kind)
+{
+	switch (kind)
+	{
+
+	case EventQueueHeap:
+		return misc::new_unique<HeapEventQueue>();
+
+	case EventQueueCalendar:
+		return misc::new_unique<CalendarEventQueue>();
+
+	default:
+		throw misc::Panic(misc::fmt("Invalid event queue kind (%d)",
+				kind));
+	}
+}
+
+
+CalendarEventQueue::CalendarEventQueue() : buckets(num_buckets)
+{
+}
+
+
+void CalendarEventQueue::Insert(std::shared_ptr<Frame> frame)
+{
+	// Frames scheduled before the first bucket of the window go into the
+	// first bucket. All frames in previous buckets have been extracted
+	// already, so ordering within the bucket is enough to keep them in
+	// place.
+	long long index = getBucketIndex(frame->time);
+	if (index < current_bucket)
+		index = current_bucket;
+
+	// Beyond the window
+	if (index >= current_bucket + num_buckets)
+	{
+		overflow.emplace(std::move(frame));
+		return;
+	}
+
+	// Find position in the bucket, starting at the end. Frames are
+	// usually pushed with increasing times and schedule sequence numbers,
+	// so the position is most likely the last one.
+	Bucket &bucket = buckets[index & (num_buckets - 1)];
+	Frame::CompareSharedPointers compare;
+	auto begin = bucket.frames.begin() + bucket.head;
+	auto position = bucket.frames.end();
+	while (position != begin && compare(*(position - 1), frame))
+		--position;
+	bucket.frames.insert(position, std::move(frame));
+	wheel_size++;
+}
+
+
+void CalendarEventQueue::Refill()
+{
+	while (overflow.size() && getBucketIndex(overflow.top()->time) <
+			current_bucket + num_buckets)
+	{
+		std::shared_ptr<Frame> frame = overflow.top();
+		overflow.pop();
+		Insert(std::move(frame));
+	}
+}
+
+
+void CalendarEventQueue::Advance()
+{
+	// Queue must not be empty
+	assert(getSize());
+
+	// If the wheel is empty, jump straight to the bucket of the earliest
+	// frame in the overflow heap.
+	if (!wheel_size)
+	{
+		current_bucket = getBucketIndex(overflow.top()->time);
+		Refill();
+	}
+
+	// Skip empty buckets
+	while (buckets[current_bucket & (num_buckets - 1)].isEmpty())
+	{
+		current_bucket++;
+		Refill();
+	}
+}
+
+
+void CalendarEventQueue::Push(std::shared_ptr<Frame> frame)
+{
+	// A cycle time must have been set by the engine
+	assert(bucket_width > 0);
+	Insert(std::move(frame));
+}
+
+
+const std::shared_ptr<Frame> &CalendarEventQueue::Top()
+{
+	Advance();
+	Bucket &bucket = buckets[current_bucket & (num_buckets - 1)];
+	return bucket.frames[bucket.head];
+}
+
+
+std::shared_ptr<Frame> CalendarEventQueue::Pop()
+{
+	// Extract from the first non-empty bucket
+	Advance();
+	Bucket &bucket = buckets[current_bucket & (num_buckets - 1)];
+	std::shared_ptr<Frame> frame = std::move(bucket.frames[bucket.head]);
+	bucket.head++;
+	wheel_size--;
+
+	// Recycle bucket when fully drained
+	if (bucket.isEmpty())
+	{
+		bucket.frames.clear();
+		bucket.head = 0;
+	}
+
+	// Done
+	return frame;
+}
+
+
+void CalendarEventQueue::setCycleTime(long long cycle_time)
+{
+	// Nothing to do if bucket width does not change
+	assert(cycle_time > 0);
+	if (cycle_time == bucket_width)
+		return;
+
+	// Collect all frames in the queue
+	std::vector<std::shared_ptr<Frame>> frames;
+	for (Bucket &bucket : buckets)
+	{
+		for (unsigned i = bucket.head; i < bucket.frames.size(); i++)
+			frames.emplace_back(std::move(bucket.frames[i]));
+		bucket.frames.clear();
+		bucket.head = 0;
+	}
+	while (overflow.size())
+	{
+		frames.emplace_back(overflow.top());
+		overflow.pop();
+	}
+
+	// Keep the start of the window at the same point in time, and
+	// redistribute frames with the new bucket width.
+	current_bucket = current_bucket * bucket_width / cycle_time;
+	bucket_width = cycle_time;
+	wheel_size = 0;
+	for (auto &frame : frames)
+		Insert(std::move(frame));
+}
+
+
+}  // namespace esim
+
@@ -0,0 +1,208 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2014  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LIB_CPP_ESIM_EVENT_QUEUE_H
+#define LIB_CPP_ESIM_EVENT_QUEUE_H
+
+#include <cassert>
+#include <memory>
+#include <queue>
+#include <vector>
+
+#include <lib/cpp/String.h>
+
+#include "Frame.h"
+
+
+namespace esim
+{
+
+/// Data structures available to keep pending events in the simulation engine
+enum EventQueueKind
+{
+	EventQueueHeap = 0,
+	EventQueueCalendar
+};
+
+/// String map for EventQueueKind
+extern const misc::StringMap EventQueueKindMap;
+
+
+/// Abstract container of pending event frames used by the simulation engine.
+/// Frames are extracted in increasing order of their scheduled time, and
+/// frames scheduled for the same time are extracted in increasing order of
+/// their schedule sequence number. To add a new implementation, subclass
+/// this class, add a value to EventQueueKind and EventQueueKindMap, and
+/// instantiate it in EventQueue::Create().
+class EventQueue
+{
+public:
+
+	/// Create an event queue of the given kind
+	static std::unique_ptr<EventQueue> Create(EventQueueKind kind);
+
+	/// Virtual destructor
+	virtual ~EventQueue() { }
+
+	/// Insert a frame. Fields 'time' and 'schedule_sequence' of the frame
+	/// must be set already.
+	virtual void Push(std::shared_ptr<Frame> frame) = 0;
+
+	/// Return the frame with the earliest time. The queue must not be
+	/// empty.
+	virtual const std::shared_ptr<Frame> &Top() = 0;
+
+	/// Remove the frame with the earliest time and return it. The queue
+	/// must not be empty.
+	virtual std::shared_ptr<Frame> Pop() = 0;
+
+	/// Return the number of frames in the queue
+	virtual int getSize() const = 0;
+
+	/// Return whether the queue is empty
+	bool isEmpty() const { return getSize() == 0; }
+
+	/// Notify the queue of the cycle time in picoseconds of the fastest
+	/// frequency domain. This is invoked by the engine every time a
+	/// frequency domain is registered or modified.
+	virtual void setCycleTime(long long cycle_time) { }
+};
+
+
+/// Event queue implemented as a binary min-heap. Insertion and extraction
+/// take O(log n) time.
+class HeapEventQueue : public EventQueue
+{
+	// Heap of pending events
+	std::priority_queue<std::shared_ptr<Frame>,
+			std::vector<std::shared_ptr<Frame>>,
+			Frame::CompareSharedPointers> heap;
+
+public:
+
+	void Push(std::shared_ptr<Frame> frame) override
+	{
+		heap.emplace(std::move(frame));
+	}
+
+	const std::shared_ptr<Frame> &Top() override
+	{
+		assert(heap.size());
+		return heap.top();
+	}
+
+	std::shared_ptr<Frame> Pop() override
+	{
+		assert(heap.size());
+		std::shared_ptr<Frame> frame = heap.top();
+		heap.pop();
+		return frame;
+	}
+
+	int getSize() const override { return heap.size(); }
+};
+
+
+/// Event queue implemented as a calendar queue (timing wheel). Time is
+/// divided in buckets as wide as the cycle time of the fastest frequency
+/// domain, and a circular array of buckets covers a window of upcoming
+/// cycles. Frames scheduled beyond the window are kept in an overflow heap,
+/// and moved into the wheel as the window advances. For the common case of
+/// events scheduled a few cycles ahead, insertion and extraction take
+/// constant time.
+class CalendarEventQueue : public EventQueue
+{
+	// A bucket contains the frames scheduled within one cycle of the
+	// fastest frequency domain, sorted by time and schedule sequence
+	// number. Extracted frames are not erased from the vector right away.
+	// Instead, 'head' advances until the bucket is fully drained.
+	struct Bucket
+	{
+		// Frames in the bucket
+		std::vector<std::shared_ptr<Frame>> frames;
+
+		// Index of the first frame in 'frames' not extracted yet
+		unsigned head = 0;
+
+		// Return whether there are frames left in the bucket
+		bool isEmpty() const { return head == frames.size(); }
+	};
+
+	// Number of buckets in the wheel, must be a power of 2
+	static const int num_buckets = 1024;
+
+	// Circular array of buckets
+	std::vector<Bucket> buckets;
+
+	// Frames scheduled beyond the window covered by the wheel
+	std::priority_queue<std::shared_ptr<Frame>,
+			std::vector<std::shared_ptr<Frame>>,
+			Frame::CompareSharedPointers> overflow;
+
+	// Width of each bucket in picoseconds
+	long long bucket_width = 0;
+
+	// Absolute index of the first bucket in the window. All frames in the
+	// queue have a bucket index equal or greater than this one. Frames
+	// pushed with an earlier time are placed in this bucket.
+	long long current_bucket = 0;
+
+	// Number of frames in the wheel, not counting the overflow heap
+	int wheel_size = 0;
+
+	// Return the absolute bucket index for a time in picoseconds
+	long long getBucketIndex(long long time) const
+	{
+		return time / bucket_width;
+	}
+
+	// Insert a frame in the wheel or the overflow heap, based on its time
+	void Insert(std::shared_ptr<Frame> frame);
+
+	// Move frames from the overflow heap that fall now within the window
+	// into the wheel.
+	void Refill();
+
+	// Advance 'current_bucket' to the first non-empty bucket. The queue
+	// must not be empty.
+	void Advance();
+
+public:
+
+	/// Constructor
+	CalendarEventQueue();
+
+	void Push(std::shared_ptr<Frame> frame) override;
+
+	const std::shared_ptr<Frame> &Top() override;
+
+	std::shared_ptr<Frame> Pop() override;
+
+	int getSize() const override
+	{
+		return wheel_size + overflow.size();
+	}
+
+	void setCycleTime(long long cycle_time) override;
+};
+
+
+}  // namespace esim
+
+#endif
@@ -40,6 +40,7 @@ class Frame
 	// this one should not have access to these values.
 	friend class Engine;
 	friend class Queue;
+	friend class CalendarEventQueue;
 
 	// Event associated with this frame when the frame is enqueued in the
 	// event heap.
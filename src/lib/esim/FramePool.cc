@@ -0,0 +1,113 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2014  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cassert>
+
+#include <lib/cpp/String.h>
+
+#include "FramePool.h"
+
+
+namespace esim
+{
+
+void FramePool::Grow()
+{
+	// Allocate slab
+	assert(block_size);
+	char *slab = new char[block_size * slab_size];
+	slabs.emplace_back(slab);
+	slab_next = slab;
+	slab_end = slab + block_size * slab_size;
+
+	// Next slab is larger
+	slab_size = std::min(slab_size * 2, (int) max_slab_size);
+}
+
+
+void *FramePool::Allocate(size_t size)
+{
+	// Block size is set by the first allocation, rounded up to keep all
+	// blocks aligned.
+	if (!block_size)
+	{
+		const size_t alignment = alignof(std::max_align_t);
+		block_size = (std::max(size, sizeof(FreeBlock)) + alignment - 1)
+				/ alignment * alignment;
+	}
+
+	// Allocations of a different size are not pooled
+	if (size > block_size)
+		return ::operator new(size);
+
+	// Statistics
+	num_allocations++;
+	num_live++;
+	max_live = std::max(max_live, num_live);
+
+	// Recycle a freed block
+	if (free_list)
+	{
+		num_recycled++;
+		FreeBlock *block = free_list;
+		free_list = block->next;
+		return block;
+	}
+
+	// Take a new block from the last slab
+	if (slab_next == slab_end)
+		Grow();
+	void *block = slab_next;
+	slab_next += block_size;
+	return block;
+}
+
+
+void FramePool::Free(void *block, size_t size)
+{
+	// Allocations of a different size were not pooled
+	if (size > block_size)
+	{
+		::operator delete(block);
+		return;
+	}
+
+	// Return block to free list
+	assert(num_live > 0);
+	num_live--;
+	FreeBlock *free_block = static_cast<FreeBlock *>(block);
+	free_block->next = free_list;
+	free_list = free_block;
+}
+
+
+void FramePool::Dump(std::ostream &os, const std::string &prefix) const
+{
+	os << misc::fmt("%sAllocated = %lld\n", prefix.c_str(),
+			num_allocations);
+	os << misc::fmt("%sRecycled = %lld\n", prefix.c_str(),
+			num_recycled);
+	os << misc::fmt("%sLive = %lld\n", prefix.c_str(), num_live);
+	os << misc::fmt("%sMaxLive = %lld\n", prefix.c_str(), max_live);
+}
+
+
+}  // namespace esim
+
@@ -0,0 +1,187 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2014  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LIB_CPP_ESIM_FRAME_POOL_H
+#define LIB_CPP_ESIM_FRAME_POOL_H
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace esim
+{
+
+/// Slab allocator for event frames of one type. Memory is obtained from the
+/// host in slabs of several frames, and freed frames are kept in a free list
+/// to be recycled by future allocations, instead of being returned to the
+/// host. The pool is not thread-safe, since the event-driven simulation
+/// engine runs in a single thread. Other short-lived objects created at a
+/// high rate during the simulation, such as the micro-instructions of the
+/// timing models, can be allocated from a frame pool as well.
+class FramePool
+{
+	// Free block, linked in the free list
+	struct FreeBlock
+	{
+		FreeBlock *next;
+	};
+
+	// Number of blocks in the first slab
+	static const int min_slab_size = 64;
+
+	// Maximum number of blocks in a slab
+	static const int max_slab_size = 4096;
+
+	// Size of each block in bytes, set upon the first allocation
+	size_t block_size = 0;
+
+	// Number of blocks in the next slab
+	int slab_size = min_slab_size;
+
+	// Slabs obtained from the host
+	std::vector<std::unique_ptr<char[]>> slabs;
+
+	// Next block never allocated in the last slab
+	char *slab_next = nullptr;
+
+	// End of the last slab
+	char *slab_end = nullptr;
+
+	// List of freed blocks
+	FreeBlock *free_list = nullptr;
+
+	// Number of allocations
+	long long num_allocations = 0;
+
+	// Number of allocations served with a recycled block
+	long long num_recycled = 0;
+
+	// Number of currently live blocks
+	long long num_live = 0;
+
+	// Maximum number of blocks live at the same time
+	long long max_live = 0;
+
+	// Allocate a new slab
+	void Grow();
+
+public:
+
+	/// Return the pool for frames of type \a T. Pools are never destroyed,
+	/// since frames can still be released by other static objects, such
+	/// as the simulation engine, at program exit.
+	template<typename T> static FramePool *getInstance()
+	{
+		static FramePool *pool = new FramePool();
+		return pool;
+	}
+
+	/// Allocate a block of \a size bytes. All blocks allocated from the
+	/// same pool are expected to have the same size. Blocks of a different
+	/// size are allocated from the host.
+	void *Allocate(size_t size);
+
+	/// Free a block of \a size bytes previously allocated with Allocate()
+	void Free(void *block, size_t size);
+
+	/// Return the number of allocations
+	long long getNumAllocations() const { return num_allocations; }
+
+	/// Return the number of allocations that recycled a freed block
+	long long getNumRecycled() const { return num_recycled; }
+
+	/// Return the number of blocks currently allocated
+	long long getNumLive() const { return num_live; }
+
+	/// Return the maximum number of blocks allocated at the same time
+	long long getMaxLive() const { return max_live; }
+
+	/// Dump statistics of the pool, with each field name preceded by
+	/// \a prefix.
+	void Dump(std::ostream &os, const std::string &prefix) const;
+};
+
+
+/// Allocator serving frames of type \a T from FramePool::getInstance<T>().
+/// The allocator can be rebound to other types, as done by
+/// std::allocate_shared() to allocate the shared pointer control block
+/// together with the frame, while still using the pool of \a T.
+template<typename U, typename T> class FrameAllocator
+{
+public:
+
+	typedef U value_type;
+
+	template<typename V> struct rebind
+	{
+		typedef FrameAllocator<V, T> other;
+	};
+
+	FrameAllocator()
+	{
+	}
+
+	template<typename V> FrameAllocator(const FrameAllocator<V, T> &other)
+	{
+	}
+
+	U *allocate(size_t n)
+	{
+		FramePool *pool = FramePool::getInstance<T>();
+		return static_cast<U *>(pool->Allocate(n * sizeof(U)));
+	}
+
+	void deallocate(U *p, size_t n)
+	{
+		FramePool *pool = FramePool::getInstance<T>();
+		pool->Free(p, n * sizeof(U));
+	}
+
+	template<typename V> bool operator==(
+			const FrameAllocator<V, T> &other) const
+	{
+		return true;
+	}
+
+	template<typename V> bool operator!=(
+			const FrameAllocator<V, T> &other) const
+	{
+		return false;
+	}
+};
+
+
+/// Create an event frame of type \a T, passing \a args to its constructor.
+/// This is equivalent to misc::new_shared(), but both the frame and the
+/// reference counter of the shared pointer are allocated from the frame
+/// pool of type \a T.
+template<typename T, typename... Args> std::shared_ptr<T>
+		new_frame(Args&&... args)
+{
+	return std::allocate_shared<T>(FrameAllocator<T, T>(),
+			std::forward<Args>(args)...);
+}
+
+
+}  // namespace esim
+
+#endif
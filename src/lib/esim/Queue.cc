@@ -148,7 +148,7 @@ void Queue::WakeupOne()
 
 	// Schedule event
 	Engine *engine = Engine::getInstance();
-	engine->Schedule(event, frame);
+	engine->Schedule(event, std::move(frame));
 }
 
 
@@ -39,8 +39,11 @@ TraceSystem::~TraceSystem()
 	if (!active)
 		return;
 	
-	// Close ZIP file
-	gzclose(gz_file);
+	// Close binary trace, or ZIP file
+	if (binary_writer)
+		binary_writer->Close();
+	else
+		gzclose(gz_file);
 }
 
 
@@ -56,7 +59,7 @@ TraceSystem *TraceSystem::getInstance()
 }
 
 	
-void TraceSystem::setPath(const std::string &path)
+void TraceSystem::setPath(const std::string &path, bool binary)
 {
 	// Trace must not have been activated yet
 	if (active)
@@ -65,6 +68,13 @@ void TraceSystem::setPath(const std::string &path)
 	// Save path
 	this->path = path;
 	active = true;
+
+	// Binary trace
+	if (binary)
+	{
+		binary_writer.reset(new BinaryTraceWriter(path));
+		return;
+	}
 	
 	// Open ZIP file
 	gz_file = gzopen(path.c_str(), "wt");
@@ -74,6 +84,23 @@ void TraceSystem::setPath(const std::string &path)
 }
 
 
+void TraceSystem::WriteCycle()
+{
+	// Cycle already printed
+	esim::Engine *engine = esim::Engine::getInstance();
+	long long cycle = engine->getCycle();
+	if (cycle <= last_cycle)
+		return;
+
+	// Print it
+	if (binary_writer)
+		binary_writer->WriteCycle(cycle);
+	else
+		gzprintf(gz_file, "c clk=%lld\n", cycle);
+	last_cycle = cycle;
+}
+
+
 void TraceSystem::Write(const std::string &s, bool print_cycle)
 {
 	// Trace system must be active
@@ -81,18 +108,31 @@ void TraceSystem::Write(const std::string &s, bool print_cycle)
 	
 	// Print cycle
 	if (print_cycle)
+		WriteCycle();
+
+	// Dump string
+	if (binary_writer)
+		binary_writer->Write(s);
+	else
+		gzwrite(gz_file, s.c_str(), s.length());
+}
+
+
+void TraceSystem::Format(const char *fmt_str, va_list va)
+{
+	// Trace system must be active
+	assert(active);
+
+	// Binary trace, encoded from the arguments
+	if (binary_writer)
 	{
-		esim::Engine *engine = esim::Engine::getInstance();
-		long long cycle = engine->getCycle();
-		if (cycle > last_cycle)
-		{
-			gzprintf(gz_file, "c clk=%lld\n", cycle);
-			last_cycle = cycle;
-		}
+		WriteCycle();
+		if (binary_writer->WriteFormat(fmt_str, va))
+			return;
 	}
 
-	// Dump string
-	gzwrite(gz_file, s.c_str(), s.length());
+	// Formatted text
+	Write(misc::vfmt(fmt_str, va));
 }
 
 
@@ -117,5 +157,11 @@ Trace::Trace()
 }
 
 
+void Trace::Dump(const char *fmt_str, va_list va)
+{
+	trace_system->Format(fmt_str, va);
+}
+
+
 }  // namespace esim
 
@@ -20,17 +20,23 @@
 #ifndef LIB_CPP_ESIM_TRACE_H
 #define LIB_CPP_ESIM_TRACE_H
 
+#include <cstdarg>
 #include <memory>
 #include <string>
 #include <sstream>
 #include <zlib.h>
 
+#include "BinaryTrace.h"
+
 
 namespace esim
 {
 
 class TraceSystem
 {
+	// Trace objects write formatted messages directly
+	friend class Trace;
+
 	// Unique trace system instance
 	static std::unique_ptr<TraceSystem> instance;
 
@@ -40,17 +46,29 @@ class TraceSystem
 	// Flag indicating whether trace is active
 	bool active = false;
 
-	// ZIP file object
+	// ZIP file object, used for text traces
 	gzFile gz_file;
 
+	// Writer used for binary traces
+	std::unique_ptr<BinaryTraceWriter> binary_writer;
+
 	// Last cycle when a trace message was printed
 	long long last_cycle = -1;
 
+	// Write a line with the current cycle if it was not written yet
+	void WriteCycle();
+
 	// Write a message to the trace file. If argument 'print_cycle' is set,
 	// a line with the current cycle will be printed if this is the first
 	// message for the cycle. The trace system must be active.
 	void Write(const std::string &s, bool print_cycle = true);
 
+	// Write a message formatted with the same rules as misc::fmt(),
+	// printing the current cycle first if needed. Binary traces encode
+	// the message from its arguments without formatting it when
+	// possible. The trace system must be active.
+	void Format(const char *fmt_str, va_list va);
+
 public:
 
 	/// Return trace system singleton.
@@ -59,9 +77,10 @@ public:
 	/// Destructor
 	~TraceSystem();
 
-	/// Activate the trace system and set the output ZIP trace file to the
-	/// given path.
-	void setPath(const std::string &path);
+	/// Activate the trace system and set the output trace file to the
+	/// given path. The trace is written as compressed plain text, or in
+	/// the binary format described in BinaryTrace.h if \a binary is set.
+	void setPath(const std::string &path, bool binary = false);
 
 	/// Return whether trace system has been activated by the user
 	bool isActive() const { return active; }
@@ -69,7 +88,7 @@ public:
 	/// Dump a message to the trace system if it was activated with a
 	/// previous call to setPath(). A line with the current cycle will be
 	/// printed if this is the first message for it.
-	template<typename T> TraceSystem& operator<<(T value)
+	template<typename T> TraceSystem& operator<<(const T &value)
 	{
 		// Convert to string and write
 		if (active)
@@ -97,6 +116,9 @@ class Trace
 	// Associated trace system
 	TraceSystem *trace_system = nullptr;
 
+	// Format a message and write it to the trace system
+	void Dump(const char *fmt_str, va_list va);
+
 public:
 
 	/// Constructor
@@ -122,13 +144,28 @@ public:
 	/// cycle to be printed in the trace file if it is the first message
 	/// for this cycle.
 	/// The argument can be of any type accepted by \c std::ostream.
-	template<typename T> Trace& operator<<(T value)
+	template<typename T> Trace& operator<<(const T &value)
 	{
 		if (active)
 			*trace_system << value;
 		return *this;
 	}
 
+	/// Dump a message formatted with the same rules as misc::fmt(). The
+	/// message is only formatted if both the current trace object and the
+	/// trace system are active, so this call is cheap in
+	/// performance-critical code when tracing is disabled.
+	void fmt(const char *fmt_str, ...)
+			__attribute__ ((format(printf, 2, 3)))
+	{
+		if (!active || !trace_system->isActive())
+			return;
+		va_list va;
+		va_start(va, fmt_str);
+		Dump(fmt_str, va);
+		va_end(va);
+	}
+
 	/// A trace object can be cast into a \c bool (e.g. within an \c if
 	/// condition) to check whether it is active or not. This is
 	/// useful when many possibly costly operations are performed just
@@ -0,0 +1,93 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2014  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include <lib/cpp/Error.h>
+#include <lib/cpp/String.h>
+#include <lib/esim/BinaryTrace.h>
+
+
+// Dump a binary trace generated with 'm2s --trace <file> --trace-binary' as
+// plain text, in the same format as a text trace. Header lines are always
+// dumped. If a cycle range is given, only the lines of those cycles follow,
+// using the trace index to skip the rest of the file.
+//
+//	m2s-trace-dump <trace> [<first_cycle> [<last_cycle>]]
+//
+
+int MainProgram(int argc, char **argv)
+{
+	// Syntax
+	if (argc < 2 || argc > 4)
+	{
+		std::cerr << "Syntax: m2s-trace-dump <trace> "
+				"[<first_cycle> [<last_cycle>]]\n";
+		return 1;
+	}
+	long long first_cycle = argc > 2 ? atoll(argv[2]) : 0;
+	long long last_cycle = argc > 3 ? atoll(argv[3]) : -1;
+
+	// Header lines
+	esim::BinaryTraceReader reader(argv[1]);
+	std::string line;
+	bool more = reader.ReadLine(line);
+	while (more && reader.getCycle() < 0)
+	{
+		std::cout << line << '\n';
+		more = reader.ReadLine(line);
+	}
+
+	// Skip to first cycle
+	if (more && first_cycle > reader.getCycle() && reader.hasIndex())
+	{
+		reader.SeekCycle(first_cycle);
+		more = reader.ReadLine(line);
+	}
+	while (more && reader.getCycle() < first_cycle)
+		more = reader.ReadLine(line);
+
+	// Dump cycles
+	while (more && (last_cycle < 0 || reader.getCycle() <= last_cycle))
+	{
+		std::cout << line << '\n';
+		more = reader.ReadLine(line);
+	}
+
+	// Success
+	return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+	// Main exception handler
+	try
+	{
+		// Run main program
+		return MainProgram(argc, argv);
+	}
+	catch (misc::Exception &e)
+	{
+		e.Dump();
+		return 1;
+	}
+}
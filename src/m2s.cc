@@ -44,6 +44,7 @@
 #include <arch/arm/disassembler/Disassembler.h>
 #include <arch/arm/emulator/Emulator.h>
 #include <dram/System.h>
+#include <memory/Memory.h>
 #include <memory/Mmu.h>
 #include <memory/Manager.h>
 #include <memory/System.h>
@@ -73,6 +74,9 @@ std::string m2s_cuda_debug;
 // Event-driven simulator debugger
 std::string m2s_debug_esim;
 
+// Data structure for pending events in the event-driven simulator
+esim::EventQueueKind m2s_esim_queue = esim::EventQueueHeap;
+
 // Inifile debugger
 std::string m2s_debug_inifile;
 
@@ -82,6 +86,9 @@ std::string m2s_debug_callstack;
 // Maximum simulation time
 long long m2s_max_time = 0;
 
+// Simulate every cycle, even when all timing simulators are stalled
+bool m2s_no_idle_skip = false;
+
 // Binary file for OpenCL runtime
 std::string m2s_opencl_binary;
 
@@ -94,6 +101,9 @@ std::string m2s_opencl_devices;
 // Trace file
 std::string m2s_trace_file;
 
+// Write trace in binary format
+bool m2s_trace_binary = false;
+
 // Visualization tool input file
 std::string m2s_visual_file;
 
@@ -193,6 +203,12 @@ void LoadProgram(const std::vector<std::string> &arguments,
 // Load programs from context configuration file
 void LoadPrograms()
 {
+	// Load x86 contexts from a checkpoint
+	const std::string &checkpoint_file =
+			x86::Emulator::getLoadCheckpointFile();
+	if (!checkpoint_file.empty())
+		x86::Emulator::getInstance()->LoadCheckpoint(checkpoint_file);
+
 	// Load command-line program
 	misc::CommandLine *command_line = misc::CommandLine::getInstance();
 	LoadProgram(command_line->getArguments());
@@ -285,6 +301,17 @@ void RegisterOptions()
 			m2s_debug_esim,
 			"Dump debug information related with the event-driven "
 			"simulation engine.");
+
+	// Event queue of event-driven simulator
+	command_line->RegisterEnum("--esim-queue {heap|calendar} "
+			"(default = heap)",
+			(int &) m2s_esim_queue, esim::EventQueueKindMap,
+			"Data structure used to keep pending events in the "
+			"event-driven simulation engine. Option 'heap' uses "
+			"a binary heap. Option 'calendar' uses a calendar "
+			"queue with one bucket per cycle of the fastest "
+			"frequency domain, which is faster when many events "
+			"are in flight.");
 	
 	// Debugger for Inifile parser
 	command_line->RegisterString("--inifile-debug <file>",
@@ -299,6 +326,18 @@ void RegisterOptions()
 			"will stop once this time is exceeded. A value of 0 "
 			"(default) means no time limit.");
 	
+	// Idle cycle skipping
+	command_line->RegisterBool("--no-idle-skip",
+			m2s_no_idle_skip,
+			"Simulate every cycle of the fastest frequency domain. "
+			"By default, when all timing simulators are stalled "
+			"waiting for an event (for example, a long-latency "
+			"memory access), the main simulation loop jumps "
+			"straight to the cycle of the next event, updating "
+			"statistics in bulk for the skipped cycles. Results "
+			"are the same with this option, which is only useful "
+			"to validate timing simulators.");
+
 	// Trace file
 	command_line->RegisterString("--trace <file>",
 			m2s_trace_file,
@@ -309,6 +348,17 @@ void RegisterOptions()
 			"user should watch the size of the generated trace as "
 			"simulation runs, since the trace file can quickly "
 			"become extremely large.");
+
+	// Binary trace
+	command_line->RegisterBool("--trace-binary",
+			m2s_trace_binary,
+			"Write the trace file produced with option '--trace' "
+			"in a compact binary format with a seek index, "
+			"instead of compressed plain text. The trace is "
+			"compressed and written by a background thread. Binary "
+			"traces are accepted by the visualization tool, and "
+			"can be converted to plain text with tool "
+			"'m2s-trace-dump'.");
 	
 	// Visualization tool input file
 	command_line->RegisterString("--visual <file>",
@@ -388,6 +438,9 @@ void ProcessOptions()
 	if (!m2s_debug_esim.empty())
 		esim::Engine::setDebugPath(m2s_debug_esim);
 
+	// Event queue of event-driven simulator
+	esim::Engine::setEventQueueKind(m2s_esim_queue);
+
 	// Inifile debugger
 	if (!m2s_debug_inifile.empty())
 		misc::IniFile::setDebugPath(m2s_debug_inifile);
@@ -408,7 +461,7 @@ void ProcessOptions()
 	if (!m2s_trace_file.empty())
 	{
 		esim::TraceSystem *trace_system = esim::TraceSystem::getInstance();
-		trace_system->setPath(m2s_trace_file);
+		trace_system->setPath(m2s_trace_file, m2s_trace_binary);
 	}
 
 	// Visualization
@@ -480,6 +533,17 @@ void MainLoop()
 		if (num_active_timing_simulators)
 			esim->ProcessEvents();
 
+		// If no architecture is running emulation, and all timing
+		// simulators are stalled until a future cycle, skip the idle
+		// cycles in between, up to the next event.
+		if (num_active_timing_simulators && !num_active_emulators &&
+				!m2s_no_idle_skip)
+		{
+			long long time = esim->getTime();
+			if (esim->SkipIdleCycles(arch_pool->getWakeupTime()) > time)
+				arch_pool->SkipCycles(time);
+		}
+
 		// If neither functional nor timing simulation was performed for
 		// any architecture, it means that all guest contexts finished
 		// execution - simulation can end.
@@ -592,6 +656,7 @@ int MainProgram(int argc, char **argv)
 	Kepler::Disassembler::RegisterOptions();
 	Kepler::Driver::RegisterOptions();
 	Kepler::Emulator::RegisterOptions();
+	mem::Memory::RegisterOptions();
 	mem::Mmu::RegisterOptions();
 	mem::Manager::RegisterOptions();
 	MIPS::Disassembler::RegisterOptions();
@@ -622,6 +687,7 @@ int MainProgram(int argc, char **argv)
 	Kepler::Disassembler::ProcessOptions();
 	Kepler::Driver::ProcessOptions();
 	Kepler::Emulator::ProcessOptions();
+	mem::Memory::ProcessOptions();
 	mem::Mmu::ProcessOptions();
 	mem::Manager::ProcessOptions();
 	MIPS::Disassembler::ProcessOptions();
@@ -652,6 +718,11 @@ int MainProgram(int argc, char **argv)
 		net::System *net_system = net::System::getInstance();
 		net_system->ReadConfiguration();
 
+		// The DRAM configuration file is also loaded first, since
+		// main memory modules refer to its memory controllers.
+		dram::System *dram_system = dram::System::getInstance();
+		dram_system->ReadConfiguration();
+
 		// Parse the memory configuration file
 		mem::System *memory_system = mem::System::getInstance();
 		memory_system->ReadConfiguration();
@@ -665,14 +736,6 @@ int MainProgram(int argc, char **argv)
 		net_system->StandAlone();
 	}
 
-	// Initialize dram system, only if the option --dram-sim is used
-	if (dram::System::isStandAlone())
-	{
-		dram::System *dram_system = dram::System::getInstance();
-		dram_system->ReadConfiguration();
-		dram_system->Run();
-	}
-
 	// Register drivers and runtimes
 	RegisterDrivers();
 	RegisterRuntimes();
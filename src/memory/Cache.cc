@@ -17,6 +17,10 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "Cache.h"
 #include "System.h"
 
@@ -24,6 +28,42 @@
 namespace mem
 {
 
+// Return the index of the first element at or after 'first' in 'tags' equal
+// to 'tag', skipping elements with a zero entry in 'valid' if given. Return
+// 'num' if not found. Groups of four tags are compared at once with SSE2.
+static unsigned FindTag(const unsigned *tags,
+		const unsigned *valid,
+		unsigned num,
+		unsigned tag,
+		unsigned first)
+{
+	unsigned index = first;
+
+#ifdef __SSE2__
+	__m128i key = _mm_set1_epi32(tag);
+	for (; index + 4 <= num; index += 4)
+	{
+		__m128i match = _mm_cmpeq_epi32(key, _mm_loadu_si128(
+				(const __m128i *) (tags + index)));
+		if (valid)
+			match = _mm_and_si128(match, _mm_loadu_si128(
+					(const __m128i *) (valid + index)));
+		int mask = _mm_movemask_ps(_mm_castsi128_ps(match));
+		if (mask)
+			return index + __builtin_ctz(mask);
+	}
+#endif
+
+	// Remaining tags, or all of them without SSE2
+	for (; index < num; index++)
+		if (tags[index] == tag && (!valid || valid[index]))
+			return index;
+
+	// Not found
+	return num;
+}
+
+
 const misc::StringMap Cache::ReplacementPolicyMap =
 {
 	{ "LRU", ReplacementLRU },
@@ -79,6 +119,9 @@ Cache::Cache(const std::string &name,
 	// Allocate blocks and sets
 	blocks = misc::new_unique_array<Block>(num_blocks);
 	sets = misc::new_unique_array<Set>(num_sets);
+	tags = misc::new_unique_array<unsigned>(num_blocks);
+	transient_tags = misc::new_unique_array<unsigned>(num_blocks);
+	valid = misc::new_unique_array<unsigned>(num_blocks);
 	
 	// Initialize sets and blocks
 	for (unsigned set_id = 0; set_id < num_sets; set_id++)
@@ -88,6 +131,10 @@ Cache::Cache(const std::string &name,
 		{
 			Block *block = getBlock(set_id, way_id);
 			block->way_id = way_id;
+			block->packed_tag = &tags[set_id * num_ways + way_id];
+			block->packed_transient_tag =
+					&transient_tags[set_id * num_ways + way_id];
+			block->packed_valid = &valid[set_id * num_ways + way_id];
 			set->lru_list.PushBack(block->lru_node);
 			
 				// Initialize RRPV for each block, 2^M - 1 initially
@@ -129,14 +176,11 @@ bool Cache::FindBlock(unsigned address,
 	unsigned tag = address & ~block_mask;
 
 	// Find block
-	for (way_id = 0; way_id < num_ways; way_id++)
+	way_id = FindWay(set_id, tag);
+	if (way_id < num_ways)
 	{
-		Block *block = getBlock(set_id, way_id);
-		if (block->tag == tag && block->state != BlockInvalid)
-		{
-			state = block->state;
-			return true;
-		}
+		state = getBlock(set_id, way_id)->state;
+		return true;
 	}
 
 	// Block not found
@@ -147,19 +191,41 @@ bool Cache::FindBlock(unsigned address,
 }
 
 
+unsigned Cache::FindWay(unsigned set_id,
+		unsigned tag,
+		unsigned first_way) const
+{
+	assert(misc::inRange(set_id, 0, num_sets - 1));
+	unsigned offset = set_id * num_ways;
+	return FindTag(&tags[offset], &valid[offset], num_ways, tag, first_way);
+}
+
+
+unsigned Cache::FindTransientWay(unsigned set_id,
+		unsigned tag,
+		unsigned first_way) const
+{
+	assert(misc::inRange(set_id, 0, num_sets - 1));
+	unsigned offset = set_id * num_ways;
+	return FindTag(&transient_tags[offset], nullptr, num_ways, tag,
+			first_way);
+}
+
+
 void Cache::setBlock(unsigned set_id,
 		unsigned way_id,
 		unsigned tag,
 		BlockState state)
 {
 	// Trace
-	System::trace << misc::fmt("mem.set_block cache=\"%s\" "
-			"set=%d way=%d tag=0x%x state=\"%s\"\n",
-			name.c_str(),
-			set_id,
-			way_id,
-			tag,
-			BlockStateMap[state]);
+	if (System::trace)
+		System::trace.fmt("mem.set_block cache=\"%s\" "
+				"set=%d way=%d tag=0x%x state=\"%s\"\n",
+				name.c_str(),
+				set_id,
+				way_id,
+				tag,
+				BlockStateMap[state]);
 	
 	// Get set and block
 	Set *set = getSet(set_id);
@@ -182,8 +248,7 @@ void Cache::setBlock(unsigned set_id,
 	}	
 
 	// Set new values for block
-	block->tag = tag;
-	block->state = state;
+	block->setStateTag(state, tag);
 }
 
 
@@ -103,6 +103,13 @@ public:
 
 		// The block belongs to an LRU list
 		misc::List<Block>::Node lru_node;
+
+		// Copies of the tag, transient tag, and validity of the block
+		// in the packed tag store of the cache, kept up to date by the
+		// setters below.
+		unsigned *packed_tag = nullptr;
+		unsigned *packed_transient_tag = nullptr;
+		unsigned *packed_valid = nullptr;
 	
 	public:
 
@@ -128,6 +135,15 @@ public:
 		{
 			this->state = state;
 			this->tag = tag;
+			*packed_tag = tag;
+			*packed_valid = state == BlockInvalid ? 0 : ~0u;
+		}
+
+		/// Set the transient tag
+		void setTransientTag(unsigned transient_tag)
+		{
+			this->transient_tag = transient_tag;
+			*packed_transient_tag = transient_tag;
 		}
 
 	};
@@ -181,6 +197,15 @@ private:
 	// Array of blocks
 	std::unique_ptr<Block[]> blocks;
 
+	// Packed tag store, with one entry per block in the same order as
+	// 'blocks'. Tags of all ways in a set are contiguous, so that they
+	// can be compared with vector instructions without touching the
+	// block objects. Valid entries are all ones for blocks in a state
+	// other than invalid, and zero otherwise.
+	std::unique_ptr<unsigned[]> tags;
+	std::unique_ptr<unsigned[]> transient_tags;
+	std::unique_ptr<unsigned[]> valid;
+
 	/// Return a pointer to a cache set
 	Set *getSet(unsigned set_id)
 	{
@@ -251,6 +276,32 @@ public:
 			unsigned &way_id,
 			BlockState &state) const;
 
+	/// Search a tag among the blocks of a set with a state other than
+	/// invalid, using the packed tag store.
+	///
+	/// \param set_id
+	///	Set to search.
+	///
+	/// \param tag
+	///	Tag to search for.
+	///
+	/// \param first_way
+	///	First way to consider. Ways before it are skipped.
+	///
+	/// \return
+	///	The first way at or after \a first_way holding the tag, or the
+	///	number of ways if the tag is not found.
+	unsigned FindWay(unsigned set_id,
+			unsigned tag,
+			unsigned first_way = 0) const;
+
+	/// Search a transient tag among the blocks of a set, regardless of
+	/// the block state. Arguments and return value are the same as for
+	/// FindWay().
+	unsigned FindTransientWay(unsigned set_id,
+			unsigned tag,
+			unsigned first_way = 0) const;
+
 	/// Set a new tag and state for a cache block. If a new tag is set to
 	/// the block, this function also updates the FIFO counters to indicate
 	/// that a new block was brought to the cache.
@@ -301,7 +352,7 @@ public:
 	void setTransientTag(unsigned set_id, unsigned way_id, unsigned tag)
 	{
 		Block *block = getBlock(set_id, way_id);
-		block->transient_tag = tag;
+		block->setTransientTag(tag);
 	}
 
 
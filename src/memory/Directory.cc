@@ -61,7 +61,7 @@ void Directory::setOwner(int set_id, int way_id, int sub_block_id, int owner)
 	entry->setOwner(owner);
 
 	// Trace
-	System::trace << misc::fmt("mem.set_owner dir=\"%s\" "
+	System::trace.fmt("mem.set_owner dir=\"%s\" "
 			"x=%d y=%d z=%d owner=%d\n",
 			name.c_str(),
 			set_id,
@@ -96,7 +96,7 @@ void Directory::setSharer(int set_id, int way_id, int sub_block_id, int node_id)
 	sharers.Set(bit_id);
 	
 	// Trace
-	System::trace << misc::fmt("mem.set_sharer dir=\"%s\" "
+	System::trace.fmt("mem.set_sharer dir=\"%s\" "
 			"x=%d y=%d z=%d sharer=%d\n",
 			name.c_str(),
 			set_id,
@@ -131,7 +131,7 @@ void Directory::clearSharer(int set_id, int way_id, int sub_block_id, int node_i
 	sharers.Set(bit_id, false);
 	
 	// Trace
-	System::trace << misc::fmt("mem.clear_sharer dir=\"%s\" "
+	System::trace.fmt("mem.clear_sharer dir=\"%s\" "
 			"x=%d y=%d z=%d sharer=%d\n",
 			name.c_str(),
 			set_id,
@@ -159,7 +159,7 @@ void Directory::clearAllSharers(int set_id, int way_id, int sub_block_id)
 		sharers.Set(bit_id + i, false);
 	
 	// Trace
-	System::trace << misc::fmt("mem.clear_all_sharers dir=\"%s\" "
+	System::trace.fmt("mem.clear_all_sharers dir=\"%s\" "
 			"x=%d y=%d z=%d\n",
 			name.c_str(),
 			set_id,
@@ -231,7 +231,7 @@ bool Directory::LockEntry(
 	if (lock->access_id)
 	{
 		lock->queue.Wait(event);
-		System::debug << misc::fmt("    "
+		System::debug.fmt("    "
 				"A-%lld suspended, "
 				"A-%lld has directory entry lock\n",
 				access_id,
@@ -240,7 +240,7 @@ bool Directory::LockEntry(
 	}
 
 	// Trace
-	System::trace << misc::fmt("mem.new_access_block "
+	System::trace.fmt("mem.new_access_block "
 			"cache=\"%s\" "
 			"access=\"A-%lld\" "
 			"set=%d "
@@ -251,7 +251,7 @@ bool Directory::LockEntry(
 			way_id);
 	
 	// Debug
-	System::debug << misc::fmt("    "
+	System::debug.fmt("    "
 			"A-%lld acquires directory lock "
 			"at set %d, way %d\n",
 			access_id,
@@ -274,7 +274,7 @@ void Directory::UnlockEntry(int set_id, int way_id, long long access_id)
 	assert(access_id == lock->access_id);
 
 	// Debug
-	System::debug << misc::fmt("    "
+	System::debug.fmt("    "
 			"A-%lld releases directory lock "
 			"at set %d, way %d\n",
 			access_id,
@@ -295,7 +295,7 @@ void Directory::UnlockEntry(int set_id, int way_id, long long access_id)
 		while (true)
 		{
 			// Print debug info
-			System::debug << misc::fmt("      "
+			System::debug.fmt("      "
 					"A-%lld resumed to retry lock\n",
 					frame->getId());
 
@@ -312,7 +312,7 @@ void Directory::UnlockEntry(int set_id, int way_id, long long access_id)
 	}
 
 	// Trace
-	System::trace << misc::fmt("mem.end_access_block "
+	System::trace.fmt("mem.end_access_block "
 			"cache=\"%s\" "
 			"access=\"A-%lld\" "
 			"set=%d "
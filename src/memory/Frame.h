@@ -24,6 +24,7 @@
 #include <memory>
 
 #include <lib/esim/Event.h>
+#include <lib/esim/FramePool.h>
 #include <lib/esim/Queue.h>
 
 #include "Cache.h"
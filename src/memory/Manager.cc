@@ -67,7 +67,7 @@ unsigned Manager::Allocate(unsigned size, unsigned alignment)
 	assert(alignment<=Memory::PageSize);
 
 	// Log memory allocation request in debug file
-	debug << misc::fmt("%d bytes of memory requested, align to %d byte\n",
+	debug.fmt("%d bytes of memory requested, align to %d byte\n",
 			size, alignment);
 
 	// If requested size is larger than a page, allocate whole pages for it
@@ -84,7 +84,7 @@ unsigned Manager::Allocate(unsigned size, unsigned alignment)
 	{
 		if (canHoleContain(it->second, size, alignment))
 		{
-			debug << misc::fmt("Allocating in hole 0x%x\n",
+			debug.fmt("Allocating in hole 0x%x\n",
 					it->second->getAddress());
 			unsigned address = AllocateIn(it->second,
 					size, alignment);
@@ -136,7 +136,7 @@ bool Manager::canHoleContain(Chunk *hole, unsigned size,
 
 	// Dump information into debug file
 	/*
-	debug << misc::fmt("Checking if hole 0x%x, size %d, "
+	debug.fmt("Checking if hole 0x%x, size %d, "
 			"fit variable size %d, align to %d. "
 			"Aligned size would be 0x%x. \n",
 			hole->getAddress(), hole->getSize(),
@@ -237,7 +237,7 @@ unsigned Manager::AllocateIn(Chunk *hole, unsigned size, unsigned alignment)
 void Manager::Free(unsigned address)
 {
 	// Dump information into debug file
-	debug << misc::fmt("Free pointer at 0x%x.\n", address);
+	debug.fmt("Free pointer at 0x%x.\n", address);
 
 	// Get the chunk to be freed
 	auto it = chunks.find(address);
@@ -407,10 +407,10 @@ Manager::Chunk *Manager::CreateHole(unsigned addr, unsigned size)
 	hole->setHolesIterator(it);
 
 	/*
-	debug << misc::fmt("Hole created at: 0x%x, size: %d\n", addr, size);
+	debug.fmt("Hole created at: 0x%x, size: %d\n", addr, size);
 	for (auto it = holes.begin(); it != holes.end(); it++)
 	{
-		debug << misc::fmt("Hole 0x%x, %d\n",
+		debug.fmt("Hole 0x%x, %d\n",
 				it->second->getAddress(),
 				it->first);
 	}
@@ -20,8 +20,15 @@
 #include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <fcntl.h>
 #include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
 
+#include <lib/cpp/Checkpoint.h>
+#include <lib/cpp/CommandLine.h>
 #include <lib/cpp/Misc.h>
 #include <lib/cpp/String.h>
 
@@ -35,14 +42,61 @@ const unsigned Memory::LogPageSize;
 const unsigned Memory::PageSize;
 const unsigned Memory::PageMask;
 
+const unsigned Memory::TlbInvalidTag;
+const int Memory::TlbSize;
+
 bool Memory::safe_mode = true;
 
+std::string Memory::debug_file;
+
+misc::Debug Memory::debug;
+
+
+void Memory::RegisterOptions()
+{
+	// Get command line object
+	misc::CommandLine *command_line = misc::CommandLine::getInstance();
+
+	// Category
+	command_line->setCategory("Memory");
+
+	// Option --memory-debug <file>
+	command_line->RegisterString("--memory-debug <file>", debug_file,
+			"Dump debug information related with guest virtual "
+			"memory spaces, such as the hit and miss counts of the "
+			"software TLB used for page lookups.");
+}
+
+
+void Memory::ProcessOptions()
+{
+	// Debug file
+	if (!debug_file.empty())
+		debug.setPath(debug_file);
+}
+
+
+Memory::MappedFile::~MappedFile()
+{
+	munmap(data, size);
+}
+
 
-Memory::Page *Memory::getPage(unsigned address)
+Memory::Page *Memory::getPageFromTable(unsigned address)
 {
+	// Look up page table
+	num_tlb_misses++;
 	unsigned tag = address & ~(PageSize - 1);
 	auto it = pages.find(tag);
-	return it == pages.end() ? nullptr : it->second.get();
+	if (it == pages.end())
+		return nullptr;
+
+	// Insert in TLB
+	Page *page = it->second.get();
+	TlbEntry &entry = getTlbEntry(tag);
+	entry.tag = tag;
+	entry.page = page;
+	return page;
 }
 
 
@@ -114,19 +168,23 @@ void Memory::Copy(unsigned dest, unsigned src, unsigned size)
 		Page *page_dest = getPage(dest);
 		Page *page_src = getPage(src);
 		assert(page_src && page_dest);
+		InvalidateCode(page_dest);
 		
 		// Different actions depending on whether source and
 		// destination page data are allocated.
 		if (page_src->getData())
 		{
-			page_dest->AllocateData();
+			UnshareData(page_dest);
 			memcpy(page_dest->getData(), page_src->getData(),
 					PageSize);
 		}
 		else
 		{
 			if (page_dest->getData())
+			{
+				UnshareData(page_dest);
 				memset(page_dest->getData(), 0, PageSize);
+			}
 		}
 
 		// Advance pointers
@@ -152,6 +210,14 @@ char *Memory::getBuffer(unsigned address, unsigned size, AccessType access)
 	// Check page permissions
 	if ((page->getPerm() & access) != access && safe)
 		throw Error(misc::fmt("[0x%x] Permission denied", address));
+
+	// The caller can modify cached code through the buffer, and the
+	// page data must be private.
+	if (access & (AccessWrite | AccessInit))
+	{
+		InvalidateCode(page);
+		UnshareData(page);
+	}
 	
 	// Return pointer to page data
 	page->AllocateData();
@@ -210,7 +276,8 @@ void Memory::AccessAtPageBoundary(unsigned address, unsigned size,
 	// Write/initialize access
 	if (access == AccessWrite || access == AccessInit)
 	{
-		page->AllocateData();
+		InvalidateCode(page);
+		UnshareData(page);
 		memcpy(page->getData() + offset, buffer, size);
 		return;
 	}
@@ -244,28 +311,116 @@ Memory::Memory()
 }
 
 
+Memory::~Memory()
+{
+	// Debug
+	long long num_lookups = num_tlb_hits + num_tlb_misses;
+	if (debug && num_lookups)
+		debug.fmt("[Memory %p] Destroyed, %lld page lookups, "
+				"%lld TLB hits, %lld TLB misses "
+				"(hit ratio %.4g)\n",
+				this, num_lookups, num_tlb_hits,
+				num_tlb_misses,
+				(double) num_tlb_hits / num_lookups);
+	if (debug && num_file_pages)
+		debug.fmt("[Memory %p] %lld pages mapped from files\n",
+				this, num_file_pages);
+	if (debug && num_shared_pages)
+		debug.fmt("[Memory %p] %lld pages shared on clone, "
+				"%lld copied on write\n",
+				this, num_shared_pages, num_copied_pages);
+}
+
+
 Memory::Memory(const Memory &memory)
 {
 	// Copy pages
-	safe = false;
+	ClonePages(memory);
+
+	// Copy other fields
+	safe = memory.safe;
+	heap_break = memory.heap_break;
+}
+
+
+void Memory::ClonePages(const Memory &memory)
+{
 	for (auto &it : memory.pages)
 	{
 		// Get source page
 		Page *src_page = it.second.get();
 
 		// Create destination page with same permissions
-		newPage(src_page->getTag(), src_page->getPerm());
+		Page *page = newPage(src_page->getTag(), src_page->getPerm());
 
-		// Copy data if any
+		// Share data if any
 		if (src_page->getData())
-			Access(src_page->getTag(), PageSize,
-					src_page->getData(),
-					AccessInit);
+		{
+			page->ShareData(*src_page);
+			num_shared_pages++;
+		}
 	}
 
-	// Copy other fields
-	safe = memory.safe;
-	heap_break = memory.heap_break;
+	// Debug
+	debug.fmt("[Memory %p] Cloned from %p, %d pages\n",
+			this, &memory, (int) memory.pages.size());
+}
+
+
+bool Memory::MapFile(unsigned address, unsigned size, int fd,
+		unsigned offset)
+{
+	assert(!(address & (PageSize - 1)));
+	assert(!(size & (PageSize - 1)));
+	assert(!(offset & (PageSize - 1)));
+
+	// The host can only map regular files, at offsets aligned to its own
+	// page size.
+	struct stat file_stat;
+	long host_page_size = sysconf(_SC_PAGESIZE);
+	if (host_page_size <= 0 || offset % host_page_size ||
+			fstat(fd, &file_stat) || !S_ISREG(file_stat.st_mode))
+		return false;
+
+	// A file opened for writing can be truncated by the guest itself,
+	// after which accessing the mapping raises SIGBUS in the host.
+	int flags = fcntl(fd, F_GETFL);
+	if (flags < 0 || (flags & O_ACCMODE) != O_RDONLY)
+		return false;
+
+	// Only pages containing file data are mapped. Accessing a host
+	// mapping past the end of the file raises SIGBUS, and the guest
+	// pages there read as zeros anyway.
+	if ((long long) offset >= file_stat.st_size)
+		return true;
+	unsigned file_size = std::min<long long>(size,
+			file_stat.st_size - offset);
+	unsigned map_size = misc::RoundUp(file_size, PageSize);
+
+	// Map the file
+	void *data = mmap(nullptr, map_size, PROT_READ, MAP_PRIVATE, fd,
+			offset);
+	if (data == MAP_FAILED)
+		return false;
+	auto file = std::make_shared<MappedFile>((char *) data, map_size);
+
+	// Point pages into the host mapping
+	for (unsigned page_offset = 0; page_offset < map_size;
+			page_offset += PageSize)
+	{
+		Page *page = getPage(address + page_offset);
+		if (!page)
+			throw misc::Panic(misc::fmt("File mapped on unallocated "
+					"page 0x%x", address + page_offset));
+		InvalidateCode(page);
+		page->MapData(file, page_offset);
+		num_file_pages++;
+	}
+
+	// Debug
+	debug.fmt("[Memory %p] File mapped at 0x%x, %u bytes, "
+			"offset 0x%x\n", this, address, map_size, offset);
+	return true;
 }
 
 
@@ -364,7 +519,18 @@ void Memory::Unmap(unsigned address, unsigned size)
 
 	// Deallocate pages
 	for (unsigned tag = tag1; tag <= tag2; tag += PageSize)
-		pages.erase(tag);
+	{
+		auto it = pages.find(tag);
+		if (it == pages.end())
+			continue;
+		InvalidateCode(it->second.get());
+		pages.erase(it);
+
+		// Invalidate TLB entry
+		TlbEntry &entry = getTlbEntry(tag);
+		if (entry.tag == tag)
+			entry.tag = TlbInvalidTag;
+	}
 }
 
 
@@ -384,6 +550,7 @@ void Memory::Protect(unsigned address, unsigned size, unsigned perm)
 			continue;
 
 		// Set page new protection flags
+		InvalidateCode(page);
 		page->setPerm(perm);
 	}
 }
@@ -474,28 +641,85 @@ void Memory::Load(const std::string &path, unsigned start)
 }
 
 
-void Memory::Clone(const Memory &memory)
+void Memory::SaveCheckpoint(misc::Checkpoint &checkpoint) const
 {
-	// Clear destination memory
+	// Sort pages by tag
+	std::vector<Page *> sorted_pages;
+	for (auto &it : pages)
+		sorted_pages.push_back(it.second.get());
+	std::sort(sorted_pages.begin(), sorted_pages.end(),
+			[](const Page *a, const Page *b)
+			{
+				return a->getTag() < b->getTag();
+			});
+
+	// Header
+	checkpoint.WriteTag("memory");
+	checkpoint.WriteValue(safe);
+	checkpoint.WriteValue(heap_break);
+	checkpoint.WriteValue<unsigned>(sorted_pages.size());
+
+	// Pages. Pages that were never written have no data.
+	for (Page *page : sorted_pages)
+	{
+		char *data = page->getData();
+		checkpoint.WriteValue(page->getTag());
+		checkpoint.WriteValue(page->getPerm());
+		checkpoint.WriteValue<bool>(data);
+		if (data)
+			checkpoint.Write(data, PageSize);
+	}
+
+	// Debug
+	debug.fmt("[Memory %p] Saved to checkpoint '%s', %d pages\n",
+			this, checkpoint.getPath().c_str(),
+			(int) sorted_pages.size());
+}
+
+
+void Memory::LoadCheckpoint(misc::Checkpoint &checkpoint)
+{
+	// Clear memory
 	Clear();
 
-	// Copy pages
-	safe = false;
-	for (auto &it : memory.pages)
+	// Header
+	checkpoint.ReadTag("memory");
+	safe = checkpoint.ReadValue<bool>();
+	heap_break = checkpoint.ReadValue<unsigned>();
+	unsigned num_pages = checkpoint.ReadValue<unsigned>();
+
+	// Pages
+	for (unsigned i = 0; i < num_pages; i++)
 	{
-		// Get source page
-		Page *src_page = it.second.get();
+		unsigned tag = checkpoint.ReadValue<unsigned>();
+		unsigned perm = checkpoint.ReadValue<unsigned>();
+		bool has_data = checkpoint.ReadValue<bool>();
+		if (tag & ~PageMask || pages.count(tag))
+			throw misc::Error(misc::fmt("%s: invalid memory page "
+					"0x%x in checkpoint file",
+					checkpoint.getPath().c_str(), tag));
+		Page *page = newPage(tag, perm);
+		if (has_data)
+		{
+			page->AllocateData();
+			checkpoint.Read(page->getData(), PageSize);
+		}
+	}
 
-		// Create destination page with same permissions
-		newPage(src_page->getTag(), src_page->getPerm());
+	// Debug
+	debug.fmt("[Memory %p] Loaded from checkpoint '%s', "
+			"%d pages\n", this, checkpoint.getPath().c_str(),
+			num_pages);
+}
 
-		// Copy data if any
-		if (src_page->getData())
-			Access(src_page->getTag(), PageSize,
-					src_page->getData(),
-					AccessInit);
-	}
 
+void Memory::Clone(const Memory &memory)
+{
+	// Clear destination memory
+	Clear();
+
+	// Copy pages
+	ClonePages(memory);
 
 	// Copy other fields
 	safe = memory.safe;
@@ -503,5 +727,25 @@ void Memory::Clone(const Memory &memory)
 }
 
 
+bool Memory::AddCode(unsigned address, unsigned size)
+{
+	// Calculate page boundaries
+	assert(size > 0 && size <= PageSize);
+	unsigned tag1 = address & ~(PageSize-1);
+	unsigned tag2 = (address + size - 1) & ~(PageSize-1);
+
+	// Check that all pages are mapped
+	Page *page1 = getPage(tag1);
+	Page *page2 = getPage(tag2);
+	if (!page1 || !page2)
+		return false;
+
+	// Mark pages. The range spans two pages at most.
+	page1->setCode(true);
+	page2->setCode(true);
+	return true;
+}
+
+
 } // namespace mem
 
@@ -21,14 +21,21 @@
 #define MEMORY_MEMORY_H
 
 #include <cassert>
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <unordered_map>
 
+#include <lib/cpp/Debug.h>
 #include <lib/cpp/Error.h>
 #include <lib/cpp/Misc.h>
 
 
+namespace misc
+{
+class Checkpoint;
+}
+
 namespace mem
 {
 
@@ -70,6 +77,39 @@ public:
 		AccessModified = 1 << 4
 	};
 
+	/// A region of a host file mapped read-only in the host address space.
+	/// Guest pages mapped from a file point into this region until they are
+	/// first written, so pages that are never touched are never read from
+	/// the file, and clean pages are shared with all other mappings of the
+	/// same file through the host page cache.
+	class MappedFile
+	{
+		// Host address of the mapping
+		char *data;
+
+		// Size of the mapping in bytes
+		size_t size;
+
+	public:
+
+		/// Constructor, taking ownership of a region of \a size bytes
+		/// mapped at \a data with a call to mmap().
+		MappedFile(char *data, size_t size) :
+				data(data),
+				size(size)
+		{
+		}
+
+		/// Destructor, unmapping the region
+		~MappedFile();
+
+		/// Return the host address of the mapping
+		char *getData() const { return data; }
+
+		/// Return the size of the mapping in bytes
+		size_t getSize() const { return size; }
+	};
+
 	/// A 4KB page of memory
 	class Page
 	{
@@ -80,8 +120,18 @@ public:
 		// Page permissions
 		unsigned perm;
 
-		// The page data
-		std::unique_ptr<char[]> data;
+		// The page data. The data can be shared with pages of other
+		// memory objects cloned from this one (or this one cloned
+		// from), in which case it is copied upon the first write.
+		std::shared_ptr<char> data;
+
+		// Flag indicating whether instructions decoded from this page
+		// are cached by an emulator
+		bool code = false;
+
+		// Flag indicating that the data points into a read-only host
+		// file mapping, and must be copied before being written.
+		bool mapped = false;
 	
 	public:
 
@@ -110,7 +160,54 @@ public:
 		void AllocateData()
 		{
 			if (data == nullptr)
-				data = misc::new_unique_array<char>(PageSize);
+				data.reset(new char[PageSize](),
+						std::default_delete<char[]>());
+		}
+
+		/// Return whether the page data is shared with other pages
+		bool isShared() const { return data.use_count() > 1; }
+
+		/// Share the data of \a page, which must have the same tag.
+		/// Neither page can be written directly anymore, and a private
+		/// copy of the data is made with UnshareData() upon the first
+		/// write to any of them.
+		void ShareData(const Page &page)
+		{
+			assert(page.tag == tag);
+			data = page.data;
+			mapped = page.mapped;
+		}
+
+		/// Point the page data into \a file at \a offset. The data is
+		/// copied upon the first write.
+		void MapData(const std::shared_ptr<MappedFile> &file,
+				unsigned offset)
+		{
+			assert(offset + PageSize <= file->getSize());
+			data = std::shared_ptr<char>(file, file->getData() +
+					offset);
+			mapped = true;
+		}
+
+		/// Return whether the page data points into a host file
+		/// mapping.
+		bool isMapped() const { return mapped; }
+
+		/// Allocate the page data, and make a private copy of it if it
+		/// is shared with other pages. This function must be called
+		/// before modifying the page data. The return value is `true`
+		/// if a copy was made.
+		bool UnshareData()
+		{
+			AllocateData();
+			if (!isShared() && !mapped)
+				return false;
+			std::shared_ptr<char> shared_data = data;
+			data.reset(new char[PageSize],
+					std::default_delete<char[]>());
+			memcpy(data.get(), shared_data.get(), PageSize);
+			mapped = false;
+			return true;
 		}
 
 		/// Set the page permissions, given as a bitmap of flags of
@@ -120,6 +217,14 @@ public:
 		/// Add a flag to the page permissions, given as a bitmap of
 		/// flags of type AccessType.
 		void addPerm(unsigned perm) { this->perm |= perm; }
+
+		/// Return whether instructions decoded from this page are
+		/// cached by an emulator.
+		bool isCode() const { return code; }
+
+		/// Set or clear the flag indicating whether instructions
+		/// decoded from this page are cached by an emulator.
+		void setCode(bool code) { this->code = code; }
 	};
 
 private:
@@ -128,9 +233,82 @@ private:
 	// safe mode.
 	static bool safe_mode;
 
+	// File to dump debug information, as set by the user
+	static std::string debug_file;
+
+	// Debugger for memory spaces
+	static misc::Debug debug;
+
 	/// Hash table of memory pages, indexed by the page tag.
 	std::unordered_map<unsigned, std::unique_ptr<Page>> pages;
 
+	// Entry of the software TLB
+	struct TlbEntry
+	{
+		// Page tag, or an unaligned value for an invalid entry
+		unsigned tag = TlbInvalidTag;
+
+		// Page associated with the tag
+		Page *page = nullptr;
+	};
+
+	// Tag of an invalid TLB entry, never matching a page-aligned address
+	static const unsigned TlbInvalidTag = 1;
+
+	// Number of entries in the software TLB, must be a power of 2
+	static const int TlbSize = 64;
+
+	/// Direct-mapped software TLB caching the most recent page lookups,
+	/// which avoids a hash table lookup in the common case. Only mapped
+	/// pages are cached, and permissions and data are read from the page
+	/// itself, so entries only need to be invalidated when pages are
+	/// deallocated.
+	TlbEntry tlb[TlbSize];
+
+	// Number of page lookups served by the TLB
+	long long num_tlb_hits = 0;
+
+	// Number of page lookups that missed in the TLB
+	long long num_tlb_misses = 0;
+
+	// Number of pages whose data was shared with another memory object
+	// when cloning it
+	long long num_shared_pages = 0;
+
+	// Number of shared pages copied upon the first write
+	long long num_copied_pages = 0;
+
+	// Number of pages mapped from host files with MapFile()
+	long long num_file_pages = 0;
+
+	// Make page data private before a write, counting copies
+	void UnshareData(Page *page)
+	{
+		if (page->UnshareData())
+			num_copied_pages++;
+	}
+
+	// Create pages with the same permissions as in \a memory, sharing
+	// their data with copy-on-write.
+	void ClonePages(const Memory &memory);
+
+	// Return the TLB entry where a page tag is mapped
+	TlbEntry &getTlbEntry(unsigned tag)
+	{
+		return tlb[(tag >> LogPageSize) & (TlbSize - 1)];
+	}
+
+	// Invalidate all TLB entries
+	void FlushTlb()
+	{
+		for (TlbEntry &entry : tlb)
+			entry.tag = TlbInvalidTag;
+	}
+
+	// Look up a page in the page table on a TLB miss, and insert it in
+	// the TLB if found.
+	Page *getPageFromTable(unsigned address);
+
 	/// Safe mode
 	bool safe;
 
@@ -140,6 +318,21 @@ private:
 	/// Last accessed address
 	unsigned last_address = 0;
 
+	/// Version of the code contained in memory, incremented every time
+	/// that a page marked with AddCode() is modified, unmapped, or changes
+	/// its permissions.
+	long long code_version = 0;
+
+	/// Increment the code version if the page was marked with AddCode()
+	void InvalidateCode(Page *page)
+	{
+		if (page->isCode())
+		{
+			page->setCode(false);
+			code_version++;
+		}
+	}
+
 	/// Create a new page and add it to the page table. The value given in
 	/// \a perm is an *or*'ed bitmap of AccessType flags.
 	Page *newPage(unsigned address, unsigned perm);
@@ -156,6 +349,15 @@ public:
 	/// Copy constructor
 	Memory(const Memory &memory);
 
+	/// Destructor
+	~Memory();
+
+	/// Register command-line options
+	static void RegisterOptions();
+
+	/// Process command-line options
+	static void ProcessOptions();
+
 	/// Set the safe mode. A memory in safe mode will crash with a fatal
 	/// error message when a memory address is accessed that was not
 	/// allocated before witn a call to Map(). In unsafe mode, all memory
@@ -169,11 +371,32 @@ public:
 	bool getSafe() const { return safe; }
 
 	/// Clear content of memory
-	void Clear() { pages.clear(); }
+	void Clear()
+	{
+		FlushTlb();
+		pages.clear();
+		code_version++;
+	}
 
 	/// Return the memory page corresponding to an address, or `nullptr` if
 	/// there is currently no page allocated for that address.
-	Page *getPage(unsigned address);
+	Page *getPage(unsigned address)
+	{
+		unsigned tag = address & PageMask;
+		TlbEntry &entry = getTlbEntry(tag);
+		if (entry.tag == tag)
+		{
+			num_tlb_hits++;
+			return entry.page;
+		}
+		return getPageFromTable(address);
+	}
+
+	/// Return the number of page lookups served by the software TLB
+	long long getNumTlbHits() const { return num_tlb_hits; }
+
+	/// Return the number of page lookups that missed in the software TLB
+	long long getNumTlbMisses() const { return num_tlb_misses; }
 
 	/// Return the memory page following \a address in the current memory
 	/// map. This function is useful to reconstruct consecutive ranges of
@@ -199,6 +422,37 @@ public:
 	///	Number of bytes, multiple of page size.
 	void Unmap(unsigned address, unsigned size);
 
+	/// Back mapped pages with the content of a host file, without reading
+	/// it. The file region is mapped read-only in the host, and guest pages
+	/// point into it until they are first written, when they get a private
+	/// copy. Pages past the end of the file are left untouched.
+	///
+	/// Files opened for writing are not mapped, since the guest could
+	/// truncate them. A file can still be truncated by another host
+	/// process while mapped, in which case accessing the pages past the
+	/// new end of the file terminates the simulator with SIGBUS.
+	///
+	/// \param address
+	///	Address aligned to page boundary. All pages in the range must
+	///	have been allocated with Map() before.
+	///
+	/// \param size
+	///	Number of bytes, multiple of page size.
+	///
+	/// \param fd
+	///	Host file descriptor. It can be closed after the call.
+	///
+	/// \param offset
+	///	Offset in the file, aligned to page boundary.
+	///
+	/// \return
+	///	The function returns `false` if the host cannot map the file,
+	///	for example because it is not a regular file or it was opened
+	///	for writing, in which case no
+	///	page was modified and the caller should read the content into
+	///	memory instead.
+	bool MapFile(unsigned address, unsigned size, int fd, unsigned offset);
+
 	/// Allocate memory.
 	///
 	/// \param address
@@ -433,6 +687,18 @@ public:
 	///	A Memory::Error is thrown if file \a path cannot be accessed.
 	void Load(const std::string &path, unsigned start);
 
+	/// Write all pages, their permissions and content, and the heap break
+	/// into a checkpoint file. Pages are written in increasing address
+	/// order, so that the same memory state produces the same file.
+	void SaveCheckpoint(misc::Checkpoint &checkpoint) const;
+
+	/// Replace the content of the memory with the state saved in a
+	/// checkpoint file with SaveCheckpoint().
+	///
+	/// \throw
+	///	A misc::Error is thrown if the checkpoint file is not valid.
+	void LoadCheckpoint(misc::Checkpoint &checkpoint);
+
 	/// Set a new value for the heap break.
 	void setHeapBreak(unsigned heap_break) { this->heap_break = heap_break; }
 
@@ -447,9 +713,36 @@ public:
 	/// Get current heap break.
 	unsigned getHeapBreak() { return heap_break; }
 
-	/// Copy the content and attributes from another memory object
+	/// Copy the content and attributes from another memory object. Page
+	/// data is shared between both memory objects, and each page is only
+	/// copied when any of them writes to it for the first time.
 	void Clone(const Memory &memory);
 
+	/// Return the number of pages whose data was shared with other memory
+	/// objects by Clone() or the copy constructor
+	long long getNumSharedPages() const { return num_shared_pages; }
+
+	/// Return the number of pages shared by a clone operation that were
+	/// later copied upon a write to this memory object
+	long long getNumCopiedPages() const { return num_copied_pages; }
+
+	/// Mark the pages containing the \a size bytes starting at \a address
+	/// as holding instructions that an emulator has decoded and cached,
+	/// where \a size is not larger than the page size. Any later write,
+	/// unmap, or permission change on these pages will increment the code
+	/// version returned by getCodeVersion().
+	///
+	/// \return
+	///	The function returns `false` if any page in the range is not
+	///	mapped, in which case decoded instructions from the range
+	///	should not be cached.
+	bool AddCode(unsigned address, unsigned size);
+
+	/// Return the version of the code contained in memory. Decoded
+	/// instructions cached by an emulator are valid as long as the code
+	/// version does not change.
+	long long getCodeVersion() const { return code_version; }
+
 };
 
 
@@ -39,7 +39,7 @@ Mmu::Space::Space(const std::string &name, Mmu *mmu) :
 		mmu(mmu)
 {
 	// Debug
-	debug << misc::fmt("[MMU %s] Space %s created\n",
+	debug.fmt("[MMU %s] Space %s created\n",
 			mmu->getName().c_str(),
 			name.c_str());
 }
@@ -102,7 +102,7 @@ Mmu::Mmu(const std::string &name) :
 		name(name)
 {
 	// Debug
-	debug << misc::fmt("[MMU %s] Memory management unit created\n",
+	debug.fmt("[MMU %s] Memory management unit created\n",
 			name.c_str());
 }
 
@@ -142,7 +142,7 @@ unsigned Mmu::TranslateVirtualAddress(Space *space,
 
 		// Debug
 		if (debug)
-			debug << misc::fmt("[MMU %s] Page created. "
+			debug.fmt("[MMU %s] Page created. "
 					"Space %s, Virtual 0x%x => "
 					"Physical 0x%x\n", name.c_str(),
 					space->getName().c_str(),
@@ -155,7 +155,7 @@ unsigned Mmu::TranslateVirtualAddress(Space *space,
 
 	// Debug
 	if (debug)
-		debug << misc::fmt("[MMU %s] Space %s, Virtual 0x%x => "
+		debug.fmt("[MMU %s] Space %s, Virtual 0x%x => "
 				"Physical 0x%x\n", name.c_str(),
 				space->getName().c_str(),
 				virtual_address,
@@ -180,7 +180,7 @@ bool Mmu::TranslatePhysicalAddress(unsigned physical_address,
 	{
 		// Debug
 		if (debug)
-			debug << misc::fmt("[MMU %s] Physical 0x%x => "
+			debug.fmt("[MMU %s] Physical 0x%x => "
 					"Invalid page\n", name.c_str(),
 					physical_address);
 
@@ -197,7 +197,7 @@ bool Mmu::TranslatePhysicalAddress(unsigned physical_address,
 
 	// Debug
 	if (debug)
-		debug << misc::fmt("[MMU %s] Physical 0x%x => "
+		debug.fmt("[MMU %s] Physical 0x%x => "
 				"Space %s, Virtual 0x%x\n",
 				name.c_str(),
 				physical_address,
@@ -17,6 +17,10 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <dram/Address.h>
+#include <dram/Controller.h>
+#include <dram/Request.h>
+
 #include "Frame.h"
 #include "Module.h"
 #include "System.h"
@@ -135,6 +139,39 @@ Module *Module::getOwner(int set_id, int way_id, int sub_block_id) const
 }
 
 
+bool Module::isHeldAbove(int set_id, int way_id, int sub_block_id,
+		Module *except)
+{
+	// Address of the sub-block
+	assert(directory.get());
+	Directory::Entry *entry = directory->getEntry(set_id,
+			way_id,
+			sub_block_id);
+	unsigned address = cache->getBlock(set_id, way_id)->getTag() +
+			sub_block_id * sub_block_size;
+
+	// Look for a sharer or owner holding the sub-block
+	for (Module *module : high_modules)
+	{
+		if (module == except)
+			continue;
+		int index = getSharerIndex(module);
+		if (!directory->isSharer(set_id, way_id, sub_block_id, index) &&
+				entry->getOwner() != index)
+			continue;
+		int set;
+		int way;
+		int tag;
+		Cache::BlockState state;
+		if (module->FindBlock(address, set, way, tag, state))
+			return true;
+	}
+
+	// Not held
+	return false;
+}
+
+
 bool Module::canAccess(int address) const
 {
 	// There must be a free port
@@ -161,7 +198,7 @@ long long Module::Access(AccessType access_type,
 		unsigned instr_addr) ///added instr_addr to pass through frame
 {
 	// Create a new event frame
-	auto frame = misc::new_shared<Frame>(
+	auto frame = esim::new_frame<Frame>(
 			Frame::getNewId(),
 			this,
 			address);
@@ -416,6 +453,9 @@ void Module::Dump(std::ostream &os) const
 	// Dump the module information
 	os << misc::fmt("BlockSize = %d\n", block_size);
 	os << misc::fmt("DataLatency = %d\n", data_latency);
+	if (dram_controller)
+		os << misc::fmt("DRAM = %s\n",
+				dram_controller->getName().c_str());
 	os << misc::fmt("Ports = %d\n", num_ports);
 	os << "\n";
 
@@ -638,7 +678,7 @@ Frame *Module::canCoalesce(AccessType access_type,
 void Module::Coalesce(Frame *master_frame, Frame *frame)
 {
 	// Debug
-	System::debug << misc::fmt("    "
+	System::debug.fmt("    "
 			"A-%lld is coalesced with A-%lld "
 			"on %s for 0x%x\n",
 			frame->getId(),
@@ -698,7 +738,7 @@ void Module::LockPort(Frame *frame, esim::Event *event)
 
 	// Debug
 	esim::Engine *esim_engine = esim::Engine::getInstance();
-	System::debug << misc::fmt("    "
+	System::debug.fmt("    "
 			"A-%lld locks port %d on %s\n",
 			frame->getId(),
 			port_index,
@@ -723,7 +763,7 @@ void Module::UnlockPort(Port *port, Frame *frame)
 	num_locked_ports--;
 
 	// Debug
-	System::debug << misc::fmt("    "
+	System::debug.fmt("    "
 			"A-%lld unlocks port on %s\n",
 			frame->getId(),
 			name.c_str());
@@ -742,7 +782,7 @@ void Module::UnlockPort(Port *port, Frame *frame)
 	port_queue.WakeupOne();
 	
 	// Debug
-	System::debug << misc::fmt("    "
+	System::debug.fmt("    "
 			"A-%lld locks port on %s\n",
 			frame->getId(),
 			name.c_str());
@@ -774,23 +814,32 @@ bool Module::FindBlock(unsigned address,
 		throw misc::Panic("Invalid range type");
 	}
 
-	// Find way in set
-	for (way = 0; way < (int) cache->getNumWays(); way++)
+	// Permanent tag available with state other than invalid
+	unsigned num_ways = cache->getNumWays();
+	unsigned hit_way = cache->FindWay(set, tag);
+
+	// Transient tag available while directory entry is locked. This is
+	// considered a hit, regardless of the state of the block. The first
+	// matching way is the hit, so only ways before a permanent tag hit
+	// are checked.
+	for (unsigned transient_way = cache->FindTransientWay(set, tag);
+			transient_way < hit_way;
+			transient_way = cache->FindTransientWay(set, tag,
+					transient_way + 1))
 	{
-		// Get block
-		Cache::Block *block = cache->getBlock(set, way);
-		state = block->getState();
-
-		// Permanent tag available with state other than invalid
-		if (block->getTag() == (unsigned) tag && state)
-			return true;
+		if (directory->isEntryLocked(set, transient_way))
+		{
+			hit_way = transient_way;
+			break;
+		}
+	}
 
-		// Transient tag available while directory entry is locked.
-		// This is considered a hit, regardless of the state of the
-		// block.
-		if (block->getTransientTag() == (unsigned) tag &&
-				directory->isEntryLocked(set, way))
-			return true;
+	// Hit
+	if (hit_way < num_ways)
+	{
+		way = hit_way;
+		state = cache->getBlock(set, way)->getState();
+		return true;
 	}
 
 	// Miss
@@ -800,13 +849,200 @@ bool Module::FindBlock(unsigned address,
 }
 
 
+bool Module::Warm(unsigned address, bool write)
+{
+	// Local memories are not part of the coherent hierarchy
+	if (type == TypeLocalMemory)
+		return false;
+
+	// Blocks with in-flight accesses are left to the timing model
+	if (isInFlightAddress(address))
+		return false;
+
+	// On a hit, only update the replacement policy, and silently upgrade
+	// an exclusive block on a write.
+	int set;
+	int way;
+	int tag;
+	Cache::BlockState state;
+	if (FindBlock(address, set, way, tag, state))
+	{
+		if (directory->isEntryLocked(set, way))
+			return false;
+		cache->AccessBlock(set, way);
+		if (write && state == Cache::BlockExclusive)
+			cache->setBlock(set, way, tag, Cache::BlockModified);
+		return true;
+	}
+
+	// Bring the block into the lower level first, keeping the hierarchy
+	// inclusive. Main memory has no lower level.
+	Module *low_module = type == TypeMainMemory ? nullptr :
+			getLowModuleServingAddress(address);
+	int low_set = 0;
+	int low_way = 0;
+	int low_tag = 0;
+	bool shared = false;
+	if (low_module)
+	{
+		// Warm lower level
+		if (!low_module->Warm(address, false))
+			return false;
+		Cache::BlockState low_state;
+		bool hit = low_module->FindBlock(address, low_set, low_way,
+				low_tag, low_state);
+		assert(hit);
+		(void) hit;
+
+		// Blocks owned by other modules, or shared on a write, would
+		// need invalidations. These are left to the timing model.
+		// Sharers no longer holding the block are ignored.
+		Directory *low_directory = low_module->getDirectory();
+		int index = low_module->getSharerIndex(this);
+		for (int z = 0; z < low_directory->getNumSubBlocks(); z++)
+		{
+			unsigned directory_entry_tag = low_tag + z *
+					low_module->getSubBlockSize();
+			if (directory_entry_tag < (unsigned) tag ||
+					directory_entry_tag >= (unsigned) tag +
+					block_size)
+				continue;
+			if (!low_module->isHeldAbove(low_set, low_way, z, this))
+				continue;
+			Directory::Entry *entry = low_directory->getEntry(
+					low_set, low_way, z);
+			if (entry->getOwner() != Directory::NoOwner &&
+					entry->getOwner() != index)
+				return false;
+			shared = true;
+		}
+		if (shared && write)
+			return false;
+	}
+
+	// Choose victim. Victims held in upper levels would need
+	// invalidations as well, so if the replacement policy picks one of
+	// them, fall back to any other way that can be evicted silently.
+	// Upper levels do not update the replacement state of this level on
+	// their hits, so the victim chosen is often still held above.
+	auto is_evictable = [this, set](int way)
+	{
+		if (directory->isEntryLocked(set, way))
+			return false;
+		for (int z = 0; z < directory->getNumSubBlocks(); z++)
+			if (isHeldAbove(set, way, z, nullptr))
+				return false;
+		return true;
+	};
+	way = cache->ReplaceBlock(set);
+	if (!is_evictable(way))
+	{
+		unsigned num_ways = cache->getNumWays();
+		unsigned w;
+		for (w = 0; w < num_ways; w++)
+			if (is_evictable(w))
+				break;
+		if (w == num_ways)
+			return false;
+		way = w;
+	}
+
+	// Drop stale sharers of the victim
+	for (int z = 0; z < directory->getNumSubBlocks(); z++)
+	{
+		directory->clearAllSharers(set, way, z);
+		directory->setOwner(set, way, z, Directory::NoOwner);
+	}
+
+	// Evict victim silently, removing this module from the directory of
+	// the lower level, and passing the dirty state down.
+	Cache::Block *victim = cache->getBlock(set, way);
+	if (victim->getState() && low_module)
+	{
+		int victim_set;
+		int victim_way;
+		int victim_tag;
+		Cache::BlockState victim_state;
+		Module *victim_module = getLowModuleServingAddress(
+				victim->getTag());
+		if (victim_module->FindBlock(victim->getTag(), victim_set,
+				victim_way, victim_tag, victim_state))
+		{
+			// Skip if the lower level is busy with the block
+			Directory *victim_directory = victim_module->getDirectory();
+			if (victim_directory->isEntryLocked(victim_set, victim_way))
+				return false;
+
+			// Update directory
+			int index = victim_module->getSharerIndex(this);
+			for (int z = 0; z < victim_directory->getNumSubBlocks(); z++)
+			{
+				unsigned directory_entry_tag = victim_tag + z *
+						victim_module->getSubBlockSize();
+				if (directory_entry_tag < victim->getTag() ||
+						directory_entry_tag >=
+						victim->getTag() + block_size)
+					continue;
+				victim_directory->clearSharer(victim_set,
+						victim_way, z, index);
+				Directory::Entry *entry = victim_directory->getEntry(
+						victim_set, victim_way, z);
+				if (entry->getOwner() == index)
+					victim_directory->setOwner(victim_set,
+							victim_way, z,
+							Directory::NoOwner);
+			}
+
+			// Dirty data
+			if (victim->getState() == Cache::BlockModified ||
+					victim->getState() == Cache::BlockOwned)
+				victim_module->getCache()->setBlock(victim_set,
+						victim_way, victim_tag,
+						Cache::BlockModified);
+		}
+	}
+
+	// Insert block. Main memory always holds blocks in exclusive state.
+	if (!low_module)
+		state = Cache::BlockExclusive;
+	else if (shared)
+		state = Cache::BlockShared;
+	else
+		state = write ? Cache::BlockModified : Cache::BlockExclusive;
+	cache->setBlock(set, way, tag, state);
+	cache->AccessBlock(set, way);
+
+	// Record this module as sharer in the lower level, and as owner if
+	// no other module shares the block.
+	if (low_module)
+	{
+		Directory *low_directory = low_module->getDirectory();
+		for (int z = 0; z < low_directory->getNumSubBlocks(); z++)
+		{
+			unsigned directory_entry_tag = low_tag + z *
+					low_module->getSubBlockSize();
+			if (directory_entry_tag < (unsigned) tag ||
+					directory_entry_tag >= (unsigned) tag +
+					block_size)
+				continue;
+			low_module->setSharer(low_set, low_way, z, this);
+			if (!shared)
+				low_module->setOwner(low_set, low_way, z, this);
+		}
+	}
+
+	// Block present
+	return true;
+}
+
+
 void Module::Flush(int *witness)
 {
 	// Get pointer to esim engine
 	esim::Engine *esim_engine = esim::Engine::getInstance();
 
 	// Create a new event frame
-	auto new_frame = misc::new_shared<Frame>(
+	auto new_frame = esim::new_frame<Frame>(
 			Frame::getNewId(),
 			this,
 			0);
@@ -859,7 +1095,7 @@ void Module::FlushCache()
 			esim::Engine *esim_engine = esim::Engine::getInstance();
 
 			// Create new frame
-			auto new_frame = misc::new_shared<Frame>(
+			auto new_frame = esim::new_frame<Frame>(
 					frame->getId(),
 					this,
 					frame->tag);
@@ -984,6 +1220,29 @@ void Module::UpdateStats(Frame *frame)
 }
 
 
+void Module::AccessData(esim::Event *event, unsigned address, bool write)
+{
+	// Fixed data latency
+	if (!dram_controller)
+	{
+		esim::Engine *esim_engine = esim::Engine::getInstance();
+		esim_engine->Next(event, data_latency);
+		return;
+	}
+
+	// Create a DRAM request for the whole block. The physical address is
+	// mapped into channel, rank, bank, row, and column by the DRAM model.
+	auto request = std::make_shared<dram::Request>();
+	request->setType(write ? dram::RequestWrite : dram::RequestRead);
+	request->setEncodedAddress(address & ~(block_size - 1));
+	request->setSize(block_size);
+
+	// Suspend the event chain until the controller completes the request
+	request->Wait(event);
+	dram_controller->AddRequest(request);
+}
+
+
 int Module::getRetryLatency() const
 {
 	// To support a data latency of zero, we must ensure that at least
@@ -35,6 +35,7 @@
 
 
 // Forward declarations
+namespace dram { class Controller; }
 namespace net { class Network; }
 namespace net { class Node; }
 
@@ -209,6 +210,16 @@ private:
 	net::EndNode *low_network_node = nullptr;
 
 
+
+	//
+	// DRAM
+	//
+
+	// DRAM memory controller serving the data accesses of a main memory
+	// module, or nullptr if accesses take a fixed data latency
+	dram::Controller *dram_controller = nullptr;
+
+
 	
 	//
 	// In-flight accesses
@@ -422,6 +433,26 @@ public:
 	/// Return data access latency
 	int getDataLatency() const { return data_latency; }
 
+	/// Set the DRAM memory controller serving the data accesses of a main
+	/// memory module, replacing its fixed data latency.
+	void setDramController(dram::Controller *dram_controller)
+	{
+		assert(type == TypeMainMemory);
+		this->dram_controller = dram_controller;
+	}
+
+	/// Return the DRAM memory controller associated with the module, or
+	/// `nullptr` if the module has a fixed data latency.
+	dram::Controller *getDramController() const { return dram_controller; }
+
+	/// Access the data of the block at \a address and continue the current
+	/// event chain with \a event once the access completes. If the module
+	/// is backed by a DRAM memory controller, the event chain is suspended
+	/// until the DRAM request completes. Otherwise, \a event is scheduled
+	/// after the fixed data latency. This function should only be invoked
+	/// in the body of an event handler.
+	void AccessData(esim::Event *event, unsigned address, bool write);
+
 	/// Set the high network and high network node that the module is
 	/// connected to.
 	void setHighNetwork(net::Network *high_network,
@@ -623,7 +654,15 @@ public:
 				sub_block_id);
 		return entry->getNumSharers();
 	}
-	
+
+	/// Return whether any higher-level module other than \a except,
+	/// listed as a sharer or owner of the given directory entry, still
+	/// holds the sub-block. Higher-level caches evict shared and exclusive
+	/// blocks silently, so the directory may list stale sharers. Argument
+	/// \a except can be `nullptr`.
+	bool isHeldAbove(int set_id, int way_id, int sub_block_id,
+			Module *except);
+
 	/// Access the module.
 	///
 	/// \param access_type
@@ -746,6 +785,24 @@ public:
 			int &tag,
 			Cache::BlockState &state);
 
+	/// Bring the block containing \a address into the module and all its
+	/// lower levels, updating tags, states, directories, and replacement
+	/// information as a completed access would, but without modeling
+	/// latencies or generating network traffic. This is used to warm up
+	/// caches during functional simulation. Accesses that would require
+	/// invalidations in other modules are skipped.
+	///
+	/// \param address
+	///	Physical address.
+	///
+	/// \param write
+	///	True if the block is written.
+	///
+	/// \return
+	///	True if the block is present in the module after the call.
+	///
+	bool Warm(unsigned address, bool write);
+
 	/// Flush the module.
 	///
 	/// \param witness
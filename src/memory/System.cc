@@ -19,6 +19,7 @@
 
 #include <fstream>
 
+#include <dram/System.h>
 #include <lib/cpp/CommandLine.h>
 #include <lib/cpp/Misc.h>
 #include <lib/esim/Engine.h>
@@ -386,11 +387,28 @@ void System::Dump(std::ostream &os) const
 			"Reads/writes coming from lower-level cache\n";
 	os << ";    NonBlockingReads, NonBlockingWrites, NonBlockingNCWrites -"
 			" Coming from upper-level cache\n";
+	os << ";    BytesRead, BytesWritten, Bandwidth - For DRAM channels, "
+			"data transferred and average bandwidth\n";
+	os << ";    RowHits, RowMisses, RowConflicts - For DRAM channels, "
+			"requests finding their row open, their bank precharged, "
+			"or another row open\n";
+	os << ";    Frames - Event frames allocated for memory accesses, "
+			"recycled from previous accesses, live at the end of "
+			"the simulation, and maximum live at a time\n";
 	os << "\n\n";
 	
 	// Dump report for each module
 	for (auto &module : modules)
 		module->Dump(os);
+
+	// Per-channel statistics of the DRAM memory controllers
+	if (dram::System::hasInstance())
+		dram::System::getInstance()->DumpReport(os);
+
+	// Event frame allocation
+	os << "[ Frames ]\n\n";
+	esim::FramePool::getInstance<Frame>()->Dump(os, "");
+	os << "\n\n";
 }
 
 }  // namespace mem
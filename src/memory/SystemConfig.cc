@@ -19,6 +19,8 @@
 
 #include <arch/common/Arch.h>
 #include <arch/common/Timing.h>
+#include <dram/Controller.h>
+#include <dram/System.h>
 #include <lib/esim/Engine.h>
 #include <network/EndNode.h>
 #include <network/Node.h>
@@ -112,6 +114,12 @@ const std::string System::help_message =
 	"      Number of read/write ports. This variable is only allowed for a main\n"
 	"      memory module. The number of ports for a cache is specified in a\n"
 	"      separate cache geometry section.\n"
+	"  DRAM = <controller>\n"
+	"      Memory controller defined in a [MemoryController <controller>] section\n"
+	"      of the DRAM configuration file (option '--dram-config'). Block reads\n"
+	"      and write-backs are served by the DRAM model, replacing the fixed\n"
+	"      'Latency' of the module. This variable is only allowed for a main\n"
+	"      memory module.\n"
 	"  DirectorySize <size>\n"
 	"      Size of the directory in number of blocks. The size of a directory\n"
 	"      limits the number of different blocks that can reside in upper-level\n"
@@ -705,6 +713,26 @@ Module *System::ConfigReadMainMemory(misc::IniFile *ini_file,
 			directory_num_ways,
 			directory_latency);
 
+	// DRAM memory controller
+	std::string dram_name = ini_file->ReadString(section, "DRAM");
+	if (!dram_name.empty())
+	{
+		dram::System *dram_system = dram::System::getInstance();
+		dram::Controller *dram_controller =
+				dram_system->getController(dram_name);
+		if (!dram_controller)
+			throw Error(misc::fmt("%s: %s: invalid DRAM memory "
+					"controller '%s'. Memory controllers "
+					"are defined in the DRAM configuration "
+					"file passed with option "
+					"'--dram-config'.\n%s",
+					ini_file->getPath().c_str(),
+					module_name.c_str(),
+					dram_name.c_str(),
+					err_config_note));
+		module->setDramController(dram_controller);
+	}
+
 	// High network
 	std::string network_name = ini_file->ReadString(section, "HighNetwork");
 	std::string network_node_name = ini_file->ReadString(section, "HighNetworkNode");
@@ -1310,7 +1338,7 @@ void System::ConfigCalculateSubBlockSizes()
 				module->getNumSubBlocks(),
 				num_nodes);
 		Directory *directory = module->getDirectory();
-		debug << misc::fmt("\t%s - %dx%dx%d (%dx%dx%d effective) - "
+		debug.fmt("\t%s - %dx%dx%d (%dx%dx%d effective) - "
 				"%d entries, %d sub-blocks\n",
 				module->getName().c_str(),
 				directory->getNumSets(),
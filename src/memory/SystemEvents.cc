@@ -122,12 +122,12 @@ void System::EventLoadHandler(esim::Event *event, esim::Frame *esim_frame)
 	// Event "load"
 	if (event == event_load)
 	{
-		debug << misc::fmt("%lld A-%lld 0x%x %s load\n",
+		debug.fmt("%lld A-%lld 0x%x %s load\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.new_access "
+		trace.fmt("mem.new_access "
 				"name=\"A-%lld\" "
 				"type=\"load\" "
 				"state=\"%s:load\" "
@@ -160,12 +160,12 @@ void System::EventLoadHandler(esim::Event *event, esim::Frame *esim_frame)
 	// Event "load_lock"
 	if (event == event_load_lock)
 	{
-		debug << misc::fmt("  %lld A-%lld 0x%x %s load lock\n",
+		debug.fmt("  %lld A-%lld 0x%x %s load lock\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:load_lock\"\n",
 				frame->getId(),
@@ -175,7 +175,7 @@ void System::EventLoadHandler(esim::Event *event, esim::Frame *esim_frame)
 		Frame *older_frame = module->getInFlightWrite(frame);
 		if (older_frame)
 		{
-			debug << misc::fmt("    A-%lld wait for store A-%lld\n",
+			debug.fmt("    A-%lld wait for store A-%lld\n",
 					frame->getId(),
 					older_frame->getId());
 			older_frame->queue.Wait(event_load_lock);
@@ -189,7 +189,7 @@ void System::EventLoadHandler(esim::Event *event, esim::Frame *esim_frame)
 				frame);
 		if (older_frame)
 		{
-			debug << misc::fmt("    A-%lld wait for access A-%lld\n",
+			debug.fmt("    A-%lld wait for access A-%lld\n",
 					frame->getId(),
 					older_frame->getId());
 			older_frame->queue.Wait(event_load_lock);
@@ -197,7 +197,7 @@ void System::EventLoadHandler(esim::Event *event, esim::Frame *esim_frame)
 		}
 
 		// Call "find_and_lock" event chain
-		auto new_frame = misc::new_shared<Frame>(
+		auto new_frame = esim::new_frame<Frame>(
 				frame->getId(),
 				module,
 				frame->getAddress());
@@ -216,12 +216,12 @@ void System::EventLoadHandler(esim::Event *event, esim::Frame *esim_frame)
 	if (event == event_load_action)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s load_action\n",
+		debug.fmt("  %lld A-%lld 0x%x %s load_action\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.access name=\"A-%lld\" "
+		trace.fmt("mem.access name=\"A-%lld\" "
 				"state=\"%s:load_action\"\n",
 				frame->getId(),
 				module->getName().c_str());
@@ -233,7 +233,7 @@ void System::EventLoadHandler(esim::Event *event, esim::Frame *esim_frame)
 			int retry_latency = module->getRetryLatency();
 
 			// Debug
-			debug << misc::fmt("    lock error, retrying in "
+			debug.fmt("    lock error, retrying in "
 					"%d cycles\n",
 					retry_latency);
 
@@ -252,7 +252,7 @@ void System::EventLoadHandler(esim::Event *event, esim::Frame *esim_frame)
 		}
 
 		// Miss
-		auto new_frame = misc::new_shared<Frame>(
+		auto new_frame = esim::new_frame<Frame>(
 				frame->getId(),
 				module,
 				frame->tag);
@@ -271,12 +271,12 @@ void System::EventLoadHandler(esim::Event *event, esim::Frame *esim_frame)
 	if (event == event_load_miss)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s load_miss\n",
+		debug.fmt("  %lld A-%lld 0x%x %s load_miss\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:load_miss\"\n",
 				frame->getId(),
@@ -294,7 +294,7 @@ void System::EventLoadHandler(esim::Event *event, esim::Frame *esim_frame)
 			int retry_latency = module->getRetryLatency();
 
 			// Debug
-			debug << misc::fmt("    lock error, retrying "
+			debug.fmt("    lock error, retrying "
 					"in %d cycles\n", retry_latency);
 
 			// Continue with 'load-lock' after retry latency
@@ -320,13 +320,13 @@ void System::EventLoadHandler(esim::Event *event, esim::Frame *esim_frame)
 	if (event == event_load_unlock)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"load unlock\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:load_unlock\"\n",
 				frame->getId(),
@@ -351,17 +351,17 @@ void System::EventLoadHandler(esim::Event *event, esim::Frame *esim_frame)
 	if (event == event_load_finish)
 	{
 		// Debug and trace
-		debug << misc::fmt("%lld A-%lld 0x%x %s load_finish\n",
+		debug.fmt("%lld A-%lld 0x%x %s load_finish\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:load_finish\"\n",
 				frame->getId(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.end_access "
+		trace.fmt("mem.end_access "
 				"name=\"A-%lld\"\n",
 				frame->getId());
 
@@ -394,12 +394,12 @@ void System::EventStoreHandler(esim::Event *event,
 	if (event == event_store)
 	{
 		// Debug and trace
-		debug << misc::fmt("%lld A-%lld 0x%x %s store\n",
+		debug.fmt("%lld A-%lld 0x%x %s store\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.new_access "
+		trace.fmt("mem.new_access "
 				"name=\"A-%lld\" "
 				"type=\"store\" "
 				"state=\"%s:store\" addr=0x%x\n",
@@ -439,12 +439,12 @@ void System::EventStoreHandler(esim::Event *event,
 	if (event == event_store_lock)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s store_lock\n",
+		debug.fmt("  %lld A-%lld 0x%x %s store_lock\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:store_lock\"\n",
 				frame->getId(),
@@ -460,7 +460,7 @@ void System::EventStoreHandler(esim::Event *event,
 			Frame *older_frame = *it;
 
 			// Debug
-			debug << misc::fmt("    A-%lld wait for access A-%lld\n",
+			debug.fmt("    A-%lld wait for access A-%lld\n",
 					frame->getId(),
 					older_frame->getId());
 
@@ -470,7 +470,7 @@ void System::EventStoreHandler(esim::Event *event,
 		}
 
 		// Call 'find-and-lock'
-		auto new_frame = misc::new_shared<Frame>(
+		auto new_frame = esim::new_frame<Frame>(
 				frame->getId(),
 				module,
 				frame->getAddress());
@@ -489,12 +489,12 @@ void System::EventStoreHandler(esim::Event *event,
 	if (event == event_store_action)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s store_action\n",
+		debug.fmt("  %lld A-%lld 0x%x %s store_action\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:store_action\"\n",
 				frame->getId(),
@@ -507,7 +507,7 @@ void System::EventStoreHandler(esim::Event *event,
 			int retry_latency = module->getRetryLatency();
 
 			// Debug
-			debug << misc::fmt("    lock error, retrying in "
+			debug.fmt("    lock error, retrying in "
 					"%d cycles\n",
 					retry_latency);
 
@@ -528,7 +528,7 @@ void System::EventStoreHandler(esim::Event *event,
 
 		// Miss - state=O/S/I/N
 		// Call 'write-request'
-		auto new_frame = misc::new_shared<Frame>(
+		auto new_frame = esim::new_frame<Frame>(
 				frame->getId(),
 				module,
 				frame->tag);
@@ -545,12 +545,12 @@ void System::EventStoreHandler(esim::Event *event,
 	if (event == event_store_unlock)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s store_unlock\n",
+		debug.fmt("  %lld A-%lld 0x%x %s store_unlock\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:store_unlock\"\n",
 				frame->getId(),
@@ -563,7 +563,7 @@ void System::EventStoreHandler(esim::Event *event,
 			int retry_latency = module->getRetryLatency();
 
 			// Debug
-			debug << misc::fmt("    lock error, retrying in "
+			debug.fmt("    lock error, retrying in "
 					"%d cycles\n", retry_latency);
 
 			// Unlock directory entry
@@ -597,17 +597,17 @@ void System::EventStoreHandler(esim::Event *event,
 	if (event == event_store_finish)
 	{
 		// Debug and trace
-		debug << misc::fmt("%lld A-%lld 0x%x %s store_finish\n",
+		debug.fmt("%lld A-%lld 0x%x %s store_finish\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:store_finish\"\n",
 				frame->getId(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.end_access "
+		trace.fmt("mem.end_access "
 				"name=\"A-%lld\"\n",
 				frame->getId());
 
@@ -638,12 +638,12 @@ void System::EventNCStoreHandler(esim::Event *event,
 	if (event == event_nc_store)
 	{
 		// Debug and trace
-		debug << misc::fmt("%lld A-%lld 0x%x %s nc_store\n",
+		debug.fmt("%lld A-%lld 0x%x %s nc_store\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.new_access "
+		trace.fmt("mem.new_access "
 				"name=\"A-%lld\" "
 				"type=\"nc_store\" "
 				"state=\"%s:nc store\" "
@@ -677,12 +677,12 @@ void System::EventNCStoreHandler(esim::Event *event,
 	if (event == event_nc_store_lock)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s nc_store_lock\n",
+		debug.fmt("  %lld A-%lld 0x%x %s nc_store_lock\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:nc_store_lock\"\n",
 				frame->getId(),
@@ -693,7 +693,7 @@ void System::EventNCStoreHandler(esim::Event *event,
 		if (older_frame)
 		{
 			// Debug
-			debug << misc::fmt("    A-%lld wait for store A-%lld\n",
+			debug.fmt("    A-%lld wait for store A-%lld\n",
 					frame->getId(),
 					older_frame->getId());
 
@@ -709,7 +709,7 @@ void System::EventNCStoreHandler(esim::Event *event,
 		if (older_frame)
 		{
 			// Debug
-			debug << misc::fmt("    A-%lld wait for access A-%lld\n",
+			debug.fmt("    A-%lld wait for access A-%lld\n",
 					frame->getId(),
 					older_frame->getId());
 
@@ -719,7 +719,7 @@ void System::EventNCStoreHandler(esim::Event *event,
 		}
 
 		// Call find and lock
-		auto new_frame = misc::new_shared<Frame>(
+		auto new_frame = esim::new_frame<Frame>(
 				frame->getId(),
 				module,
 				frame->getAddress());
@@ -737,12 +737,12 @@ void System::EventNCStoreHandler(esim::Event *event,
 	if (event == event_nc_store_writeback)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s nc_store_writeback\n",
+		debug.fmt("  %lld A-%lld 0x%x %s nc_store_writeback\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:nc_store_writeback\"\n",
 				frame->getId(),
@@ -755,7 +755,7 @@ void System::EventNCStoreHandler(esim::Event *event,
 			int retry_latency = module->getRetryLatency();
 
 			// Debug
-			debug << misc::fmt("    lock error, retrying in "
+			debug.fmt("    lock error, retrying in "
 					"%d cycles\n", retry_latency);
 
 			// Retry access after latency
@@ -773,7 +773,7 @@ void System::EventNCStoreHandler(esim::Event *event,
 			frame->eviction = true;
 
 			// Call 'evict'
-			auto new_frame = misc::new_shared<Frame>(
+			auto new_frame = esim::new_frame<Frame>(
 					frame->getId(),
 					module,
 					0);
@@ -794,12 +794,12 @@ void System::EventNCStoreHandler(esim::Event *event,
 	if (event == event_nc_store_action)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s nc_store_action\n",
+		debug.fmt("  %lld A-%lld 0x%x %s nc_store_action\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:nc_store_action\"\n",
 				frame->getId(),
@@ -812,7 +812,7 @@ void System::EventNCStoreHandler(esim::Event *event,
 			int retry_latency = module->getRetryLatency();
 
 			// Debug
-			debug << misc::fmt("    lock error, retrying in "
+			debug.fmt("    lock error, retrying in "
 					"%d cycles\n", retry_latency);
 
 			// Retry after latency
@@ -849,7 +849,7 @@ void System::EventNCStoreHandler(esim::Event *event,
 		{
 			// E state must tell the lower-level module to remove
 			// this module as an owner. Call 'message'.
-			auto new_frame = misc::new_shared<Frame>(
+			auto new_frame = esim::new_frame<Frame>(
 					frame->getId(),
 					module,
 					frame->tag);
@@ -869,7 +869,7 @@ void System::EventNCStoreHandler(esim::Event *event,
 			// because we've already evicted the block so that the
 			// lower-level cache will have the latest value before
 			// it becomes non-coherent. Call 'read-request'.
-			auto new_frame = misc::new_shared<Frame>(
+			auto new_frame = esim::new_frame<Frame>(
 					frame->getId(),
 					module,
 					frame->tag);
@@ -895,12 +895,12 @@ void System::EventNCStoreHandler(esim::Event *event,
 	if (event == event_nc_store_miss)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s nc_store_miss\n",
+		debug.fmt("  %lld A-%lld 0x%x %s nc_store_miss\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:nc_store_miss\"\n",
 				frame->getId(),
@@ -918,7 +918,7 @@ void System::EventNCStoreHandler(esim::Event *event,
 					frame->getId());
 
 			// Debug
-			debug << misc::fmt("    lock error, retrying in "
+			debug.fmt("    lock error, retrying in "
 					"%d cycles\n", retry_latency);
 
 
@@ -937,12 +937,12 @@ void System::EventNCStoreHandler(esim::Event *event,
 	if (event == event_nc_store_unlock)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s nc_store_unlock\n",
+		debug.fmt("  %lld A-%lld 0x%x %s nc_store_unlock\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:nc_store_unlock\"\n",
 				frame->getId(),
@@ -971,17 +971,17 @@ void System::EventNCStoreHandler(esim::Event *event,
 	if (event == event_nc_store_finish)
 	{
 		// Debug and trace
-		debug << misc::fmt("%lld A-%lld 0x%x %s nc_store_finish\n",
+		debug.fmt("%lld A-%lld 0x%x %s nc_store_finish\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:nc_store_finish\"\n",
 				frame->getId(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.end_access name=\"A-%lld\"\n",
+		trace.fmt("mem.end_access name=\"A-%lld\"\n",
 				frame->getId());
 
 		// Increment witness variable
@@ -1015,14 +1015,14 @@ void System::EventFindAndLockHandler(esim::Event *event,
 	// Event "find_and_lock"
 	if (event == event_find_and_lock)
 	{
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"find_and_lock (blocking=%d)\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str(),
 				frame->blocking);
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:find_and_lock\"\n",
 				frame->getId(),
@@ -1047,12 +1047,12 @@ void System::EventFindAndLockHandler(esim::Event *event,
 		assert(port);
 
 		// Debug
-		debug << misc::fmt("  %lld A-%lld 0x%x %s find_and_lock_port\n",
+		debug.fmt("  %lld A-%lld 0x%x %s find_and_lock_port\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:find_and_lock_port\"\n",
 				frame->getId(),
@@ -1076,15 +1076,16 @@ void System::EventFindAndLockHandler(esim::Event *event,
 				frame->state);
 		if (frame->hit)
 		{
-			debug << misc::fmt("    A-%lld 0x%x %s "
-					"hit: set=%d, way=%d, "
-					"state=%s\n",
-					frame->getId(),
-					frame->tag,
-					module->getName().c_str(),
-					frame->set,
-					frame->way,
-					Cache::BlockStateMap[frame->state]);
+			if (debug)
+				debug.fmt("    A-%lld 0x%x %s "
+						"hit: set=%d, way=%d, "
+						"state=%s\n",
+						frame->getId(),
+						frame->tag,
+						module->getName().c_str(),
+						frame->set,
+						frame->way,
+						Cache::BlockStateMap[frame->state]);
 		}
 
 		// If a store access hits in the cache, we can be sure
@@ -1105,7 +1106,7 @@ void System::EventFindAndLockHandler(esim::Event *event,
 			// for it.
 			if (frame->request_direction == Frame::RequestDirectionDownUp)
 			{
-				debug << misc::fmt("        A-%lld "
+				debug.fmt("        A-%lld "
 						"block not found",
 						frame->getId());
 				parent_frame->block_not_found = true;
@@ -1127,7 +1128,7 @@ void System::EventFindAndLockHandler(esim::Event *event,
 				!frame->blocking)
 		{
 			// Debug
-			debug << misc::fmt("    A-%lld 0x%x %s block locked at "
+			debug.fmt("    A-%lld 0x%x %s block locked at "
 					"set=%d, "
 					"way=%d "
 					"by A-%lld - aborting\n",
@@ -1164,7 +1165,7 @@ void System::EventFindAndLockHandler(esim::Event *event,
 				frame->getId()))
 		{
 			// Debug
-			debug << misc::fmt("    A-%lld 0x%x %s block locked at "
+			debug.fmt("    A-%lld 0x%x %s block locked at "
 					"set=%d, "
 					"way=%d by "
 					"A-%lld - waiting\n",
@@ -1202,16 +1203,17 @@ void System::EventFindAndLockHandler(esim::Event *event,
 					frame->set, frame->way));
 			
 			// Debug
-			debug << misc::fmt("    A-%lld 0x%x %s miss -> lru: "
-					"set=%d, "
-					"way=%d, "
-					"state=%s\n",
-					frame->getId(),
-					frame->tag,
-					module->getName().c_str(),
-					frame->set,
-					frame->way,
-					Cache::BlockStateMap[frame->state]);
+			if (debug)
+				debug.fmt("    A-%lld 0x%x %s miss -> lru: "
+						"set=%d, "
+						"way=%d, "
+						"state=%s\n",
+						frame->getId(),
+						frame->tag,
+						module->getName().c_str(),
+						frame->set,
+						frame->way,
+						Cache::BlockStateMap[frame->state]);
 		}
 
 		// Statistics
@@ -1240,12 +1242,12 @@ void System::EventFindAndLockHandler(esim::Event *event,
 		assert(port);
 
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s find_and_lock_action\n",
+		debug.fmt("  %lld A-%lld 0x%x %s find_and_lock_action\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:find_and_lock_action\"\n",
 				frame->getId(),
@@ -1263,7 +1265,7 @@ void System::EventFindAndLockHandler(esim::Event *event,
 			module->incConflictInvalidations();
 
 			// Call 'evict'
-			auto new_frame = misc::new_shared<Frame>(
+			auto new_frame = esim::new_frame<Frame>(
 					frame->getId(),
 					module,
 					0);
@@ -1288,14 +1290,14 @@ void System::EventFindAndLockHandler(esim::Event *event,
 		Directory *directory = module->getDirectory();
 
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"find_and_lock_finish (err=%d)\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				module->getName().c_str(),
 				frame->error);
-		trace << misc::fmt("mem.access name=\"A-%lld\" "
+		trace.fmt("mem.access name=\"A-%lld\" "
 				"state=\"%s:find_and_lock_finish\"\n",
 				frame->getId(),
 				module->getName().c_str());
@@ -1391,16 +1393,17 @@ void System::EventEvictHandler(esim::Event *event,
 				frame->set, frame->way));
 
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s evict "
-				"(set=%d, way=%d, state=%s)\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				module->getName().c_str(),
-				frame->set,
-				frame->way,
-				Cache::BlockStateMap[frame->state]);
-		trace << misc::fmt("mem.access name=\"A-%lld\" "
+		if (debug)
+			debug.fmt("  %lld A-%lld 0x%x %s evict "
+					"(set=%d, way=%d, state=%s)\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					module->getName().c_str(),
+					frame->set,
+					frame->way,
+					Cache::BlockStateMap[frame->state]);
+		trace.fmt("mem.access name=\"A-%lld\" "
 				"state=\"%s:evict\"\n",
 				frame->getId(),
 				module->getName().c_str());
@@ -1412,7 +1415,7 @@ void System::EventEvictHandler(esim::Event *event,
 		frame->target_module = module->getLowModuleServingAddress(frame->tag);
 
 		// Send write request to all sharers
-		auto new_frame = misc::new_shared<Frame>(
+		auto new_frame = esim::new_frame<Frame>(
 				frame->getId(),
 				module,
 				0);
@@ -1429,12 +1432,12 @@ void System::EventEvictHandler(esim::Event *event,
 	if (event == event_evict_invalid)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s evict_invalid\n",
+		debug.fmt("  %lld A-%lld 0x%x %s evict_invalid\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:evict_invalid\"\n",
 				frame->getId(),
@@ -1485,12 +1488,12 @@ void System::EventEvictHandler(esim::Event *event,
 	if (event == event_evict_action)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s evict_action\n",
+		debug.fmt("  %lld A-%lld 0x%x %s evict_action\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:evict_action\"\n",
 				frame->getId(),
@@ -1535,7 +1538,7 @@ void System::EventEvictHandler(esim::Event *event,
 				event_evict_receive,
 				event);
 		if (frame->message)
-			net::System::trace << misc::fmt("net.msg_access "
+			net::System::trace.fmt("net.msg_access "
 					"net=\"%s\" "
 					"name=\"M-%lld\" "
 					"access=\"A-%lld\"\n",
@@ -1549,12 +1552,12 @@ void System::EventEvictHandler(esim::Event *event,
 	if (event == event_evict_receive)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s evict_receive\n",
+		debug.fmt("  %lld A-%lld 0x%x %s evict_receive\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:evict_receive\"\n",
 				frame->getId(),
@@ -1566,7 +1569,7 @@ void System::EventEvictHandler(esim::Event *event,
 		network->Receive(node, frame->message);
 
 		// Call find-and-lock
-		auto new_frame = misc::new_shared<Frame>(
+		auto new_frame = esim::new_frame<Frame>(
 				frame->getId(),
 				target_module,
 				frame->src_tag);
@@ -1589,12 +1592,12 @@ void System::EventEvictHandler(esim::Event *event,
 	if (event == event_evict_process)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s evict_process\n",
+		debug.fmt("  %lld A-%lld 0x%x %s evict_process\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:evict_process\"\n",
 				frame->getId(),
@@ -1673,9 +1676,14 @@ void System::EventEvictHandler(esim::Event *event,
 		// Stats
 		target_module->incDataAccesses();
 
-		// Continue with 'evict-reply', after data latency
-		esim_engine->Next(event_evict_reply,
-				target_module->getDataLatency());
+		// Continue with 'evict-reply' after the data access. Only an
+		// eviction carrying data writes the block back.
+		if (frame->reply == Frame::ReplyAckData)
+			target_module->AccessData(event_evict_reply,
+					frame->tag, true);
+		else
+			esim_engine->Next(event_evict_reply,
+					target_module->getDataLatency());
 		return;
 	}
 
@@ -1683,13 +1691,13 @@ void System::EventEvictHandler(esim::Event *event,
 	if (event == event_evict_process_noncoherent)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"evict_process_noncoherent\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:evict_process_noncoherent\"\n",
 				frame->getId(),
@@ -1781,9 +1789,8 @@ void System::EventEvictHandler(esim::Event *event,
 		// Stats
 		target_module->incDataAccesses();
 		
-		// Continue with 'evict-reply' after latency
-		esim_engine->Next(event_evict_reply,
-				target_module->getDataLatency());
+		// Continue with 'evict-reply' after writing back the data
+		target_module->AccessData(event_evict_reply, frame->tag, true);
 		return;
 	}
 
@@ -1791,13 +1798,13 @@ void System::EventEvictHandler(esim::Event *event,
 	if (event == event_evict_reply)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"evict_reply\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:evict_reply\"\n",
 				frame->getId(),
@@ -1813,7 +1820,7 @@ void System::EventEvictHandler(esim::Event *event,
 				event_evict_reply_receive,
 				event);
 		if (frame->message)
-			net::System::trace << misc::fmt("net.msg_access "
+			net::System::trace.fmt("net.msg_access "
 					"net=\"%s\" "
 					"name=\"M-%lld\" "
 					"access=\"A-%lld\"\n",
@@ -1827,13 +1834,13 @@ void System::EventEvictHandler(esim::Event *event,
 	if (event == event_evict_reply_receive)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"evict_reply_receive\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:evict_reply_receive\"\n",
 				frame->getId(),
@@ -1863,12 +1870,12 @@ void System::EventEvictHandler(esim::Event *event,
 	if (event == event_evict_finish)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s evict_finish\n",
+		debug.fmt("  %lld A-%lld 0x%x %s evict_finish\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:evict_finish\"\n",
 				frame->getId(),
@@ -1900,12 +1907,12 @@ void System::EventWriteRequestHandler(esim::Event *event,
 	if (event == event_write_request)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s write_request\n",
+		debug.fmt("  %lld A-%lld 0x%x %s write_request\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:write_request\"\n",
 				frame->getId(),
@@ -1953,7 +1960,7 @@ void System::EventWriteRequestHandler(esim::Event *event,
 				event_write_request_receive,
 				event);
 		if (frame->message)
-			net::System::trace << misc::fmt("net.msg_access "
+			net::System::trace.fmt("net.msg_access "
 					"net=\"%s\" "
 					"name=\"M-%lld\" "
 					"access=\"A-%lld\"\n",
@@ -1967,13 +1974,13 @@ void System::EventWriteRequestHandler(esim::Event *event,
 	if (event == event_write_request_receive)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"write_request_receive\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:write_request_receive\"\n",
 				frame->getId(),
@@ -1995,7 +2002,7 @@ void System::EventWriteRequestHandler(esim::Event *event,
 		network->Receive(node, frame->message);
 		
 		// Call 'find-and-lock'
-		auto new_frame = misc::new_shared<Frame>(
+		auto new_frame = esim::new_frame<Frame>(
 				frame->getId(),
 				target_module,
 				frame->getAddress());
@@ -2014,12 +2021,12 @@ void System::EventWriteRequestHandler(esim::Event *event,
 	if (event == event_write_request_action)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s write_request_action\n", 
+		debug.fmt("  %lld A-%lld 0x%x %s write_request_action\n", 
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:write_request_action\"\n",
 				frame->getId(),
@@ -2063,7 +2070,7 @@ void System::EventWriteRequestHandler(esim::Event *event,
 
 		// Invalidate the rest of higher-level sharers.
 		// Call 'invalidate' event chain.
-		auto new_frame = misc::new_shared<Frame>(
+		auto new_frame = esim::new_frame<Frame>(
 				frame->getId(),
 				target_module,
 				0);
@@ -2080,13 +2087,13 @@ void System::EventWriteRequestHandler(esim::Event *event,
 	if (event == event_write_request_exclusive)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"write_request_exclusive\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:write_request_exclusive\"\n",
 				frame->getId(),
@@ -2105,12 +2112,12 @@ void System::EventWriteRequestHandler(esim::Event *event,
 	if (event == event_write_request_updown)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s write_request_updown\n",
+		debug.fmt("  %lld A-%lld 0x%x %s write_request_updown\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:write_request_updown\"\n",
 				frame->getId(),
@@ -2134,7 +2141,7 @@ void System::EventWriteRequestHandler(esim::Event *event,
 		case Cache::BlockInvalid:
 		case Cache::BlockNonCoherent:
 		{
-			auto new_frame = misc::new_shared<Frame>(
+			auto new_frame = esim::new_frame<Frame>(
 					frame->getId(),
 					target_module,
 					frame->tag);
@@ -2159,13 +2166,13 @@ void System::EventWriteRequestHandler(esim::Event *event,
 	if (event == event_write_request_updown_finish)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"write_request_updown_finish\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:write_request_updown_finish\"\n",
 				frame->getId(),
@@ -2251,9 +2258,14 @@ void System::EventWriteRequestHandler(esim::Event *event,
 		// Stats
 		target_module->incDataAccesses();
 
-		// Continue with 'write-request-reply' after data latency
-		esim_engine->Next(event_write_request_reply,
-				target_module->getDataLatency());
+		// Continue with 'write-request-reply' after the data access.
+		// The block is only read if it is sent up to the requester.
+		if (frame->reply_size > 8)
+			target_module->AccessData(event_write_request_reply,
+					frame->tag, false);
+		else
+			esim_engine->Next(event_write_request_reply,
+					target_module->getDataLatency());
 		return;
 	}
 
@@ -2261,12 +2273,12 @@ void System::EventWriteRequestHandler(esim::Event *event,
 	if (event == event_write_request_downup)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s write_request_downup\n",
+		debug.fmt("  %lld A-%lld 0x%x %s write_request_downup\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:write_request_downup\"\n",
 				frame->getId(),
@@ -2313,13 +2325,13 @@ void System::EventWriteRequestHandler(esim::Event *event,
 	if (event == event_write_request_downup_finish)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"write_request_downup_finish\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:write_request_downup_finish\"\n",
 				frame->getId(),
@@ -2368,13 +2380,13 @@ void System::EventWriteRequestHandler(esim::Event *event,
 	if (event == event_write_request_reply)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"write_request_reply\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:write_request_reply\"\n",
 				frame->getId(),
@@ -2409,7 +2421,7 @@ void System::EventWriteRequestHandler(esim::Event *event,
 				event_write_request_finish,
 				event);
 		if (frame->message)
-			net::System::trace << misc::fmt("net.msg_access "
+			net::System::trace.fmt("net.msg_access "
 					"net=\"%s\" "
 					"name=\"M-%lld\" "
 					"access=\"A-%lld\"\n",
@@ -2423,13 +2435,13 @@ void System::EventWriteRequestHandler(esim::Event *event,
 	if (event == event_write_request_finish)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"write_request_finish\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:write_request_finish\"\n",
 				frame->getId(),
@@ -2484,12 +2496,12 @@ void System::EventReadRequestHandler(esim::Event *event,
 	if (event == event_read_request)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s read_request\n",
+		debug.fmt("  %lld A-%lld 0x%x %s read_request\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:read_request\"\n",
 				frame->getId(),
@@ -2534,7 +2546,7 @@ void System::EventReadRequestHandler(esim::Event *event,
 				event_read_request_receive,
 				event);
 		if (frame->message)
-			net::System::trace << misc::fmt("net.msg_access "
+			net::System::trace.fmt("net.msg_access "
 					"net=\"%s\" "
 					"name=\"M-%lld\" "
 					"access=\"A-%lld\"\n",
@@ -2548,12 +2560,12 @@ void System::EventReadRequestHandler(esim::Event *event,
 	if (event == event_read_request_receive)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s read_request_receive\n",
+		debug.fmt("  %lld A-%lld 0x%x %s read_request_receive\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:read_request_receive\"\n",
 				frame->getId(),
@@ -2579,7 +2591,7 @@ void System::EventReadRequestHandler(esim::Event *event,
 		// only need to hit and not have ownership.  We would never 
 		// cross paths with a request coming down-up because we would
 		// hit before that.
-		auto new_frame = misc::new_shared<Frame>(
+		auto new_frame = esim::new_frame<Frame>(
 				frame->getId(),
 				target_module,
 				frame->getAddress());
@@ -2598,12 +2610,12 @@ void System::EventReadRequestHandler(esim::Event *event,
 	if (event == event_read_request_action)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s read_request_action\n",
+		debug.fmt("  %lld A-%lld 0x%x %s read_request_action\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:read_request_action\"\n",
 				frame->getId(),
@@ -2652,12 +2664,12 @@ void System::EventReadRequestHandler(esim::Event *event,
 	if (event == event_read_request_updown)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s read_request_updown\n",
+		debug.fmt("  %lld A-%lld 0x%x %s read_request_updown\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:read_request_updown\"\n",
 				frame->getId(),
@@ -2716,7 +2728,7 @@ void System::EventReadRequestHandler(esim::Event *event,
 				frame->pending++;
 
 				// Call 'read-request'
-				auto new_frame = misc::new_shared<Frame>(
+				auto new_frame = esim::new_frame<Frame>(
 						frame->getId(),
 						target_module,
 						directory_entry_tag);
@@ -2737,7 +2749,7 @@ void System::EventReadRequestHandler(esim::Event *event,
 			assert(!directory->isBlockSharedOrOwned(frame->set, frame->way));
 
 			// Call 'read-request'
-			auto new_frame = misc::new_shared<Frame>(
+			auto new_frame = esim::new_frame<Frame>(
 					frame->getId(),
 					target_module,
 					frame->tag);
@@ -2754,13 +2766,13 @@ void System::EventReadRequestHandler(esim::Event *event,
 	if (event == event_read_request_updown_miss)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"read_request_updown_miss\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:read_request_updown_miss\"\n",
 				frame->getId(),
@@ -2812,13 +2824,13 @@ void System::EventReadRequestHandler(esim::Event *event,
 			return;
 
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"read_request_updown_finish\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:read_request_updown_finish\"\n",
 				frame->getId(),
@@ -2924,9 +2936,14 @@ void System::EventReadRequestHandler(esim::Event *event,
 		// Stats
 		target_module->incDataAccesses();
 
-		// Continue with 'read-request-reply' after latency
-		esim_engine->Next(event_read_request_reply,
-				target_module->getDataLatency());
+		// Continue with 'read-request-reply' after the data access.
+		// The block is only read if it is sent up to the requester.
+		if (frame->reply_size > 8)
+			target_module->AccessData(event_read_request_reply,
+					frame->tag, false);
+		else
+			esim_engine->Next(event_read_request_reply,
+					target_module->getDataLatency());
 		return;
 	}
 
@@ -2934,12 +2951,12 @@ void System::EventReadRequestHandler(esim::Event *event,
 	if (event == event_read_request_downup)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s read_request_downup\n",
+		debug.fmt("  %lld A-%lld 0x%x %s read_request_downup\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:read_request_downup\"\n",
 				frame->getId(),
@@ -2982,7 +2999,7 @@ void System::EventReadRequestHandler(esim::Event *event,
 			frame->pending++;
 
 			// Call 'read-request'
-			auto new_frame = misc::new_shared<Frame>(
+			auto new_frame = esim::new_frame<Frame>(
 					frame->getId(),
 					target_module,
 					directory_entry_tag);
@@ -3008,13 +3025,13 @@ void System::EventReadRequestHandler(esim::Event *event,
 			return;
 		
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"read_request_downup_finish\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:read_request_downup_finish\"\n",
 				frame->getId(),
@@ -3130,13 +3147,13 @@ void System::EventReadRequestHandler(esim::Event *event,
 	if (event == event_read_request_reply)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"read_request_reply\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				target_module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:read_request_reply\"\n",
 				frame->getId(),
@@ -3175,7 +3192,7 @@ void System::EventReadRequestHandler(esim::Event *event,
 				event_read_request_finish,
 				event);
 		if (frame->message)
-			net::System::trace << misc::fmt("net.msg_access "
+			net::System::trace.fmt("net.msg_access "
 					"net=\"%s\" "
 					"name=\"M-%lld\" "
 					"access=\"A-%lld\"\n",
@@ -3189,13 +3206,13 @@ void System::EventReadRequestHandler(esim::Event *event,
 	if (event == event_read_request_finish)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"read_request_finish\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:read_request_finish\"\n",
 				frame->getId(),
@@ -3245,16 +3262,17 @@ void System::EventInvalidateHandler(esim::Event *event,
 		frame->tag = tag;
 
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s invalidate "
-				"(set=%d, way=%d, state=%s)\n",
-				esim_engine->getTime(),
-				frame->getId(),
-				frame->tag,
-				module->getName().c_str(),
-				frame->set,
-				frame->way,
-				Cache::BlockStateMap[frame->state]);
-		trace << misc::fmt("mem.access name=\"A-%lld\" "
+		if (debug)
+			debug.fmt("  %lld A-%lld 0x%x %s invalidate "
+					"(set=%d, way=%d, state=%s)\n",
+					esim_engine->getTime(),
+					frame->getId(),
+					frame->tag,
+					module->getName().c_str(),
+					frame->set,
+					frame->way,
+					Cache::BlockStateMap[frame->state]);
+		trace.fmt("mem.access name=\"A-%lld\" "
 				"state=\"%s:invalidate\"\n",
 				frame->getId(),
 				module->getName().c_str());
@@ -3306,7 +3324,7 @@ void System::EventInvalidateHandler(esim::Event *event,
 				frame->pending++;
 
 				// Send write request upwards if beginning of block
-				auto new_frame = misc::new_shared<Frame>(
+				auto new_frame = esim::new_frame<Frame>(
 						frame->getId(),
 						module,
 						directory_entry_tag);
@@ -3327,12 +3345,12 @@ void System::EventInvalidateHandler(esim::Event *event,
 	if (event == event_invalidate_finish)
 	{
 		// Debug and trace
-		debug << misc::fmt("  %lld A-%lld 0x%x %s invalidate_finish\n",
+		debug.fmt("  %lld A-%lld 0x%x %s invalidate_finish\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->tag,
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:invalidate_finish\"\n",
 				frame->getId(),
@@ -3376,7 +3394,7 @@ void System::EventMessageHandler(esim::Event *event,
 	if (event == event_message)
 	{
 		// Memory debug
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"message\n",
 				esim_engine->getTime(),
 				frame->getId(),
@@ -3408,7 +3426,7 @@ void System::EventMessageHandler(esim::Event *event,
 
 		// Trace
 		if (frame->message)
-			net::System::trace << misc::fmt("net.msg_access "
+			net::System::trace.fmt("net.msg_access "
 					"net=\"%s\" "
 					"name=\"M-%lld\" "
 					"access=\"A-%lld\"\n",
@@ -3423,7 +3441,7 @@ void System::EventMessageHandler(esim::Event *event,
 	if (event == event_message_receive)
 	{
 		// Memory debug
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"message_receive\n",
 				esim_engine->getTime(),
 				frame->getId(),
@@ -3436,7 +3454,7 @@ void System::EventMessageHandler(esim::Event *event,
 		network->Receive(node, frame->message);
 
 		// Find and lock
-		auto new_frame = misc::new_shared<Frame>(
+		auto new_frame = esim::new_frame<Frame>(
 					frame->getId(),
 					target_module,
 					frame->getAddress());
@@ -3456,7 +3474,7 @@ void System::EventMessageHandler(esim::Event *event,
 	if (event == event_message_action)
 	{
 		// Memory debug
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"message_action\n",
 				esim_engine->getTime(),
 				frame->getId(),
@@ -3466,7 +3484,7 @@ void System::EventMessageHandler(esim::Event *event,
 		assert(frame->message);
 
 		// Check block locking error
-		debug << misc::fmt("frame error = %u\n", frame->error);
+		debug.fmt("frame error = %u\n", frame->error);
 		if (frame->error)
 		{
 			parent_frame->error = true;
@@ -3513,7 +3531,7 @@ void System::EventMessageHandler(esim::Event *event,
 	if (event == event_message_reply)
 	{
 		// Memory debug
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"message_reply\n",
 				esim_engine->getTime(),
 				frame->getId(),
@@ -3535,7 +3553,7 @@ void System::EventMessageHandler(esim::Event *event,
 
 		// Trace
 		if (frame->message)
-			net::System::trace << misc::fmt("net.msg_access "
+			net::System::trace.fmt("net.msg_access "
 					"net=\"%s\" "
 					"name=\"M-%lld\" "
 					"access=\"A-%lld\"\n",
@@ -3549,7 +3567,7 @@ void System::EventMessageHandler(esim::Event *event,
 	if (event == event_message_finish)
 	{
 		// Memory debug
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"message_finish\n",
 				esim_engine->getTime(),
 				frame->getId(),
@@ -3583,7 +3601,7 @@ void System::EventFlushHandler(esim::Event *event,
 	if (event == event_flush)
 	{
 		// Memory debug
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"flush\n",
 				esim_engine->getTime(),
 				frame->getId(),
@@ -3591,7 +3609,7 @@ void System::EventFlushHandler(esim::Event *event,
 				module->getName().c_str());
 
 		// Trace
-		trace << misc::fmt("mem.new_access "
+		trace.fmt("mem.new_access "
 				"name=\"A-%lld\" "
 				"type=\"flush\" "
 				"state=\"%s:flush\" "
@@ -3623,7 +3641,7 @@ void System::EventFlushHandler(esim::Event *event,
 			return;
 
 		// Trace
-		trace << misc::fmt("mem.end_access name=\"A-%lld\"\n",
+		trace.fmt("mem.end_access name=\"A-%lld\"\n",
 				frame->getId());
 
 		// Increment the witness pointer if one was provided
@@ -3651,13 +3669,13 @@ void System::EventLocalLoadHandler(esim::Event *event,
 	if (event == event_local_load)
 	{
 		// Memory debug
-		debug << misc::fmt("%lld A-%lld 0x%x %s local_load\n",
+		debug.fmt("%lld A-%lld 0x%x %s local_load\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
 		// Trace
-		trace << misc::fmt("mem.new_access "
+		trace.fmt("mem.new_access "
 				"name=\"A-%lld\" "
 				"type=\"store\" "
 				"state=\"%s:store\" addr=0x%x\n",
@@ -3692,12 +3710,12 @@ void System::EventLocalLoadHandler(esim::Event *event,
 	// Event "local_load_lock"
 	if (event == event_local_load_lock)
 	{
-		debug << misc::fmt("  %lld A-%lld 0x%x %s local_load_lock\n",
+		debug.fmt("  %lld A-%lld 0x%x %s local_load_lock\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:load_lock\"\n",
 				frame->getId(),
@@ -3707,7 +3725,7 @@ void System::EventLocalLoadHandler(esim::Event *event,
 		Frame *older_frame = module->getInFlightWrite(frame);
 		if (older_frame)
 		{
-			debug << misc::fmt("    A-%lld wait for write A-%lld\n",
+			debug.fmt("    A-%lld wait for write A-%lld\n",
 					frame->getId(),
 					older_frame->getId());
 			older_frame->queue.Wait(event_local_load_lock);
@@ -3721,7 +3739,7 @@ void System::EventLocalLoadHandler(esim::Event *event,
 				frame);
 		if (older_frame)
 		{
-			debug << misc::fmt("    A-%lld wait for access A-%lld\n",
+			debug.fmt("    A-%lld wait for access A-%lld\n",
 					frame->getId(),
 					older_frame->getId());
 			older_frame->queue.Wait(event_local_load_lock);
@@ -3729,7 +3747,7 @@ void System::EventLocalLoadHandler(esim::Event *event,
 		}
 
 		// Call "find_and_lock" event chain
-		auto new_frame = misc::new_shared<Frame>(
+		auto new_frame = esim::new_frame<Frame>(
 				frame->getId(),
 				module,
 				frame->getAddress());
@@ -3747,21 +3765,21 @@ void System::EventLocalLoadHandler(esim::Event *event,
 	if (event == event_local_load_finish)
 	{
 		// Memory debug
-		debug << misc::fmt("%lld A-%lld 0x%x %s local_load_finish\n",
+		debug.fmt("%lld A-%lld 0x%x %s local_load_finish\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
 
 		// Trace
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:load_finish\"\n",
 				frame->getId(),
 				module->getName().c_str());
 
 		// Trace
-		trace << misc::fmt("mem.end_access "
+		trace.fmt("mem.end_access "
 				"name=\"A-%lld\"\n",
 				frame->getId());
 
@@ -3794,14 +3812,14 @@ void System::EventLocalStoreHandler(esim::Event *event,
 	if (event == event_local_store)
 	{
 		// Memory debug
-		debug << misc::fmt("%lld A-%lld 0x%x %s local_store\n",
+		debug.fmt("%lld A-%lld 0x%x %s local_store\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
 
 		// Trace
-		trace << misc::fmt("mem.new_access "
+		trace.fmt("mem.new_access "
 				"name=\"A-%lld\" "
 				"type=\"store\" "
 				"state=\"%s:store\" addr=0x%x\n",
@@ -3841,14 +3859,14 @@ void System::EventLocalStoreHandler(esim::Event *event,
 	if (event == event_local_store_lock)
 	{
 		// Debug
-		debug << misc::fmt("  %lld A-%lld 0x%x %s local_store_lock\n",
+		debug.fmt("  %lld A-%lld 0x%x %s local_store_lock\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
 
 		// Trace
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:store_lock\"\n",
 				frame->getId(),
@@ -3864,7 +3882,7 @@ void System::EventLocalStoreHandler(esim::Event *event,
 			Frame *older_frame = *it;
 
 			// Debug
-			debug << misc::fmt("    A-%lld wait for access A-%lld\n",
+			debug.fmt("    A-%lld wait for access A-%lld\n",
 					frame->getId(),
 					older_frame->getId());
 
@@ -3874,7 +3892,7 @@ void System::EventLocalStoreHandler(esim::Event *event,
 		}
 
 		// Call 'find-and-lock'
-		auto new_frame = misc::new_shared<Frame>(
+		auto new_frame = esim::new_frame<Frame>(
 				frame->getId(),
 				module,
 				frame->getAddress());
@@ -3897,21 +3915,21 @@ void System::EventLocalStoreHandler(esim::Event *event,
 	if (event == event_local_store_finish)
 	{
 		// Debug
-		debug << misc::fmt("%lld A-%lld 0x%x %s local_store_finish\n",
+		debug.fmt("%lld A-%lld 0x%x %s local_store_finish\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
 
 		// Trace
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:store_finish\"\n",
 				frame->getId(),
 				module->getName().c_str());
 
 		// Trace
-		trace << misc::fmt("mem.end_access "
+		trace.fmt("mem.end_access "
 				"name=\"A-%lld\"\n",
 				frame->getId());
 
@@ -3940,14 +3958,14 @@ void System::EventLocalFindAndLockHandler(esim::Event *event,
 	// Event "local_find_and_lock"
 	if (event == event_local_find_and_lock)
 	{
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"local_find_and_lock (blocking=%d)\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str(),
 				frame->blocking);
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:find_and_lock\"\n",
 				frame->getId(),
@@ -3973,14 +3991,14 @@ void System::EventLocalFindAndLockHandler(esim::Event *event,
 		assert(port);
 
 		// Memory debug
-		debug << misc::fmt("  %lld A-%lld 0x%x %s local_find_and_lock_port\n",
+		debug.fmt("  %lld A-%lld 0x%x %s local_find_and_lock_port\n",
 				esim_engine->getTime(),
 				frame->getId(),
 				frame->getAddress(),
 				module->getName().c_str());
 
 		// Trace
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:find_and_lock_port\"\n",
 				frame->getId(),
@@ -4029,7 +4047,7 @@ void System::EventLocalFindAndLockHandler(esim::Event *event,
 		assert(port);
 
 		// Memory debug
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"local_find_and_lock_action\n",
 				esim_engine->getTime(),
 				frame->getId(),
@@ -4037,7 +4055,7 @@ void System::EventLocalFindAndLockHandler(esim::Event *event,
 				module->getName().c_str());
 
 		// Trace
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:find_and_lock_action\"\n",
 				frame->getId(),
@@ -4056,7 +4074,7 @@ void System::EventLocalFindAndLockHandler(esim::Event *event,
 	if (event == event_local_find_and_lock_finish)
 	{
 		// Memory debug
-		debug << misc::fmt("  %lld A-%lld 0x%x %s "
+		debug.fmt("  %lld A-%lld 0x%x %s "
 				"local_find_and_lock_finish\n",
 				esim_engine->getTime(),
 				frame->getId(),
@@ -4064,7 +4082,7 @@ void System::EventLocalFindAndLockHandler(esim::Event *event,
 				module->getName().c_str());
 
 		// Trace
-		trace << misc::fmt("mem.access "
+		trace.fmt("mem.access "
 				"name=\"A-%lld\" "
 				"state=\"%s:find_and_lock_finish\"\n",
 				frame->getId(),
@@ -55,7 +55,7 @@ void Buffer::InsertPacket(Packet *packet)
 
 	// Debug
 	Message *message = packet->getMessage();
-	System::debug << misc::fmt("net: %s - M-%lld:%d - "
+	System::debug.fmt("net: %s - M-%lld:%d - "
 			"insert_buf: %s:%s\n",
 			message->getNetwork()->getName().c_str(),
 			message->getId(),
@@ -126,7 +126,7 @@ void Buffer::ExtractPacket()
 
 	// Debug
 	Message *message = packet->getMessage();
-	System::debug << misc::fmt("net: %s - M-%lld:%d - "
+	System::debug.fmt("net: %s - M-%lld:%d - "
 			"extract_buf: %s:%s\n",
 			message->getNetwork()->getName().c_str(),
 			message->getId(),
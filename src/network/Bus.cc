@@ -114,7 +114,7 @@ void Bus::TransferPacket(Packet *packet)
 	if (source_buffer->getBufferHead() != packet)
 	{
 		// Update debug information
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
+		System::debug.fmt("net: %s - M-%lld:%d - "
 				"stl_not_buf_head: %s:%s\n",
 				network->getName().c_str(),
 				message->getId(), packet->getId(),
@@ -159,7 +159,7 @@ void Bus::TransferPacket(Packet *packet)
 	// Check if the destination buffer is not busy
 	if (destination_buffer->write_busy >= cycle)
 	{
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
+		System::debug.fmt("net: %s - M-%lld:%d - "
 				"stl_busy_dest_buf: %s:%s\n", 
 				network->getName().c_str(),
 				message->getId(), packet->getId(),
@@ -179,7 +179,7 @@ void Bus::TransferPacket(Packet *packet)
 	if (destination_buffer->getCount() + packet_size >
 			destination_buffer->getSize())
 	{
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
+		System::debug.fmt("net: %s - M-%lld:%d - "
 				"stl_full_bus_dest_buf: %s - %s:%s\n", 
 				network->getName().c_str(),
 				message->getId(), packet->getId(),
@@ -194,7 +194,7 @@ void Bus::TransferPacket(Packet *packet)
 	Lane *lane = Arbitration(source_buffer);
 	if (!lane)
 	{
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
+		System::debug.fmt("net: %s - M-%lld:%d - "
 				"stl_bus_arb: %s\n", 
 				network->getName().c_str(),
 				message->getId(), packet->getId(),
@@ -217,14 +217,14 @@ void Bus::TransferPacket(Packet *packet)
 	packet->setBusy(cycle + latency - 1);
 
 	// Buffer's trace information
-    	System::trace << misc::fmt("net.packet_extract net=\"%s\" node=\"%s\" "
+    	System::trace.fmt("net.packet_extract net=\"%s\" node=\"%s\" "
 			"buffer=\"%s\" name=\"P-%lld:%d\" occpncy=%d\n",
     			network->getName().c_str(),
 			source_buffer->getNode()->getName().c_str(),
 			source_buffer->getName().c_str(),
 			message->getId(), packet->getId(),
 			source_buffer->getOccupancyInBytes());
-	System::trace << misc::fmt("net.packet_insert net=\"%s\" node=\"%s\" "
+	System::trace.fmt("net.packet_insert net=\"%s\" node=\"%s\" "
 			"buffer=\"%s\" name=\"P-%lld:%d\" occpncy=%d\n",
 			network->getName().c_str(),
 			destination_buffer->getNode()->getName().c_str(),
@@ -126,7 +126,7 @@ void Link::TransferPacket(Packet *packet)
 	if (source_buffer->getBufferHead() != packet)
 	{
 		// Update debug information
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
+		System::debug.fmt("net: %s - M-%lld:%d - "
 				"stl_not_buf_head: %s:%s\n",
 				network->getName().c_str(),
 				message->getId(), packet->getId(),
@@ -142,7 +142,7 @@ void Link::TransferPacket(Packet *packet)
 	if (busy >= cycle)
 	{
 		// Update debug information
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
+		System::debug.fmt("net: %s - M-%lld:%d - "
 				"stl at %s:%s busy_link: %s\n",
 				network->getName().c_str(),
 				message->getId(), packet->getId(),
@@ -151,7 +151,7 @@ void Link::TransferPacket(Packet *packet)
 				getName().c_str());
 
 		// Trace information
-		System::trace << misc::fmt("net.packet "
+		System::trace.fmt("net.packet "
 				"net=\"%s\" name=\"P-%lld:%d\" "
 				"state=\"%s:%s:link_busy\" "
 				"stg=\"LB\"\n",
@@ -170,7 +170,7 @@ void Link::TransferPacket(Packet *packet)
 	if (next_buffer != source_buffer)
 	{
 		// Update debug information
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
+		System::debug.fmt("net: %s - M-%lld:%d - "
 				"stl at %s:%s vc_arb: %s\n",
 				network->getName().c_str(),
 				message->getId(), packet->getId(),
@@ -179,7 +179,7 @@ void Link::TransferPacket(Packet *packet)
 				name.c_str());
 
 		// Trace information
-		System::trace << misc::fmt("net.packet "
+		System::trace.fmt("net.packet "
 				"net=\"%s\" "
 				"name=\"P-%lld:%d\" "
 				"state=\"%s:%s:VC_arbitration_fail\" "
@@ -204,7 +204,7 @@ void Link::TransferPacket(Packet *packet)
 	if (write_busy >= cycle)
 	{
 		// Update debug information
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
+		System::debug.fmt("net: %s - M-%lld:%d - "
 				"stl_busy_dst_buf: %s:%s\n",
 				network->getName().c_str(),
 				message->getId(), packet->getId(),
@@ -212,7 +212,7 @@ void Link::TransferPacket(Packet *packet)
 				destination_buffer->getName().c_str());
 
 		// Trace information
-		System::trace << misc::fmt("net.packet "
+		System::trace.fmt("net.packet "
 				"net=\"%s\" "
 				"name=\"P-%lld:%d\" "
 				"state=\"%s:%s:Dest_buffer_busy\" "
@@ -232,7 +232,7 @@ void Link::TransferPacket(Packet *packet)
 			destination_buffer->getSize())
 	{
 		// Update debug information
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
+		System::debug.fmt("net: %s - M-%lld:%d - "
 				"stl_full_dst_buf: %s:%s\n",
 				network->getName().c_str(),
 				message->getId(), packet->getId(),
@@ -240,7 +240,7 @@ void Link::TransferPacket(Packet *packet)
 				destination_buffer->getName().c_str());
 
 		// Trace information
-		System::trace << misc::fmt("net.packet "
+		System::trace.fmt("net.packet "
                 		"net=\"%s\" "
 		                "name=\"P-%lld:%d\" "
 		                "state=\"%s:%s:Dest_buffer_full\" "
@@ -269,14 +269,14 @@ void Link::TransferPacket(Packet *packet)
 	packet->setBusy(cycle + latency - 1);
 
 	// Buffer's trace information
-	System::trace << misc::fmt("net.packet_extract net=\"%s\" node=\"%s\" "
+	System::trace.fmt("net.packet_extract net=\"%s\" node=\"%s\" "
 			"buffer=\"%s\" name=\"P-%lld:%d\" occpncy=%d\n",
 			network->getName().c_str(),
 			source_buffer->getNode()->getName().c_str(),
 			source_buffer->getName().c_str(),
 			message->getId(), packet->getId(),
 			source_buffer->getOccupancyInBytes());
-	System::trace << misc::fmt("net.packet_insert net=\"%s\" node=\"%s\" "
+	System::trace.fmt("net.packet_insert net=\"%s\" node=\"%s\" "
 			"buffer=\"%s\" name=\"P-%lld:%d\" occpncy=%d\n",
 			network->getName().c_str(),
 			destination_buffer->getNode()->getName().c_str(),
@@ -293,7 +293,7 @@ void Link::TransferPacket(Packet *packet)
 	destination_node->incReceivedBytes(packet_size);
 	destination_node->incReceivedPackets();
 
-	System::trace << misc::fmt("net.link_transfer net=\"%s\" link=\"%s\" "
+	System::trace.fmt("net.link_transfer net=\"%s\" link=\"%s\" "
 			"transB=%lld last_size=%d busy=%lld\n",
 			network->getName().c_str(), getName().c_str(),
 			transferred_bytes,
@@ -85,7 +85,7 @@ bool Message::Assemble(Packet *packet)
 	received_packets.push_back(packet);
 
 	// Update the trace with the position of the packet, the depacketizer
-	net::System::trace << misc::fmt("net.packet net=\"%s\" "
+	net::System::trace.fmt("net.packet net=\"%s\" "
 			"name=\"P-%lld:%d\" state=\"%s:depacketizer\" stg=\"DC\"\n",
 			network->getName().c_str(), id,
 			packet->getId(),
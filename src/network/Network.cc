@@ -909,7 +909,7 @@ Message *Network::Send(EndNode *source_node,
 	Message *message = newMessage(source_node, destination_node, size);
 
 	// Updating trace with new message creation
-	net::System::trace << misc::fmt("net.new_msg net=\"%s\" "
+	net::System::trace.fmt("net.new_msg net=\"%s\" "
 			"name=\"M-%lld\" size=%d state=\"%s:create\"\n",
 			name.c_str(), message->getId(),
 			message->getSize(), source_node->getName().c_str());
@@ -921,13 +921,13 @@ Message *Network::Send(EndNode *source_node,
 		message->Packetize(packet_size);
 
 	// Updating the trace with the message's packetization information
-	net::System::trace << misc::fmt("net.msg net=\"%s\" name=\"M-%lld\" "
+	net::System::trace.fmt("net.msg net=\"%s\" name=\"M-%lld\" "
 			"state=\"%s:packetize\"\n",
 			name.c_str(), message->getId(),
 			source_node->getName().c_str());
 
 	// Debug information
-	System::debug << misc::fmt("net: %s - send M-%lld "
+	System::debug.fmt("net: %s - send M-%lld "
 			"'%s'-->'%s'\n",
 			name.c_str(),
 			message->getId(),
@@ -940,14 +940,14 @@ Message *Network::Send(EndNode *source_node,
 		Packet *packet = message->getPacket(i);
 
 		// Update the trace with the new packet and its state
-		net::System::trace << misc::fmt("net.new_packet net=\"%s\" "
+		net::System::trace.fmt("net.new_packet net=\"%s\" "
 				"name=\"P-%lld:%d\" size=%d state=\"%s:packetizer\"\n",
 				name.c_str(), message->getId(),
 				packet->getId(), packet->getSize(),
 				source_node->getName().c_str());
 
 		// Update the trace with the new packet association
-		net::System::trace << misc::fmt("net.packet_msg net=\"%s\" "
+		net::System::trace.fmt("net.packet_msg net=\"%s\" "
 				"name=\"P-%lld:%d\" message=\"M-%lld\"\n",
 				name.c_str(), message->getId(),
 				packet->getId(), message->getId());
@@ -1037,7 +1037,7 @@ void Network::Receive(EndNode *node, Message *message)
 
 			// Updating the trace with extraction of the packet
 			// from the buffer
-			System::trace << misc::fmt("net.packet_extract "
+			System::trace.fmt("net.packet_extract "
 					"net=\"%s\" node=\"%s\" buffer=\"%s\" "
 					"name=\"P-%lld:%d\" occpncy=%d\n",
 					name.c_str(),
@@ -1049,20 +1049,20 @@ void Network::Receive(EndNode *node, Message *message)
 
 		// Updating the trace with end of packet
 		// transmission information
-		System::trace << misc::fmt("net.end_packet net=\"%s\" "
+		System::trace.fmt("net.end_packet net=\"%s\" "
 				"name=\"P-%lld:%d\"\n",
 				name.c_str(), message->getId(),
 				packet->getId());
 	}
 
 	// Dump debug information
-	System::debug << misc::fmt("net: %s - M-%lld rcv'd at %s\n",
+	System::debug.fmt("net: %s - M-%lld rcv'd at %s\n",
 			name.c_str(),
 			message->getId(),
 			node->getName().c_str());
 
 	// Updating the trace with the end of the message
-	System::trace << misc::fmt("net.end_msg net=\"%s\" name=\"M-%lld\"\n",
+	System::trace.fmt("net.end_msg net=\"%s\" name=\"M-%lld\"\n",
 			name.c_str(), message->getId());
 
 	// Destroy the message
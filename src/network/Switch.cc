@@ -81,7 +81,7 @@ void Switch::Forward(Packet *packet)
 	if (input_buffer->read_busy >= cycle)
 	{
 		// Update debug information
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
+		System::debug.fmt("net: %s - M-%lld:%d - "
 				"stl_busy_sw_src_buf: %s:%s\n",
 				network->getName().c_str(),
 				message->getId(),
@@ -112,7 +112,7 @@ void Switch::Forward(Packet *packet)
 	if (output_buffer->write_busy >= cycle)
 	{
 		// Update debug information
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
+		System::debug.fmt("net: %s - M-%lld:%d - "
 				"stl_busy_sw_dst_buf: %s:%s\n",
 				network->getName().c_str(),
 				message->getId(),
@@ -122,7 +122,7 @@ void Switch::Forward(Packet *packet)
 				output_buffer->getName().c_str());
 
 		// Update trace information
-		System::trace << misc::fmt("net.packet "
+		System::trace.fmt("net.packet "
 				"net=\"%s\" "
 				"name=\"P-%lld:%d\" "
 				"state=\"%s:%s:Dest_buffer_busy\" "
@@ -151,7 +151,7 @@ void Switch::Forward(Packet *packet)
 			output_buffer->getSize())
 	{
 		// Update debug information
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
+		System::debug.fmt("net: %s - M-%lld:%d - "
 				"stl_full_sw_dst_buf: %s:%s\n",
 				network->getName().c_str(),
 				message->getId(),
@@ -161,7 +161,7 @@ void Switch::Forward(Packet *packet)
 				output_buffer->getName().c_str());
 
 		// Update trace information
-		System::trace << misc::fmt("net.packet "
+		System::trace.fmt("net.packet "
 				"net=\"%s\" "
 				"name=\"P-%lld:%d\" "
 				"state=\"%s:%s:Dest_buffer_full\" "
@@ -181,7 +181,7 @@ void Switch::Forward(Packet *packet)
 	if (Schedule(output_buffer) != input_buffer)
 	{
 		// Update debug information
-		System::debug << misc::fmt("net: %s - M-%lld:%d - "
+		System::debug.fmt("net: %s - M-%lld:%d - "
 				"stl_sw_arb: %s\n",
 				network->getName().c_str(),
 				message->getId(),
@@ -204,7 +204,7 @@ void Switch::Forward(Packet *packet)
 	packet->setBusy(cycle + latency - 1);
 
 	// Buffer's trace information
-	System::trace << misc::fmt("net.packet_extract "
+	System::trace.fmt("net.packet_extract "
 			"net=\"%s\" node=\"%s\" buffer=\"%s\" "
 			"name=\"P-%lld:%d\" occpncy=%d\n",
 			network->getName().c_str(),
@@ -213,7 +213,7 @@ void Switch::Forward(Packet *packet)
 			message->getId(), packet->getId(),
 			input_buffer->getOccupancyInBytes());
 
-	System::trace << misc::fmt("net.packet_insert net=\"%s\" "
+	System::trace.fmt("net.packet_insert net=\"%s\" "
 			"node=\"%s\" buffer=\"%s\" "
 			"name=\"P-%lld:%d\" occpncy=%d\n",
 			network->getName().c_str(),
@@ -299,7 +299,7 @@ void System::UniformTrafficSimulation(Network *network)
 		}
 
 		// Next cycle
-		debug << misc::fmt("___ cycle %lld ___\n", cycle);	
+		debug.fmt("___ cycle %lld ___\n", cycle);	
 		esim_engine->ProcessEvents();
 	}
 }
@@ -55,7 +55,7 @@ void System::EventTypeSendHandler(esim::Event *event,
 	if (network->hasConstantLatency())
 	{
 		// Debug Information
-		debug << misc::fmt("net: %s - M-%lld:%d -"
+		debug.fmt("net: %s - M-%lld:%d -"
 				"fix_lat=%d\n",
 				network->getName().c_str(),
 				message->getId(),
@@ -107,7 +107,7 @@ void System::EventTypeSendHandler(esim::Event *event,
 	packet->setBusy(cycle);
 
 	// Update trace with buffer information
-	System::trace << misc::fmt("net.packet_insert "
+	System::trace.fmt("net.packet_insert "
 			"net=\"%s\" node=\"%s\" buffer=\"%s\" "
 			"name=\"P-%lld:%d\" occpncy=%d\n",
 			network->getName().c_str(),
@@ -164,7 +164,7 @@ void System::EventTypeInputBufferHandler(esim::Event *event,
 	if (buffer->getBufferHead() != packet)
 	{
 		// Debug info
-		debug << misc::fmt("net: %s - M-%lld:%d -"
+		debug.fmt("net: %s - M-%lld:%d -"
 				"stl_not_buf_head: %s:%s\n",
 				network->getName().c_str(),
 				message->getId(),
@@ -214,7 +214,7 @@ void System::EventTypeReceiveHandler(esim::Event *event,
 			// Produce the depacketize in the trace, if message
 			// was packetized
 			if (message->getNumPackets() > 1)
-				System::trace << misc::fmt("net.msg net=\"%s\" "
+				System::trace.fmt("net.msg net=\"%s\" "
 						"name=\"M-%lld\" "
 						"state=\"%s:depacketize\"\n",
 						network->getName().c_str(),
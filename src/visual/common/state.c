@@ -17,6 +17,8 @@
  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <limits.h>
+
 #include <gtk/gtk.h>
 
 #include <lib/mhandle/mhandle.h>
@@ -42,21 +44,22 @@ struct vi_state_checkpoint_t
 {
 	long long cycle;
 
-	/* Position in files */
-	long int unzipped_trace_file_offset;
+	/* Position in files. The trace position is an offset in the
+	 * uncompressed trace file, or a position in the binary trace. */
+	long long trace_offset;
 	long int checkpoint_file_offset;
 };
 
 
 struct vi_state_checkpoint_t *vi_state_checkpoint_create(long long cycle,
-	long int unzipped_trace_file_offset, long int checkpoint_file_offset)
+	long long trace_offset, long int checkpoint_file_offset)
 {
 	struct vi_state_checkpoint_t *checkpoint;
 
 	/* Initialize */
 	checkpoint = xcalloc(1, sizeof(struct vi_state_checkpoint_t));
 	checkpoint->cycle = cycle;
-	checkpoint->unzipped_trace_file_offset = unzipped_trace_file_offset;
+	checkpoint->trace_offset = trace_offset;
 	checkpoint->checkpoint_file_offset = checkpoint_file_offset;
 	
 	/* Return */
@@ -161,6 +164,10 @@ struct vi_state_t
 	char *unzipped_trace_file_name;
 	FILE *unzipped_trace_file;
 
+	/* Binary trace, read in place instead of uncompressing it, using its
+	 * block index to seek. NULL for text traces. */
+	struct vi_trace_t *trace;
+
 	/* Checkpoint file */
 	char *checkpoint_file_name;
 	FILE *checkpoint_file;
@@ -181,17 +188,43 @@ struct vi_state_t
 
 	/* Enumeration of header trace lines */
 	struct vi_trace_line_t *header_trace_line;
-	long int header_trace_line_offset;
+	long long header_trace_line_offset;
 
 	/* Enumeration of body trace lines */
 	struct vi_trace_line_t *body_trace_line;
-	long int body_trace_line_offset;
+	long long body_trace_line_offset;
 };
 
 
 static struct vi_state_t *vi_state;
 
 
+/* Read the next line from the uncompressed trace file or the binary trace */
+static struct vi_trace_line_t *vi_state_read_trace_line(void)
+{
+	if (vi_state->trace)
+		return vi_trace_line_create_from_trace(vi_state->trace);
+	return vi_trace_line_create_from_file(vi_state->unzipped_trace_file);
+}
+
+
+static long long vi_state_tell_trace(void)
+{
+	if (vi_state->trace)
+		return vi_trace_tell(vi_state->trace);
+	return ftell(vi_state->unzipped_trace_file);
+}
+
+
+static void vi_state_seek_trace(long long offset)
+{
+	if (vi_state->trace)
+		vi_trace_seek(vi_state->trace, offset);
+	else
+		fseek(vi_state->unzipped_trace_file, offset, SEEK_SET);
+}
+
+
 static void vi_state_read_checkpoint(int index)
 {
 	struct vi_state_checkpoint_t *checkpoint;
@@ -205,7 +238,7 @@ static void vi_state_read_checkpoint(int index)
 
 	/* Set file positions */
 	fseek(vi_state->checkpoint_file, checkpoint->checkpoint_file_offset, SEEK_SET);
-	fseek(vi_state->unzipped_trace_file, checkpoint->unzipped_trace_file_offset, SEEK_SET);
+	vi_state_seek_trace(checkpoint->trace_offset);
 	vi_state->cycle = checkpoint->cycle;
 
 	/* Read checkpoint for every category */
@@ -245,10 +278,6 @@ void vi_state_init(const char *trace_file_name)
 	/* Create */
 	vi_state = xcalloc(1, sizeof(struct vi_state_t));
 	
-	/* Create uncompressed trace file */
-	vi_state->unzipped_trace_file = file_create_temp(buf, sizeof buf);
-	vi_state->unzipped_trace_file_name = xstrdup(buf);
-
 	/* Create checkpoint file */
 	vi_state->checkpoint_file = file_create_temp(buf, sizeof buf);
 	vi_state->checkpoint_file_name = xstrdup(buf);
@@ -258,9 +287,31 @@ void vi_state_init(const char *trace_file_name)
 	vi_state->category_list = list_create();
 	vi_state->command_table = hash_table_create(0, FALSE);
 
+	/* Binary traces are read in place. The number of cycles is taken from
+	 * the last block in the index, or from the whole trace if it has no
+	 * index, in which case the index is built while reading it. */
+	trace_file = vi_trace_create(trace_file_name);
+	if (vi_trace_is_binary(trace_file))
+	{
+		vi_state->trace = trace_file;
+		vi_trace_seek_cycle(trace_file, LLONG_MAX);
+		while ((trace_line = vi_trace_line_create_from_trace(trace_file)))
+		{
+			if (!strcmp(vi_trace_line_get_command(trace_line), "c"))
+				vi_state->num_cycles = vi_trace_line_get_symbol_long_long(trace_line, "clk");
+			vi_trace_line_free(trace_line);
+		}
+		printf("Binary trace (%lld cycles)\n", vi_state->num_cycles);
+		fflush(stdout);
+		return;
+	}
+
+	/* Create uncompressed trace file */
+	vi_state->unzipped_trace_file = file_create_temp(buf, sizeof buf);
+	vi_state->unzipped_trace_file_name = xstrdup(buf);
+
 	/* Unpack trace */
 	num_trace_lines = 0;
-	trace_file = vi_trace_create(trace_file_name);
 	while ((trace_line = vi_trace_line_create_from_trace(trace_file)))
 	{
 		/* Copy trace */
@@ -297,9 +348,16 @@ void vi_state_done(void)
 
 	int i;
 
-	/* Close and delete uncompressed trace file */
-	fclose(vi_state->unzipped_trace_file);
-	unlink(vi_state->unzipped_trace_file_name);
+	/* Close binary trace, or close and delete uncompressed trace file */
+	if (vi_state->trace)
+	{
+		vi_trace_free(vi_state->trace);
+	}
+	else
+	{
+		fclose(vi_state->unzipped_trace_file);
+		unlink(vi_state->unzipped_trace_file_name);
+	}
 
 	/* Close and detele checkpoint file */
 	fclose(vi_state->checkpoint_file);
@@ -363,17 +421,22 @@ void vi_state_create_checkpoints(void)
 	int num_trace_lines;
 
 	/* Get unzipped trace file size */
-	fseek(vi_state->unzipped_trace_file, 0, SEEK_END);
-	unzipped_trace_file_size = ftell(vi_state->unzipped_trace_file);
+	unzipped_trace_file_size = 0;
+	if (!vi_state->trace)
+	{
+		fseek(vi_state->unzipped_trace_file, 0, SEEK_END);
+		unzipped_trace_file_size = ftell(vi_state->unzipped_trace_file);
+	}
 
 	/* Initialize */
 	last_checkpoint_cycle = -VI_STATE_CHECKPOINT_INTERVAL;
-	fseek(vi_state->unzipped_trace_file, 0, SEEK_SET);
+	vi_state_seek_trace(0);
 
-	/* Parse uncompressed trace file */
+	/* Parse uncompressed trace file or binary trace. Checkpoints in a
+	 * binary trace point to the cycle record in its block. */
 	num_trace_lines = 0;
 	vi_state->cycle = 0;
-	while ((trace_line = vi_trace_line_create_from_file(vi_state->unzipped_trace_file)))
+	while ((trace_line = vi_state_read_trace_line()))
 	{
 		struct vi_state_checkpoint_t *checkpoint;
 		struct vi_state_command_t *state_command;
@@ -413,6 +476,9 @@ void vi_state_create_checkpoints(void)
 		{
 			printf("Creating checkpoints (%.1fMB, %.1f%%)   \r",
 				ftell(vi_state->checkpoint_file) / 1.048e6,
+				vi_state->trace ?
+				(vi_state->num_cycles ? (double) vi_state->cycle * 100.0 /
+				vi_state->num_cycles : 0.0) :
 				unzipped_trace_file_size ?
 				(double) ftell(vi_state->unzipped_trace_file) * 100.0 /
 				unzipped_trace_file_size : 0.0);
@@ -485,8 +551,8 @@ struct vi_trace_line_t *vi_state_header_next(void)
 		return NULL;
 
 	/* Read trace line */
-	fseek(vi_state->unzipped_trace_file, vi_state->header_trace_line_offset, SEEK_SET);
-	trace_line = vi_trace_line_create_from_file(vi_state->unzipped_trace_file);
+	vi_state_seek_trace(vi_state->header_trace_line_offset);
+	trace_line = vi_state_read_trace_line();
 	if (!trace_line)
 	{
 		vi_state->header_trace_line_offset = -1;
@@ -503,14 +569,14 @@ struct vi_trace_line_t *vi_state_header_next(void)
 
 	/* Save trace line and return */
 	vi_state->header_trace_line = trace_line;
-	vi_state->header_trace_line_offset = ftell(vi_state->unzipped_trace_file);
+	vi_state->header_trace_line_offset = vi_state_tell_trace();
 	return trace_line;
 }
 
 
 struct vi_trace_line_t *vi_state_trace_line_first(long long cycle)
 {
-	long int trace_file_offset;
+	long long trace_file_offset;
 
 	int checkpoint_index;
 
@@ -530,7 +596,7 @@ struct vi_trace_line_t *vi_state_trace_line_first(long long cycle)
 		return NULL;
 
 	/* Store current position in trace file */
-	trace_file_offset = ftell(vi_state->unzipped_trace_file);
+	trace_file_offset = vi_state_tell_trace();
 
 	/* Get closest checkpoint */
 	checkpoint_index = cycle / VI_STATE_CHECKPOINT_INTERVAL;
@@ -540,13 +606,13 @@ struct vi_trace_line_t *vi_state_trace_line_first(long long cycle)
 		panic("%s: invalid checkpoint index", __FUNCTION__);
 
 	/* Set position in trace file */
-	fseek(vi_state->unzipped_trace_file, checkpoint->unzipped_trace_file_offset, SEEK_SET);
-	vi_state->body_trace_line_offset = checkpoint->unzipped_trace_file_offset;
+	vi_state_seek_trace(checkpoint->trace_offset);
+	vi_state->body_trace_line_offset = checkpoint->trace_offset;
 	for (;;)
 	{
 		/* Read trace line */
-		vi_state->body_trace_line = vi_trace_line_create_from_file(vi_state->unzipped_trace_file);
-		vi_state->body_trace_line_offset = checkpoint->unzipped_trace_file_offset;
+		vi_state->body_trace_line = vi_state_read_trace_line();
+		vi_state->body_trace_line_offset = checkpoint->trace_offset;
 		if (!vi_state->body_trace_line || checkpoint_cycle == cycle)
 			break;
 
@@ -561,7 +627,7 @@ struct vi_trace_line_t *vi_state_trace_line_first(long long cycle)
 	}
 
 	/* Return to original position in trace file */
-	fseek(vi_state->unzipped_trace_file, trace_file_offset, SEEK_SET);
+	vi_state_seek_trace(trace_file_offset);
 	return vi_state->body_trace_line;
 }
 
@@ -571,7 +637,7 @@ struct vi_trace_line_t *vi_state_trace_line_next(void)
 	long long trace_file_offset;
 
 	/* Store current position in trace file */
-	trace_file_offset = ftell(vi_state->unzipped_trace_file);
+	trace_file_offset = vi_state_tell_trace();
 
 	/* Release previous body trace line if any */
 	if (vi_state->body_trace_line)
@@ -581,12 +647,12 @@ struct vi_trace_line_t *vi_state_trace_line_next(void)
 	}
 
 	/* Get next trace line */
-	fseek(vi_state->unzipped_trace_file, vi_state->body_trace_line_offset, SEEK_SET);
-	vi_state->body_trace_line = vi_trace_line_create_from_file(vi_state->unzipped_trace_file);
-	vi_state->body_trace_line_offset = ftell(vi_state->unzipped_trace_file);
+	vi_state_seek_trace(vi_state->body_trace_line_offset);
+	vi_state->body_trace_line = vi_state_read_trace_line();
+	vi_state->body_trace_line_offset = vi_state_tell_trace();
 
 	/* Return to original position in trace file */
-	fseek(vi_state->unzipped_trace_file, trace_file_offset, SEEK_SET);
+	vi_state_seek_trace(trace_file_offset);
 	return vi_state->body_trace_line;
 }
 
@@ -611,12 +677,12 @@ void vi_state_go_to_cycle(long long cycle)
 	{
 		struct vi_trace_line_t *trace_line;
 		struct vi_state_command_t *state_command;
-		long int unzipped_trace_file_pos;
+		long long unzipped_trace_file_pos;
 		char *command;
 
 		/* Read a trace line */
-		unzipped_trace_file_pos = ftell(vi_state->unzipped_trace_file);
-		trace_line = vi_trace_line_create_from_file(vi_state->unzipped_trace_file);
+		unzipped_trace_file_pos = vi_state_tell_trace();
+		trace_line = vi_state_read_trace_line();
 		if (!trace_line)
 			break;
 
@@ -632,7 +698,7 @@ void vi_state_go_to_cycle(long long cycle)
 			/* If we passed the target cycle, done */
 			if (new_cycle > cycle)
 			{
-				fseek(vi_state->unzipped_trace_file, unzipped_trace_file_pos, SEEK_SET);
+				vi_state_seek_trace(unzipped_trace_file_pos);
 				vi_trace_line_free(trace_line);
 				break;
 			}
@@ -26,10 +26,37 @@
 #include <lib/util/hash-table.h>
 #include <lib/util/string.h>
 
+#include "trace.h"
 
 
 
 
+
+/* Binary trace format generated by 'm2s --trace-binary'. See the
+ * description of the format in 'src/lib/esim/BinaryTrace.h'. */
+#define VI_TRACE_BINARY_MAGIC "m2strace"
+#define VI_TRACE_BINARY_INDEX_MAGIC "m2sindex"
+#define VI_TRACE_BINARY_VERSION 2
+#define VI_TRACE_BINARY_HEADER_SIZE 12
+#define VI_TRACE_BINARY_FOOTER_SIZE 16
+
+enum vi_trace_binary_record_t
+{
+	vi_trace_binary_record_string = 0,
+	vi_trace_binary_record_cycle,
+	vi_trace_binary_record_line,
+	vi_trace_binary_record_raw
+};
+
+enum vi_trace_binary_value_t
+{
+	vi_trace_binary_value_string = 0,
+	vi_trace_binary_value_int = 2,
+	vi_trace_binary_value_hex = 4,
+	vi_trace_binary_value_prefix_int = 6
+};
+
+
 struct vi_trace_t
 {
 	char *name;
@@ -38,6 +65,27 @@ struct vi_trace_t
 	/* Last line number read from zip file with a call to
 	 * 'vi_trace_line_create_from_trace'. */
 	int line_num;
+
+	/* Binary trace */
+	int binary;
+	FILE *binary_f;
+
+	/* Current decompressed block, its position in the list of blocks,
+	 * and position of the next record. */
+	unsigned char *block;
+	unsigned int block_size;
+	unsigned int block_pos;
+	int block_index;
+
+	/* Blocks listed in the index, or read so far if the trace has no
+	 * index, with their offset in the file and first cycle. */
+	long int *block_offsets;
+	long long *block_cycles;
+	int num_blocks;
+
+	/* String table */
+	char **strings;
+	int num_strings;
 };
 
 
@@ -50,8 +98,9 @@ struct vi_trace_line_t
 	char *command;
 	struct hash_table_t *symbol_table;
 
-	/* Offset in the file where it was read from */
-	long int offset;
+	/* Offset in the file where it was read from, or position in a
+	 * binary trace as returned by 'vi_trace_tell' */
+	long long offset;
 };
 
 
@@ -140,27 +189,14 @@ struct vi_trace_line_t *vi_trace_line_create_from_file(FILE *f)
 }
 
 
-struct vi_trace_line_t *vi_trace_line_create_from_trace(struct vi_trace_t *trace)
+/* Create a trace line from its text. The contents of 'buf' are modified. */
+static struct vi_trace_line_t *vi_trace_line_create_from_text(struct vi_trace_t *trace,
+	char *buf, long long offset)
 {
 	struct vi_trace_line_t *line;
 
-	long int offset;
-
-	char buf[4096];
 	char *buf_ptr;
 
-	/* Read line from trace file */
-	offset = gztell(trace->f);
-	buf_ptr = gzgets(trace->f, buf, sizeof buf);
-
-	/* Empty line */
-	if (!buf_ptr)
-		return NULL;
-
-	/* Line too long */
-	if (strlen(buf) == sizeof(buf) - 1)
-		fatal("%s: buffer too small", __FUNCTION__);
-
 	/* Initialize */
 	line = xcalloc(1, sizeof(struct vi_trace_line_t));
 	trace->line_num++;
@@ -169,6 +205,7 @@ struct vi_trace_line_t *vi_trace_line_create_from_trace(struct vi_trace_t *trace
 	line->symbol_table = hash_table_create(13, FALSE);
 
 	/* Read command */
+	buf_ptr = buf;
 	while (isspace(*buf_ptr))
 		buf_ptr++;
 	line->command = buf_ptr;
@@ -229,6 +266,283 @@ struct vi_trace_line_t *vi_trace_line_create_from_trace(struct vi_trace_t *trace
 }
 
 
+static unsigned long long vi_trace_binary_read_varint(struct vi_trace_t *trace);
+
+
+/* Read the block following the current one in a binary trace. Return FALSE
+ * if there are no more blocks. */
+static int vi_trace_binary_read_block(struct vi_trace_t *trace)
+{
+	unsigned char sizes[8];
+	unsigned char *compressed;
+
+	unsigned int raw_size;
+	unsigned int compressed_size;
+	uLongf size;
+	long int offset;
+
+	int err;
+	int i;
+
+	/* Block sizes. A truncated block at the end of a trace without end
+	 * marker is ignored. */
+	offset = ftell(trace->binary_f);
+	if (fread(sizes, 1, 8, trace->binary_f) != 8)
+		return FALSE;
+	raw_size = 0;
+	compressed_size = 0;
+	for (i = 0; i < 4; i++)
+	{
+		raw_size |= (unsigned int) sizes[i] << (i * 8);
+		compressed_size |= (unsigned int) sizes[i + 4] << (i * 8);
+	}
+
+	/* End of blocks */
+	if (!raw_size && !compressed_size)
+		return FALSE;
+	compressed = xmalloc(compressed_size + 1);
+	if (fread(compressed, 1, compressed_size, trace->binary_f) != compressed_size)
+	{
+		free(compressed);
+		return FALSE;
+	}
+
+	/* Decompress */
+	trace->block = xrealloc(trace->block, raw_size + 1);
+	size = raw_size;
+	err = uncompress(trace->block, &size, compressed, compressed_size);
+	free(compressed);
+	if (err != Z_OK || size != raw_size)
+		fatal("%s: corrupted trace block", trace->name);
+	trace->block_size = raw_size;
+	trace->block_pos = 0;
+	trace->block_index++;
+
+	/* Add block to the list if the trace has no index. Every block except
+	 * the one with header lines starts with a cycle record. */
+	if (trace->block_index == trace->num_blocks)
+	{
+		trace->num_blocks++;
+		trace->block_offsets = xrealloc(trace->block_offsets,
+			trace->num_blocks * sizeof(long int));
+		trace->block_cycles = xrealloc(trace->block_cycles,
+			trace->num_blocks * sizeof(long long));
+		trace->block_offsets[trace->block_index] = offset;
+		trace->block_cycles[trace->block_index] = -1;
+		if (trace->block[0] == vi_trace_binary_record_cycle)
+		{
+			trace->block_pos = 1;
+			trace->block_cycles[trace->block_index] =
+				vi_trace_binary_read_varint(trace);
+			trace->block_pos = 0;
+		}
+	}
+	return TRUE;
+}
+
+
+static unsigned long long vi_trace_binary_read_varint(struct vi_trace_t *trace)
+{
+	unsigned long long value;
+	unsigned char byte;
+	int shift;
+
+	value = 0;
+	for (shift = 0; shift < 64 && trace->block_pos < trace->block_size; shift += 7)
+	{
+		byte = trace->block[trace->block_pos++];
+		value |= (unsigned long long) (byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+			return value;
+	}
+	fatal("%s: corrupted trace block", trace->name);
+	return 0;
+}
+
+
+static char *vi_trace_binary_get_string(struct vi_trace_t *trace, unsigned long long id)
+{
+	if (id >= trace->num_strings || !trace->strings[id])
+		fatal("%s: undefined string %llu", trace->name, id);
+	return trace->strings[id];
+}
+
+
+/* Read the next line of a binary trace */
+static struct vi_trace_line_t *vi_trace_binary_read_line(struct vi_trace_t *trace)
+{
+	struct vi_trace_line_t *line;
+
+	unsigned long long id;
+	unsigned long long size;
+	unsigned long long num_symbols;
+	unsigned long long value;
+	unsigned long long i;
+
+	long long offset;
+
+	char buf[4096];
+	char *symbol_name;
+	char *value_str;
+	char *prefix;
+	int kind;
+
+	for (;;)
+	{
+		/* Next block */
+		while (trace->block_pos >= trace->block_size)
+			if (!vi_trace_binary_read_block(trace))
+				return NULL;
+
+		/* Position of the record */
+		offset = vi_trace_tell(trace);
+
+		/* Record type */
+		switch (trace->block[trace->block_pos++])
+		{
+
+		case vi_trace_binary_record_string:
+
+			/* Define string */
+			id = vi_trace_binary_read_varint(trace);
+			size = vi_trace_binary_read_varint(trace);
+			if (id > (1 << 30) || trace->block_pos + size > trace->block_size)
+				fatal("%s: corrupted trace block", trace->name);
+			if (id >= trace->num_strings)
+			{
+				trace->strings = xrealloc(trace->strings, (id + 1) * sizeof(char *));
+				memset(trace->strings + trace->num_strings, 0,
+					(id + 1 - trace->num_strings) * sizeof(char *));
+				trace->num_strings = id + 1;
+			}
+			free(trace->strings[id]);
+			trace->strings[id] = xmalloc(size + 1);
+			memcpy(trace->strings[id], trace->block + trace->block_pos, size);
+			trace->strings[id][size] = '\0';
+			trace->block_pos += size;
+			break;
+
+		case vi_trace_binary_record_cycle:
+
+			/* Cycle */
+			value = vi_trace_binary_read_varint(trace);
+			line = xcalloc(1, sizeof(struct vi_trace_line_t));
+			trace->line_num++;
+			line->offset = offset;
+			line->line_num = trace->line_num;
+			line->symbol_table = hash_table_create(13, FALSE);
+			line->command = xstrdup("c");
+			snprintf(buf, sizeof buf, "%lld", (long long) value);
+			hash_table_insert(line->symbol_table, "clk", xstrdup(buf));
+			return line;
+
+		case vi_trace_binary_record_line:
+
+			/* Command */
+			line = xcalloc(1, sizeof(struct vi_trace_line_t));
+			trace->line_num++;
+			line->offset = offset;
+			line->line_num = trace->line_num;
+			line->symbol_table = hash_table_create(13, FALSE);
+			line->command = xstrdup(vi_trace_binary_get_string(trace,
+				vi_trace_binary_read_varint(trace)));
+
+			/* Symbols */
+			num_symbols = vi_trace_binary_read_varint(trace);
+			for (i = 0; i < num_symbols; i++)
+			{
+				symbol_name = vi_trace_binary_get_string(trace,
+					vi_trace_binary_read_varint(trace));
+				if (trace->block_pos >= trace->block_size)
+					fatal("%s: corrupted trace block", trace->name);
+				kind = trace->block[trace->block_pos++] & ~1;
+				switch (kind)
+				{
+
+				case vi_trace_binary_value_string:
+
+					value_str = xstrdup(vi_trace_binary_get_string(trace,
+						vi_trace_binary_read_varint(trace)));
+					break;
+
+				case vi_trace_binary_value_int:
+
+					value = vi_trace_binary_read_varint(trace);
+					snprintf(buf, sizeof buf, "%lld", (long long)
+						(value >> 1) ^ -(long long) (value & 1));
+					value_str = xstrdup(buf);
+					break;
+
+				case vi_trace_binary_value_hex:
+
+					snprintf(buf, sizeof buf, "0x%llx",
+						vi_trace_binary_read_varint(trace));
+					value_str = xstrdup(buf);
+					break;
+
+				case vi_trace_binary_value_prefix_int:
+
+					prefix = vi_trace_binary_get_string(trace,
+						vi_trace_binary_read_varint(trace));
+					snprintf(buf, sizeof buf, "%s%lld", prefix,
+						(long long) vi_trace_binary_read_varint(trace));
+					value_str = xstrdup(buf);
+					break;
+
+				default:
+
+					fatal("%s: invalid value type", trace->name);
+					value_str = NULL;
+				}
+				hash_table_insert(line->symbol_table, symbol_name, value_str);
+			}
+			return line;
+
+		case vi_trace_binary_record_raw:
+
+			/* Line not following the trace syntax */
+			size = vi_trace_binary_read_varint(trace);
+			if (trace->block_pos + size > trace->block_size)
+				fatal("%s: corrupted trace block", trace->name);
+			if (size >= sizeof buf)
+				fatal("%s: buffer too small", __FUNCTION__);
+			memcpy(buf, trace->block + trace->block_pos, size);
+			buf[size] = '\0';
+			trace->block_pos += size;
+			return vi_trace_line_create_from_text(trace, buf, offset);
+
+		default:
+
+			fatal("%s: invalid record type", trace->name);
+		}
+	}
+}
+
+
+struct vi_trace_line_t *vi_trace_line_create_from_trace(struct vi_trace_t *trace)
+{
+	long int offset;
+
+	char buf[4096];
+
+	/* Binary trace */
+	if (trace->binary)
+		return vi_trace_binary_read_line(trace);
+
+	/* Read line from trace file */
+	offset = gztell(trace->f);
+	if (!gzgets(trace->f, buf, sizeof buf))
+		return NULL;
+
+	/* Line too long */
+	if (strlen(buf) == sizeof(buf) - 1)
+		fatal("%s: buffer too small", __FUNCTION__);
+
+	/* Parse */
+	return vi_trace_line_create_from_text(trace, buf, offset);
+}
+
+
 void vi_trace_line_free(struct vi_trace_line_t *line)
 {
 	char *symbol_name;
@@ -295,7 +609,7 @@ void vi_trace_line_dump_plain_text(struct vi_trace_line_t *line, FILE *f)
 }
 
 
-long int vi_trace_line_get_offset(struct vi_trace_line_t *line)
+long long vi_trace_line_get_offset(struct vi_trace_line_t *line)
 {
 	return line->offset;
 }
@@ -358,6 +672,141 @@ unsigned int vi_trace_line_get_symbol_hex(struct vi_trace_line_t *line, char *sy
  */
 
 
+/* Read fixed-size little-endian integers from a binary trace. Return FALSE on
+ * end of file. */
+static int vi_trace_binary_read_uint32(FILE *f, unsigned int *value)
+{
+	unsigned char bytes[4];
+	int i;
+
+	if (fread(bytes, 1, 4, f) != 4)
+		return FALSE;
+	*value = 0;
+	for (i = 0; i < 4; i++)
+		*value |= (unsigned int) bytes[i] << (i * 8);
+	return TRUE;
+}
+
+
+static int vi_trace_binary_read_uint64(FILE *f, unsigned long long *value)
+{
+	unsigned char bytes[8];
+	int i;
+
+	if (fread(bytes, 1, 8, f) != 8)
+		return FALSE;
+	*value = 0;
+	for (i = 0; i < 8; i++)
+		*value |= (unsigned long long) bytes[i] << (i * 8);
+	return TRUE;
+}
+
+
+/* Read the string table and the list of blocks from the index of a binary
+ * trace. Return FALSE if the trace has no index, which happens when the
+ * simulation did not finish. */
+static int vi_trace_binary_read_index(struct vi_trace_t *trace)
+{
+	FILE *f = trace->binary_f;
+
+	char magic[8];
+
+	unsigned long long index_offset;
+	unsigned long long offset;
+	unsigned long long cycle;
+	unsigned int num_strings;
+	unsigned int num_blocks;
+	unsigned int size;
+	unsigned int i;
+
+	long int file_size;
+
+	/* Footer */
+	fseek(f, 0, SEEK_END);
+	file_size = ftell(f);
+	if (file_size < VI_TRACE_BINARY_HEADER_SIZE + VI_TRACE_BINARY_FOOTER_SIZE)
+		return FALSE;
+	fseek(f, -VI_TRACE_BINARY_FOOTER_SIZE, SEEK_END);
+	if (!vi_trace_binary_read_uint64(f, &index_offset) ||
+		fread(magic, 1, 8, f) != 8 ||
+		memcmp(magic, VI_TRACE_BINARY_INDEX_MAGIC, 8) ||
+		index_offset > file_size)
+		return FALSE;
+
+	/* String table */
+	fseek(f, index_offset, SEEK_SET);
+	if (!vi_trace_binary_read_uint32(f, &num_strings))
+		fatal("%s: invalid index", trace->name);
+	trace->strings = xcalloc(num_strings + 1, sizeof(char *));
+	trace->num_strings = num_strings;
+	for (i = 0; i < num_strings; i++)
+	{
+		if (!vi_trace_binary_read_uint32(f, &size))
+			fatal("%s: invalid index", trace->name);
+		trace->strings[i] = xmalloc(size + 1);
+		if (fread(trace->strings[i], 1, size, f) != size)
+			fatal("%s: invalid index", trace->name);
+		trace->strings[i][size] = '\0';
+	}
+
+	/* Blocks */
+	if (!vi_trace_binary_read_uint32(f, &num_blocks))
+		fatal("%s: invalid index", trace->name);
+	trace->block_offsets = xcalloc(num_blocks + 1, sizeof(long int));
+	trace->block_cycles = xcalloc(num_blocks + 1, sizeof(long long));
+	trace->num_blocks = num_blocks;
+	for (i = 0; i < num_blocks; i++)
+	{
+		if (!vi_trace_binary_read_uint64(f, &offset) ||
+			!vi_trace_binary_read_uint64(f, &cycle))
+			fatal("%s: invalid index", trace->name);
+		trace->block_offsets[i] = offset;
+		trace->block_cycles[i] = cycle;
+	}
+	return TRUE;
+}
+
+
+/* Open the trace as a binary trace. Return FALSE if the file is not a binary
+ * trace. The string table and the list of blocks are taken from the index if
+ * the trace has one. Otherwise, they are built as blocks are read. */
+static int vi_trace_open_binary(struct vi_trace_t *trace)
+{
+	unsigned char header[VI_TRACE_BINARY_HEADER_SIZE];
+
+	unsigned int version;
+
+	FILE *f;
+	int i;
+
+	/* Check header */
+	f = fopen(trace->name, "rb");
+	if (!f)
+		return FALSE;
+	if (fread(header, 1, sizeof header, f) != sizeof header ||
+		memcmp(header, VI_TRACE_BINARY_MAGIC, 8))
+	{
+		fclose(f);
+		return FALSE;
+	}
+	version = 0;
+	for (i = 0; i < 4; i++)
+		version |= (unsigned int) header[i + 8] << (i * 8);
+	if (version != VI_TRACE_BINARY_VERSION)
+		fatal("%s: unsupported binary trace version %u", trace->name, version);
+
+	/* Index */
+	trace->binary = TRUE;
+	trace->binary_f = f;
+	vi_trace_binary_read_index(trace);
+
+	/* Blocks start right after the header */
+	fseek(f, VI_TRACE_BINARY_HEADER_SIZE, SEEK_SET);
+	trace->block_index = -1;
+	return TRUE;
+}
+
+
 struct vi_trace_t *vi_trace_create(const char *file_name)
 {
 	struct vi_trace_t *trace;
@@ -366,6 +815,10 @@ struct vi_trace_t *vi_trace_create(const char *file_name)
 	trace = xcalloc(1, sizeof(struct vi_trace_t));
 	trace->name = xstrdup(file_name);
 
+	/* Binary trace */
+	if (vi_trace_open_binary(trace))
+		return trace;
+
 	/* Open */
 	trace->f = gzopen(file_name, "r");
 	if (!trace->f)
@@ -378,8 +831,103 @@ struct vi_trace_t *vi_trace_create(const char *file_name)
 
 void vi_trace_free(struct vi_trace_t *trace)
 {
-	gzclose(trace->f);
+	int i;
+
+	/* Binary trace */
+	if (trace->binary)
+	{
+		fclose(trace->binary_f);
+		for (i = 0; i < trace->num_strings; i++)
+			free(trace->strings[i]);
+		free(trace->strings);
+		free(trace->block);
+		free(trace->block_offsets);
+		free(trace->block_cycles);
+	}
+	else
+	{
+		gzclose(trace->f);
+	}
+
+	/* Free */
 	free(trace->name);
 	free(trace);
 }
 
+
+int vi_trace_is_binary(struct vi_trace_t *trace)
+{
+	return trace->binary;
+}
+
+
+long long vi_trace_tell(struct vi_trace_t *trace)
+{
+	/* Text traces are not seekable */
+	if (!trace->binary)
+		panic("%s: not a binary trace", __FUNCTION__);
+
+	/* The position of a record is given by the index of its block in the
+	 * upper 32 bits, and its position in the block in the lower 32 bits. */
+	if (trace->block_pos >= trace->block_size)
+		return (long long) (trace->block_index + 1) << 32;
+	return ((long long) trace->block_index << 32) | trace->block_pos;
+}
+
+
+void vi_trace_seek(struct vi_trace_t *trace, long long position)
+{
+	int index;
+
+	/* Text traces are not seekable */
+	if (!trace->binary)
+		panic("%s: not a binary trace", __FUNCTION__);
+
+	/* Load block, unless it is the current one. Blocks are never empty,
+	 * so a block size of 0 means no block is loaded. */
+	index = position >> 32;
+	if (index != trace->block_index || !trace->block_size)
+	{
+		/* Past the last block */
+		if (index >= trace->num_blocks)
+		{
+			fseek(trace->binary_f, 0, SEEK_END);
+			trace->block_index = trace->num_blocks - 1;
+			trace->block_size = 0;
+			trace->block_pos = 0;
+			return;
+		}
+
+		/* Read it */
+		fseek(trace->binary_f, trace->block_offsets[index], SEEK_SET);
+		trace->block_index = index - 1;
+		if (!vi_trace_binary_read_block(trace))
+			fatal("%s: cannot read trace block", trace->name);
+	}
+
+	/* Position in block */
+	trace->block_pos = position & 0xffffffff;
+}
+
+
+void vi_trace_seek_cycle(struct vi_trace_t *trace, long long cycle)
+{
+	int i;
+
+	/* Text traces are not seekable */
+	if (!trace->binary)
+		panic("%s: not a binary trace", __FUNCTION__);
+
+	/* Find last block starting at or before the cycle */
+	i = 0;
+	while (i + 1 < trace->num_blocks && trace->block_cycles[i + 1] <= cycle)
+		i++;
+
+	/* Position at the beginning of the block, or at the first block if
+	 * none was read yet in a trace without index */
+	fseek(trace->binary_f, trace->num_blocks ? trace->block_offsets[i] :
+		VI_TRACE_BINARY_HEADER_SIZE, SEEK_SET);
+	trace->block_index = i - 1;
+	trace->block_size = 0;
+	trace->block_pos = 0;
+}
@@ -28,6 +28,11 @@ struct vi_trace_t;
 struct vi_trace_t *vi_trace_create(const char *file_name);
 void vi_trace_free(struct vi_trace_t *trace);
 
+int vi_trace_is_binary(struct vi_trace_t *trace);
+long long vi_trace_tell(struct vi_trace_t *trace);
+void vi_trace_seek(struct vi_trace_t *trace, long long position);
+void vi_trace_seek_cycle(struct vi_trace_t *trace, long long cycle);
+
 
 struct vi_trace_line_t;
 
@@ -38,7 +43,7 @@ void vi_trace_line_free(struct vi_trace_line_t *line);
 void vi_trace_line_dump(struct vi_trace_line_t *line, FILE *f);
 void vi_trace_line_dump_plain_text(struct vi_trace_line_t *line, FILE *f);
 
-long int vi_trace_line_get_offset(struct vi_trace_line_t *line);
+long long vi_trace_line_get_offset(struct vi_trace_line_t *line);
 
 char *vi_trace_line_get_command(struct vi_trace_line_t *line);
 char *vi_trace_line_get_symbol(struct vi_trace_line_t *line, char *symbol_name);
@@ -0,0 +1,356 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2014  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <arch/hsa/disassembler/Brig.h>
+#include <arch/hsa/driver/Driver.h>
+#include <arch/hsa/driver/HsaExecutable.h>
+#include <arch/hsa/driver/HsaExecutableSymbol.h>
+#include <arch/hsa/emulator/AQLPacket.h>
+#include <arch/hsa/emulator/Component.h>
+#include <arch/hsa/emulator/Emulator.h>
+#include <arch/hsa/emulator/Function.h>
+#include <arch/hsa/emulator/Grid.h>
+#include <lib/cpp/Error.h>
+#include <lib/cpp/Misc.h>
+#include <lib/cpp/Timer.h>
+#include <memory/Memory.h>
+
+
+// Benchmark of the HSA functional emulator, reporting the number of emulated
+// HSAIL instructions per second. A BRIG module is built in memory with one
+// kernel, where each work-item runs the following loop, and the kernel is
+// launched on a 1D grid.
+//
+//	mov_b32 $s0, 0;
+//	mov_b32 $s1, 0;
+//	@loop:
+//	add_u32 $s0, $s0, $s1;
+//	mul_u32 $s2, $s0, 3;
+//	add_u32 $s1, $s1, 1;
+//	cmp_lt_b1_u32 $c0, $s1, <num_iterations>;
+//	cbr_b1 $c0, @loop;
+//	ret;
+//
+// Run as
+//
+//	src_arch_hsa_benchmark [<num_work_items> [<num_iterations>]]
+//
+
+namespace HSA
+{
+
+// Builder of a BRIG module with a single kernel
+class BenchmarkBrigBuilder
+{
+	// Sections, including their headers
+	std::string data;
+	std::string code;
+	std::string operand;
+
+	// Initialize a section header
+	static void InitSection(std::string &section, const std::string &name)
+	{
+		unsigned name_offset = offsetof(BrigSectionHeader, name);
+		unsigned size = (name_offset + name.size() + 3) / 4 * 4;
+		section.assign(size, 0);
+		BrigSectionHeader *header = (BrigSectionHeader *) &section[0];
+		header->headerByteCount = size;
+		header->nameLength = name.size();
+		memcpy(&section[name_offset], name.data(), name.size());
+	}
+
+	// Append an entry to a section and return its offset
+	static unsigned Append(std::string &section, const void *entry,
+			unsigned size)
+	{
+		unsigned offset = section.size();
+		section.append((const char *) entry, size);
+		section.append((4 - size % 4) % 4, 0);
+		return offset;
+	}
+
+	// Append a data entry and return its offset
+	unsigned AddData(const void *bytes, unsigned size)
+	{
+		unsigned offset = data.size();
+		uint32_t byte_count = size;
+		data.append((const char *) &byte_count, 4);
+		data.append((const char *) bytes, size);
+		data.append((4 - size % 4) % 4, 0);
+		return offset;
+	}
+
+	// Append an instruction and return its offset
+	template<typename T> unsigned AddInst(T &inst, BrigKind kind,
+			BrigOpcode opcode, BrigType type,
+			const std::vector<unsigned> &operands)
+	{
+		BrigInstBase *base = (BrigInstBase *) &inst;
+		base->base.byteCount = sizeof inst;
+		base->base.kind = kind;
+		base->opcode = opcode;
+		base->type = type;
+		base->operands = AddData(operands.data(), operands.size() * 4);
+		return Append(code, &inst, sizeof inst);
+	}
+
+public:
+
+	BenchmarkBrigBuilder()
+	{
+		InitSection(data, "hsa_data");
+		InitSection(code, "hsa_code");
+		InitSection(operand, "hsa_operand");
+	}
+
+	// Kernel directive, returning its offset
+	unsigned AddKernel(const std::string &name)
+	{
+		BrigDirectiveExecutable dir;
+		memset(&dir, 0, sizeof dir);
+		dir.base.byteCount = sizeof dir;
+		dir.base.kind = BRIG_KIND_DIRECTIVE_KERNEL;
+		dir.name = AddData(name.data(), name.size());
+		dir.modifier.allBits = BRIG_EXECUTABLE_DEFINITION;
+		return Append(code, &dir, sizeof dir);
+	}
+
+	// Label directive
+	unsigned AddLabel(const std::string &name)
+	{
+		BrigDirectiveLabel dir;
+		dir.base.byteCount = sizeof dir;
+		dir.base.kind = BRIG_KIND_DIRECTIVE_LABEL;
+		dir.name = AddData(name.data(), name.size());
+		return Append(code, &dir, sizeof dir);
+	}
+
+	// Operands
+	unsigned AddRegister(BrigRegisterKind kind, unsigned number)
+	{
+		BrigOperandRegister reg;
+		reg.base.byteCount = sizeof reg;
+		reg.base.kind = BRIG_KIND_OPERAND_REGISTER;
+		reg.regKind = kind;
+		reg.regNum = number;
+		return Append(operand, &reg, sizeof reg);
+	}
+
+	unsigned AddImmediate(BrigType type, uint32_t value)
+	{
+		BrigOperandConstantBytes immed;
+		immed.base.byteCount = sizeof immed;
+		immed.base.kind = BRIG_KIND_OPERAND_CONSTANT_BYTES;
+		immed.type = type;
+		immed.reserved = 0;
+		immed.bytes = AddData(&value, 4);
+		return Append(operand, &immed, sizeof immed);
+	}
+
+	unsigned AddCodeRef(unsigned ref)
+	{
+		BrigOperandCodeRef code_ref;
+		code_ref.base.byteCount = sizeof code_ref;
+		code_ref.base.kind = BRIG_KIND_OPERAND_CODE_REF;
+		code_ref.ref = ref;
+		return Append(operand, &code_ref, sizeof code_ref);
+	}
+
+	// Instructions
+	unsigned AddInstBasic(BrigOpcode opcode, BrigType type,
+			const std::vector<unsigned> &operands)
+	{
+		BrigInstBasic inst;
+		return AddInst(inst, BRIG_KIND_INST_BASIC, opcode, type,
+				operands);
+	}
+
+	unsigned AddInstCmp(BrigCompareOperation compare,
+			BrigType source_type,
+			const std::vector<unsigned> &operands)
+	{
+		BrigInstCmp inst;
+		memset(&inst, 0, sizeof inst);
+		inst.sourceType = source_type;
+		inst.compare = compare;
+		return AddInst(inst, BRIG_KIND_INST_CMP, BRIG_OPCODE_CMP,
+				BRIG_TYPE_B1, operands);
+	}
+
+	unsigned AddInstBr(BrigOpcode opcode, BrigType type,
+			const std::vector<unsigned> &operands)
+	{
+		BrigInstBr inst;
+		memset(&inst, 0, sizeof inst);
+		inst.width = BRIG_WIDTH_1;
+		return AddInst(inst, BRIG_KIND_INST_BR, opcode, type,
+				operands);
+	}
+
+	// Set the first code block entry and next module entry of the kernel
+	void FinishKernel(unsigned kernel, unsigned first_entry)
+	{
+		BrigDirectiveExecutable *dir =
+				(BrigDirectiveExecutable *) &code[kernel];
+		dir->firstCodeBlockEntry = first_entry;
+		dir->nextModuleEntry = code.size();
+	}
+
+	// Return the complete module
+	std::string Build()
+	{
+		// Section sizes
+		std::string *sections[] = { &data, &code, &operand };
+		for (std::string *section : sections)
+			((BrigSectionHeader *) &(*section)[0])->byteCount =
+					section->size();
+
+		// Module header and section index
+		BrigModuleHeader header;
+		memset(&header, 0, sizeof header);
+		memcpy(header.identification, "HSA BRIG", 8);
+		header.brigMajor = BRIG_VERSION_BRIG_MAJOR;
+		header.brigMinor = BRIG_VERSION_BRIG_MINOR;
+		header.sectionCount = 3;
+		header.sectionIndex = sizeof header;
+		uint64_t index[3];
+		index[0] = sizeof header + sizeof index;
+		index[1] = index[0] + data.size();
+		index[2] = index[1] + code.size();
+		header.byteCount = index[2] + operand.size();
+
+		// Module
+		std::string module((const char *) &header, sizeof header);
+		module.append((const char *) index, sizeof index);
+		module += data;
+		module += code;
+		module += operand;
+		return module;
+	}
+};
+
+
+// Build the benchmark module
+std::string BenchmarkBuildModule(unsigned num_iterations)
+{
+	BenchmarkBrigBuilder builder;
+	unsigned kernel = builder.AddKernel("&benchmark");
+	unsigned s0 = builder.AddRegister(BRIG_REGISTER_KIND_SINGLE, 0);
+	unsigned s1 = builder.AddRegister(BRIG_REGISTER_KIND_SINGLE, 1);
+	unsigned s2 = builder.AddRegister(BRIG_REGISTER_KIND_SINGLE, 2);
+	unsigned c0 = builder.AddRegister(BRIG_REGISTER_KIND_CONTROL, 0);
+	unsigned zero = builder.AddImmediate(BRIG_TYPE_B32, 0);
+	unsigned one = builder.AddImmediate(BRIG_TYPE_U32, 1);
+	unsigned three = builder.AddImmediate(BRIG_TYPE_U32, 3);
+	unsigned count = builder.AddImmediate(BRIG_TYPE_U32, num_iterations);
+
+	// Body
+	unsigned first_entry = builder.AddInstBasic(BRIG_OPCODE_MOV,
+			BRIG_TYPE_B32, { s0, zero });
+	builder.AddInstBasic(BRIG_OPCODE_MOV, BRIG_TYPE_B32, { s1, zero });
+	unsigned loop = builder.AddLabel("@loop");
+	builder.AddInstBasic(BRIG_OPCODE_ADD, BRIG_TYPE_U32, { s0, s0, s1 });
+	builder.AddInstBasic(BRIG_OPCODE_MUL, BRIG_TYPE_U32, { s2, s0, three });
+	builder.AddInstBasic(BRIG_OPCODE_ADD, BRIG_TYPE_U32, { s1, s1, one });
+	builder.AddInstCmp(BRIG_COMPARE_LT, BRIG_TYPE_U32, { c0, s1, count });
+	builder.AddInstBr(BRIG_OPCODE_CBR, BRIG_TYPE_B1,
+			{ c0, builder.AddCodeRef(loop) });
+	builder.AddInstBasic(BRIG_OPCODE_RET, BRIG_TYPE_NONE, { });
+	builder.FinishKernel(kernel, first_entry);
+	return builder.Build();
+}
+
+
+// Run the kernel and return the number of instructions per second
+double Benchmark(unsigned num_work_items, unsigned num_iterations)
+{
+	// Guest memory
+	mem::Memory memory;
+	Emulator *emulator = Emulator::getInstance();
+	emulator->setMemory(&memory);
+
+	// Load the kernel
+	std::string module = BenchmarkBuildModule(num_iterations);
+	HsaExecutable executable;
+	executable.AddModule(module.data());
+	Function *function = executable.getFunction("&benchmark");
+	HsaExecutableSymbol symbol(&executable,
+			function->getFunctionDirective());
+
+	// GPU component and dispatch packet
+	auto component = Component::getDefaultGPUComponent(1);
+	AQLDispatchPacket packet;
+	packet.setDimension(1);
+	packet.setWorkGroupSize(64, 1, 1);
+	packet.setGridSize(num_work_items, 1, 1);
+	packet.setPrivateSegmentSizeBytes(0);
+	packet.setGroupSegmentSizeBytes(0);
+	packet.setKernalObjectAddress((unsigned long long) &symbol);
+	packet.setKernargAddress(0);
+	packet.setCompletionSignal(Driver::getInstance()->
+			getSignalManager()->CreateSignal(1));
+
+	// Run
+	long long num_instructions = emulator->getNumInstructions();
+	misc::Timer timer("benchmark");
+	timer.Start();
+	Grid grid(component.get(), &packet);
+	while (grid.Execute());
+	timer.Stop();
+	num_instructions = emulator->getNumInstructions() - num_instructions;
+	return (double) num_instructions / timer.getValue() * 1e6;
+}
+
+}  // namespace HSA
+
+
+int main(int argc, char **argv)
+{
+	try
+	{
+		// Arguments
+		unsigned num_work_items = 1024;
+		unsigned num_iterations = 1000;
+		if (argc > 1)
+			num_work_items = atoi(argv[1]);
+		if (argc > 2)
+			num_iterations = atoi(argv[2]);
+
+		// Run
+		double throughput = HSA::Benchmark(num_work_items,
+				num_iterations);
+		std::cout << misc::fmt("%u work-items, %u iterations: "
+				"%.0f instructions/s\n", num_work_items,
+				num_iterations, throughput);
+	}
+	catch (misc::Exception &e)
+	{
+		e.Dump();
+		return 1;
+	}
+
+	// Success
+	return 0;
+}
@@ -0,0 +1,201 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <arch/common/Arch.h>
+#include <arch/kepler/driver/Function.h>
+#include <arch/kepler/emulator/Emulator.h>
+#include <arch/kepler/emulator/Grid.h>
+#include <lib/esim/Engine.h>
+#include <memory/Memory.h>
+
+
+namespace Kepler
+{
+
+// Number of threads per thread block
+static const unsigned test_emulator_thread_block_size = 32;
+
+// Number of thread blocks in the grid
+static const unsigned test_emulator_num_thread_blocks = 64;
+
+// Number of elements of each vector
+static const unsigned test_emulator_num_elements =
+		test_emulator_thread_block_size *
+		test_emulator_num_thread_blocks;
+
+// Number of times the kernel is launched
+static const int test_emulator_num_grids = 3;
+
+// Kernel adding vector 'b' to vector 'a', with one element per thread
+// given by its global identifier. Each instruction is given as the two
+// 32-bit words stored in the ISA section, and every eighth word is a
+// scheduling control word.
+//
+//	MOV R1, c [0x0] [0x44];
+//	S2R R0, SR_TID.X;
+//	S2R R5, SR_CTAID.X;
+//	ISCADD R0, R5, R0, 0x5;
+//	ISCADD R4, R0, c [0x0] [0x144], 0x2;
+//	ISCADD R2, R0, c [0x0] [0x140], 0x2;
+//	LD R0, [R4];
+//	LD R3, [R2];
+//	IADD R0, R3, R0;
+//	ST [R2], R0;
+//	EXIT;
+//	BRA 0x68;
+//	NOP;
+//	NOP;
+//
+static const unsigned test_emulator_kernel[] =
+{
+	0x10a0a000, 0x08a0dca0,
+	0x089c0006, 0x64c03c00,
+	0x109c0002, 0x86400000,
+	0x129c0016, 0x86400000,
+	0x001c1402, 0xe0c01400,
+	0x289c0012, 0x60c00800,
+	0x281c000a, 0x60c00800,
+	0x001c1000, 0xc4000000,
+	0x0000b810, 0x08000000,
+	0x001c080c, 0xc4000000,
+	0x001c0c02, 0xe0800000,
+	0x001c0800, 0xe4000000,
+	0x001c003c, 0x18000000,
+	0xfc1c003c, 0x12007fff,
+	0x001c3c02, 0x85800000,
+	0x001c3c02, 0x85800000
+};
+
+// Results of an emulation compared across runs
+struct TestEmulatorResult
+{
+	std::vector<int> a;
+	long long num_instructions = 0;
+	long long num_parallel_thread_blocks = 0;
+};
+
+
+static void Cleanup()
+{
+	Emulator::Destroy();
+	comm::ArchPool::Destroy();
+	esim::Engine::Destroy();
+}
+
+
+// Launch the kernel several times on the same vectors, running the thread
+// blocks of each grid on the given number of host threads, and return the
+// contents of global memory.
+static void TestEmulatorRun(int num_threads, TestEmulatorResult &result)
+{
+	// Cleanup singleton instances
+	Cleanup();
+
+	// Emulator
+	Emulator::setNumThreads(num_threads);
+	Emulator *emulator = Emulator::getInstance();
+
+	// Vectors in global memory, allocated as the driver does
+	unsigned size = test_emulator_num_elements * sizeof(int);
+	unsigned address[2];
+	for (int i = 0; i < 2; i++)
+	{
+		address[i] = emulator->getGlobalMemoryTop();
+		emulator->getGlobalMemory()->Map(address[i], size,
+				mem::Memory::AccessRead |
+				mem::Memory::AccessWrite);
+		emulator->incGloablMemoryTop(size);
+	}
+	for (unsigned i = 0; i < test_emulator_num_elements; i++)
+	{
+		int a = i;
+		int b = 3 * i + 1;
+		emulator->WriteGlobalMemory(address[0] + i * sizeof(int),
+				sizeof(int), (const char *) &a);
+		emulator->WriteGlobalMemory(address[1] + i * sizeof(int),
+				sizeof(int), (const char *) &b);
+	}
+
+	// Arguments in constant memory
+	emulator->WriteConstantMemory(0x140, sizeof address,
+			(const char *) address);
+
+	// Launch grids
+	Function function(0, "vect_add",
+			(const char *) test_emulator_kernel,
+			sizeof test_emulator_kernel);
+	for (int i = 0; i < test_emulator_num_grids; i++)
+	{
+		unsigned grid_dim[3] = { test_emulator_num_thread_blocks,
+				1, 1 };
+		unsigned block_dim[3] = { test_emulator_thread_block_size,
+				1, 1 };
+		Grid *grid = emulator->addGrid(&function);
+		grid->SetupSize(grid_dim, block_dim);
+		grid->GridSetupConstantMemory();
+		emulator->PushPendingGrid(grid);
+	}
+
+	// Run
+	while (emulator->Run());
+
+	// Results
+	result.a.resize(test_emulator_num_elements);
+	emulator->ReadGlobalMemory(address[0], size, (char *) &result.a[0]);
+	result.num_instructions = emulator->getNumAluInstructions();
+	result.num_parallel_thread_blocks =
+			emulator->getNumParallelThreadBlocks();
+
+	// Restore the default number of host threads
+	Emulator::setNumThreads(1);
+	Cleanup();
+}
+
+
+// This test checks that running the thread blocks of several grids on
+// host threads produces the same global memory and instruction count as
+// running them sequentially.
+TEST(TestEmulator, parallel_thread_blocks_match_sequential)
+{
+	TestEmulatorResult sequential;
+	TestEmulatorRun(1, sequential);
+	TestEmulatorResult parallel;
+	TestEmulatorRun(4, parallel);
+
+	// Every element was incremented once per grid
+	for (unsigned i = 0; i < test_emulator_num_elements; i++)
+		ASSERT_EQ((int) (i + test_emulator_num_grids * (3 * i + 1)),
+				sequential.a[i]) << "element " << i;
+	EXPECT_GT(sequential.num_instructions, 0);
+
+	// Thread blocks only ran on host threads in the parallel run
+	EXPECT_EQ(0, sequential.num_parallel_thread_blocks);
+	EXPECT_EQ(test_emulator_num_grids * test_emulator_num_thread_blocks,
+			parallel.num_parallel_thread_blocks);
+
+	// Both runs match
+	EXPECT_EQ(sequential.a, parallel.a);
+	EXPECT_EQ(sequential.num_instructions, parallel.num_instructions);
+}
+
+}
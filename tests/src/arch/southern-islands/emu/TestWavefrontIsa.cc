@@ -0,0 +1,377 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <cstring>
+#include <random>
+
+#include <gtest/gtest.h>
+#include <lib/cpp/Misc.h>
+
+#include "ObjectPool.h"
+
+
+namespace SI
+{
+
+// Format and operation code of every instruction
+struct TestWavefrontIsaInfo
+{
+	Instruction::Format format;
+	int op;
+};
+
+static const TestWavefrontIsaInfo test_wavefront_isa_info[] =
+{
+	{ Instruction::FormatInvalid, 0 },
+#define DEFINST(_name, _fmt_str, _fmt, _op, _size, _flags) \
+	{ Instruction::Format##_fmt, _op },
+#include <arch/southern-islands/disassembler/Instruction.def>
+#undef DEFINST
+};
+
+// Instructions with a wavefront-level implementation in WavefrontIsa.cc
+static const Instruction::Opcode test_wavefront_isa_opcodes[] =
+{
+	Instruction::Opcode_V_MOV_B32,
+	Instruction::Opcode_V_NOT_B32,
+	Instruction::Opcode_V_CVT_F32_I32,
+	Instruction::Opcode_V_CVT_F32_U32,
+
+	Instruction::Opcode_V_ADD_F32,
+	Instruction::Opcode_V_SUB_F32,
+	Instruction::Opcode_V_SUBREV_F32,
+	Instruction::Opcode_V_MUL_F32,
+	Instruction::Opcode_V_MIN_F32,
+	Instruction::Opcode_V_MAX_F32,
+	Instruction::Opcode_V_MIN_I32,
+	Instruction::Opcode_V_MAX_I32,
+	Instruction::Opcode_V_MIN_U32,
+	Instruction::Opcode_V_MAX_U32,
+	Instruction::Opcode_V_AND_B32,
+	Instruction::Opcode_V_OR_B32,
+	Instruction::Opcode_V_XOR_B32,
+	Instruction::Opcode_V_LSHRREV_B32,
+	Instruction::Opcode_V_ASHRREV_I32,
+	Instruction::Opcode_V_LSHLREV_B32,
+	Instruction::Opcode_V_MAC_F32,
+	Instruction::Opcode_V_CNDMASK_B32,
+	Instruction::Opcode_V_ADD_I32,
+	Instruction::Opcode_V_SUB_I32,
+	Instruction::Opcode_V_SUBREV_I32,
+
+	Instruction::Opcode_V_CMP_LT_F32,
+	Instruction::Opcode_V_CMP_GT_F32,
+	Instruction::Opcode_V_CMP_NGT_F32,
+	Instruction::Opcode_V_CMP_NEQ_F32,
+	Instruction::Opcode_V_CMP_LT_I32,
+	Instruction::Opcode_V_CMP_EQ_I32,
+	Instruction::Opcode_V_CMP_LE_I32,
+	Instruction::Opcode_V_CMP_GT_I32,
+	Instruction::Opcode_V_CMP_NE_I32,
+	Instruction::Opcode_V_CMP_GE_I32,
+	Instruction::Opcode_V_CMP_LT_U32,
+	Instruction::Opcode_V_CMP_LE_U32,
+	Instruction::Opcode_V_CMP_GT_U32,
+
+	Instruction::Opcode_V_ADD_F32_VOP3a,
+	Instruction::Opcode_V_MUL_F32_VOP3a,
+	Instruction::Opcode_V_MAD_F32,
+	Instruction::Opcode_V_MAD_U32_U24,
+	Instruction::Opcode_V_MUL_LO_U32,
+	Instruction::Opcode_V_MUL_LO_I32,
+	Instruction::Opcode_V_MUL_HI_U32
+};
+
+// Number of vector and scalar registers used as operands
+static const int test_wavefront_isa_num_regs = 8;
+
+// Pseudo-random number generator, seeded for reproducible runs. It
+// produces full 32-bit values, used as register contents and masks.
+static std::mt19937 test_wavefront_isa_random;
+
+// Random register value, either any 32-bit pattern, a small integer, or a
+// float in a small range
+static unsigned TestWavefrontIsaValue()
+{
+	Instruction::Register value;
+	switch (test_wavefront_isa_random() % 3)
+	{
+	case 0:
+		value.as_uint = test_wavefront_isa_random();
+		break;
+	case 1:
+		value.as_int = (int) (test_wavefront_isa_random() % 33) - 16;
+		break;
+	default:
+		value.as_float = ((int) (test_wavefront_isa_random() % 2001) -
+				1000) / 16.0f;
+		break;
+	}
+	return value.as_uint;
+}
+
+// Random source operand of a VALU instruction, either a vector register, a
+// scalar register, an integer or float inline constant, or a literal
+// constant if allowed
+static int TestWavefrontIsaOperand(bool literal)
+{
+	switch (test_wavefront_isa_random() % (literal ? 5 : 4))
+	{
+	case 0:
+		return 256 + test_wavefront_isa_random() %
+				test_wavefront_isa_num_regs;
+	case 1:
+		return test_wavefront_isa_random() % test_wavefront_isa_num_regs;
+	case 2:
+		return 128 + test_wavefront_isa_random() % 81;
+	case 3:
+		return 240 + test_wavefront_isa_random() % 8;
+	default:
+		return 0xff;
+	}
+}
+
+// Encode a random instance of an instruction into 'bytes'
+static void TestWavefrontIsaEncode(Instruction::Opcode opcode,
+		Instruction::Bytes &bytes)
+{
+	const TestWavefrontIsaInfo &info = test_wavefront_isa_info[opcode];
+	memset(&bytes, 0, sizeof bytes);
+	switch (info.format)
+	{
+
+	case Instruction::FormatVOP1:
+
+		bytes.vop1.enc = 0x3f;
+		bytes.vop1.op = info.op;
+		bytes.vop1.src0 = TestWavefrontIsaOperand(true);
+		bytes.vop1.vdst = test_wavefront_isa_random() %
+				test_wavefront_isa_num_regs;
+		bytes.vop1.lit_cnst = TestWavefrontIsaValue();
+		break;
+
+	case Instruction::FormatVOP2:
+
+		bytes.vop2.enc = 0;
+		bytes.vop2.op = info.op;
+		bytes.vop2.src0 = TestWavefrontIsaOperand(true);
+		bytes.vop2.vsrc1 = test_wavefront_isa_random() %
+				test_wavefront_isa_num_regs;
+		bytes.vop2.vdst = test_wavefront_isa_random() %
+				test_wavefront_isa_num_regs;
+		bytes.vop2.lit_cnst = TestWavefrontIsaValue();
+
+		// The per-work-item shifts only accept literal shift amounts
+		// below 32
+		if (opcode == Instruction::Opcode_V_LSHRREV_B32 ||
+				opcode == Instruction::Opcode_V_ASHRREV_I32 ||
+				opcode == Instruction::Opcode_V_LSHLREV_B32)
+			bytes.vop2.lit_cnst &= 0x1f;
+		break;
+
+	case Instruction::FormatVOPC:
+
+		bytes.vopc.enc = 0x3e;
+		bytes.vopc.op = info.op;
+		bytes.vopc.src0 = TestWavefrontIsaOperand(true);
+		bytes.vopc.vsrc1 = test_wavefront_isa_random() %
+				test_wavefront_isa_num_regs;
+		bytes.vopc.lit_cnst = TestWavefrontIsaValue();
+		break;
+
+	case Instruction::FormatVOP3a:
+
+		bytes.vop3a.enc = 0x34;
+		bytes.vop3a.op = info.op;
+		bytes.vop3a.vdst = test_wavefront_isa_random() %
+				test_wavefront_isa_num_regs;
+		bytes.vop3a.src0 = TestWavefrontIsaOperand(false);
+		bytes.vop3a.src1 = TestWavefrontIsaOperand(false);
+		bytes.vop3a.src2 = TestWavefrontIsaOperand(false);
+		break;
+
+	default:
+
+		FAIL() << "Unexpected instruction format";
+	}
+}
+
+// Set the same random register state in a list of wavefronts
+static void TestWavefrontIsaSetState(Wavefront *wavefronts[], int count)
+{
+	// Vector registers, including lanes past the last work-item
+	for (int reg = 0; reg < test_wavefront_isa_num_regs; reg++)
+	{
+		for (unsigned lane = 0; lane < WorkGroup::WavefrontSize; lane++)
+		{
+			unsigned value = TestWavefrontIsaValue();
+			for (int i = 0; i < count; i++)
+				wavefronts[i]->getVregLanes(reg)[lane].as_uint =
+						value;
+		}
+	}
+
+	// Scalar registers
+	for (int reg = 0; reg < test_wavefront_isa_num_regs; reg++)
+	{
+		unsigned value = TestWavefrontIsaValue();
+		for (int i = 0; i < count; i++)
+			wavefronts[i]->setSregUint(reg, value);
+	}
+
+	// EXEC and VCC. All work-items are active in one out of four cases.
+	bool all_active = test_wavefront_isa_random() % 4 == 0;
+	unsigned exec_lo = all_active ? ~0U : test_wavefront_isa_random();
+	unsigned exec_hi = all_active ? ~0U : test_wavefront_isa_random();
+	unsigned vcc_lo = test_wavefront_isa_random();
+	unsigned vcc_hi = test_wavefront_isa_random();
+	for (int i = 0; i < count; i++)
+	{
+		wavefronts[i]->setSregUint(Instruction::RegisterExec, exec_lo);
+		wavefronts[i]->setSregUint(Instruction::RegisterExec + 1,
+				exec_hi);
+		wavefronts[i]->setSregUint(Instruction::RegisterVcc, vcc_lo);
+		wavefronts[i]->setSregUint(Instruction::RegisterVcc + 1, vcc_hi);
+	}
+}
+
+// Return whether two register values are equal, considering all NaN values
+// equal to each other, since the NaN payload produced by the host may
+// depend on the order of the operations.
+static bool TestWavefrontIsaEqual(unsigned a, unsigned b)
+{
+	Instruction::Register reg_a;
+	Instruction::Register reg_b;
+	reg_a.as_uint = a;
+	reg_b.as_uint = b;
+	if (std::isnan(reg_a.as_float) && std::isnan(reg_b.as_float))
+		return true;
+	return a == b;
+}
+
+// Runs random instances of every instruction with a wavefront-level
+// implementation, once on each work-item with WorkItem::Execute(), and once
+// through Wavefront::Execute(), which uses the wavefront-level
+// implementation. Both must produce the same
+// registers and register access statistics, for full and partial
+// wavefronts.
+TEST(TestWavefrontIsa, compare_per_work_item)
+{
+	// Environment
+	ObjectPool pool;
+	test_wavefront_isa_random.seed(1);
+
+	for (unsigned work_item_count : { 64, 40 })
+	{
+		// ND-Range with one wavefront
+		NDRange ndrange;
+		unsigned size[1] = { work_item_count };
+		ndrange.SetupSize(size, size, 1);
+
+		// Work-groups running the per-work-item and wavefront-level
+		// implementations
+		WorkGroup reference_work_group(&ndrange, 0);
+		WorkGroup work_group(&ndrange, 0);
+		Wavefront *reference = reference_work_group.getWavefront(0);
+		Wavefront *wavefront = work_group.getWavefront(0);
+		Wavefront *wavefronts[2] = { reference, wavefront };
+		ASSERT_EQ(work_item_count, wavefront->getWorkItemCount());
+
+		for (Instruction::Opcode opcode : test_wavefront_isa_opcodes)
+		{
+			for (int test = 0; test < 50; test++)
+			{
+				// Instruction
+				Instruction::Bytes bytes;
+				TestWavefrontIsaEncode(opcode, bytes);
+				ndrange.SetupInstructionMemory((char *) &bytes,
+						sizeof bytes, 0);
+
+				// Initial state
+				TestWavefrontIsaSetState(wavefronts, 2);
+
+				// Execute on each active work-item, as done by
+				// the wavefront for instructions without a
+				// wavefront-level implementation
+				Instruction instruction;
+				instruction.Decode((char *) &bytes, 0);
+				for (auto it = reference->getWorkItemsBegin(),
+						e = reference->getWorkItemsEnd();
+						it != e; ++it)
+				{
+					WorkItem *work_item = (*it).get();
+					if (reference->isWorkItemActive(
+							work_item->getIdInWavefront()))
+						work_item->Execute(
+								instruction.getOpcode(),
+								&instruction);
+				}
+
+				// Execute on the wavefront
+				ASSERT_EQ(opcode, instruction.getOpcode());
+				wavefront->setPC(0);
+				wavefront->Execute();
+
+				// Vector registers
+				SCOPED_TRACE(misc::fmt("%d work-items, "
+						"opcode %d, test %d",
+						work_item_count, opcode, test));
+				for (int reg = 0; reg < test_wavefront_isa_num_regs;
+						reg++)
+					for (unsigned lane = 0; lane <
+							WorkGroup::WavefrontSize;
+							lane++)
+						ASSERT_PRED2(TestWavefrontIsaEqual,
+								reference->getVregLanes(
+								reg)[lane].as_uint,
+								wavefront->getVregLanes(
+								reg)[lane].as_uint)
+								<< "v" << reg
+								<< " lane " << lane;
+
+				// VCC
+				ASSERT_EQ(reference->getSregUint(
+						Instruction::RegisterVcc),
+						wavefront->getSregUint(
+						Instruction::RegisterVcc));
+				ASSERT_EQ(reference->getSregUint(
+						Instruction::RegisterVcc + 1),
+						wavefront->getSregUint(
+						Instruction::RegisterVcc + 1));
+				ASSERT_EQ(reference->getSregUint(
+						Instruction::RegisterVccz),
+						wavefront->getSregUint(
+						Instruction::RegisterVccz));
+
+				// Statistics
+				ASSERT_EQ(reference_work_group.getSregReadCount(),
+						work_group.getSregReadCount());
+				ASSERT_EQ(reference_work_group.getSregWriteCount(),
+						work_group.getSregWriteCount());
+				ASSERT_EQ(reference_work_group.getVregReadCount(),
+						work_group.getVregReadCount());
+				ASSERT_EQ(reference_work_group.getVregWriteCount(),
+						work_group.getVregWriteCount());
+			}
+		}
+	}
+}
+
+}  // namespace SI
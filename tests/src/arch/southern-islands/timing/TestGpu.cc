@@ -0,0 +1,374 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <arch/southern-islands/disassembler/Instruction.h>
+#include <arch/southern-islands/emulator/Emulator.h>
+#include <arch/southern-islands/emulator/NDRange.h>
+#include <arch/southern-islands/timing/ComputeUnit.h>
+#include <arch/southern-islands/timing/Gpu.h>
+#include <arch/southern-islands/timing/Timing.h>
+#include <dram/System.h>
+#include <lib/cpp/IniFile.h>
+#include <lib/esim/Engine.h>
+#include <memory/Memory.h>
+#include <memory/Mmu.h>
+#include <memory/System.h>
+#include <network/System.h>
+
+
+namespace SI
+{
+
+// Base address of the buffer read and written by the kernel
+static const unsigned test_gpu_buffer_address = 0x100000;
+
+// Number of work-groups and work-items per work-group in the ND-Range
+static const int test_gpu_num_work_groups = 32;
+static const int test_gpu_local_size = 256;
+
+// Size of the region of the buffer accessed by each work-group, in words
+static const int test_gpu_work_group_words = 1024;
+
+// Results of a simulation compared across runs
+struct TestGpuResult
+{
+	long long cycles = 0;
+	long long num_instructions = 0;
+	std::vector<unsigned> buffer;
+	std::vector<long long> compute_unit_stats;
+	long long num_vector_memory_instructions = 0;
+	long long num_vector_memory_work_item_accesses = 0;
+	long long num_vector_memory_accesses = 0;
+	int vector_cache_block_size = 0;
+};
+
+static void Cleanup()
+{
+	mem::System::Destroy();
+	Timing::Destroy();
+	Emulator::Destroy();
+	net::System::Destroy();
+	dram::System::Destroy();
+	comm::ArchPool::Destroy();
+	esim::Engine::Destroy();
+}
+
+// Append the encoding of an instruction to the kernel binary
+static void Emit(std::vector<unsigned> &code, Instruction::Bytes &bytes,
+		int num_words)
+{
+	for (int i = 0; i < num_words; i++)
+		code.push_back(bytes.word[i]);
+	memset(&bytes, 0, sizeof bytes);
+}
+
+// Kernel with scalar and vector memory accesses, vector ALU work, LDS
+// accesses and a barrier. Each work-item loads one word of the buffer,
+// stores it back incremented by one, and exchanges it through the LDS. The
+// work-group id is in s0 and the local id in v0.
+static std::vector<unsigned> TestGpuKernel()
+{
+	std::vector<unsigned> code;
+	Instruction::Bytes b;
+	memset(&b, 0, sizeof b);
+
+	// s_lshl_b32 s3, s0, 12
+	b.sop2.enc = 0x2;
+	b.sop2.op = 30;
+	b.sop2.sdst = 3;
+	b.sop2.ssrc0 = 0;
+	b.sop2.ssrc1 = 140;
+	Emit(code, b, 1);
+
+	// s_mov_b32 s[4:7], buffer resource without a stride, so that the
+	// address only depends on the offset in v1
+	const unsigned resource[4] = { test_gpu_buffer_address, 0,
+			0xffffffff, 0 };
+	for (int i = 0; i < 4; i++)
+	{
+		b.sop1.enc = 0x17d;
+		b.sop1.op = 3;
+		b.sop1.sdst = 4 + i;
+		b.sop1.ssrc0 = 255;
+		b.sop1.lit_cnst = resource[i];
+		Emit(code, b, 2);
+	}
+
+	// s_mov_b32 m0, -1
+	b.sop1.enc = 0x17d;
+	b.sop1.op = 3;
+	b.sop1.sdst = 124;
+	b.sop1.ssrc0 = 193;
+	Emit(code, b, 1);
+
+	// s_buffer_load_dword s8, s[4:7], s3
+	b.smrd.enc = 0x18;
+	b.smrd.op = 8;
+	b.smrd.sdst = 8;
+	b.smrd.sbase = 4 >> 1;
+	b.smrd.offset = 3;
+	Emit(code, b, 1);
+
+	// v_lshlrev_b32 v1, 2, v0
+	b.vop2.op = 26;
+	b.vop2.vdst = 1;
+	b.vop2.src0 = 130;
+	b.vop2.vsrc1 = 0;
+	Emit(code, b, 1);
+
+	// buffer_load_dword v3, v1, s[4:7], s3 offen
+	b.mubuf.enc = 0x38;
+	b.mubuf.op = 12;
+	b.mubuf.vdata = 3;
+	b.mubuf.vaddr = 1;
+	b.mubuf.srsrc = 4 >> 2;
+	b.mubuf.soffset = 3;
+	b.mubuf.offen = 1;
+	Emit(code, b, 2);
+
+	// s_waitcnt 0
+	b.sopp.enc = 0x17f;
+	b.sopp.op = 12;
+	Emit(code, b, 1);
+
+	// v_mul_f32 v4, v3, v3
+	for (int i = 0; i < 8; i++)
+	{
+		b.vop2.op = 8;
+		b.vop2.vdst = 4;
+		b.vop2.src0 = 259;
+		b.vop2.vsrc1 = 3;
+		Emit(code, b, 1);
+	}
+
+	// v_add_i32 v3, vcc, 1, v3
+	b.vop2.op = 37;
+	b.vop2.vdst = 3;
+	b.vop2.src0 = 129;
+	b.vop2.vsrc1 = 3;
+	Emit(code, b, 1);
+
+	// buffer_store_dword v3, v1, s[4:7], s3 offen
+	b.mubuf.enc = 0x38;
+	b.mubuf.op = 28;
+	b.mubuf.vdata = 3;
+	b.mubuf.vaddr = 1;
+	b.mubuf.srsrc = 4 >> 2;
+	b.mubuf.soffset = 3;
+	b.mubuf.offen = 1;
+	Emit(code, b, 2);
+
+	// ds_write_b32 v1, v3
+	b.ds.enc = 0x36;
+	b.ds.op = 13;
+	b.ds.addr = 1;
+	b.ds.data0 = 3;
+	Emit(code, b, 2);
+
+	// s_waitcnt 0
+	b.sopp.enc = 0x17f;
+	b.sopp.op = 12;
+	Emit(code, b, 1);
+
+	// s_barrier
+	b.sopp.enc = 0x17f;
+	b.sopp.op = 10;
+	Emit(code, b, 1);
+
+	// ds_read_b32 v6, v1
+	b.ds.enc = 0x36;
+	b.ds.op = 54;
+	b.ds.vdst = 6;
+	b.ds.addr = 1;
+	Emit(code, b, 2);
+
+	// s_waitcnt 0
+	b.sopp.enc = 0x17f;
+	b.sopp.op = 12;
+	Emit(code, b, 1);
+
+	// s_endpgm
+	b.sopp.enc = 0x17f;
+	b.sopp.op = 1;
+	Emit(code, b, 1);
+
+	return code;
+}
+
+// Run the kernel in the detailed simulation with the given number of host
+// threads, using the default memory configuration
+static void TestGpuRun(int num_threads, TestGpuResult &result)
+{
+	// Cleanup singleton instances
+	Cleanup();
+
+	// The memory hierarchy draws retry latencies from random(), so both
+	// runs must start from the same sequence
+	srandom(1);
+
+	// Configuration
+	misc::IniFile ini_file;
+	ini_file.LoadFromString(
+			"[ Device ]\n"
+			"NumComputeUnits = 8");
+	Timing::ParseConfiguration(&ini_file);
+	Gpu::num_threads = num_threads;
+	Timing *timing = Timing::getInstance();
+	mem::System::getInstance()->ReadConfiguration();
+
+	// Global memory with small values, which 'buffer_load_dword' in the
+	// emulator reads back unchanged
+	const int num_words = test_gpu_num_work_groups *
+			test_gpu_work_group_words;
+	mem::Memory global_memory;
+	global_memory.setSafe(false);
+	for (int i = 0; i < num_words; i++)
+	{
+		unsigned value = i % 128;
+		global_memory.Write(test_gpu_buffer_address + i * 4, 4,
+				(char *) &value);
+	}
+	Emulator *emulator = Emulator::getInstance();
+	emulator->setGlobalMemory(&global_memory);
+
+	// ND-Range
+	std::vector<unsigned> code = TestGpuKernel();
+	NDRange *ndrange = emulator->addNDRange();
+	ndrange->SetupInstructionMemory((const char *) code.data(),
+			code.size() * 4, 0);
+	ndrange->setWgIdSgpr(0);
+	ndrange->setNumVgprUsed(8);
+	ndrange->setNumSgprUsed(16);
+	ndrange->setLocalMemTop(test_gpu_local_size * 4);
+	unsigned global_size[3] = { test_gpu_num_work_groups *
+			test_gpu_local_size, 1, 1 };
+	unsigned local_size[3] = { test_gpu_local_size, 1, 1 };
+	ndrange->SetupSize(global_size, local_size, 1);
+	Gpu *gpu = timing->getGpu();
+	gpu->MapNDRange(ndrange);
+	ndrange->address_space = gpu->getMmu()->newSpace("Southern Islands");
+	for (int i = 0; i < test_gpu_num_work_groups; i++)
+		ndrange->AddWorkgroupIdToWaitingList(i);
+
+	// Simulation loop
+	esim::Engine *esim_engine = esim::Engine::getInstance();
+	comm::ArchPool *arch_pool = comm::ArchPool::getInstance();
+	while (!ndrange->isWaitingWorkGroupsEmpty() ||
+			!ndrange->isRunningWorkGroupsEmpty())
+	{
+		int num_active_emulators;
+		int num_active_timing_simulators;
+		arch_pool->Run(num_active_emulators,
+				num_active_timing_simulators);
+		ASSERT_GT(num_active_timing_simulators, 0);
+		esim_engine->ProcessEvents();
+	}
+	esim_engine->ProcessAllEvents();
+
+	// Results
+	result.cycles = timing->getCycle();
+	result.num_instructions = emulator->getNumInstructions();
+	result.buffer.resize(num_words);
+	global_memory.Read(test_gpu_buffer_address, num_words * 4,
+			(char *) result.buffer.data());
+	for (auto it = gpu->getComputeUnitsBegin(),
+			e = gpu->getComputeUnitsEnd();
+			it != e;
+			++it)
+	{
+		ComputeUnit *compute_unit = it->get();
+		result.compute_unit_stats.push_back(
+				compute_unit->num_mapped_work_groups);
+		result.compute_unit_stats.push_back(
+				compute_unit->num_total_instructions);
+		result.compute_unit_stats.push_back(
+				compute_unit->num_vector_memory_accesses);
+		result.compute_unit_stats.push_back(
+				compute_unit->num_vreg_reads);
+		result.compute_unit_stats.push_back(
+				compute_unit->getLdsModule()->num_reads);
+		result.compute_unit_stats.push_back(
+				compute_unit->getLdsModule()->num_writes);
+		result.num_vector_memory_instructions +=
+				compute_unit->num_vector_memory_instructions;
+		result.num_vector_memory_work_item_accesses +=
+				compute_unit->num_vector_memory_work_item_accesses;
+		result.num_vector_memory_accesses +=
+				compute_unit->num_vector_memory_accesses;
+		result.vector_cache_block_size =
+				compute_unit->vector_cache->getBlockSize();
+	}
+
+	// The emulator refers to the local global memory
+	Cleanup();
+}
+
+
+// This test checks that running the compute units on several host threads
+// gives the same cycle count, memory contents and statistics as running
+// them on one thread.
+TEST(TestGpu, parallel_run_matches_sequential_run)
+{
+	int num_compute_units = Gpu::num_compute_units;
+	int num_threads = Gpu::num_threads;
+
+	TestGpuResult sequential;
+	TestGpuRun(1, sequential);
+	TestGpuResult parallel;
+	TestGpuRun(4, parallel);
+
+	Gpu::num_compute_units = num_compute_units;
+	Gpu::num_threads = num_threads;
+
+	// The kernel ran to completion
+	ASSERT_GT(sequential.cycles, 0);
+	for (int i = 0; i < test_gpu_num_work_groups; i++)
+		for (int j = 0; j < test_gpu_local_size; j++)
+		{
+			int index = i * test_gpu_work_group_words + j;
+			ASSERT_EQ((unsigned) index % 128 + 1,
+					sequential.buffer[index]);
+		}
+
+	// Each wavefront loads and stores 64 consecutive words aligned to
+	// their size, so every instruction accesses all of their blocks once
+	ASSERT_GT(sequential.vector_cache_block_size, 0);
+	EXPECT_EQ(2 * test_gpu_num_work_groups * test_gpu_local_size / 64,
+			sequential.num_vector_memory_instructions);
+	EXPECT_EQ(64 * sequential.num_vector_memory_instructions,
+			sequential.num_vector_memory_work_item_accesses);
+	EXPECT_EQ(64 * 4 / sequential.vector_cache_block_size *
+			sequential.num_vector_memory_instructions,
+			sequential.num_vector_memory_accesses);
+
+	// Both runs match
+	EXPECT_EQ(sequential.cycles, parallel.cycles);
+	EXPECT_EQ(sequential.num_instructions, parallel.num_instructions);
+	EXPECT_TRUE(sequential.buffer == parallel.buffer);
+	EXPECT_EQ(sequential.compute_unit_stats, parallel.compute_unit_stats);
+}
+
+
+} // namespace SI
@@ -0,0 +1,285 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <arch/southern-islands/disassembler/Instruction.h>
+#include <arch/southern-islands/emulator/Emulator.h>
+#include <arch/southern-islands/emulator/NDRange.h>
+#include <arch/southern-islands/emulator/Wavefront.h>
+#include <arch/southern-islands/emulator/WorkGroup.h>
+#include <arch/southern-islands/timing/ComputeUnit.h>
+#include <arch/southern-islands/timing/Gpu.h>
+#include <arch/southern-islands/timing/Timing.h>
+#include <arch/southern-islands/timing/Uop.h>
+#include <arch/southern-islands/timing/VectorMemoryUnit.h>
+#include <dram/System.h>
+#include <lib/cpp/IniFile.h>
+#include <lib/esim/Engine.h>
+#include <memory/Memory.h>
+#include <memory/Mmu.h>
+#include <memory/Module.h>
+#include <memory/System.h>
+#include <network/System.h>
+
+
+namespace SI
+{
+
+// Base virtual address of the accesses
+static const unsigned test_vector_memory_unit_address = 0x100000;
+
+// Global memory of the emulator
+static mem::Memory test_vector_memory_unit_global_memory;
+
+// Expected access to one cache block, given by its virtual address
+struct TestVectorMemoryUnitAccess
+{
+	unsigned address;
+	unsigned long long work_item_mask;
+};
+
+static void Cleanup()
+{
+	mem::System::Destroy();
+	Timing::Destroy();
+	Emulator::Destroy();
+	net::System::Destroy();
+	dram::System::Destroy();
+	comm::ArchPool::Destroy();
+	esim::Engine::Destroy();
+}
+
+// Map a work-group of one wavefront to the first compute unit of a GPU with
+// the default memory configuration, and return the wavefront
+static Wavefront *TestVectorMemoryUnitSetup()
+{
+	// Cleanup singleton instances
+	Cleanup();
+
+	// Configuration. The device frequency is static, so it is given
+	// explicitly in case another test changed it.
+	misc::IniFile ini_file;
+	ini_file.LoadFromString(
+			"[ Device ]\n"
+			"Frequency = 1000");
+	Timing::ParseConfiguration(&ini_file);
+	Timing *timing = Timing::getInstance();
+	mem::System::getInstance()->ReadConfiguration();
+	Emulator *emulator = Emulator::getInstance();
+	emulator->setGlobalMemory(&test_vector_memory_unit_global_memory);
+
+	// ND-Range with one wavefront running 's_endpgm'
+	Instruction::Bytes b;
+	memset(&b, 0, sizeof b);
+	b.sopp.enc = 0x17f;
+	b.sopp.op = 1;
+	NDRange *ndrange = emulator->addNDRange();
+	ndrange->SetupInstructionMemory((const char *) &b.word[0], 4, 0);
+	ndrange->setNumVgprUsed(8);
+	ndrange->setNumSgprUsed(16);
+	unsigned size[3] = { WorkGroup::WavefrontSize, 1, 1 };
+	ndrange->SetupSize(size, size, 1);
+	Gpu *gpu = timing->getGpu();
+	gpu->MapNDRange(ndrange);
+	ndrange->address_space = gpu->getMmu()->newSpace("Southern Islands");
+
+	// Map the work-group
+	WorkGroup *work_group = ndrange->ScheduleWorkGroup(0);
+	ComputeUnit *compute_unit = gpu->getComputeUnit(0);
+	gpu->RemoveFromAvailableComputeUnits(compute_unit);
+	compute_unit->MapWorkGroup(work_group);
+	return work_group->getWavefront(0);
+}
+
+// Coalesce the accesses of a uop of the wavefront, where the active
+// work-items given in 'work_item_mask' access the address returned by
+// 'address' for their identifier in the wavefront, and check the accesses
+// and statistics produced, in the given order.
+static void TestVectorMemoryUnitCoalesce(Wavefront *wavefront,
+		unsigned long long work_item_mask,
+		std::function<unsigned(int)> address,
+		const std::vector<TestVectorMemoryUnitAccess> &expected)
+{
+	// Execution mask
+	wavefront->setSregUint(Instruction::RegisterExec, work_item_mask);
+	wavefront->setSregUint(Instruction::RegisterExec + 1,
+			work_item_mask >> 32);
+
+	// Uop with one access per work-item
+	WorkGroup *work_group = wavefront->getWorkGroup();
+	Uop uop(wavefront, wavefront->getWavefrontPoolEntry(), 0, work_group,
+			0);
+	for (int i = 0; i < WorkGroup::WavefrontSize; i++)
+	{
+		uop.work_item_info_list[i].global_memory_access_address =
+				address(i);
+		uop.work_item_info_list[i].global_memory_access_size = 4;
+	}
+
+	// Coalesce
+	ComputeUnit *compute_unit = uop.getComputeUnit();
+	long long num_work_item_accesses =
+			compute_unit->num_vector_memory_work_item_accesses;
+	compute_unit->getVectorMemoryUnit()->Coalesce(&uop);
+	EXPECT_TRUE(uop.coalesced);
+
+	// Statistics
+	EXPECT_EQ(__builtin_popcountll(work_item_mask),
+			compute_unit->num_vector_memory_work_item_accesses -
+			num_work_item_accesses);
+
+	// Accesses, with their virtual addresses translated
+	mem::Mmu *mmu = compute_unit->getGpu()->getMmu();
+	mem::Mmu::Space *space = work_group->getNDRange()->address_space;
+	ASSERT_EQ(expected.size(), uop.coalesced_accesses.size());
+	for (unsigned i = 0; i < expected.size(); i++)
+	{
+		Uop::CoalescedAccess &access = uop.coalesced_accesses[i];
+		EXPECT_EQ(mmu->TranslateVirtualAddress(space,
+				expected[i].address), access.address);
+		EXPECT_EQ(expected[i].work_item_mask, access.work_item_mask);
+		EXPECT_FALSE(access.accessed);
+	}
+}
+
+
+TEST(TestVectorMemoryUnit, coalesce)
+{
+	Wavefront *wavefront = TestVectorMemoryUnitSetup();
+	ComputeUnit *compute_unit = Timing::getInstance()->getGpu()->
+			getComputeUnit(0);
+	const unsigned block_size = compute_unit->vector_cache->getBlockSize();
+	const unsigned words_per_block = block_size / 4;
+	const unsigned long long all = ~0ULL;
+	const unsigned base = test_vector_memory_unit_address;
+	ASSERT_EQ(64, WorkGroup::WavefrontSize);
+	ASSERT_GE(block_size, 8u);
+	ASSERT_LE(block_size, 128u);
+
+	// Mask of the work-items from 'first' to 'first' + 'count' - 1
+	auto lanes = [](unsigned first, unsigned count)
+	{
+		return (count == 64 ? ~0ULL : ((1ULL << count) - 1)) << first;
+	};
+
+	// Fully coalesced, with consecutive words starting at a block
+	// boundary
+	std::vector<TestVectorMemoryUnitAccess> expected;
+	for (unsigned i = 0; i < 64; i += words_per_block)
+		expected.push_back({ base + i * 4, lanes(i, words_per_block) });
+	TestVectorMemoryUnitCoalesce(wavefront, all,
+			[base](int i) { return base + i * 4; },
+			expected);
+
+	// Consecutive words starting in the middle of a block, so that the
+	// first and last accesses merge fewer work-items
+	const unsigned offset = block_size / 2;
+	const unsigned first = words_per_block / 2;
+	expected.clear();
+	expected.push_back({ base, lanes(0, first) });
+	for (unsigned i = first; i < 64; i += words_per_block)
+		expected.push_back({ base + offset + i * 4,
+				lanes(i, std::min(words_per_block, 64 - i)) });
+	TestVectorMemoryUnitCoalesce(wavefront, all,
+			[base, offset](int i) { return base + offset + i * 4; },
+			expected);
+
+	// Strided, two work-items per block
+	const unsigned stride = block_size / 2;
+	expected.clear();
+	for (unsigned i = 0; i < 64; i += 2)
+		expected.push_back({ base + i * stride, lanes(i, 2) });
+	TestVectorMemoryUnitCoalesce(wavefront, all,
+			[base, stride](int i) { return base + i * stride; },
+			expected);
+
+	// Strided by a page, with one access per work-item, each of them
+	// translated on its own page
+	expected.clear();
+	for (unsigned i = 0; i < 64; i++)
+		expected.push_back({ base + i * mem::Memory::PageSize,
+				lanes(i, 1) });
+	TestVectorMemoryUnitCoalesce(wavefront, all,
+			[base](int i) { return base + i * mem::Memory::PageSize; },
+			expected);
+
+	// Work-items accessing blocks out of order are merged in the access
+	// of the first work-item found in each block
+	expected.clear();
+	for (unsigned i = 0; i < 4; i++)
+	{
+		unsigned long long mask = 0;
+		for (unsigned j = i; j < 64; j += 4)
+			mask |= 1ULL << j;
+		expected.push_back({ base + i * block_size, mask });
+	}
+	TestVectorMemoryUnitCoalesce(wavefront, all,
+			[base, block_size](int i)
+			{
+				return base + (i % 4) * block_size + i / 4 % 2 * 4;
+			},
+			expected);
+
+	// Partially active, with inactive work-items skipped even if they
+	// access blocks not accessed by any active work-item
+	unsigned long long mask = 0x00ff00000000f0f0ULL;
+	expected.clear();
+	for (unsigned i = 0; i < 64; i += words_per_block)
+		if (mask & lanes(i, words_per_block))
+			expected.push_back({ base + i * 4,
+					mask & lanes(i, words_per_block) });
+	TestVectorMemoryUnitCoalesce(wavefront, mask,
+			[base](int i) { return base + i * 4; },
+			expected);
+
+	// Single active work-item in the upper half of the wavefront
+	TestVectorMemoryUnitCoalesce(wavefront, 1ULL << 63,
+			[base](int i) { return base + i * 4; },
+			{ { base + 63 * 4 / block_size * block_size,
+					1ULL << 63 } });
+
+	// No active work-item
+	TestVectorMemoryUnitCoalesce(wavefront, 0,
+			[base](int i) { return base + i * 4; },
+			{ });
+
+	// With coalescing disabled, there is one access per active work-item,
+	// even if they fall in the same block
+	VectorMemoryUnit::coalesce = false;
+	mask = 0xf0000000000000ffULL;
+	expected.clear();
+	for (unsigned i = 0; i < 64; i++)
+		if (mask & (1ULL << i))
+			expected.push_back({ base + i * 4, 1ULL << i });
+	TestVectorMemoryUnitCoalesce(wavefront, mask,
+			[base](int i) { return base + i * 4; },
+			expected);
+	VectorMemoryUnit::coalesce = true;
+
+	Cleanup();
+}
+
+
+} // namespace SI
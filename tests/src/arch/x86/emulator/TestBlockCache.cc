@@ -0,0 +1,317 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <arch/x86/emulator/Context.h>
+#include <arch/x86/emulator/Emulator.h>
+#include <memory/Memory.h>
+
+
+namespace x86
+{
+
+// Address of the guest code
+static const unsigned test_block_cache_code_address = 0x8048000;
+
+// Address of the guest data page
+static const unsigned test_block_cache_data_address = 0x10000000;
+
+// Address of the top of the guest stack
+static const unsigned test_block_cache_stack_address = 0x20000000;
+
+// Register state and statistics compared across runs
+struct TestBlockCacheResult
+{
+	std::vector<unsigned> regs;
+	std::vector<char> data;
+	long long num_instructions = 0;
+};
+
+static void Cleanup()
+{
+	Emulator::Destroy();
+	comm::ArchPool::Destroy();
+}
+
+// Append bytes to the guest code
+static void Emit(std::vector<unsigned char> &code,
+		std::initializer_list<unsigned char> bytes)
+{
+	code.insert(code.end(), bytes);
+}
+
+// Append a 32-bit value to the guest code
+static void Emit32(std::vector<unsigned char> &code, unsigned value)
+{
+	for (int i = 0; i < 4; i++)
+		code.push_back(value >> (i * 8));
+}
+
+// Create a context running the given code, with a writable and executable
+// code page, a data page, and a stack page
+static Context *TestBlockCacheContext(const std::vector<unsigned char> &code)
+{
+	Cleanup();
+	Emulator *emulator = Emulator::getInstance();
+	Context *context = emulator->newContext();
+	context->Initialize();
+	context->setState(Context::StateRunning);
+
+	// Code
+	mem::Memory *memory = context->getMemory();
+	memory->Map(test_block_cache_code_address, mem::Memory::PageSize,
+			mem::Memory::AccessRead |
+			mem::Memory::AccessWrite |
+			mem::Memory::AccessExec |
+			mem::Memory::AccessInit);
+	memory->Init(test_block_cache_code_address, code.size(),
+			(const char *) code.data());
+
+	// Data and stack
+	memory->Map(test_block_cache_data_address, mem::Memory::PageSize,
+			mem::Memory::AccessRead |
+			mem::Memory::AccessWrite);
+	memory->Map(test_block_cache_stack_address - mem::Memory::PageSize,
+			mem::Memory::PageSize,
+			mem::Memory::AccessRead |
+			mem::Memory::AccessWrite);
+
+	// Registers
+	Regs &regs = context->getRegs();
+	regs.setEip(test_block_cache_code_address);
+	regs.setEsp(test_block_cache_stack_address);
+	return context;
+}
+
+// Program with a loop, a function call, stack and memory accesses,
+// instructions modifying the code that follows them, and a final 'exit'
+// system call
+static std::vector<unsigned char> TestBlockCacheProgram()
+{
+	std::vector<unsigned char> code;
+
+	// jmp main
+	Emit(code, { 0xeb, 15 });
+
+	// function:
+	//	push eax
+	//	xor eax, 0x1234
+	//	mov [ebx + 0x100], eax
+	//	pop eax
+	//	inc esi
+	//	ret
+	unsigned function = code.size();
+	Emit(code, { 0x50 });
+	Emit(code, { 0x35, 0x34, 0x12, 0x00, 0x00 });
+	Emit(code, { 0x89, 0x83, 0x00, 0x01, 0x00, 0x00 });
+	Emit(code, { 0x58 });
+	Emit(code, { 0x46 });
+	Emit(code, { 0xc3 });
+
+	// main:
+	//	mov ecx, 100
+	//	xor eax, eax
+	//	mov ebx, data
+	EXPECT_EQ(17u, code.size());
+	Emit(code, { 0xb9, 100, 0x00, 0x00, 0x00 });
+	Emit(code, { 0x31, 0xc0 });
+	Emit(code, { 0xbb });
+	Emit32(code, test_block_cache_data_address);
+
+	// loop:
+	//	add eax, ecx
+	//	mov [ebx], eax
+	//	add ebx, 4
+	//	call function
+	//	dec ecx
+	//	jnz loop
+	unsigned loop = code.size();
+	Emit(code, { 0x01, 0xc8 });
+	Emit(code, { 0x89, 0x03 });
+	Emit(code, { 0x83, 0xc3, 0x04 });
+	Emit(code, { 0xe8 });
+	Emit32(code, function - (code.size() + 4));
+	Emit(code, { 0x49 });
+	Emit(code, { 0x75, (unsigned char) (loop - (code.size() + 2)) });
+
+	//	mov byte [next + 1], 0x55
+	// next:
+	//	mov edx, 0x11		(runs as mov edx, 0x55)
+	//	add edx, eax
+	Emit(code, { 0xc6, 0x05 });
+	Emit32(code, test_block_cache_code_address + code.size() + 5 + 1);
+	Emit(code, { 0x55 });
+	Emit(code, { 0xba, 0x11, 0x00, 0x00, 0x00 });
+	Emit(code, { 0x01, 0xc2 });
+
+	//	mov eax, 1
+	//	mov ebx, 0
+	//	int 0x80
+	Emit(code, { 0xb8, 0x01, 0x00, 0x00, 0x00 });
+	Emit(code, { 0xbb, 0x00, 0x00, 0x00, 0x00 });
+	Emit(code, { 0xcd, 0x80 });
+	return code;
+}
+
+// Run the program until the context finishes, with basic blocks of up to
+// 'block_size' instructions, or one instruction at a time if 'block_size'
+// is 1.
+static void TestBlockCacheRun(int block_size, TestBlockCacheResult &result)
+{
+	Context *context = TestBlockCacheContext(TestBlockCacheProgram());
+	while (context->getState(Context::StateRunning))
+	{
+		if (block_size > 1)
+			context->ExecuteBlock(block_size);
+		else
+			context->Execute();
+	}
+
+	// Results
+	Regs &regs = context->getRegs();
+	result.regs = { regs.getEax(), regs.getEbx(), regs.getEcx(),
+			regs.getEdx(), regs.getEsi(), regs.getEdi(),
+			regs.getEbp(), regs.getEsp(), regs.getEip(),
+			regs.getEflags() };
+	result.data.resize(mem::Memory::PageSize);
+	context->getMemory()->Read(test_block_cache_data_address,
+			mem::Memory::PageSize, result.data.data());
+	result.num_instructions = Emulator::getInstance()->getNumInstructions();
+	Cleanup();
+}
+
+
+// This test checks that running basic blocks of several sizes gives the same
+// register state, memory contents, and instruction count as running one
+// instruction at a time.
+TEST(TestBlockCache, block_execution_matches_single_step)
+{
+	TestBlockCacheResult single_step;
+	TestBlockCacheRun(1, single_step);
+
+	// The program ran to completion
+	EXPECT_EQ(0x55u + 5050, single_step.regs[3]);
+	EXPECT_EQ(100u, single_step.regs[4]);
+	EXPECT_EQ(test_block_cache_stack_address, single_step.regs[7]);
+
+	for (int block_size : { 2, 3, 16, 1000 })
+	{
+		TestBlockCacheResult block;
+		TestBlockCacheRun(block_size, block);
+		EXPECT_EQ(single_step.regs, block.regs);
+		EXPECT_TRUE(single_step.data == block.data);
+		EXPECT_EQ(single_step.num_instructions,
+				block.num_instructions);
+	}
+}
+
+
+TEST(TestBlockCache, self_modifying_code)
+{
+	// mov byte [next + 1], 0x2a
+	// next:
+	// mov eax, 1			(runs as mov eax, 0x2a)
+	// inc eax
+	// jmp next
+	std::vector<unsigned char> code;
+	Emit(code, { 0xc6, 0x05 });
+	Emit32(code, test_block_cache_code_address + 8);
+	Emit(code, { 0x2a });
+	Emit(code, { 0xb8, 0x01, 0x00, 0x00, 0x00 });
+	Emit(code, { 0x40 });
+	Emit(code, { 0xeb, 0xf8 });
+	Context *context = TestBlockCacheContext(code);
+	Regs &regs = context->getRegs();
+
+	// The block stops after the instruction modifying its own code
+	EXPECT_EQ(1, context->ExecuteBlock(16));
+	EXPECT_EQ(test_block_cache_code_address + 7, regs.getEip());
+
+	// The rest of the block is decoded again
+	EXPECT_EQ(3, context->ExecuteBlock(16));
+	EXPECT_EQ(0x2bu, regs.getEax());
+	EXPECT_EQ(test_block_cache_code_address + 7, regs.getEip());
+
+	// The cached block is invalidated by a write to the code page from
+	// outside the block
+	EXPECT_EQ(3, context->ExecuteBlock(16));
+	EXPECT_EQ(0x2bu, regs.getEax());
+	const char value = 0x10;
+	context->getMemory()->Write(test_block_cache_code_address + 8, 1,
+			&value);
+	EXPECT_EQ(3, context->ExecuteBlock(16));
+	EXPECT_EQ(0x11u, regs.getEax());
+
+	Cleanup();
+}
+
+
+TEST(TestBlockCache, fallback_to_single_step)
+{
+	// inc eax
+	// inc eax
+	// mov eax, 20			(getpid)
+	// int 0x80
+	// inc eax
+	// inc eax
+	std::vector<unsigned char> code;
+	Emit(code, { 0x40, 0x40 });
+	Emit(code, { 0xb8, 20, 0x00, 0x00, 0x00 });
+	Emit(code, { 0xcd, 0x80 });
+	Emit(code, { 0x40, 0x40 });
+	Context *context = TestBlockCacheContext(code);
+	Regs &regs = context->getRegs();
+	Emulator *emulator = Emulator::getInstance();
+
+	// Running in parallel stops before the system call
+	long long num_blocks = 0;
+	EXPECT_EQ(3, context->ExecuteParallel(100, num_blocks));
+	EXPECT_EQ(1, num_blocks);
+	EXPECT_EQ(test_block_cache_code_address + 7, regs.getEip());
+
+	// A block ends at the system call
+	EXPECT_EQ(1, context->ExecuteBlock(16));
+	EXPECT_EQ((unsigned) context->getId(), regs.getEax());
+	EXPECT_EQ(test_block_cache_code_address + 9, regs.getEip());
+
+	// In a signal handler, instructions run one at a time
+	context->setState(Context::StateHandler);
+	EXPECT_EQ(1, context->ExecuteBlock(16));
+	EXPECT_EQ(test_block_cache_code_address + 10, regs.getEip());
+	context->clearState(Context::StateHandler);
+
+	// So they do in speculative mode, where the context recovers the
+	// registers it had when it started
+	long long num_instructions = emulator->getNumInstructions();
+	context->setEip(test_block_cache_code_address);
+	EXPECT_TRUE(context->getState(Context::StateSpecMode));
+	EXPECT_EQ(1, context->ExecuteBlock(16));
+	EXPECT_EQ(test_block_cache_code_address + 1, regs.getEip());
+	EXPECT_EQ(num_instructions + 1, emulator->getNumInstructions());
+	context->Recover();
+	EXPECT_EQ(test_block_cache_code_address + 10, regs.getEip());
+
+	Cleanup();
+}
+
+
+}  // namespace x86
@@ -0,0 +1,374 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <arch/common/FileTable.h>
+#include <arch/x86/emulator/Context.h>
+#include <arch/x86/emulator/Emulator.h>
+#include <memory/Memory.h>
+
+
+namespace x86
+{
+
+// Address of the 'int 0x80' instruction
+static const unsigned test_syscall_code_address = 0x8048000;
+
+// Address of the first page of data buffers
+static const unsigned test_syscall_data_address = 0x10000000;
+
+// Page size
+static const unsigned test_syscall_page_size = mem::Memory::PageSize;
+
+// System call codes
+static const int test_syscall_read = 3;
+static const int test_syscall_write = 4;
+static const int test_syscall_readv = 145;
+static const int test_syscall_writev = 146;
+
+static void Cleanup()
+{
+	Emulator::Destroy();
+	comm::ArchPool::Destroy();
+}
+
+// Create a context with an 'int 0x80' instruction and two consecutive
+// read-write data pages
+static Context *TestSyscallContext()
+{
+	Cleanup();
+	Emulator *emulator = Emulator::getInstance();
+	Context *context = emulator->newContext();
+	context->Initialize();
+	context->setState(Context::StateRunning);
+
+	// Code
+	mem::Memory *memory = context->getMemory();
+	const char code[] = { (char) 0xcd, (char) 0x80 };
+	memory->Map(test_syscall_code_address, test_syscall_page_size,
+			mem::Memory::AccessRead |
+			mem::Memory::AccessExec |
+			mem::Memory::AccessInit);
+	memory->Init(test_syscall_code_address, sizeof code, code);
+
+	// Data
+	memory->Map(test_syscall_data_address, 2 * test_syscall_page_size,
+			mem::Memory::AccessRead |
+			mem::Memory::AccessWrite);
+	return context;
+}
+
+// Run system call 'code' with arguments in 'ebx', 'ecx', and 'edx'. Return
+// the value of 'eax' after the call.
+static int TestSyscallRun(Context *context, int code, unsigned ebx,
+		unsigned ecx, unsigned edx)
+{
+	Regs &regs = context->getRegs();
+	regs.setEax(code);
+	regs.setEbx(ebx);
+	regs.setEcx(ecx);
+	regs.setEdx(edx);
+	regs.setEip(test_syscall_code_address);
+	context->Execute();
+	return regs.getEax();
+}
+
+// Wake up a context suspended in a blocking system call, once the host file
+// is ready. Return the value of 'eax' after the call.
+static int TestSyscallWakeup(Context *context)
+{
+	EXPECT_TRUE(context->getState(Context::StateSuspended));
+	EXPECT_TRUE(context->CanWakeup());
+	context->Wakeup();
+	return context->getRegs().getEax();
+}
+
+// Return a string of 'size' characters with a different value per position
+static std::string TestSyscallPattern(int size, int seed)
+{
+	std::string s;
+	for (int i = 0; i < size; i++)
+		s += (char) ('a' + (i * 7 + seed) % 26);
+	return s;
+}
+
+// Write a string into guest memory
+static void TestSyscallWriteString(Context *context, unsigned address,
+		const std::string &s)
+{
+	context->getMemory()->Write(address, s.size(), s.data());
+}
+
+// Read a string from guest memory
+static std::string TestSyscallReadString(Context *context, unsigned address,
+		int size)
+{
+	std::string s(size, '\0');
+	context->getMemory()->Read(address, size, &s[0]);
+	return s;
+}
+
+// Read all the data available in a non-blocking host file descriptor
+static std::string TestSyscallDrain(int fd)
+{
+	std::string s;
+	char buffer[4096];
+	int count;
+	while ((count = read(fd, buffer, sizeof buffer)) > 0)
+		s.append(buffer, count);
+	return s;
+}
+
+
+TEST(TestSyscall, write_page_crossing_buffer)
+{
+	Context *context = TestSyscallContext();
+	int fds[2];
+	ASSERT_EQ(0, pipe(fds));
+	fcntl(fds[0], F_SETFL, O_NONBLOCK);
+	int guest_fd = context->getFileTable()->newFileDescriptor(
+			comm::FileDescriptor::TypePipe, fds[1], "",
+			O_WRONLY)->getGuestIndex();
+
+	// Buffer crossing the boundary of the two data pages
+	unsigned address = test_syscall_data_address +
+			test_syscall_page_size - 100;
+	std::string data = TestSyscallPattern(300, 1);
+	TestSyscallWriteString(context, address, data);
+	EXPECT_EQ(300, TestSyscallRun(context, test_syscall_write,
+			guest_fd, address, data.size()));
+	EXPECT_EQ(data, TestSyscallDrain(fds[0]));
+
+	close(fds[0]);
+	close(fds[1]);
+	Cleanup();
+}
+
+
+TEST(TestSyscall, read_page_crossing_buffer)
+{
+	Context *context = TestSyscallContext();
+	int fds[2];
+	ASSERT_EQ(0, pipe(fds));
+	int guest_fd = context->getFileTable()->newFileDescriptor(
+			comm::FileDescriptor::TypePipe, fds[0], "",
+			O_RDONLY)->getGuestIndex();
+
+	// Data available in the pipe
+	std::string data = TestSyscallPattern(300, 2);
+	ASSERT_EQ(300, write(fds[1], data.data(), data.size()));
+
+	// Buffer crossing the boundary of the two data pages
+	unsigned address = test_syscall_data_address +
+			test_syscall_page_size - 200;
+	EXPECT_EQ(300, TestSyscallRun(context, test_syscall_read,
+			guest_fd, address, 1000));
+	EXPECT_EQ(data, TestSyscallReadString(context, address, 300));
+
+	close(fds[0]);
+	close(fds[1]);
+	Cleanup();
+}
+
+
+TEST(TestSyscall, partly_unmapped_buffer_in_safe_mode)
+{
+	Context *context = TestSyscallContext();
+	int fds[2];
+	ASSERT_EQ(0, pipe(fds));
+	fcntl(fds[0], F_SETFL, O_NONBLOCK);
+	comm::FileTable *file_table = context->getFileTable();
+	int guest_read_fd = file_table->newFileDescriptor(
+			comm::FileDescriptor::TypePipe, fds[0], "",
+			O_RDONLY)->getGuestIndex();
+	int guest_write_fd = file_table->newFileDescriptor(
+			comm::FileDescriptor::TypePipe, fds[1], "",
+			O_WRONLY)->getGuestIndex();
+
+	// Buffer with 16 bytes at the end of the second data page, followed by
+	// a page that is not mapped
+	unsigned address = test_syscall_data_address +
+			2 * test_syscall_page_size - 16;
+	std::string data = TestSyscallPattern(16, 3);
+	TestSyscallWriteString(context, address, data);
+	ASSERT_TRUE(context->getMemory()->getSafe());
+
+	// The write stops at the unmapped page
+	EXPECT_EQ(16, TestSyscallRun(context, test_syscall_write,
+			guest_write_fd, address, 64));
+	EXPECT_EQ(data, TestSyscallDrain(fds[0]));
+
+	// So does the read
+	std::string other = TestSyscallPattern(64, 4);
+	ASSERT_EQ(64, write(fds[1], other.data(), other.size()));
+	EXPECT_EQ(16, TestSyscallRun(context, test_syscall_read,
+			guest_read_fd, address, 64));
+	EXPECT_EQ(other.substr(0, 16), TestSyscallReadString(context,
+			address, 16));
+	TestSyscallDrain(fds[0]);
+
+	// A buffer in the unmapped page only is invalid
+	unsigned unmapped_address = address + 16;
+	EXPECT_EQ(-EFAULT, TestSyscallRun(context, test_syscall_write,
+			guest_write_fd, unmapped_address, 64));
+	ASSERT_EQ(64, write(fds[1], other.data(), other.size()));
+	EXPECT_EQ(-EFAULT, TestSyscallRun(context, test_syscall_read,
+			guest_read_fd, unmapped_address, 64));
+
+	close(fds[0]);
+	close(fds[1]);
+	Cleanup();
+}
+
+
+TEST(TestSyscall, blocking_read)
+{
+	Context *context = TestSyscallContext();
+	int fds[2];
+	ASSERT_EQ(0, pipe(fds));
+	int guest_fd = context->getFileTable()->newFileDescriptor(
+			comm::FileDescriptor::TypePipe, fds[0], "",
+			O_RDONLY)->getGuestIndex();
+
+	// Read on an empty pipe into a page-crossing buffer suspends the
+	// context, which reads the data once available
+	unsigned address = test_syscall_data_address +
+			test_syscall_page_size - 10;
+	TestSyscallRun(context, test_syscall_read, guest_fd, address, 100);
+	std::string data = TestSyscallPattern(100, 5);
+	ASSERT_EQ(100, write(fds[1], data.data(), data.size()));
+	EXPECT_EQ(100, TestSyscallWakeup(context));
+	EXPECT_EQ(data, TestSyscallReadString(context, address, 100));
+
+	// A blocked read on an unmapped buffer fails in safe mode, instead of
+	// returning end of file
+	unsigned unmapped_address = test_syscall_data_address +
+			2 * test_syscall_page_size;
+	TestSyscallRun(context, test_syscall_read, guest_fd,
+			unmapped_address, 100);
+	ASSERT_EQ(100, write(fds[1], data.data(), data.size()));
+	EXPECT_EQ(-EFAULT, TestSyscallWakeup(context));
+
+	close(fds[0]);
+	close(fds[1]);
+	Cleanup();
+}
+
+
+TEST(TestSyscall, blocking_write)
+{
+	Context *context = TestSyscallContext();
+	int fds[2];
+	ASSERT_EQ(0, pipe(fds));
+	fcntl(fds[0], F_SETFL, O_NONBLOCK);
+	fcntl(fds[1], F_SETFL, O_NONBLOCK);
+	int guest_fd = context->getFileTable()->newFileDescriptor(
+			comm::FileDescriptor::TypePipe, fds[1], "",
+			O_WRONLY)->getGuestIndex();
+
+	// Fill the pipe
+	std::string fill(4096, 'x');
+	while (write(fds[1], fill.data(), fill.size()) > 0)
+		;
+
+	// Write from a buffer that is unmapped while the context is
+	// suspended
+	unsigned address = test_syscall_data_address +
+			test_syscall_page_size - 10;
+	std::string data = TestSyscallPattern(100, 6);
+	TestSyscallWriteString(context, address, data);
+	TestSyscallRun(context, test_syscall_write, guest_fd, address, 100);
+	context->getMemory()->Unmap(test_syscall_data_address,
+			2 * test_syscall_page_size);
+	TestSyscallDrain(fds[0]);
+	EXPECT_EQ(-EFAULT, TestSyscallWakeup(context));
+	EXPECT_EQ("", TestSyscallDrain(fds[0]));
+
+	close(fds[0]);
+	close(fds[1]);
+	Cleanup();
+}
+
+
+TEST(TestSyscall, readv_writev)
+{
+	Context *context = TestSyscallContext();
+	char path[] = "/tmp/m2s-test-syscall-XXXXXX";
+	int host_fd = mkstemp(path);
+	ASSERT_GE(host_fd, 0);
+	unlink(path);
+	int guest_fd = context->getFileTable()->newFileDescriptor(
+			comm::FileDescriptor::TypeRegular, host_fd, path,
+			O_RDWR)->getGuestIndex();
+
+	// Vectors at the beginning of the first data page, pointing to a
+	// page-crossing buffer and a buffer within one page
+	mem::Memory *memory = context->getMemory();
+	unsigned iovec_address = test_syscall_data_address;
+	unsigned first = test_syscall_data_address +
+			test_syscall_page_size - 50;
+	unsigned second = test_syscall_data_address + 100;
+	unsigned iovecs[4] = { first, 150, second, 70 };
+	memory->Write(iovec_address, sizeof iovecs, (char *) iovecs);
+	std::string data = TestSyscallPattern(220, 7);
+	TestSyscallWriteString(context, first, data.substr(0, 150));
+	TestSyscallWriteString(context, second, data.substr(150));
+	EXPECT_EQ(220, TestSyscallRun(context, test_syscall_writev,
+			guest_fd, iovec_address, 2));
+
+	// Read the file back with the vectors in the opposite order
+	unsigned reverse_iovecs[4] = { second, 70, first, 150 };
+	memory->Write(iovec_address, sizeof reverse_iovecs,
+			(char *) reverse_iovecs);
+	TestSyscallWriteString(context, first, std::string(150, '\0'));
+	TestSyscallWriteString(context, second, std::string(70, '\0'));
+	ASSERT_EQ(0, lseek(host_fd, 0, SEEK_SET));
+	EXPECT_EQ(220, TestSyscallRun(context, test_syscall_readv,
+			guest_fd, iovec_address, 2));
+	EXPECT_EQ(data.substr(0, 70), TestSyscallReadString(context,
+			second, 70));
+	EXPECT_EQ(data.substr(70), TestSyscallReadString(context,
+			first, 150));
+
+	// In safe mode, the transfer stops at the first vector reaching an
+	// unmapped page
+	unsigned unmapped_iovecs[4] = { second, 70,
+			test_syscall_data_address + 2 * test_syscall_page_size - 20,
+			100 };
+	memory->Write(iovec_address, sizeof unmapped_iovecs,
+			(char *) unmapped_iovecs);
+	ASSERT_EQ(0, lseek(host_fd, 0, SEEK_SET));
+	EXPECT_EQ(90, TestSyscallRun(context, test_syscall_readv,
+			guest_fd, iovec_address, 2));
+	EXPECT_EQ(data.substr(0, 70), TestSyscallReadString(context,
+			second, 70));
+
+	close(host_fd);
+	Cleanup();
+}
+
+
+}  // namespace x86
@@ -0,0 +1,220 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iostream>
+#include <list>
+#include <memory>
+#include <random>
+
+#include <lib/cpp/Error.h>
+#include <lib/cpp/IniFile.h>
+#include <lib/cpp/Misc.h>
+#include <lib/cpp/RingBuffer.h>
+#include <lib/cpp/Timer.h>
+#include <lib/esim/FramePool.h>
+#include <arch/x86/emulator/Uinst.h>
+#include <arch/x86/timing/Cpu.h>
+#include <arch/x86/timing/Timing.h>
+#include <arch/x86/timing/Uop.h>
+
+#include "ObjectPool.h"
+
+
+// Micro-benchmark comparing the cost of moving uops through the in-order
+// queues of the x86 pipeline for different pipeline widths. Every cycle,
+// each stage moves up to <width> uops: fetch creates a micro-instruction and
+// its uop and inserts them in the fetch queue, decode moves them to the uop
+// queue, dispatch to the reorder buffer, and commit removes them from the
+// head of the reorder buffer once it is half full. One in 64 cycles, a
+// misprediction squashes the uops in the fetch and uop queues and the
+// youngest half of the reorder buffer. Queues implemented as lists of
+// uops allocated from the heap, as done before ring buffers and pooled
+// uops were introduced, are compared against ring buffers of uops allocated
+// from a frame pool. Run as
+//
+//	src_arch_x86_timing_benchmark [<num_uops>]
+//
+
+namespace x86
+{
+
+// Pseudo-random number generator, seeded for reproducible runs
+static std::minstd_rand benchmark_random;
+
+// Opcodes of the micro-instructions created
+const Uinst::Opcode benchmark_opcodes[] =
+{
+	Uinst::OpcodeAdd,
+	Uinst::OpcodeLoad,
+	Uinst::OpcodeAdd,
+	Uinst::OpcodeStore
+};
+
+// Queues and allocation as before ring buffers and pooled uops
+struct BenchmarkList
+{
+	typedef std::list<std::shared_ptr<Uop>> Queue;
+
+	static void Reserve(Queue &queue, int capacity)
+	{
+	}
+
+	static std::shared_ptr<Uop> newUop(Thread *thread, Context *context,
+			Uinst::Opcode opcode)
+	{
+		auto uinst = misc::new_shared<Uinst>(opcode);
+		return misc::new_shared<Uop>(thread, context, uinst);
+	}
+};
+
+// Ring buffers and pooled uops, as used by x86::Thread
+struct BenchmarkRing
+{
+	typedef misc::RingBuffer<std::shared_ptr<Uop>> Queue;
+
+	static void Reserve(Queue &queue, int capacity)
+	{
+		queue.reserve(capacity);
+	}
+
+	static std::shared_ptr<Uop> newUop(Thread *thread, Context *context,
+			Uinst::Opcode opcode)
+	{
+		auto uinst = esim::new_frame<Uinst>(opcode);
+		return esim::new_frame<Uop>(thread, context, uinst);
+	}
+};
+
+// Move up to 'width' uops from the head of a queue to the tail of another,
+// without exceeding 'capacity' uops in the destination.
+template<typename Queue> void BenchmarkMove(Queue &from, Queue &to,
+		int width, int capacity)
+{
+	for (int i = 0; i < width && from.size() &&
+			(int) to.size() < capacity; i++)
+	{
+		to.push_back(std::move(from.front()));
+		from.pop_front();
+	}
+}
+
+// Run the benchmark for a given pipeline width and queue implementation.
+// Return the number of committed uops per second.
+template<typename Policy> double Benchmark(int width, long long num_uops)
+{
+	// Fresh simulation, using the default configuration
+	ObjectPool::Destroy();
+	misc::IniFile ini_file;
+	Timing::ParseConfiguration(&ini_file);
+	ObjectPool *object_pool = ObjectPool::getInstance();
+	Thread *thread = object_pool->getThread();
+	Context *context = object_pool->getContext();
+
+	// Queues, sized as in the thread
+	int uop_queue_size = Cpu::getUopQueueSize();
+	int reorder_buffer_size = Cpu::getReorderBufferSize();
+	typename Policy::Queue fetch_queue;
+	typename Policy::Queue uop_queue;
+	typename Policy::Queue reorder_buffer;
+	Policy::Reserve(fetch_queue, uop_queue_size);
+	Policy::Reserve(uop_queue, uop_queue_size);
+	Policy::Reserve(reorder_buffer, reorder_buffer_size);
+
+	// Simulate cycles
+	benchmark_random.seed(1);
+	long long num_committed = 0;
+	misc::Timer timer("benchmark");
+	timer.Start();
+	while (num_committed < num_uops)
+	{
+		// Commit
+		for (int i = 0; i < width && (int) reorder_buffer.size() >
+				reorder_buffer_size / 2; i++)
+		{
+			reorder_buffer.pop_front();
+			num_committed++;
+		}
+
+		// Dispatch and decode
+		BenchmarkMove(uop_queue, reorder_buffer, width,
+				reorder_buffer_size);
+		BenchmarkMove(fetch_queue, uop_queue, width, uop_queue_size);
+
+		// Fetch
+		for (int i = 0; i < width && (int) fetch_queue.size() <
+				uop_queue_size; i++)
+			fetch_queue.push_back(Policy::newUop(thread, context,
+					benchmark_opcodes[i % 4]));
+
+		// Misprediction
+		if (benchmark_random() % 64 == 0)
+		{
+			fetch_queue.clear();
+			uop_queue.clear();
+			int num_squashed = reorder_buffer.size() / 2;
+			for (int i = 0; i < num_squashed; i++)
+				reorder_buffer.pop_back();
+		}
+	}
+	timer.Stop();
+
+	// Free uops before destroying the simulation
+	fetch_queue.clear();
+	uop_queue.clear();
+	reorder_buffer.clear();
+	return (double) num_committed / timer.getValue() * 1e6;
+}
+
+}  // namespace x86
+
+
+int main(int argc, char **argv)
+{
+	try
+	{
+		// Number of uops
+		long long num_uops = 20000000;
+		if (argc > 1)
+			num_uops = atoll(argv[1]);
+
+		// Header
+		std::cout << misc::fmt("%10s %18s %18s %10s\n",
+				"Width", "List [uop/s]",
+				"Ring [uop/s]", "Speedup");
+
+		// Run
+		for (int width = 1; width <= 8; width *= 2)
+		{
+			double list = x86::Benchmark<x86::BenchmarkList>(
+					width, num_uops);
+			double ring = x86::Benchmark<x86::BenchmarkRing>(
+					width, num_uops);
+			std::cout << misc::fmt("%10d %18.0f %18.0f %9.2fx\n",
+					width, list, ring, ring / list);
+		}
+	}
+	catch (misc::Exception &e)
+	{
+		e.Dump();
+		return 1;
+	}
+
+	// Success
+	return 0;
+}
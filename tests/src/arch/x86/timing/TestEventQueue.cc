@@ -0,0 +1,285 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "gtest/gtest.h"
+
+#include <iterator>
+#include <limits>
+#include <list>
+#include <random>
+#include <vector>
+
+#include <lib/cpp/IniFile.h>
+#include <arch/x86/emulator/Uinst.h>
+#include <arch/x86/timing/EventQueue.h>
+#include <arch/x86/timing/Timing.h>
+#include <arch/x86/timing/Uop.h>
+
+#include "ObjectPool.h"
+
+namespace x86
+{
+
+// Reference event queue, implemented as a list sorted with Uop::Compare(),
+// as the event queue of the core was originally implemented.
+class ReferenceEventQueue
+{
+	std::list<std::shared_ptr<Uop>> list;
+
+public:
+
+	void Insert(std::shared_ptr<Uop> uop)
+	{
+		auto it = list.begin();
+		while (it != list.end() && uop->Compare(it->get()) >= 0)
+			++it;
+		list.insert(it, uop);
+	}
+
+	void Extract(Uop *uop)
+	{
+		for (auto it = list.begin(); it != list.end(); ++it)
+		{
+			if (it->get() == uop)
+			{
+				list.erase(it);
+				return;
+			}
+		}
+	}
+
+	std::shared_ptr<Uop> getCompleted(long long cycle)
+	{
+		if (list.empty() || list.front()->complete_when > cycle)
+			return nullptr;
+		return list.front();
+	}
+
+	long long getFirstCompletion() const
+	{
+		return list.empty() ? std::numeric_limits<long long>::max() :
+				list.front()->complete_when;
+	}
+
+	const std::list<std::shared_ptr<Uop>> &getList() const { return list; }
+};
+
+
+// Pseudo-random number generator, seeded for reproducible runs
+static std::minstd_rand test_event_queue_random;
+
+
+// Reset the simulation, using the default configuration
+static void TestEventQueueReset()
+{
+	ObjectPool::Destroy();
+	misc::IniFile ini_file;
+	Timing::ParseConfiguration(&ini_file);
+}
+
+
+// Create a uop completing in the given cycle
+static std::shared_ptr<Uop> TestEventQueueUop(long long complete_when)
+{
+	ObjectPool *object_pool = ObjectPool::getInstance();
+	auto uinst = misc::new_shared<Uinst>(Uinst::OpcodeAdd);
+	auto uop = misc::new_shared<Uop>(object_pool->getThread(),
+			object_pool->getContext(),
+			uinst);
+	uop->complete_when = complete_when;
+	return uop;
+}
+
+
+// Extract all uops completing up to the given cycle from both queues, and
+// check that they come out in the same order.
+static void TestEventQueueDrain(EventQueue &event_queue,
+		ReferenceEventQueue &reference, long long cycle)
+{
+	for (;;)
+	{
+		std::shared_ptr<Uop> uop = event_queue.getCompleted(cycle);
+		std::shared_ptr<Uop> expected = reference.getCompleted(cycle);
+		ASSERT_EQ(expected, uop);
+		if (!uop)
+			break;
+		event_queue.Extract(uop.get());
+		reference.Extract(uop.get());
+		ASSERT_FALSE(uop->in_event_queue);
+	}
+}
+
+
+TEST(TestEventQueue, same_cycle_order)
+{
+	// Create uops completing in the same cycle, inserted in reverse order
+	// of identifier.
+	TestEventQueueReset();
+	EventQueue event_queue(4);
+	std::vector<std::shared_ptr<Uop>> uops;
+	for (int i = 0; i < 5; i++)
+		uops.push_back(TestEventQueueUop(2));
+	for (int i = 4; i >= 0; i--)
+		event_queue.Insert(uops[i]);
+	EXPECT_EQ(5, event_queue.getSize());
+	EXPECT_EQ(2, event_queue.getFirstCompletion());
+
+	// Nothing completes before cycle 2
+	EXPECT_EQ(nullptr, event_queue.getCompleted(1));
+
+	// Uops come out in order of identifier
+	for (int i = 0; i < 5; i++)
+	{
+		std::shared_ptr<Uop> uop = event_queue.getCompleted(2);
+		EXPECT_EQ(uops[i], uop);
+		event_queue.Extract(uop.get());
+	}
+	EXPECT_TRUE(event_queue.isEmpty());
+	EXPECT_EQ(nullptr, event_queue.getCompleted(2));
+	EXPECT_EQ(std::numeric_limits<long long>::max(),
+			event_queue.getFirstCompletion());
+}
+
+
+TEST(TestEventQueue, overflow)
+{
+	// Uops beyond the window of 4 cycles go to the overflow list
+	TestEventQueueReset();
+	EventQueue event_queue(4);
+	auto uop_0 = TestEventQueueUop(100);
+	auto uop_1 = TestEventQueueUop(3);
+	auto uop_2 = TestEventQueueUop(10);
+	auto uop_3 = TestEventQueueUop(10);
+	event_queue.Insert(uop_3);
+	event_queue.Insert(uop_0);
+	event_queue.Insert(uop_2);
+	event_queue.Insert(uop_1);
+	EXPECT_EQ(3, event_queue.getFirstCompletion());
+
+	// Extract in order of completion
+	EXPECT_EQ(nullptr, event_queue.getCompleted(2));
+	EXPECT_EQ(uop_1, event_queue.getCompleted(5));
+	event_queue.Extract(uop_1.get());
+	EXPECT_EQ(10, event_queue.getFirstCompletion());
+	EXPECT_EQ(nullptr, event_queue.getCompleted(9));
+
+	// Uop inserted after the window moved, completing before the ones
+	// that were in the overflow list.
+	auto uop_4 = TestEventQueueUop(9);
+	event_queue.Insert(uop_4);
+	EXPECT_EQ(uop_4, event_queue.getCompleted(9));
+	event_queue.Extract(uop_4.get());
+	EXPECT_EQ(uop_2, event_queue.getCompleted(50));
+	event_queue.Extract(uop_2.get());
+	EXPECT_EQ(uop_3, event_queue.getCompleted(50));
+	event_queue.Extract(uop_3.get());
+	EXPECT_EQ(nullptr, event_queue.getCompleted(50));
+	EXPECT_EQ(100, event_queue.getFirstCompletion());
+	EXPECT_EQ(uop_0, event_queue.getCompleted(1000));
+	event_queue.Extract(uop_0.get());
+	EXPECT_TRUE(event_queue.isEmpty());
+}
+
+
+TEST(TestEventQueue, extract_speculative)
+{
+	// Insert speculative and non-speculative uops, some of them in the
+	// overflow list.
+	TestEventQueueReset();
+	EventQueue event_queue(8);
+	std::vector<std::shared_ptr<Uop>> uops;
+	for (int i = 0; i < 10; i++)
+	{
+		auto uop = TestEventQueueUop(i * 3);
+		uop->speculative_mode = i % 2;
+		event_queue.Insert(uop);
+		uops.push_back(uop);
+	}
+
+	// Only non-speculative uops remain
+	event_queue.ExtractSpeculative(ObjectPool::getInstance()->getThread());
+	EXPECT_EQ(5, event_queue.getSize());
+	for (int i = 0; i < 10; i++)
+		EXPECT_EQ(!(i % 2), uops[i]->in_event_queue);
+	for (int i = 0; i < 10; i += 2)
+	{
+		std::shared_ptr<Uop> uop = event_queue.getCompleted(100);
+		EXPECT_EQ(uops[i], uop);
+		event_queue.Extract(uop.get());
+	}
+	EXPECT_TRUE(event_queue.isEmpty());
+}
+
+
+TEST(TestEventQueue, equivalence)
+{
+	// Run a random sequence of insertions, extractions of arbitrary uops,
+	// and drains at cycles that sometimes skip ahead, checking that the
+	// uops are extracted in the same order as in the reference queue.
+	TestEventQueueReset();
+	test_event_queue_random.seed(1);
+	EventQueue event_queue(16);
+	ReferenceEventQueue reference;
+	long long cycle = 0;
+	for (int i = 0; i < 20000; i++)
+	{
+		// Insert some uops with latencies within and beyond the wheel.
+		// Latency 0 models memory accesses completing after the
+		// writeback stage of the current cycle.
+		int num_uops = test_event_queue_random() % 4;
+		for (int j = 0; j < num_uops; j++)
+		{
+			int latency = test_event_queue_random() % 10 ?
+					test_event_queue_random() % 16 :
+					test_event_queue_random() % 200;
+			auto uop = TestEventQueueUop(cycle + latency);
+			event_queue.Insert(uop);
+			reference.Insert(uop);
+		}
+
+		// Occasionally extract an arbitrary uop, as in recovery
+		if (event_queue.getSize() && test_event_queue_random() % 8 == 0)
+		{
+			auto &list = reference.getList();
+			auto it = list.begin();
+			std::advance(it, test_event_queue_random() % list.size());
+			std::shared_ptr<Uop> uop = *it;
+			event_queue.Extract(uop.get());
+			reference.Extract(uop.get());
+		}
+
+		// Check first completion and size
+		ASSERT_EQ(reference.getFirstCompletion(),
+				event_queue.getFirstCompletion());
+		ASSERT_EQ((int) reference.getList().size(),
+				event_queue.getSize());
+
+		// Next cycle, sometimes skipping idle cycles
+		cycle += test_event_queue_random() % 16 ? 1 :
+				test_event_queue_random() % 100;
+		TestEventQueueDrain(event_queue, reference, cycle);
+	}
+
+	// Drain everything
+	TestEventQueueDrain(event_queue, reference,
+			std::numeric_limits<long long>::max() / 2);
+	EXPECT_TRUE(event_queue.isEmpty());
+}
+
+}
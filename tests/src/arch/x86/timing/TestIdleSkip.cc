@@ -0,0 +1,258 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <vector>
+
+#include <lib/cpp/IniFile.h>
+#include <lib/esim/Engine.h>
+#include <memory/System.h>
+#include <network/System.h>
+#include <arch/x86/emulator/Emulator.h>
+#include <arch/x86/timing/Core.h>
+#include <arch/x86/timing/Cpu.h>
+#include <arch/x86/timing/Timing.h>
+
+namespace x86
+{
+
+// Address of the guest code
+static const unsigned test_idle_skip_code_address = 0x8048000;
+
+// Address of the array traversed by the guest
+static const unsigned test_idle_skip_data_address = 0x10000000;
+
+// Number of cache blocks in the array
+static const int test_idle_skip_num_blocks = 2048;
+
+// Results of a simulation compared across runs
+struct TestIdleSkipResult
+{
+	long long cycles = 0;
+	long long num_iterations = 0;
+	long long num_committed_instructions = 0;
+	std::vector<long long> dispatch_stalls;
+	std::vector<long long> num_denied_accesses;
+};
+
+
+static void Cleanup()
+{
+	mem::System::Destroy();
+	net::System::Destroy();
+	Timing::Destroy();
+	Emulator::Destroy();
+	comm::ArchPool::Destroy();
+	esim::Engine::Destroy();
+}
+
+
+// Append bytes to the guest code
+static void Emit(std::vector<unsigned char> &code,
+		std::initializer_list<unsigned char> bytes)
+{
+	code.insert(code.end(), bytes);
+}
+
+
+// Append a 32-bit value to the guest code
+static void Emit32(std::vector<unsigned char> &code, unsigned value)
+{
+	for (int i = 0; i < 4; i++)
+		code.push_back(value >> (i * 8));
+}
+
+
+// Program following a chain of pointers, one per cache block of the array,
+// so that every load misses in the caches and depends on the previous one.
+// Two independent divisions per iteration compete for the divider while the
+// pipeline waits for memory.
+static std::vector<unsigned char> TestIdleSkipProgram()
+{
+	std::vector<unsigned char> code;
+
+	// mov ebx, data
+	// mov ecx, num_blocks
+	// mov esi, 3
+	Emit(code, { 0xbb });
+	Emit32(code, test_idle_skip_data_address);
+	Emit(code, { 0xb9 });
+	Emit32(code, test_idle_skip_num_blocks);
+	Emit(code, { 0xbe, 0x03, 0x00, 0x00, 0x00 });
+
+	// loop:
+	//	mov eax, [ebx]
+	//	add ebx, eax
+	//	mov edx, 0
+	//	mov eax, edi
+	//	div esi
+	//	mov edx, 0
+	//	mov eax, ebp
+	//	div esi
+	//	dec ecx
+	//	jnz loop
+	unsigned loop = code.size();
+	Emit(code, { 0x8b, 0x03 });
+	Emit(code, { 0x01, 0xc3 });
+	Emit(code, { 0xba, 0x00, 0x00, 0x00, 0x00 });
+	Emit(code, { 0x89, 0xf8 });
+	Emit(code, { 0xf7, 0xf6 });
+	Emit(code, { 0xba, 0x00, 0x00, 0x00, 0x00 });
+	Emit(code, { 0x89, 0xe8 });
+	Emit(code, { 0xf7, 0xf6 });
+	Emit(code, { 0x49 });
+	Emit(code, { 0x75, (unsigned char) (loop - (code.size() + 2)) });
+
+	// mov eax, 1
+	// xor ebx, ebx
+	// int 0x80
+	Emit(code, { 0xb8, 0x01, 0x00, 0x00, 0x00 });
+	Emit(code, { 0x31, 0xdb });
+	Emit(code, { 0xcd, 0x80 });
+	return code;
+}
+
+
+// Run the program in a detailed simulation with the default memory
+// hierarchy, using the main simulation loop of m2s.cc with or without
+// skipping idle cycles.
+static void TestIdleSkipRun(bool idle_skip, TestIdleSkipResult &result)
+{
+	// Cleanup singleton instances
+	Cleanup();
+
+	// The memory hierarchy draws retry latencies from random(), so both
+	// runs must start from the same sequence
+	srandom(1);
+
+	// CPU configuration, with enough physical registers for the reorder
+	// buffer to fill up with divisions waiting for the divider. The
+	// configuration of functional units is static, so the divider is
+	// given explicitly in case another test changed it.
+	misc::IniFile config_ini;
+	config_ini.LoadFromString(
+			"[ Queues ]\n"
+			"RfIntSize = 256\n"
+			"[ FunctionalUnits ]\n"
+			"IntDiv.Count = 1\n"
+			"IntDiv.OpLat = 14\n"
+			"IntDiv.IssueLat = 11");
+	Timing::ParseConfiguration(&config_ini);
+	Emulator *emulator = Emulator::getInstance();
+	Timing *timing = Timing::getInstance();
+	mem::System::getInstance()->ReadConfiguration();
+
+	// Context
+	Context *context = emulator->newContext();
+	context->Initialize();
+	mem::Memory *memory = context->getMemory();
+	std::vector<unsigned char> code = TestIdleSkipProgram();
+	memory->Map(test_idle_skip_code_address, mem::Memory::PageSize,
+			mem::Memory::AccessRead |
+			mem::Memory::AccessExec |
+			mem::Memory::AccessInit);
+	memory->Init(test_idle_skip_code_address, code.size(),
+			(const char *) code.data());
+	memory->Map(test_idle_skip_data_address,
+			test_idle_skip_num_blocks * 64,
+			mem::Memory::AccessRead |
+			mem::Memory::AccessWrite);
+	for (int i = 0; i < test_idle_skip_num_blocks; i++)
+	{
+		unsigned next = 64;
+		memory->Write(test_idle_skip_data_address + i * 64, 4,
+				(char *) &next);
+	}
+	context->getRegs().setEip(test_idle_skip_code_address);
+	context->setState(Context::StateRunning);
+	context->setUinstActive(true);
+
+	// Main simulation loop
+	esim::Engine *esim = esim::Engine::getInstance();
+	comm::ArchPool *arch_pool = comm::ArchPool::getInstance();
+	while (!esim->hasFinished())
+	{
+		int num_active_emulators;
+		int num_active_timing_simulators;
+		arch_pool->Run(num_active_emulators,
+				num_active_timing_simulators);
+		if (num_active_timing_simulators)
+			esim->ProcessEvents();
+		if (num_active_timing_simulators && !num_active_emulators &&
+				idle_skip)
+		{
+			long long time = esim->getTime();
+			if (esim->SkipIdleCycles(arch_pool->getWakeupTime()) > time)
+				arch_pool->SkipCycles(time);
+		}
+		if (!num_active_emulators && !num_active_timing_simulators)
+			esim->Finish("ContextsFinished");
+		result.num_iterations++;
+	}
+	esim->ProcessAllEvents();
+
+	// Results
+	Cpu *cpu = timing->getCpu();
+	Core *core = cpu->getCore(0);
+	result.cycles = timing->getCycle();
+	result.num_committed_instructions = cpu->getNumCommittedInstructions();
+	for (int i = 0; i < Thread::DispatchStallMax; i++)
+		result.dispatch_stalls.push_back(core->getDispatchStall(
+				(Thread::DispatchStall) i));
+	for (int i = 1; i < FunctionalUnit::TypeCount; i++)
+		result.num_denied_accesses.push_back(core->getAlu()->
+				getFunctionalUnit((FunctionalUnit::Type) i)->
+				getNumDeniedAccesses());
+
+	Cleanup();
+}
+
+
+// This test checks that skipping idle cycles in the main simulation loop
+// gives the same cycle count and statistics as simulating every cycle, on a
+// guest program that stalls on memory most of the time.
+TEST(TestIdleSkip, idle_skip_matches_full_run)
+{
+	TestIdleSkipResult full;
+	TestIdleSkipRun(false, full);
+	TestIdleSkipResult skip;
+	TestIdleSkipRun(true, skip);
+
+	// The program ran to completion, stalling on memory and on the
+	// divider
+	EXPECT_GT(full.num_committed_instructions,
+			10 * test_idle_skip_num_blocks);
+	EXPECT_GT(full.cycles, 100 * test_idle_skip_num_blocks);
+	EXPECT_GT(full.num_denied_accesses[FunctionalUnit::TypeIntDiv - 1],
+			0);
+
+	// Cycles were skipped
+	EXPECT_LT(skip.num_iterations, full.num_iterations / 2);
+
+	// Both runs match
+	EXPECT_EQ(full.cycles, skip.cycles);
+	EXPECT_EQ(full.num_committed_instructions,
+			skip.num_committed_instructions);
+	EXPECT_EQ(full.dispatch_stalls, skip.dispatch_stalls);
+	EXPECT_EQ(full.num_denied_accesses, skip.num_denied_accesses);
+}
+
+}
@@ -0,0 +1,304 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "gtest/gtest.h"
+
+#include <list>
+#include <random>
+#include <vector>
+
+#include <lib/cpp/IniFile.h>
+#include <lib/esim/Engine.h>
+#include <memory/System.h>
+#include <arch/x86/emulator/Emulator.h>
+#include <arch/x86/timing/Cpu.h>
+#include <arch/x86/timing/RegisterFile.h>
+#include <arch/x86/timing/Thread.h>
+#include <arch/x86/timing/Timing.h>
+#include <arch/x86/timing/Uop.h>
+
+namespace x86
+{
+
+// Address of the guest code
+static const unsigned test_issue_code_address = 0x8048000;
+
+// Address of the guest data page
+static const unsigned test_issue_data_address = 0x10000000;
+
+// Pseudo-random number generator, seeded for reproducible runs
+static std::minstd_rand test_issue_random;
+
+
+static void Cleanup()
+{
+	mem::System::Destroy();
+	Timing::Destroy();
+	Emulator::Destroy();
+	comm::ArchPool::Destroy();
+	esim::Engine::Destroy();
+}
+
+
+// Append bytes to the guest code
+static void Emit(std::vector<unsigned char> &code,
+		std::initializer_list<unsigned char> bytes)
+{
+	code.insert(code.end(), bytes);
+}
+
+
+// Append a 32-bit value to the guest code
+static void Emit32(std::vector<unsigned char> &code, unsigned value)
+{
+	for (int i = 0; i < 4; i++)
+		code.push_back(value >> (i * 8));
+}
+
+
+// Endless loop of random integer operations, multiplications, loads and
+// stores on registers eax, edx, ebp, esi, and edi, forming dependency chains
+// through registers and memory. Branches on the lowest bit of the computed
+// values are mispredicted often, squashing uops waiting for their inputs.
+static std::vector<unsigned char> TestIssueProgram(int size)
+{
+	const unsigned char registers[] = { 0, 2, 5, 6, 7 };
+	std::vector<unsigned char> code;
+
+	// mov ebx, data
+	Emit(code, { 0xbb });
+	Emit32(code, test_issue_data_address);
+
+	// loop:
+	unsigned loop = code.size();
+	for (int i = 0; i < size; i++)
+	{
+		unsigned char r1 = registers[test_issue_random() % 5];
+		unsigned char r2 = registers[test_issue_random() % 5];
+		unsigned char offset = (test_issue_random() % 32) * 4;
+		switch (test_issue_random() % 6)
+		{
+		case 0:
+
+			// add r1, r2
+			Emit(code, { 0x01, (unsigned char) (0xc0 | r2 << 3 |
+					r1) });
+			break;
+
+		case 1:
+
+			// imul r1, r2
+			Emit(code, { 0x0f, 0xaf, (unsigned char) (0xc0 |
+					r1 << 3 | r2) });
+			break;
+
+		case 2:
+
+			// mov r1, [ebx + offset]
+			Emit(code, { 0x8b, (unsigned char) (0x40 | r1 << 3 |
+					3), offset });
+			break;
+
+		case 3:
+
+			// mov [ebx + offset], r1
+			Emit(code, { 0x89, (unsigned char) (0x40 | r1 << 3 |
+					3), offset });
+			break;
+
+		case 4:
+
+			// add r1, [ebx + offset]
+			Emit(code, { 0x03, (unsigned char) (0x40 | r1 << 3 |
+					3), offset });
+			break;
+
+		case 5:
+
+			// test r1, 1
+			// jz skip
+			// add r2, r1
+			// skip:
+			Emit(code, { 0xf7, (unsigned char) (0xc0 | r1) });
+			Emit32(code, 1);
+			Emit(code, { 0x74, 2 });
+			Emit(code, { 0x01, (unsigned char) (0xc0 | r1 << 3 |
+					r2) });
+			break;
+		}
+	}
+
+	// jmp loop
+	Emit(code, { 0xe9 });
+	Emit32(code, loop - (code.size() + 4));
+	return code;
+}
+
+
+// Check that the ready list contains exactly the uops of the queue found
+// ready by a full scan with RegisterFile::isUopReady(), in the same order.
+// The number of uops not ready is added to 'num_waiting'.
+static void TestIssueCheck(RegisterFile *register_file,
+		const std::list<std::shared_ptr<Uop>> &queue,
+		const std::list<std::shared_ptr<Uop>> &ready_list,
+		long long &num_waiting)
+{
+	std::vector<Uop *> expected;
+	for (auto &uop : queue)
+	{
+		// Check the input registers, ignoring the flag set when the
+		// uop was woken up
+		bool ready = uop->ready;
+		uop->ready = false;
+		bool reference = register_file->isUopReady(uop.get());
+		uop->ready = ready;
+		ASSERT_EQ(reference, ready);
+		ASSERT_EQ(reference, uop->in_ready_list);
+		if (reference)
+			expected.push_back(uop.get());
+		else
+			num_waiting++;
+	}
+	std::vector<Uop *> actual;
+	for (auto &uop : ready_list)
+		actual.push_back(uop.get());
+	ASSERT_EQ(expected, actual);
+}
+
+
+// Run the random program for a number of cycles, checking the ready lists
+// of the instruction queue and load queue after every cycle.
+static void TestIssueRun(const std::string &recover_kind)
+{
+	// Cleanup singleton instances
+	Cleanup();
+
+	// CPU configuration
+	misc::IniFile config_ini;
+	config_ini.LoadFromString(
+			"[ General ]\n"
+			"RecoverKind = " + recover_kind + "\n"
+			"[ Queues ]\n"
+			"IqSize = 64\n"
+			"LsqSize = 32\n"
+			"[ TraceCache ]\n"
+			"Present = f");
+	Timing::ParseConfiguration(&config_ini);
+	Emulator *emulator = Emulator::getInstance();
+	Timing *timing = Timing::getInstance();
+
+	// Memory configuration, with a long latency for loads
+	misc::IniFile mem_config_ini;
+	mem_config_ini.LoadFromString(
+			"[ General ]\n"
+			"[ Module mod-mm ]\n"
+			"Type = MainMemory\n"
+			"Latency = 20\n"
+			"BlockSize = 64\n"
+			"[ Entry core-1 ]\n"
+			"Arch = x86\n"
+			"Core = 0\n"
+			"Thread = 0\n"
+			"Module = mod-mm\n");
+	mem::System::getInstance()->ReadConfiguration(&mem_config_ini);
+
+	// Context with the program and random data
+	Context *context = emulator->newContext();
+	context->Initialize();
+	mem::Memory *memory = context->getMemory();
+	std::vector<unsigned char> code = TestIssueProgram(200);
+	memory->Map(test_issue_code_address, misc::RoundUp((unsigned)
+			code.size(), mem::Memory::PageSize),
+			mem::Memory::AccessRead |
+			mem::Memory::AccessExec |
+			mem::Memory::AccessInit);
+	memory->Init(test_issue_code_address, code.size(),
+			(const char *) code.data());
+	memory->Map(test_issue_data_address, mem::Memory::PageSize,
+			mem::Memory::AccessRead |
+			mem::Memory::AccessWrite);
+	for (int i = 0; i < 32; i++)
+	{
+		unsigned value = test_issue_random();
+		memory->Write(test_issue_data_address + i * 4, 4,
+				(char *) &value);
+	}
+	context->setState(Context::StateRunning);
+	context->getRegs().setEip(test_issue_code_address);
+	context->setUinstActive(true);
+
+	// Map the context to the thread
+	Thread *thread = timing->getCpu()->getThread(0, 0);
+	thread->MapContext(context);
+	thread->Schedule();
+	thread->setFetchNeip(test_issue_code_address);
+
+	// Simulation
+	RegisterFile *register_file = thread->getRegisterFile();
+	esim::Engine *engine = esim::Engine::getInstance();
+	long long num_waiting = 0;
+	long long num_squashed = 0;
+	long long num_recoveries_with_waiting_uops = 0;
+	for (int i = 0; i < 100000; i++)
+	{
+		// Run one cycle
+		timing->Run();
+		engine->ProcessEvents();
+
+		// Recovery squashing uops while others were waiting
+		if (thread->getNumSquashedUinsts() > num_squashed &&
+				num_waiting)
+			num_recoveries_with_waiting_uops++;
+		num_squashed = thread->getNumSquashedUinsts();
+
+		// Check ready lists
+		num_waiting = 0;
+		TestIssueCheck(register_file,
+				thread->getInstructionQueue(),
+				thread->getInstructionReadyList(),
+				num_waiting);
+		TestIssueCheck(register_file,
+				thread->getLoadQueue(),
+				thread->getLoadReadyList(),
+				num_waiting);
+		if (::testing::Test::HasFatalFailure())
+			return;
+	}
+
+	// The program exercised mispredictions with uops waiting for their
+	// input operands
+	EXPECT_GT(thread->getNumCommittedUinsts(), 10000);
+	EXPECT_GT(thread->getNumMispredictedBranches(), 20);
+	EXPECT_GT(num_recoveries_with_waiting_uops, 20);
+
+	Cleanup();
+}
+
+
+// This test runs random dependency chains with frequent mispredictions, and
+// checks after every cycle that the issue stage selects the same uops in the
+// same order as a full scan of the instruction queue and load queue would.
+TEST(TestIssue, ready_lists_match_full_scan)
+{
+	test_issue_random.seed(1);
+	TestIssueRun("Writeback");
+	TestIssueRun("Commit");
+}
+
+}
@@ -0,0 +1,465 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+#include <lib/cpp/IniFile.h>
+#include <lib/cpp/String.h>
+#include <lib/esim/Engine.h>
+#include <memory/Mmu.h>
+#include <memory/System.h>
+#include <network/System.h>
+#include <arch/x86/emulator/Emulator.h>
+#include <arch/x86/timing/Cpu.h>
+#include <arch/x86/timing/Thread.h>
+#include <arch/x86/timing/Timing.h>
+
+namespace x86
+{
+
+// Address of the guest code
+static const unsigned test_sampling_code_address = 0x8048000;
+
+// Address of the array traversed by the guest
+static const unsigned test_sampling_data_address = 0x10000000;
+
+// Number of loop iterations of the guest, and bytes of the array read in
+// each of them
+static const int test_sampling_num_iterations = 10000;
+static const int test_sampling_stride = 16;
+
+// Number of instructions of the guest: two before the loop, five per
+// iteration, and three to exit
+static const long long test_sampling_num_instructions =
+		2 + 5 * test_sampling_num_iterations + 3;
+
+// Sampling parameters
+static const long long test_sampling_period = 10000;
+static const long long test_sampling_warmup = 1000;
+static const long long test_sampling_length = 2000;
+
+// Switch between phases of sampled simulation
+struct TestSamplingSwitch
+{
+	Timing::SamplingPhase phase;
+	long long num_committed_instructions;
+	long long num_functional_instructions;
+
+	// Whether the guest had run all of its instructions
+	bool finished;
+
+	// Whether the last block read by the guest was in the data cache
+	// after switching to this phase, while the guest was running
+	bool last_block_cached;
+};
+
+// Results of a simulation
+struct TestSamplingResult
+{
+	long long cycles = 0;
+	long long num_committed_instructions = 0;
+	long long num_functional_instructions = 0;
+	std::vector<TestSamplingSwitch> switches;
+	std::vector<double> sample_cpis;
+	std::string summary;
+};
+
+
+static void Cleanup()
+{
+	mem::System::Destroy();
+	net::System::Destroy();
+	Timing::Destroy();
+	Emulator::Destroy();
+	comm::ArchPool::Destroy();
+	esim::Engine::Destroy();
+}
+
+
+// Append bytes to the guest code
+static void Emit(std::vector<unsigned char> &code,
+		std::initializer_list<unsigned char> bytes)
+{
+	code.insert(code.end(), bytes);
+}
+
+
+// Append a 32-bit value to the guest code
+static void Emit32(std::vector<unsigned char> &code, unsigned value)
+{
+	for (int i = 0; i < 4; i++)
+		code.push_back(value >> (i * 8));
+}
+
+
+// Program reading the array sequentially, with a fixed number of
+// instructions and the same behavior in every iteration
+static std::vector<unsigned char> TestSamplingProgram()
+{
+	std::vector<unsigned char> code;
+
+	// mov ebx, data
+	// mov ecx, num_iterations
+	Emit(code, { 0xbb });
+	Emit32(code, test_sampling_data_address);
+	Emit(code, { 0xb9 });
+	Emit32(code, test_sampling_num_iterations);
+
+	// loop:
+	//	mov eax, [ebx]
+	//	add edx, eax
+	//	add ebx, stride
+	//	dec ecx
+	//	jnz loop
+	unsigned loop = code.size();
+	Emit(code, { 0x8b, 0x03 });
+	Emit(code, { 0x01, 0xc2 });
+	Emit(code, { 0x83, 0xc3, test_sampling_stride });
+	Emit(code, { 0x49 });
+	Emit(code, { 0x75, (unsigned char) (loop - (code.size() + 2)) });
+
+	// mov eax, 1
+	// xor ebx, ebx
+	// int 0x80
+	Emit(code, { 0xb8, 0x01, 0x00, 0x00, 0x00 });
+	Emit(code, { 0x31, 0xdb });
+	Emit(code, { 0xcd, 0x80 });
+	return code;
+}
+
+
+// Return whether the block last read by the guest, after running the given
+// number of instructions, is in the data cache of the thread running it.
+// The address is not taken from the registers of the context, since the
+// fetch stage may have run further instructions in the meantime.
+static bool TestSamplingLastBlockCached(Context *context,
+		long long num_instructions)
+{
+	Thread *thread = context->thread;
+	if (!thread)
+		return false;
+
+	// Two instructions before the loop, and five per iteration, the
+	// first of which reads the array
+	long long num_loads = (num_instructions - 2 + 4) / 5;
+	if (num_loads <= 0)
+		return false;
+	unsigned address = test_sampling_data_address +
+			(num_loads - 1) * test_sampling_stride;
+	int set;
+	int way;
+	int tag;
+	mem::Cache::BlockState state;
+	return thread->data_module->FindBlock(context->getMmu()->
+			TranslateVirtualAddress(context->getMmuSpace(), address),
+			set, way, tag, state) && state != mem::Cache::BlockInvalid;
+}
+
+
+// Run the program with the default memory hierarchy, sampled with the
+// given functional warming setting if 'sampling' is set, or in detail
+// otherwise, recording every switch between phases of sampled simulation.
+static void TestSamplingRun(bool sampling, bool functional_warming,
+		TestSamplingResult &result)
+{
+	// Cleanup singleton instances
+	Cleanup();
+
+	// The memory hierarchy draws retry latencies from random(), so all
+	// runs must start from the same sequence
+	srandom(1);
+
+	// Configuration
+	misc::IniFile config_ini;
+	if (sampling)
+		config_ini.LoadFromString(misc::fmt(
+				"[ General ]\n"
+				"SamplingPeriod = %lld\n"
+				"SamplingWarmup = %lld\n"
+				"SamplingLength = %lld\n"
+				"SamplingFunctionalWarming = %s",
+				test_sampling_period,
+				test_sampling_warmup,
+				test_sampling_length,
+				functional_warming ? "t" : "f"));
+	Timing::ParseConfiguration(&config_ini);
+	Emulator *emulator = Emulator::getInstance();
+	Timing *timing = Timing::getInstance();
+	mem::System::getInstance()->ReadConfiguration();
+
+	// Context
+	Context *context = emulator->newContext();
+	context->Initialize();
+	mem::Memory *memory = context->getMemory();
+	std::vector<unsigned char> code = TestSamplingProgram();
+	memory->Map(test_sampling_code_address, mem::Memory::PageSize,
+			mem::Memory::AccessRead |
+			mem::Memory::AccessExec |
+			mem::Memory::AccessInit);
+	memory->Init(test_sampling_code_address, code.size(),
+			(const char *) code.data());
+	memory->Map(test_sampling_data_address,
+			test_sampling_num_iterations * test_sampling_stride,
+			mem::Memory::AccessRead |
+			mem::Memory::AccessWrite);
+	context->getRegs().setEip(test_sampling_code_address);
+	context->setState(Context::StateRunning);
+	context->setUinstActive(true);
+
+	// Main simulation loop
+	esim::Engine *esim = esim::Engine::getInstance();
+	comm::ArchPool *arch_pool = comm::ArchPool::getInstance();
+	Cpu *cpu = timing->getCpu();
+	Timing::SamplingPhase phase = timing->getSamplingPhase();
+	while (!esim->hasFinished())
+	{
+		int num_active_emulators;
+		int num_active_timing_simulators;
+		arch_pool->Run(num_active_emulators,
+				num_active_timing_simulators);
+		if (num_active_timing_simulators)
+			esim->ProcessEvents();
+		if (!num_active_emulators && !num_active_timing_simulators)
+			esim->Finish("ContextsFinished");
+
+		// Record switch between phases
+		if (timing->getSamplingPhase() == phase)
+			continue;
+		phase = timing->getSamplingPhase();
+		long long num_instructions = cpu->getNumCommittedInstructions() +
+				timing->getNumSamplingFunctionalInstructions();
+		bool finished = num_instructions ==
+				test_sampling_num_instructions;
+		result.switches.push_back({
+				phase,
+				cpu->getNumCommittedInstructions(),
+				timing->getNumSamplingFunctionalInstructions(),
+				finished,
+				!finished && TestSamplingLastBlockCached(context,
+						num_instructions) });
+	}
+	esim->ProcessAllEvents();
+
+	// Results
+	result.cycles = timing->getCycle();
+	result.num_committed_instructions = cpu->getNumCommittedInstructions();
+	result.num_functional_instructions =
+			timing->getNumSamplingFunctionalInstructions();
+	result.sample_cpis = timing->getSampleCpis();
+	std::ostringstream summary;
+	timing->DumpSummary(summary);
+	result.summary = summary.str();
+
+	// Restore the default configuration
+	misc::IniFile default_ini;
+	Timing::ParseConfiguration(&default_ini);
+	Cleanup();
+}
+
+
+// Return the value of a variable in the summary, or the lower or upper end
+// of an interval given as '[low, high]' if 'index' is 0 or 1.
+static double TestSamplingSummaryValue(const std::string &summary,
+		const std::string &name, int index = 0)
+{
+	std::istringstream is(summary);
+	std::string line;
+	while (std::getline(is, line))
+	{
+		if (line.compare(0, name.size() + 3, name + " = "))
+			continue;
+		std::string value = line.substr(name.size() + 3);
+		if (value[0] == '[')
+			value = index ? value.substr(value.find(',') + 1) :
+					value.substr(1);
+		return atof(value.c_str());
+	}
+	ADD_FAILURE() << name << " not found in summary";
+	return 0.0;
+}
+
+
+// This test checks the switches between the detailed warm-up, detailed
+// measured, draining, and functional phases of sampled simulation on a
+// guest with a fixed number of instructions, and the IPC reported for the
+// samples.
+TEST(TestSampling, phase_switches)
+{
+	TestSamplingResult detailed;
+	TestSamplingRun(false, false, detailed);
+	TestSamplingResult sampled;
+	TestSamplingRun(true, true, sampled);
+
+	// The detailed run commits every instruction
+	EXPECT_EQ(test_sampling_num_instructions,
+			detailed.num_committed_instructions);
+	EXPECT_EQ(0, detailed.num_functional_instructions);
+	EXPECT_TRUE(detailed.switches.empty());
+	EXPECT_TRUE(detailed.sample_cpis.empty());
+
+	// The sampled run runs every instruction once, either in detail or
+	// functionally
+	EXPECT_EQ(test_sampling_num_instructions,
+			sampled.num_committed_instructions +
+			sampled.num_functional_instructions);
+	EXPECT_LT(sampled.cycles, detailed.cycles / 2);
+
+	// Phases follow each other in order, starting with the warm-up
+	// phase. Each warm-up and measured phase lasts for the configured
+	// number of instructions, up to the commit width. Phases switch at
+	// the beginning of a cycle, while they are recorded here after the
+	// instructions of that cycle commit, which adds up to one more commit
+	// width of error on each side. The instructions in flight when fetch
+	// stops are committed while draining. These are bounded by the
+	// reorder buffer, the uop queue, and the fetch queue, given in bytes
+	// of at least one per instruction. Instructions only run
+	// functionally after draining, up to the end of the period or of the
+	// guest.
+	int commit_width = Cpu::getCommitWidth();
+	int num_samples = 0;
+	TestSamplingSwitch previous = { Timing::SamplingPhaseWarmup, 0, 0,
+			false, false };
+	for (auto &s : sampled.switches)
+	{
+		long long num_committed = s.num_committed_instructions -
+				previous.num_committed_instructions;
+		long long num_functional = s.num_functional_instructions -
+				previous.num_functional_instructions;
+		switch (s.phase)
+		{
+		case Timing::SamplingPhaseMeasure:
+
+			ASSERT_EQ(Timing::SamplingPhaseWarmup, previous.phase);
+			EXPECT_GE(num_committed, test_sampling_warmup -
+					commit_width);
+			EXPECT_LT(num_committed, test_sampling_warmup +
+					2 * commit_width);
+			EXPECT_EQ(0, num_functional);
+			break;
+
+		case Timing::SamplingPhaseDrain:
+
+			ASSERT_EQ(Timing::SamplingPhaseMeasure, previous.phase);
+			EXPECT_GE(num_committed, test_sampling_length -
+					commit_width);
+			EXPECT_LT(num_committed, test_sampling_length +
+					2 * commit_width);
+			EXPECT_EQ(0, num_functional);
+			num_samples++;
+			break;
+
+		case Timing::SamplingPhaseWarmup:
+
+		{
+			ASSERT_EQ(Timing::SamplingPhaseDrain, previous.phase);
+			EXPECT_LE(num_committed, Cpu::getReorderBufferSize() +
+					Cpu::getUopQueueSize() +
+					Cpu::getFetchQueueSize());
+			long long num_remaining = test_sampling_num_instructions -
+					s.num_committed_instructions -
+					previous.num_functional_instructions;
+			EXPECT_EQ(std::min(num_remaining, test_sampling_period -
+					test_sampling_warmup -
+					test_sampling_length), num_functional);
+			EXPECT_EQ(num_remaining == num_functional, s.finished);
+
+			// Functional warming brought the data read by the
+			// guest into the cache
+			EXPECT_EQ(!s.finished, s.last_block_cached);
+			break;
+		}
+		}
+		previous = s;
+	}
+	EXPECT_EQ(test_sampling_num_instructions / test_sampling_period,
+			num_samples);
+	ASSERT_EQ(num_samples, (int) sampled.sample_cpis.size());
+
+	// Reported IPC, estimated from the mean CPI of the samples, with its
+	// confidence interval
+	double mean = 0.0;
+	for (double cpi : sampled.sample_cpis)
+		mean += cpi;
+	mean /= num_samples;
+	double variance = 0.0;
+	for (double cpi : sampled.sample_cpis)
+		variance += (cpi - mean) * (cpi - mean);
+	variance /= num_samples - 1;
+	double error = sqrt(variance / num_samples);
+	double ipc = TestSamplingSummaryValue(sampled.summary,
+			"SampledInstructionsPerCycle");
+	double low = TestSamplingSummaryValue(sampled.summary,
+			"SampledInstructionsPerCycleInterval95", 0);
+	double high = TestSamplingSummaryValue(sampled.summary,
+			"SampledInstructionsPerCycleInterval95", 1);
+	EXPECT_EQ(num_samples, TestSamplingSummaryValue(sampled.summary,
+			"Samples"));
+	EXPECT_NEAR(1.0 / mean, ipc, 1e-3 * ipc);
+	EXPECT_NEAR(1.0 / (mean + 1.96 * error), low, 1e-3 * ipc);
+	EXPECT_NEAR(1.0 / (mean - 1.96 * error), high, 1e-3 * ipc);
+	EXPECT_LE(low, ipc);
+	EXPECT_GE(high, ipc);
+
+	// The guest behaves the same in every iteration, so the IPC of the
+	// samples estimates the IPC of the detailed run
+	double detailed_ipc = (double) detailed.num_committed_instructions /
+			detailed.cycles;
+	EXPECT_NEAR(detailed_ipc, ipc, 0.1 * detailed_ipc);
+}
+
+
+// This test checks that the caches are only warmed up between samples when
+// functional warming is enabled.
+TEST(TestSampling, functional_warming)
+{
+	TestSamplingResult warm;
+	TestSamplingRun(true, true, warm);
+	TestSamplingResult cold;
+	TestSamplingRun(true, false, cold);
+
+	// Both runs switch phases after the same number of instructions
+	ASSERT_EQ(warm.switches.size(), cold.switches.size());
+	int num_functional_phases = 0;
+	for (unsigned i = 0; i < warm.switches.size(); i++)
+	{
+		TestSamplingSwitch &w = warm.switches[i];
+		TestSamplingSwitch &c = cold.switches[i];
+		ASSERT_EQ(w.phase, c.phase);
+		EXPECT_EQ(w.num_functional_instructions,
+				c.num_functional_instructions);
+		if (w.phase != Timing::SamplingPhaseWarmup || w.finished)
+			continue;
+
+		// After running functionally, the block last read by the
+		// guest is cached only with functional warming
+		EXPECT_TRUE(w.last_block_cached);
+		EXPECT_FALSE(c.last_block_cached);
+		num_functional_phases++;
+	}
+	EXPECT_GT(num_functional_phases, 0);
+}
+
+
+}
@@ -0,0 +1,306 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2015  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <dram/Address.h>
+#include <dram/Channel.h>
+#include <dram/Controller.h>
+#include <dram/Request.h>
+#include <dram/System.h>
+#include <lib/cpp/Error.h>
+#include <lib/cpp/IniFile.h>
+#include <lib/cpp/Misc.h>
+#include <lib/esim/Engine.h>
+
+
+// Trace-driven benchmark comparing the scheduling policies of the DRAM
+// model on bandwidth and average request latency. A trace contains one
+// request per line, in order of issue, in the format
+//
+//	<cycle> {R|W} <address>
+//
+// where <cycle> is the DRAM cycle when the request is issued, and <address>
+// is an encoded DRAM address, which maps from MSB to LSB to rank, bank, row
+// and column. Each request transfers 64 bytes. Without a trace file, a set
+// of synthetic traces is used, issuing one request every <interval> cycles:
+//
+//	stream	Eight interleaved sequential streams, two of them in each of
+//		four banks, so that streams sharing a bank compete for its row
+//		buffer.
+//	random	Random addresses, one third of them writes.
+//	mixed	The streams of 'stream' with every fourth request replaced by
+//		a write to a random address.
+//
+// Run as
+//
+//	src_dram_benchmark [<trace_file>] | [<num_requests> [<interval>]]
+//
+
+namespace dram
+{
+
+// Controller geometry, as used to generate synthetic traces
+const int benchmark_num_ranks = 2;
+const int benchmark_num_banks = 8;
+const int benchmark_num_rows = 1024;
+const int benchmark_num_columns = 1024;
+
+// Bytes transferred by each request
+const int benchmark_request_size = 64;
+
+// Common part of the configuration for all runs
+const std::string benchmark_config =
+		"[ General ]\n"
+		"Frequency = 800\n"
+		"[ MemoryController Benchmark ]\n"
+		"NumRanks = 2\n"
+		"NumBanks = 8\n"
+		"NumRows = 1024\n"
+		"NumColumns = 1024\n";
+
+// Policies compared, with the variables added to the configuration
+struct BenchmarkPolicy
+{
+	const char *name;
+	const char *config;
+};
+
+const BenchmarkPolicy benchmark_policies[] =
+{
+	{ "OldestFirst", "SchedulingPolicy = OldestFirst\n" },
+	{ "RankBankRoundRobin", "SchedulingPolicy = RankBankRoundRobin\n" },
+	{ "FRFCFS", "SchedulingPolicy = FRFCFS\n" },
+	{ "Batch", "SchedulingPolicy = Batch\n" },
+	{ "FRFCFS+WriteDrain", "SchedulingPolicy = FRFCFS\n"
+			"WriteDrainHighWatermark = 16\n"
+			"WriteDrainLowWatermark = 4\n" }
+};
+
+// Trace entry
+struct BenchmarkAccess
+{
+	long long cycle;
+	bool write;
+	long long address;
+};
+
+// Pseudo-random number generator, seeded for reproducible runs
+static std::minstd_rand benchmark_random;
+
+// Encode a DRAM address from its components
+long long BenchmarkEncode(int rank, int bank, int row, int column)
+{
+	return (((long long) rank * benchmark_num_banks + bank) *
+			benchmark_num_rows + row) *
+			benchmark_num_columns + column;
+}
+
+// Random address in the whole DRAM
+long long BenchmarkRandomAddress()
+{
+	return benchmark_random() % ((long long) benchmark_num_ranks *
+			benchmark_num_banks * benchmark_num_rows *
+			benchmark_num_columns);
+}
+
+// Generate a synthetic trace
+void BenchmarkGenerate(const std::string &name, int num_requests,
+		int interval, std::vector<BenchmarkAccess> &trace)
+{
+	const int num_streams = 8;
+	int stream_column[num_streams] = {};
+	benchmark_random.seed(1);
+	trace.clear();
+	for (int i = 0; i < num_requests; i++)
+	{
+		BenchmarkAccess access;
+		access.cycle = (long long) i * interval;
+		access.write = false;
+
+		// Random request
+		if (name == "random" || (name == "mixed" && i % 4 == 3))
+		{
+			access.write = name == "mixed" ||
+					benchmark_random() % 3 == 0;
+			access.address = BenchmarkRandomAddress();
+			trace.push_back(access);
+			continue;
+		}
+
+		// Next block of a stream. Streams 2k and 2k+1 use different
+		// rows of bank k.
+		int stream = i % num_streams;
+		int column = stream_column[stream];
+		stream_column[stream] = (column + 8) % (benchmark_num_columns *
+				benchmark_num_rows / 2);
+		access.address = BenchmarkEncode(0, stream / 2,
+				(stream % 2) * benchmark_num_rows / 2 +
+				column / benchmark_num_columns,
+				column % benchmark_num_columns);
+		trace.push_back(access);
+	}
+}
+
+// Read a trace file
+void BenchmarkRead(const std::string &path,
+		std::vector<BenchmarkAccess> &trace)
+{
+	std::ifstream f(path);
+	if (!f)
+		throw misc::Error(misc::fmt("%s: cannot open trace",
+				path.c_str()));
+	trace.clear();
+	std::string type;
+	std::string address;
+	BenchmarkAccess access;
+	while (f >> access.cycle >> type >> address)
+	{
+		if (type != "R" && type != "W")
+			throw misc::Error(misc::fmt("%s: invalid request "
+					"type '%s'", path.c_str(),
+					type.c_str()));
+		access.write = type == "W";
+		access.address = std::stoll(address, nullptr, 0);
+		trace.push_back(access);
+	}
+}
+
+// Run a trace with a scheduling policy, and print bandwidth, average
+// latency, and row hit ratio.
+void Benchmark(const std::string &trace_name,
+		const std::vector<BenchmarkAccess> &trace,
+		const BenchmarkPolicy &policy)
+{
+	// Fresh simulation
+	esim::Engine::Destroy();
+	System::Destroy();
+	misc::IniFile ini_file;
+	ini_file.LoadFromString(benchmark_config + policy.config);
+	System *dram = System::getInstance();
+	dram->ParseConfiguration(&ini_file);
+	esim::Engine *engine = esim::Engine::getInstance();
+
+	// Issue the requests in their cycle, and run until all of them
+	// complete.
+	std::vector<std::shared_ptr<Request>> requests;
+	unsigned num_issued = 0;
+	unsigned num_finished = 0;
+	while (num_finished < trace.size())
+	{
+		long long cycle = System::frequency_domain->getCycle();
+		while (num_issued < trace.size() &&
+				trace[num_issued].cycle <= cycle)
+		{
+			const BenchmarkAccess &access = trace[num_issued];
+			auto request = std::make_shared<Request>();
+			request->setType(access.write ? RequestWrite :
+					RequestRead);
+			request->setSize(benchmark_request_size);
+			request->setEncodedAddress(access.address);
+			dram->AddRequest(request);
+			requests.push_back(request);
+			num_issued++;
+		}
+		engine->ProcessEvents();
+		while (num_finished < num_issued &&
+				requests[num_finished]->getCycleFinished() >= 0)
+			num_finished++;
+	}
+
+	// Latency
+	long long total_latency = 0;
+	for (auto &request : requests)
+		total_latency += request->getCycleFinished() -
+				request->getCycleIssued();
+
+	// Channel statistics
+	Channel *channel = dram->getController(0)->getChannel(0);
+	long long num_bytes = channel->getNumBytesRead() +
+			channel->getNumBytesWritten();
+	long long num_requests = channel->getNumRowHits() +
+			channel->getNumRowMisses() +
+			channel->getNumRowConflicts();
+	double bandwidth = (double) num_bytes * 1000 / engine->getTime();
+	std::cout << misc::fmt("%-8s %-20s %10lld %12.3f %12.1f %10.3f\n",
+			trace_name.c_str(), policy.name,
+			System::frequency_domain->getCycle(), bandwidth,
+			(double) total_latency / requests.size(),
+			(double) channel->getNumRowHits() / num_requests);
+}
+
+}  // namespace dram
+
+
+int main(int argc, char **argv)
+{
+	try
+	{
+		// Traces
+		std::vector<std::string> trace_names;
+		std::string trace_path;
+		int num_requests = 20000;
+		int interval = 4;
+		if (argc > 1 && std::string(argv[1]).find_first_not_of(
+				"0123456789") != std::string::npos)
+		{
+			trace_path = argv[1];
+			trace_names.push_back("trace");
+		}
+		else
+		{
+			if (argc > 1)
+				num_requests = atoi(argv[1]);
+			if (argc > 2)
+				interval = atoi(argv[2]);
+			trace_names = { "stream", "random", "mixed" };
+		}
+
+		// Header
+		std::cout << misc::fmt("%-8s %-20s %10s %12s %12s %10s\n",
+				"Trace", "Policy", "Cycles",
+				"BW [GB/s]", "Latency", "RowHits");
+
+		// Run
+		std::vector<dram::BenchmarkAccess> trace;
+		for (auto &trace_name : trace_names)
+		{
+			if (trace_path.empty())
+				dram::BenchmarkGenerate(trace_name, num_requests,
+						interval, trace);
+			else
+				dram::BenchmarkRead(trace_path, trace);
+			if (trace.empty())
+				throw misc::Error("Empty trace");
+			for (auto &policy : dram::benchmark_policies)
+				dram::Benchmark(trace_name, trace, policy);
+		}
+	}
+	catch (misc::Error &e)
+	{
+		e.Dump();
+		return 1;
+	}
+	return 0;
+}
@@ -67,6 +67,27 @@ static std::string zero_time_config = default_config +
 			"tWR = 0\n"
 			"tRTP = 0\n"
 			"tBURST = 0\n";
+
+// Process events until the channel has started 'num_requests' requests and
+// all their commands have run.
+static void RunRequests(Channel *channel, int num_requests)
+{
+	esim::Engine *engine = esim::Engine::getInstance();
+	for (int i = 0; i < 10000; i++)
+	{
+		engine->ProcessEvents();
+		if (channel->getNumReads() + channel->getNumWrites() <
+				num_requests)
+			continue;
+		bool done = true;
+		for (int j = 0; j < channel->getNumBanksTotal(); j++)
+			if (channel->getBankTotal(j)->getNumCommandsInQueue())
+				done = false;
+		if (done)
+			return;
+	}
+	FAIL();
+}
 			
 TEST(TestSystemEvents, section_one_read)
 {
@@ -806,4 +827,158 @@ TEST(TestSystemEvents, section_test_address_out_of_bounds)
 	EXPECT_REGEX_MATCH(misc::fmt("Invalid Address").c_str(),
 			message.c_str());
 }
+
+TEST(TestSystemEvents, section_frfcfs_row_hit_first)
+{
+	// cleanup singleton instance
+	Cleanup();
+
+	// Set up INI file
+	misc::IniFile ini_file;
+	ini_file.LoadFromString(default_config +
+			"SchedulingPolicy = FRFCFS\n");
+
+	// Set up dram instance
+	System *dram_system = System::getInstance();
+	dram_system->ParseConfiguration(&ini_file);
+
+	// Test body
+	try
+	{
+		// The read to row 1 arrives before the second read to row 0,
+		// but the latter hits the open row and goes first.
+		dram_system->Read(0);
+		dram_system->Read(1024);
+		dram_system->Read(1);
+		Channel *channel = dram_system->getController(0)->
+				getChannel(0);
+		RunRequests(channel, 3);
+
+		// Oldest first would have found two row conflicts
+		EXPECT_EQ(1, channel->getNumRowMisses());
+		EXPECT_EQ(1, channel->getNumRowHits());
+		EXPECT_EQ(1, channel->getNumRowConflicts());
+	}
+	catch (misc::Error &e)
+	{
+		e.Dump();
+		FAIL();
+	}
+}
+
+TEST(TestSystemEvents, section_batch_marked_first)
+{
+	// cleanup singleton instance
+	Cleanup();
+
+	// Set up INI file
+	misc::IniFile ini_file;
+	ini_file.LoadFromString(default_config +
+			"SchedulingPolicy = Batch\n"
+			"BatchMarkingCap = 1\n");
+
+	// Set up dram instance
+	System *dram_system = System::getInstance();
+	dram_system->ParseConfiguration(&ini_file);
+
+	// Test body
+	try
+	{
+		// With one request per batch, the read to row 1 is the oldest
+		// queued request and goes before the row hits to row 0.
+		dram_system->Read(0);
+		dram_system->Read(1024);
+		dram_system->Read(1);
+		dram_system->Read(2);
+		Channel *channel = dram_system->getController(0)->
+				getChannel(0);
+		RunRequests(channel, 4);
+
+		// FR-FCFS would have found two row hits
+		EXPECT_EQ(1, channel->getNumRowMisses());
+		EXPECT_EQ(1, channel->getNumRowHits());
+		EXPECT_EQ(2, channel->getNumRowConflicts());
+	}
+	catch (misc::Error &e)
+	{
+		e.Dump();
+		FAIL();
+	}
+}
+
+TEST(TestSystemEvents, section_write_drain_reads_first)
+{
+	// cleanup singleton instance
+	Cleanup();
+
+	// Set up INI file
+	misc::IniFile ini_file;
+	ini_file.LoadFromString(default_config +
+			"WriteDrainHighWatermark = 3\n");
+
+	// Set up dram instance
+	System *dram_system = System::getInstance();
+	dram_system->ParseConfiguration(&ini_file);
+
+	// Test body
+	try
+	{
+		// Writes stay below the high watermark and wait for the read,
+		// which hits the open row.
+		dram_system->Read(0);
+		dram_system->Write(1024);
+		dram_system->Write(1025);
+		dram_system->Read(1);
+		Channel *channel = dram_system->getController(0)->
+				getChannel(0);
+		RunRequests(channel, 4);
+		EXPECT_FALSE(channel->getScheduler()->isDraining());
+		EXPECT_EQ(1, channel->getNumRowMisses());
+		EXPECT_EQ(2, channel->getNumRowHits());
+		EXPECT_EQ(1, channel->getNumRowConflicts());
+	}
+	catch (misc::Error &e)
+	{
+		e.Dump();
+		FAIL();
+	}
+}
+
+TEST(TestSystemEvents, section_write_drain_high_watermark)
+{
+	// cleanup singleton instance
+	Cleanup();
+
+	// Set up INI file
+	misc::IniFile ini_file;
+	ini_file.LoadFromString(default_config +
+			"WriteDrainHighWatermark = 2\n");
+
+	// Set up dram instance
+	System *dram_system = System::getInstance();
+	dram_system->ParseConfiguration(&ini_file);
+
+	// Test body
+	try
+	{
+		// Two queued writes start a drain, so both writes go before
+		// the read.
+		dram_system->Read(0);
+		dram_system->Write(1024);
+		dram_system->Write(1025);
+		dram_system->Read(1);
+		Channel *channel = dram_system->getController(0)->
+				getChannel(0);
+		RunRequests(channel, 4);
+		EXPECT_FALSE(channel->getScheduler()->isDraining());
+		EXPECT_EQ(1, channel->getNumRowMisses());
+		EXPECT_EQ(1, channel->getNumRowHits());
+		EXPECT_EQ(2, channel->getNumRowConflicts());
+	}
+	catch (misc::Error &e)
+	{
+		e.Dump();
+		FAIL();
+	}
+}
 }
@@ -0,0 +1,130 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2014  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iostream>
+#include <random>
+
+#include <lib/cpp/Error.h>
+#include <lib/cpp/Misc.h>
+#include <lib/cpp/Timer.h>
+#include <lib/esim/Engine.h>
+
+
+// Micro-benchmark comparing the event queues available in the event-driven
+// simulation engine. A fixed number of event chains is kept in flight, each
+// rescheduling itself a random number of cycles ahead, as memory accesses in
+// the memory hierarchy do. Run as
+//
+//	src_lib_esim_benchmark [<num_events>]
+//
+
+namespace esim
+{
+
+// Event type
+static Event *benchmark_event;
+
+// Number of events executed so far
+static long long benchmark_num_events;
+
+// Pseudo-random number generator, seeded for reproducible runs
+static std::minstd_rand benchmark_random;
+
+// Reschedule the event chain. One out of 64 events is scheduled a long time
+// ahead, modeling a main memory access.
+void BenchmarkHandler(Event *event, Frame *frame)
+{
+	Engine *engine = Engine::getInstance();
+	benchmark_num_events++;
+	int after = benchmark_random() % 64 ? 1 + benchmark_random() % 20 :
+			200 + benchmark_random() % 200;
+	engine->Next(benchmark_event, after);
+}
+
+// Run the benchmark with a given event queue and number of event chains in
+// flight. Return the number of events executed per second.
+double Benchmark(EventQueueKind kind, int num_chains, long long num_events)
+{
+	// Initialize engine
+	Engine::Destroy();
+	Engine::setEventQueueKind(kind);
+	Engine *engine = Engine::getInstance();
+	FrequencyDomain *domain = engine->RegisterFrequencyDomain("domain");
+	benchmark_event = engine->RegisterEvent("event", BenchmarkHandler,
+			domain);
+
+	// Create event chains
+	benchmark_random.seed(1);
+	benchmark_num_events = 0;
+	for (int i = 0; i < num_chains; i++)
+		engine->Call(benchmark_event, nullptr, nullptr,
+				benchmark_random() % 20);
+
+	// Simulate
+	misc::Timer timer("benchmark");
+	timer.Start();
+	while (benchmark_num_events < num_events)
+		engine->ProcessEvents();
+	timer.Stop();
+
+	// Discard pending events
+	Engine::Destroy();
+	return (double) benchmark_num_events / timer.getValue() * 1e6;
+}
+
+}  // namespace esim
+
+
+int main(int argc, char **argv)
+{
+	try
+	{
+		// Number of events
+		long long num_events = 10000000;
+		if (argc > 1)
+			num_events = atoll(argv[1]);
+
+		// Header
+		std::cout << misc::fmt("%10s %15s %15s %10s\n",
+				"InFlight", "Heap [ev/s]",
+				"Calendar [ev/s]", "Speedup");
+
+		// Run
+		for (int num_chains = 16; num_chains < 10000;
+				num_chains *= 4)
+		{
+			double heap = esim::Benchmark(esim::EventQueueHeap,
+					num_chains, num_events);
+			double calendar = esim::Benchmark(
+					esim::EventQueueCalendar,
+					num_chains, num_events);
+			std::cout << misc::fmt("%10d %15.0f %15.0f %9.2fx\n",
+					num_chains, heap, calendar,
+					calendar / heap);
+		}
+	}
+	catch (misc::Exception &e)
+	{
+		e.Dump();
+		return 1;
+	}
+
+	// Success
+	return 0;
+}
@@ -0,0 +1,207 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2014  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdarg>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include <lib/cpp/Error.h>
+#include <lib/cpp/String.h>
+#include <lib/esim/BinaryTrace.h>
+
+
+namespace esim
+{
+
+// Checks that a binary trace reproduces the lines of the text trace, and
+// that the index can be used to seek to a cycle.
+TEST(TestBinaryTrace, test_round_trip)
+{
+	// Temporary file
+	char path[] = "/tmp/m2s-test-trace.XXXXXX";
+	int fd = mkstemp(path);
+	ASSERT_GE(fd, 0);
+	close(fd);
+
+	// Header lines, including one that does not follow the trace syntax
+	std::vector<std::string> lines;
+	lines.push_back("mem.init version=\"1.678\"");
+	lines.push_back("mem.new_net name=\"net-l1-l2\" num_nodes=4");
+	lines.push_back("free text, not a trace command");
+
+	// Enough cycles to fill several blocks
+	for (int cycle = 1; cycle <= 20000; cycle++)
+	{
+		lines.push_back(misc::fmt("c clk=%d", cycle));
+		lines.push_back(misc::fmt("mem.new_access name=\"A-%d\" "
+				"type=\"load\" state=\"mod-l1-%d:load\" "
+				"addr=0x%x", cycle, cycle % 4, cycle * 64));
+		lines.push_back(misc::fmt("x86.inst id=%d core=0 "
+				"stg=\"i\" delta=%d name=\"A-007\"",
+				cycle, -cycle));
+	}
+
+	// Write, with lines split across calls
+	{
+		BinaryTraceWriter writer(path);
+		for (auto &line : lines)
+		{
+			writer.Write(line.substr(0, 5));
+			writer.Write(line.substr(5) + "\n");
+		}
+	}
+
+	// Read all lines
+	std::string line;
+	{
+		BinaryTraceReader reader(path);
+		EXPECT_TRUE(reader.hasIndex());
+		for (auto &expected : lines)
+		{
+			ASSERT_TRUE(reader.ReadLine(line));
+			EXPECT_EQ(expected, line);
+		}
+		EXPECT_FALSE(reader.ReadLine(line));
+	}
+
+	// Seek
+	{
+		BinaryTraceReader reader(path);
+		reader.SeekCycle(15000);
+		do
+			ASSERT_TRUE(reader.ReadLine(line));
+		while (reader.getCycle() < 15000);
+		EXPECT_EQ("c clk=15000", line);
+		EXPECT_LE(reader.getCycle(), 15000);
+		ASSERT_TRUE(reader.ReadLine(line));
+		EXPECT_EQ("mem.new_access name=\"A-15000\" type=\"load\" "
+				"state=\"mod-l1-0:load\" addr=0xea600", line);
+	}
+	unlink(path);
+
+	// Not a binary trace
+	EXPECT_FALSE(BinaryTraceReader::isBinaryTrace("/dev/null"));
+	EXPECT_THROW(BinaryTraceReader("/dev/null"), misc::Error);
+}
+
+
+// Write a trace message with BinaryTraceWriter::WriteFormat(), or as text if
+// the writer cannot encode it, and return the expected line
+static std::string TestBinaryTraceWriteFormat(BinaryTraceWriter &writer,
+		bool &encoded, const char *fmt_str, ...)
+{
+	va_list va;
+	va_start(va, fmt_str);
+	encoded = writer.WriteFormat(fmt_str, va);
+	std::string text = misc::vfmt(fmt_str, va);
+	va_end(va);
+	if (!encoded)
+		writer.Write(text);
+	return text.substr(0, text.size() - 1);
+}
+
+
+// Checks that lines encoded from the format string and arguments of a trace
+// message read back as the formatted text
+TEST(TestBinaryTrace, test_write_format)
+{
+	// Temporary file
+	char path[] = "/tmp/m2s-test-trace.XXXXXX";
+	int fd = mkstemp(path);
+	ASSERT_GE(fd, 0);
+	close(fd);
+
+	// Write lines, recording which ones were encoded from the arguments
+	std::vector<std::string> lines;
+	std::vector<bool> encoded;
+	{
+		BinaryTraceWriter writer(path);
+		bool e;
+		for (int cycle = 1; cycle <= 3; cycle++)
+		{
+			writer.WriteCycle(cycle);
+			lines.push_back(misc::fmt("c clk=%d", cycle));
+			encoded.push_back(true);
+
+			// Memory access, with a value built as text
+			lines.push_back(TestBinaryTraceWriteFormat(writer, e,
+					"mem.new_access name=\"A-%lld\" "
+					"type=\"load\" state=\"%s:load\" "
+					"addr=0x%x\n", cycle * 1000000000000ll,
+					"mod-l1-0", 0x40 * cycle));
+			encoded.push_back(e);
+
+			// Integers out of the range of decimal varints, and
+			// strings reading as integers
+			lines.push_back(TestBinaryTraceWriteFormat(writer, e,
+					"x86.inst id=%llu delta=%d core=\"%s\" "
+					"name=\"%s\" big=\"A-%llu\" "
+					"neg=\"A-%d\"\n",
+					18446744073709551615ull, -cycle, "007",
+					"12", 1000000000000000000ull, -cycle));
+			encoded.push_back(e);
+
+			// Prefixes reading as integers
+			lines.push_back(TestBinaryTraceWriteFormat(writer, e,
+					"x86.inst a=0x%d b=-%u c=\"\" d=%lx\n",
+					cycle, cycle, 0xabcul));
+			encoded.push_back(e);
+		}
+
+		// Values not following the trace syntax
+		lines.push_back(TestBinaryTraceWriteFormat(writer, e,
+				"x86.inst asm=\"%s\"\n", "mov \"a\""));
+		encoded.push_back(e);
+		lines.push_back(TestBinaryTraceWriteFormat(writer, e,
+				"x86.inst asm=%s\n", "mov eax"));
+		encoded.push_back(e);
+
+		// Partial line
+		lines.push_back(TestBinaryTraceWriteFormat(writer, e,
+				"x86.new_inst id=%d\n", 1));
+		encoded.push_back(e);
+		writer.Write("x86.new_inst");
+		lines.push_back("x86.new_inst" + TestBinaryTraceWriteFormat(
+				writer, e, " id=%d\n", 2));
+		encoded.push_back(e);
+	}
+
+	// Only lines following the trace syntax were encoded from the
+	// arguments
+	std::vector<bool> expected_encoded = { true, true, true, true,
+			true, true, true, true, true, true, true, true,
+			false, false, true, false };
+	EXPECT_EQ(expected_encoded, encoded);
+
+	// Read lines
+	{
+		std::string line;
+		BinaryTraceReader reader(path);
+		for (auto &expected : lines)
+		{
+			ASSERT_TRUE(reader.ReadLine(line));
+			EXPECT_EQ(expected, line);
+		}
+		EXPECT_FALSE(reader.ReadLine(line));
+	}
+	unlink(path);
+}
+
+}  // namespace esim
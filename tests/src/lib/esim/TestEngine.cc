@@ -19,6 +19,8 @@
 
 #include "gtest/gtest.h"
 
+#include <random>
+
 #include <lib/cpp/Misc.h>
 #include <lib/cpp/Error.h>
 #include <lib/esim/Engine.h>
@@ -516,9 +518,155 @@ TEST(TestEngine, test_event_queue_priority)
 	}
 }
 
+
+
+
+//
+// Test 5
+//
+
+// Frame carrying an identifier and a number of pending reschedules
+class DummyFrame_5 : public Frame
+{
+public:
+	int id = 0;
+	int remaining = 0;
+};
+
+// Event types, one per frequency domain
+Event *events_5[3];
+
+// Sequence of (frame identifier, time) pairs of executed events
+std::vector<std::pair<int, long long>> trace_5;
+
+// Pseudo-random number generator, seeded for reproducible runs
+static std::minstd_rand random_5;
+
+// Record event and reschedule it in a random frequency domain, mostly a few
+// cycles ahead, and occasionally far in the future.
+void testHandler_5(Event *event, Frame *frame)
+{
+	Engine *engine = Engine::getInstance();
+	DummyFrame_5 *data = dynamic_cast<DummyFrame_5 *>(frame);
+	trace_5.emplace_back(data->id, engine->getTime());
+	if (--data->remaining <= 0)
+		return;
+	int after = random_5() % 16 ? random_5() % 4 :
+			2000 + random_5() % 3000;
+	engine->Next(events_5[random_5() % 3], after);
+}
+
+// Run a workload with the given event queue and return its trace
+std::vector<std::pair<int, long long>> runTrace_5(EventQueueKind kind)
+{
+	// Set up esim engine
+	Cleanup();
+	Engine::setEventQueueKind(kind);
+	Engine *engine = Engine::getInstance();
+
+	// Set up frequency domains and events
+	FrequencyDomain *domain_0 = engine->RegisterFrequencyDomain(
+			"domain 0", 1000);
+	FrequencyDomain *domain_1 = engine->RegisterFrequencyDomain(
+			"domain 1", 600);
+	FrequencyDomain *domain_2 = engine->RegisterFrequencyDomain(
+			"domain 2", 2000);
+	events_5[0] = engine->RegisterEvent("event 0", testHandler_5, domain_0);
+	events_5[1] = engine->RegisterEvent("event 1", testHandler_5, domain_1);
+	events_5[2] = engine->RegisterEvent("event 2", testHandler_5, domain_2);
+
+	// Create frames
+	random_5.seed(1);
+	trace_5.clear();
+	for (int i = 0; i < 200; i++)
+	{
+		auto frame = misc::new_shared<DummyFrame_5>();
+		frame->id = i;
+		frame->remaining = 50;
+		engine->Call(events_5[i % 3], frame, nullptr, random_5() % 50);
+	}
+
+	// Run part of the simulation cycle by cycle, and drain the rest
+	for (int i = 0; i < 20000; i++)
+		engine->ProcessEvents();
+	engine->ProcessAllEvents();
+
+	// Restore default event queue
+	Engine::setEventQueueKind(EventQueueHeap);
+	return trace_5;
+}
+
+// Tests that the calendar queue runs events in exactly the same order as the
+// heap, including events scheduled beyond the calendar window.
+TEST(TestEngine, test_calendar_queue)
+{
+	try
+	{
+		auto heap_trace = runTrace_5(EventQueueHeap);
+		auto calendar_trace = runTrace_5(EventQueueCalendar);
+		EXPECT_EQ(200 * 50, (int) heap_trace.size());
+		EXPECT_TRUE(heap_trace == calendar_trace);
+	}
+	catch (misc::Exception &e)
+	{
+		e.Dump();
+		FAIL();
+	}
 }
 
 
 
 
+//
+// Test 6
+//
 
+// Dummy frame with some payload
+class DummyFrame_6 : public Frame
+{
+public:
+	int value;
+
+	DummyFrame_6(int value) : value(value)
+	{
+	}
+};
+
+// Tests that frames released by the engine are recycled by the frame pool
+TEST(TestEngine, test_frame_pool)
+{
+	try
+	{
+		FramePool *pool = FramePool::getInstance<DummyFrame_6>();
+
+		// Allocate frames
+		std::vector<std::shared_ptr<DummyFrame_6>> frames;
+		for (int i = 0; i < 100; i++)
+			frames.emplace_back(new_frame<DummyFrame_6>(i));
+		EXPECT_EQ(100, pool->getNumAllocations());
+		EXPECT_EQ(0, pool->getNumRecycled());
+		EXPECT_EQ(100, pool->getNumLive());
+		EXPECT_EQ(42, frames[42]->value);
+
+		// Release half of them and allocate again
+		frames.resize(50);
+		EXPECT_EQ(50, pool->getNumLive());
+		for (int i = 0; i < 30; i++)
+			frames.emplace_back(new_frame<DummyFrame_6>(i));
+		EXPECT_EQ(130, pool->getNumAllocations());
+		EXPECT_EQ(30, pool->getNumRecycled());
+		EXPECT_EQ(80, pool->getNumLive());
+		EXPECT_EQ(100, pool->getMaxLive());
+
+		// Release all
+		frames.clear();
+		EXPECT_EQ(0, pool->getNumLive());
+	}
+	catch (misc::Exception &e)
+	{
+		e.Dump();
+		FAIL();
+	}
+}
+
+}
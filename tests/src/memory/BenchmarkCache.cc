@@ -0,0 +1,153 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2014  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iostream>
+#include <random>
+
+#include <lib/cpp/Error.h>
+#include <lib/cpp/Misc.h>
+#include <lib/cpp/Timer.h>
+#include <memory/Cache.h>
+
+
+// Micro-benchmark comparing the tag lookup throughput of a cache for
+// different associativities. Cache::FindBlock(), which compares the packed
+// tags of a set with vector instructions, is compared against a linear walk
+// over the block objects of the set, as done before the packed tag store was
+// introduced. Caches are 2MB with 64-byte blocks, all blocks valid, and half
+// of the lookups hit. Run as
+//
+//	src_memory_benchmark [<num_lookups>]
+//
+
+namespace mem
+{
+
+// Cache geometry
+const unsigned benchmark_cache_size = 2 << 20;
+const unsigned benchmark_block_size = 64;
+
+// Pseudo-random number generator, seeded for reproducible runs
+static std::minstd_rand benchmark_random;
+
+// Lookup walking the block objects of a set
+bool BenchmarkFindBlockLinear(Cache *cache, unsigned address)
+{
+	unsigned set_id;
+	unsigned tag;
+	unsigned block_offset;
+	cache->DecodeAddress(address, set_id, tag, block_offset);
+	for (unsigned way_id = 0; way_id < cache->getNumWays(); way_id++)
+	{
+		Cache::Block *block = cache->getBlock(set_id, way_id);
+		if (block->getTag() == tag && block->getState())
+			return true;
+	}
+	return false;
+}
+
+// Lookup using the packed tag store
+bool BenchmarkFindBlockPacked(Cache *cache, unsigned address)
+{
+	unsigned set_id;
+	unsigned way_id;
+	Cache::BlockState state;
+	return cache->FindBlock(address, set_id, way_id, state);
+}
+
+// Run the benchmark for a given associativity and lookup function. Return the
+// number of lookups per second.
+double Benchmark(unsigned num_ways,
+		bool (*find_block)(Cache *, unsigned),
+		long long num_lookups)
+{
+	// Create cache
+	unsigned num_sets = benchmark_cache_size / benchmark_block_size /
+			num_ways;
+	Cache cache("benchmark", num_sets, num_ways, benchmark_block_size,
+			0, Cache::ReplacementLRU, Cache::WriteBack);
+
+	// Fill all blocks. The block in way 'w' of set 's' holds the block
+	// address (w * num_sets + s).
+	for (unsigned set_id = 0; set_id < num_sets; set_id++)
+		for (unsigned way_id = 0; way_id < num_ways; way_id++)
+			cache.getBlock(set_id, way_id)->setStateTag(
+					Cache::BlockShared,
+					(way_id * num_sets + set_id) *
+					benchmark_block_size);
+
+	// Lookups, half of them within the cached region
+	benchmark_random.seed(1);
+	long long num_hits = 0;
+	misc::Timer timer("benchmark");
+	timer.Start();
+	for (long long i = 0; i < num_lookups; i++)
+	{
+		unsigned address = benchmark_random() %
+				(2 * benchmark_cache_size);
+		num_hits += find_block(&cache, address);
+	}
+	timer.Stop();
+
+	// Sanity
+	if (num_hits < num_lookups / 3)
+		throw misc::Panic("Unexpected hit ratio");
+	return (double) num_lookups / timer.getValue() * 1e6;
+}
+
+}  // namespace mem
+
+
+int main(int argc, char **argv)
+{
+	try
+	{
+		// Number of lookups
+		long long num_lookups = 20000000;
+		if (argc > 1)
+			num_lookups = atoll(argv[1]);
+
+		// Header
+		std::cout << misc::fmt("%10s %18s %18s %10s\n",
+				"Assoc", "Linear [lookup/s]",
+				"Packed [lookup/s]", "Speedup");
+
+		// Run
+		for (unsigned num_ways = 1; num_ways <= 64; num_ways *= 2)
+		{
+			double linear = mem::Benchmark(num_ways,
+					mem::BenchmarkFindBlockLinear,
+					num_lookups);
+			double packed = mem::Benchmark(num_ways,
+					mem::BenchmarkFindBlockPacked,
+					num_lookups);
+			std::cout << misc::fmt("%10u %18.0f %18.0f %9.2fx\n",
+					num_ways, linear, packed,
+					packed / linear);
+		}
+	}
+	catch (misc::Exception &e)
+	{
+		e.Dump();
+		return 1;
+	}
+
+	// Success
+	return 0;
+}
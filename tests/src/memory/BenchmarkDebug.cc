@@ -0,0 +1,124 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2014  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iostream>
+
+#include <lib/cpp/Error.h>
+#include <lib/cpp/Misc.h>
+#include <lib/cpp/Timer.h>
+#include <memory/System.h>
+
+
+// Micro-benchmark measuring the cost of the debug and trace messages of the
+// memory system when neither the debug file nor the trace are enabled. The
+// two messages emitted by the 'load_lock' event handler are dumped once
+// formatted eagerly with misc::fmt() and an output operator, as done before
+// the fmt() member functions were introduced, and once with Debug::fmt() and
+// Trace::fmt(), which skip formatting for inactive sinks. Run as
+//
+//	src_memory_debug_benchmark [<num_messages>]
+//
+
+namespace mem
+{
+
+// Module name used in the messages
+const std::string benchmark_module_name = "mod-l1-0";
+
+// Dump the messages formatting them eagerly
+void BenchmarkMessagesEager(long long time, long long id, unsigned address)
+{
+	System::debug << misc::fmt("  %lld A-%lld 0x%x %s load lock\n",
+			time,
+			id,
+			address,
+			benchmark_module_name.c_str());
+	System::trace << misc::fmt("mem.access "
+			"name=\"A-%lld\" "
+			"state=\"%s:load_lock\"\n",
+			id,
+			benchmark_module_name.c_str());
+}
+
+// Dump the messages with the lazy format functions
+void BenchmarkMessagesLazy(long long time, long long id, unsigned address)
+{
+	System::debug.fmt("  %lld A-%lld 0x%x %s load lock\n",
+			time,
+			id,
+			address,
+			benchmark_module_name.c_str());
+	System::trace.fmt("mem.access "
+			"name=\"A-%lld\" "
+			"state=\"%s:load_lock\"\n",
+			id,
+			benchmark_module_name.c_str());
+}
+
+// Run the benchmark for a given message function. Return the time in
+// nanoseconds spent per pair of messages.
+double Benchmark(void (*messages)(long long, long long, unsigned),
+		long long num_messages)
+{
+	misc::Timer timer("benchmark");
+	timer.Start();
+	for (long long i = 0; i < num_messages; i++)
+		messages(i, i, (unsigned) i << 6);
+	timer.Stop();
+	return (double) timer.getValue() * 1e3 / num_messages;
+}
+
+}  // namespace mem
+
+
+int main(int argc, char **argv)
+{
+	try
+	{
+		// Number of message pairs
+		long long num_messages = 20000000;
+		if (argc > 1)
+			num_messages = atoll(argv[1]);
+
+		// Sinks must be inactive
+		if (mem::System::debug || mem::System::trace)
+			throw misc::Panic("Debug or trace unexpectedly active");
+
+		// Run
+		double eager = mem::Benchmark(mem::BenchmarkMessagesEager,
+				num_messages);
+		double lazy = mem::Benchmark(mem::BenchmarkMessagesLazy,
+				num_messages);
+
+		// Report
+		std::cout << misc::fmt("%10s %14s %14s %10s\n",
+				"Messages", "Eager [ns]", "Lazy [ns]",
+				"Speedup");
+		std::cout << misc::fmt("%10lld %14.2f %14.2f %9.2fx\n",
+				num_messages, eager, lazy, eager / lazy);
+	}
+	catch (misc::Exception &e)
+	{
+		e.Dump();
+		return 1;
+	}
+
+	// Success
+	return 0;
+}
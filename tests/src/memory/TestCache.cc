@@ -0,0 +1,70 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2014  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "gtest/gtest.h"
+
+#include <memory/Cache.h>
+
+namespace mem
+{
+
+// This test checks that FindBlock() finds tags in every way of a highly
+// associative set, ignoring invalid blocks holding a stale copy of the tag.
+TEST(TestCache, find_block)
+{
+	Cache cache("cache", 4, 32, 64, 0, Cache::ReplacementLRU,
+			Cache::WriteBack);
+	unsigned set_id;
+	unsigned way_id;
+	Cache::BlockState state;
+
+	// Empty cache
+	EXPECT_FALSE(cache.FindBlock(0x0, set_id, way_id, state));
+
+	// Fill set 1
+	for (unsigned way = 0; way < 32; way++)
+		cache.setBlock(1, way, (way * 4 + 1) * 64,
+				Cache::BlockShared);
+	for (unsigned way = 0; way < 32; way++)
+	{
+		ASSERT_TRUE(cache.FindBlock((way * 4 + 1) * 64 + 3, set_id,
+				way_id, state));
+		EXPECT_EQ(1u, set_id);
+		EXPECT_EQ(way, way_id);
+		EXPECT_EQ(Cache::BlockShared, state);
+	}
+
+	// Invalidate way 5 and bring its tag into way 30
+	unsigned tag = (5 * 4 + 1) * 64;
+	cache.setBlock(1, 5, tag, Cache::BlockInvalid);
+	EXPECT_FALSE(cache.FindBlock(tag, set_id, way_id, state));
+	cache.getBlock(1, 30)->setStateTag(Cache::BlockModified, tag);
+	ASSERT_TRUE(cache.FindBlock(tag, set_id, way_id, state));
+	EXPECT_EQ(30u, way_id);
+	EXPECT_EQ(Cache::BlockModified, state);
+
+	// Transient tags
+	EXPECT_EQ(32u, cache.FindTransientWay(1, tag));
+	cache.setTransientTag(1, 3, tag);
+	cache.setTransientTag(1, 17, tag);
+	EXPECT_EQ(3u, cache.FindTransientWay(1, tag));
+	EXPECT_EQ(17u, cache.FindTransientWay(1, tag, 4));
+}
+
+}  // namespace mem
@@ -0,0 +1,313 @@
+/*
+ *  Multi2Sim
+ *  Copyright (C) 2014  Rafael Ubal (ubal@ece.neu.edu)
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
+
+#include <lib/cpp/Checkpoint.h>
+#include <memory/Memory.h>
+
+
+namespace mem
+{
+
+TEST(TestMemory, test_code_version)
+{
+	// Map two pages
+	Memory memory;
+	unsigned perm = Memory::AccessRead | Memory::AccessWrite |
+			Memory::AccessExec;
+	memory.Map(0x1000, 2 * Memory::PageSize, perm);
+
+	// Code in unmapped page
+	EXPECT_FALSE(memory.AddCode(0x8000, 4));
+
+	// Writing to a page without code does not invalidate
+	long long version = memory.getCodeVersion();
+	EXPECT_TRUE(memory.AddCode(0x1000, 4));
+	char buffer[4] = { 0 };
+	memory.Write(0x2000, 4, buffer);
+	EXPECT_EQ(version, memory.getCodeVersion());
+
+	// Writing to a page with code invalidates once
+	memory.Write(0x1100, 4, buffer);
+	EXPECT_LT(version, memory.getCodeVersion());
+	version = memory.getCodeVersion();
+	memory.Write(0x1100, 4, buffer);
+	EXPECT_EQ(version, memory.getCodeVersion());
+
+	// Code crossing a page boundary, invalidated by a write to the
+	// second page.
+	EXPECT_TRUE(memory.AddCode(0x1ffe, 4));
+	memory.Write(0x2010, 4, buffer);
+	EXPECT_LT(version, memory.getCodeVersion());
+	version = memory.getCodeVersion();
+
+	// Protect
+	EXPECT_TRUE(memory.AddCode(0x1000, 4));
+	memory.Protect(0x1000, Memory::PageSize, Memory::AccessRead);
+	EXPECT_LT(version, memory.getCodeVersion());
+	version = memory.getCodeVersion();
+
+	// Unmap
+	EXPECT_TRUE(memory.AddCode(0x2000, 4));
+	memory.Unmap(0x2000, Memory::PageSize);
+	EXPECT_LT(version, memory.getCodeVersion());
+	version = memory.getCodeVersion();
+
+	// Clear
+	memory.Clear();
+	EXPECT_LT(version, memory.getCodeVersion());
+}
+
+TEST(TestMemory, test_tlb)
+{
+	// Map two pages with conflicting TLB entries
+	Memory memory;
+	unsigned perm = Memory::AccessRead | Memory::AccessWrite;
+	unsigned address1 = 0x10000;
+	unsigned address2 = 0x10000 + 64 * Memory::PageSize;
+	memory.Map(address1, Memory::PageSize, perm);
+	memory.Map(address2, Memory::PageSize, perm);
+
+	// Repeated lookups hit in the TLB
+	Memory::Page *page1 = memory.getPage(address1);
+	ASSERT_TRUE(page1 != nullptr);
+	long long num_hits = memory.getNumTlbHits();
+	EXPECT_EQ(page1, memory.getPage(address1 + 100));
+	EXPECT_EQ(num_hits + 1, memory.getNumTlbHits());
+
+	// Conflicting page replaces the entry
+	long long num_misses = memory.getNumTlbMisses();
+	Memory::Page *page2 = memory.getPage(address2);
+	ASSERT_TRUE(page2 != nullptr);
+	EXPECT_NE(page1, page2);
+	EXPECT_EQ(num_misses + 1, memory.getNumTlbMisses());
+	EXPECT_EQ(page1, memory.getPage(address1));
+
+	// Data written through the TLB is read back
+	int value = 1234;
+	memory.Write(address1 + 8, 4, (char *) &value);
+	value = 0;
+	memory.Read(address1 + 8, 4, (char *) &value);
+	EXPECT_EQ(1234, value);
+
+	// Unmapped pages are not returned anymore
+	memory.Unmap(address1, Memory::PageSize);
+	EXPECT_TRUE(memory.getPage(address1) == nullptr);
+	memory.Map(address1, Memory::PageSize, perm);
+	EXPECT_TRUE(memory.getPage(address1) != nullptr);
+
+	// Same after clearing
+	memory.Clear();
+	EXPECT_TRUE(memory.getPage(address1) == nullptr);
+	EXPECT_TRUE(memory.getPage(address2) == nullptr);
+}
+
+TEST(TestMemory, test_clone)
+{
+	// Map and initialize two pages, with a third one without data
+	Memory memory;
+	unsigned perm = Memory::AccessRead | Memory::AccessWrite;
+	memory.Map(0x1000, 3 * Memory::PageSize, perm);
+	int value = 10;
+	memory.Write(0x1000, 4, (char *) &value);
+	value = 20;
+	memory.Write(0x2000, 4, (char *) &value);
+
+	// Clone, data is shared
+	Memory clone;
+	clone.Clone(memory);
+	EXPECT_EQ(2, clone.getNumSharedPages());
+	EXPECT_EQ(0, clone.getNumCopiedPages());
+	EXPECT_EQ(memory.getPage(0x1000)->getData(),
+			clone.getPage(0x1000)->getData());
+	EXPECT_EQ(memory.getPage(0x1000)->getPerm(),
+			clone.getPage(0x1000)->getPerm());
+
+	// Write to the clone copies the page
+	value = 11;
+	clone.Write(0x1004, 4, (char *) &value);
+	EXPECT_EQ(1, clone.getNumCopiedPages());
+	EXPECT_NE(memory.getPage(0x1000)->getData(),
+			clone.getPage(0x1000)->getData());
+	clone.Read(0x1000, 4, (char *) &value);
+	EXPECT_EQ(10, value);
+	memory.Read(0x1004, 4, (char *) &value);
+	EXPECT_EQ(0, value);
+
+	// Write to the original copies the page, too
+	value = 21;
+	memory.Write(0x2000, 4, (char *) &value);
+	EXPECT_EQ(1, memory.getNumCopiedPages());
+	clone.Read(0x2000, 4, (char *) &value);
+	EXPECT_EQ(20, value);
+	memory.Read(0x2000, 4, (char *) &value);
+	EXPECT_EQ(21, value);
+
+	// Pages are only copied once
+	clone.Write(0x1008, 4, (char *) &value);
+	memory.Write(0x2008, 4, (char *) &value);
+	EXPECT_EQ(1, clone.getNumCopiedPages());
+	EXPECT_EQ(1, memory.getNumCopiedPages());
+
+	// Writable buffers are private too
+	Memory copy(memory);
+	char *buffer = copy.getBuffer(0x2000, 4, Memory::AccessWrite);
+	buffer[0] = 0;
+	memory.Read(0x2000, 4, (char *) &value);
+	EXPECT_EQ(21, value);
+	EXPECT_EQ(1, copy.getNumCopiedPages());
+
+	// Page without data in clone
+	clone.Read(0x3000, 4, (char *) &value);
+	EXPECT_EQ(0, value);
+}
+
+TEST(TestMemory, test_map_file)
+{
+	// File with one page and 8 bytes
+	char path[] = "/tmp/m2s-test-map-file.XXXXXX";
+	int fd = mkstemp(path);
+	ASSERT_GE(fd, 0);
+	std::vector<int> content((Memory::PageSize + 8) / 4);
+	content[0] = 11;
+	content[Memory::PageSize / 4 + 1] = 22;
+	ASSERT_EQ((ssize_t) (content.size() * 4),
+			write(fd, content.data(), content.size() * 4));
+
+	// A file opened for writing is not mapped, since it could be
+	// truncated while mapped
+	Memory memory;
+	memory.Map(0x10000, 3 * Memory::PageSize,
+			Memory::AccessRead | Memory::AccessWrite);
+	EXPECT_FALSE(memory.MapFile(0x10000, 3 * Memory::PageSize, fd, 0));
+	EXPECT_TRUE(memory.getPage(0x10000)->getData() == nullptr);
+	close(fd);
+
+	// Map it read-only on three pages. The last one is past the end of
+	// the file.
+	fd = open(path, O_RDONLY);
+	ASSERT_GE(fd, 0);
+	ASSERT_TRUE(memory.MapFile(0x10000, 3 * Memory::PageSize, fd, 0));
+	close(fd);
+	EXPECT_TRUE(memory.getPage(0x10000)->isMapped());
+	EXPECT_TRUE(memory.getPage(0x11000)->isMapped());
+	EXPECT_TRUE(memory.getPage(0x12000)->getData() == nullptr);
+
+	// Content
+	int value;
+	memory.Read(0x10000, 4, (char *) &value);
+	EXPECT_EQ(11, value);
+	memory.Read(0x11004, 4, (char *) &value);
+	EXPECT_EQ(22, value);
+	memory.Read(0x11010, 4, (char *) &value);
+	EXPECT_EQ(0, value);
+
+	// Writes make a private copy, also in clones
+	Memory clone(memory);
+	EXPECT_TRUE(clone.getPage(0x10000)->isMapped());
+	value = 33;
+	memory.Write(0x10000, 4, (char *) &value);
+	EXPECT_EQ(1, memory.getNumCopiedPages());
+	EXPECT_FALSE(memory.getPage(0x10000)->isMapped());
+	clone.Read(0x10000, 4, (char *) &value);
+	EXPECT_EQ(11, value);
+	memory.Read(0x10000, 4, (char *) &value);
+	EXPECT_EQ(33, value);
+
+	// The file is not modified
+	fd = open(path, O_RDONLY);
+	ASSERT_GE(fd, 0);
+	ASSERT_EQ(4, read(fd, &value, 4));
+	EXPECT_EQ(11, value);
+
+	// Offset past the end of the file
+	memory.Map(0x20000, Memory::PageSize, Memory::AccessRead);
+	EXPECT_TRUE(memory.MapFile(0x20000, Memory::PageSize, fd,
+			2 * Memory::PageSize));
+	EXPECT_TRUE(memory.getPage(0x20000)->getData() == nullptr);
+	close(fd);
+	unlink(path);
+
+	// Files that the host cannot map
+	int pipe_fd[2];
+	ASSERT_EQ(0, pipe(pipe_fd));
+	EXPECT_FALSE(memory.MapFile(0x20000, Memory::PageSize, pipe_fd[0], 0));
+	close(pipe_fd[0]);
+	close(pipe_fd[1]);
+}
+
+TEST(TestMemory, test_checkpoint)
+{
+	// Temporary file
+	char path[] = "/tmp/m2s-test-checkpoint.XXXXXX";
+	int fd = mkstemp(path);
+	ASSERT_GE(fd, 0);
+	close(fd);
+
+	// Memory with two initialized pages and one page without data
+	Memory memory;
+	memory.Map(0x1000, 2 * Memory::PageSize,
+			Memory::AccessRead | Memory::AccessWrite);
+	memory.Map(0x8000, Memory::PageSize, Memory::AccessRead);
+	memory.setHeapBreak(0x9000);
+	int value = 10;
+	memory.Write(0x1000, 4, (char *) &value);
+	value = 20;
+	memory.Write(0x2ffc, 4, (char *) &value);
+
+	// Save
+	{
+		misc::Checkpoint checkpoint(path, true);
+		memory.SaveCheckpoint(checkpoint);
+		checkpoint.WriteValue(1234);
+	}
+
+	// Load into a memory with other content
+	Memory restored;
+	restored.Map(0x5000, Memory::PageSize, Memory::AccessRead);
+	{
+		misc::Checkpoint checkpoint(path, false);
+		restored.LoadCheckpoint(checkpoint);
+		EXPECT_EQ(1234, checkpoint.ReadValue<int>());
+	}
+	unlink(path);
+
+	// Check content
+	EXPECT_EQ(0x9000u, restored.getHeapBreak());
+	EXPECT_TRUE(restored.getPage(0x5000) == nullptr);
+	ASSERT_TRUE(restored.getPage(0x8000) != nullptr);
+	EXPECT_TRUE(restored.getPage(0x8000)->getData() == nullptr);
+	EXPECT_EQ((unsigned) Memory::AccessRead,
+			restored.getPage(0x8000)->getPerm());
+	restored.Read(0x1000, 4, (char *) &value);
+	EXPECT_EQ(10, value);
+	restored.Read(0x2ffc, 4, (char *) &value);
+	EXPECT_EQ(20, value);
+
+	// Not a checkpoint file
+	EXPECT_THROW(misc::Checkpoint("/dev/null", false), misc::Error);
+}
+
+}  // namespace mem
@@ -23,6 +23,9 @@
 
 #include <arch/x86/timing/Timing.h>
 #include <arch/common/Arch.h>
+#include <dram/Channel.h>
+#include <dram/Controller.h>
+#include <dram/System.h>
 #include <lib/cpp/IniFile.h>
 #include <lib/cpp/Error.h>
 #include <lib/esim/Engine.h>
@@ -265,6 +268,17 @@ const std::string mem_config_1 =
 		"Thread = 0\n"
 		"Module = mod-l1-3\n";
 
+const std::string dram_config =
+		"[ General ]\n"
+		"Frequency = 1000\n"
+		"\n"
+		"[ MemoryController dram-0 ]\n"
+		"NumChannels = 1\n"
+		"NumRanks = 1\n"
+		"NumBanks = 8\n"
+		"NumRows = 1024\n"
+		"NumColumns = 1024\n";
+
 const std::string x86_config =
 		"[ General ]\n"
 		"Cores = 4\n"
@@ -497,6 +511,8 @@ static void Cleanup()
 
 	System::Destroy();
 
+	dram::System::Destroy();
+
 	x86::Timing::Destroy();
 
 	comm::ArchPool::Destroy();
@@ -4221,6 +4237,102 @@ TEST(TestSystemEvents, config_1_evict_0)
 	}
 }
 
+// mod-mm is backed by DRAM controller dram-0
+// l1_0 reads addresses 0x0, 0x80, and 0x400 one after the other, causing a
+// row miss, a row hit, and a row conflict in the same DRAM bank
+TEST(TestSystemEvents, config_0_dram_load_0)
+{
+	try
+	{
+		// Cleanup singleton instances
+		Cleanup();
+
+		// Load configuration files
+		misc::IniFile ini_file_mem;
+		misc::IniFile ini_file_x86;
+		misc::IniFile ini_file_net;
+		misc::IniFile ini_file_dram;
+		ini_file_mem.LoadFromString(std::regex_replace(mem_config_0,
+				std::regex("Type = MainMemory\n"),
+				"Type = MainMemory\nDRAM = dram-0\n"));
+		ini_file_x86.LoadFromString(x86_config);
+		ini_file_net.LoadFromString(net_config);
+		ini_file_dram.LoadFromString(dram_config);
+
+		// Set up x86 timing simulator
+		x86::Timing::ParseConfiguration(&ini_file_x86);
+		x86::Timing::getInstance();
+
+		// Set up network system
+		net::System *network_system = net::System::getInstance();
+		network_system->ParseConfiguration(&ini_file_net);
+
+		// Set up DRAM system
+		dram::System *dram_system = dram::System::getInstance();
+		dram_system->ParseConfiguration(&ini_file_dram);
+
+		// Set up memory system
+		System *memory_system = System::getInstance();
+		memory_system->ReadConfiguration(&ini_file_mem);
+
+		// Get modules
+		Module *module_l1_0 = memory_system->getModule("mod-l1-0");
+		Module *module_mm = memory_system->getModule("mod-mm");
+		ASSERT_NE(module_l1_0, nullptr);
+		ASSERT_NE(module_mm, nullptr);
+
+		// Check DRAM controller
+		dram::Controller *controller = dram_system->getController(0);
+		ASSERT_EQ(module_mm->getDramController(), controller);
+
+		// Accesses, one at a time, recording their latencies
+		esim::Engine *esim_engine = esim::Engine::getInstance();
+		long long latencies[3];
+		unsigned addresses[3] = { 0x0, 0x80, 0x400 };
+		for (int i = 0; i < 3; i++)
+		{
+			int witness = -1;
+			long long start = esim_engine->getCycle();
+			module_l1_0->Access(Module::AccessLoad, addresses[i],
+					&witness);
+			while (witness < 0)
+				esim_engine->ProcessEvents();
+			latencies[i] = esim_engine->getCycle() - start;
+		}
+
+		// Check blocks
+		for (unsigned address : addresses)
+		{
+			unsigned set_id;
+			unsigned way_id;
+			Cache::BlockState state;
+			EXPECT_TRUE(module_l1_0->getCache()->FindBlock(address,
+					set_id, way_id, state));
+			EXPECT_EQ(state, Cache::BlockExclusive);
+		}
+
+		// Check DRAM requests
+		dram::Channel *channel = controller->getChannel(0);
+		EXPECT_EQ(channel->getNumReads(), 3);
+		EXPECT_EQ(channel->getNumWrites(), 0);
+		EXPECT_EQ(channel->getNumBytesRead(), 3 * 128);
+		EXPECT_EQ(channel->getNumRowMisses(), 1);
+		EXPECT_EQ(channel->getNumRowHits(), 1);
+		EXPECT_EQ(channel->getNumRowConflicts(), 1);
+
+		// A row hit is faster than a row miss, which is faster than
+		// a row conflict
+		EXPECT_LT(latencies[1], latencies[0]);
+		EXPECT_LT(latencies[0], latencies[2]);
+	}
+	catch (misc::Exception &e)
+	{
+		e.Dump();
+		FAIL();
+	}
+}
+
+
 /* TODO: This test will be added again when the support for the test
 is provided in the multi2sim 
 TEST(TestSystemEvents, test_flood)